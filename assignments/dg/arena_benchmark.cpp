@@ -0,0 +1,91 @@
+// Per-request scratch graphs: build a small graph, query it, throw it away, many times over.
+// Compares where the graph's memory comes from: the global heap, a shared pool resource, a fresh
+// arena per request, and one arena graph reused through Clear(). Prints JSON to stdout.
+//
+//   arena_benchmark [--requests=500] [--nodes=500] [--edges=4000] [--seed=42]
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/graph.h"
+
+namespace {
+
+namespace bm = gdwg::benchmark;
+using Graph = gdwg::Graph<int, float>;
+using Request = std::vector<std::tuple<int, int, float>>;
+
+std::vector<Request> MakeRequests(std::size_t requests,
+                                  std::size_t nodes,
+                                  std::size_t edges,
+                                  std::size_t seed) {
+  std::mt19937_64 rng{seed};
+  std::uniform_int_distribution<int> node(0, static_cast<int>(nodes) - 1);
+  std::uniform_real_distribution<float> weight(0, 1);
+  std::vector<Request> out(requests);
+  for (auto& request : out) {
+    request.reserve(edges);
+    for (std::size_t i = 0; i < edges; ++i) {
+      request.emplace_back(node(rng), node(rng), weight(rng));
+    }
+  }
+  return out;
+}
+
+void Build(Graph& g, const Request& request, std::size_t nodes) {
+  for (std::size_t i = 0; i < nodes; ++i) {
+    g.InsertNode(static_cast<int>(i));
+  }
+  for (const auto& [src, dst, w] : request) {
+    g.InsertEdge(src, dst, w);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto num_requests = bm::Arg(argc, argv, "requests", 500);
+  const auto nodes = bm::Arg(argc, argv, "nodes", 500);
+  const auto edges = bm::Arg(argc, argv, "edges", 4000);
+  const auto requests = MakeRequests(num_requests, nodes, edges, bm::Arg(argc, argv, "seed", 42));
+  const bm::Fields params{{"requests", num_requests}, {"nodes", nodes}, {"edges", edges}};
+  bm::Reporter reporter;
+
+  // make_graph returns the graph to serve a request with, and teardown is timed as its Clear().
+  // The fresh graphs are destroyed (empty) when the next one is made.
+  auto run = [&](const std::string& name, auto&& make_graph) {
+    double build_seconds = 0;
+    double teardown_seconds = 0;
+    for (const auto& request : requests) {
+      bm::Timer timer;
+      auto& g = make_graph();
+      Build(g, request, nodes);
+      bm::DoNotOptimize(g.NumEdges());
+      build_seconds += timer.Seconds();
+      timer.Reset();
+      g.Clear();
+      teardown_seconds += timer.Seconds();
+    }
+    const double n = num_requests;
+    reporter.Add(name, params,
+                 {{"build_us", 1e6 * build_seconds / n},
+                  {"teardown_us", 1e6 * teardown_seconds / n},
+                  {"requests_per_second", n / (build_seconds + teardown_seconds)}});
+  };
+
+  std::optional<Graph> scratch;
+  run("heap", [&]() -> Graph& { return scratch.emplace(); });
+  std::pmr::unsynchronized_pool_resource pool;
+  run("pool", [&]() -> Graph& { return scratch.emplace(&pool); });
+  run("arena", [&]() -> Graph& { return scratch.emplace(gdwg::ArenaOptions{}); });
+  Graph reused{gdwg::ArenaOptions{}};
+  run("arena_reused", [&]() -> Graph& { return reused; });
+
+  reporter.Print(std::cout);
+}
@@ -0,0 +1,110 @@
+#ifndef ASSIGNMENTS_DG_BENCHMARK_H_
+#define ASSIGNMENTS_DG_BENCHMARK_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+namespace benchmark {
+
+class Timer {
+ public:
+  Timer() : start_{std::chrono::steady_clock::now()} {}
+  void Reset() { start_ = std::chrono::steady_clock::now(); }
+  double Seconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Stops the compiler from optimising away a result that is otherwise unused.
+template <typename T>
+void DoNotOptimize(const T& val) {
+  __asm__ __volatile__("" : : "r"(&val) : "memory");
+}
+
+// Runs fn until at least min_seconds have passed (at least once) and returns seconds per run.
+template <typename Fn>
+double Measure(Fn&& fn, double min_seconds = 0.1) {
+  std::size_t runs = 0;
+  Timer timer;
+  do {
+    fn();
+    ++runs;
+  } while (timer.Seconds() < min_seconds);
+  return timer.Seconds() / static_cast<double>(runs);
+}
+
+using Fields = std::vector<std::pair<std::string, double>>;
+
+// Collects results and prints them as one JSON document so that runs can be diffed between
+// releases:
+//   {"benchmarks": [{"name": "...", "params": {"edges": 1000}, "metrics": {"seconds": 0.1}}]}
+class Reporter {
+ public:
+  void Add(std::string name, Fields params, Fields metrics) {
+    results_.push_back({std::move(name), std::move(params), std::move(metrics)});
+    // progress goes to stderr so stdout stays valid JSON
+    std::cerr << results_.back().name;
+    for (const auto& [key, val] : results_.back().params)
+      std::cerr << ' ' << key << '=' << val;
+    for (const auto& [key, val] : results_.back().metrics)
+      std::cerr << ' ' << key << '=' << val;
+    std::cerr << '\n';
+  }
+
+  void Print(std::ostream& os) const {
+    os << "{\"benchmarks\": [";
+    for (std::size_t i = 0; i < results_.size(); ++i) {
+      os << (i == 0 ? "\n" : ",\n") << "  {\"name\": \"" << results_[i].name << "\", \"params\": ";
+      PrintFields(os, results_[i].params);
+      os << ", \"metrics\": ";
+      PrintFields(os, results_[i].metrics);
+      os << '}';
+    }
+    os << "\n]}\n";
+  }
+
+ private:
+  struct Result {
+    std::string name;
+    Fields params;
+    Fields metrics;
+  };
+
+  static void PrintFields(std::ostream& os, const Fields& fields) {
+    os << '{';
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << '"' << fields[i].first << "\": " << std::setprecision(9)
+         << fields[i].second;
+    }
+    os << '}';
+  }
+
+  std::vector<Result> results_;
+};
+
+// Reads a "--name=value" argument, falling back to the default when it isn't given.
+inline std::size_t Arg(int argc, char** argv, const std::string& name, std::size_t fallback) {
+  const std::string prefix = "--" + name + "=";
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg{argv[i]};
+    if (arg.compare(0, prefix.size(), prefix) == 0) {
+      return std::strtoull(arg.c_str() + prefix.size(), nullptr, 10);
+    }
+  }
+  return fallback;
+}
+
+}  // namespace benchmark
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_BENCHMARK_H_
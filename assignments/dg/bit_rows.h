@@ -0,0 +1,174 @@
+#ifndef ASSIGNMENTS_DG_BIT_ROWS_H_
+#define ASSIGNMENTS_DG_BIT_ROWS_H_
+
+// Kernels over rows of packed bits (bit i of a row is bit i % 64 of word i / 64), used by the
+// bitset based representations and indexes. Each has a scalar version and, where the target
+// has them, AVX2 or SSSE3 versions that work 256 or 128 bits at a time. Population counts use
+// the nibble lookup (pshufb) method; the scalar fallback uses __builtin_popcountll, which is a
+// single instruction when built with -mpopcnt (or -march=native).
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+namespace gdwg {
+namespace detail {
+
+constexpr std::size_t WordsFor(std::size_t bits) noexcept {
+  return (bits + 63) / 64;
+}
+
+inline bool TestBit(const std::uint64_t* row, std::size_t i) noexcept {
+  return (row[i / 64] >> (i % 64)) & 1;
+}
+
+inline void SetBit(std::uint64_t* row, std::size_t i) noexcept {
+  row[i / 64] |= std::uint64_t{1} << (i % 64);
+}
+
+// bits set in row's first `bit` bits of word bit / 64, i.e. the rank of bit within its word
+inline std::size_t RankInWord(const std::uint64_t* row, std::size_t bit) noexcept {
+  const std::uint64_t below = (std::uint64_t{1} << (bit % 64)) - 1;
+  return static_cast<std::size_t>(__builtin_popcountll(row[bit / 64] & below));
+}
+
+#if defined(__AVX2__)
+// per-byte popcounts of v, summed into four 64-bit lanes
+inline __m256i PopCount256(__m256i v) noexcept {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1,
+                       2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+  const __m256i hi =
+      _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+  return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+inline std::size_t Sum256(__m256i v) noexcept {
+  return static_cast<std::size_t>(_mm256_extract_epi64(v, 0) + _mm256_extract_epi64(v, 1) +
+                                  _mm256_extract_epi64(v, 2) + _mm256_extract_epi64(v, 3));
+}
+#elif defined(__SSSE3__)
+inline __m128i PopCount128(__m128i v) noexcept {
+  const __m128i lookup = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m128i low_mask = _mm_set1_epi8(0x0f);
+  const __m128i lo = _mm_shuffle_epi8(lookup, _mm_and_si128(v, low_mask));
+  const __m128i hi = _mm_shuffle_epi8(lookup, _mm_and_si128(_mm_srli_epi16(v, 4), low_mask));
+  return _mm_sad_epu8(_mm_add_epi8(lo, hi), _mm_setzero_si128());
+}
+inline std::size_t Sum128(__m128i v) noexcept {
+  return static_cast<std::size_t>(_mm_cvtsi128_si64(v) +
+                                  _mm_cvtsi128_si64(_mm_unpackhi_epi64(v, v)));
+}
+#endif
+
+// bits set in a[0..words)
+inline std::size_t PopCount(const std::uint64_t* a, std::size_t words) noexcept {
+  std::size_t count = 0;
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= words; i += 4) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    acc = _mm256_add_epi64(acc, PopCount256(v));
+  }
+  count += Sum256(acc);
+#elif defined(__SSSE3__)
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 2 <= words; i += 2) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    acc = _mm_add_epi64(acc, PopCount128(v));
+  }
+  count += Sum128(acc);
+#endif
+  for (; i < words; ++i) {
+    count += static_cast<std::size_t>(__builtin_popcountll(a[i]));
+  }
+  return count;
+}
+
+// bits set in both a and b
+inline std::size_t AndPopCount(const std::uint64_t* a,
+                               const std::uint64_t* b,
+                               std::size_t words) noexcept {
+  std::size_t count = 0;
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= words; i += 4) {
+    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    acc = _mm256_add_epi64(acc, PopCount256(_mm256_and_si256(va, vb)));
+  }
+  count += Sum256(acc);
+#elif defined(__SSSE3__)
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 2 <= words; i += 2) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    acc = _mm_add_epi64(acc, PopCount128(_mm_and_si128(va, vb)));
+  }
+  count += Sum128(acc);
+#endif
+  for (; i < words; ++i) {
+    count += static_cast<std::size_t>(__builtin_popcountll(a[i] & b[i]));
+  }
+  return count;
+}
+
+// out = a & b
+inline void And(const std::uint64_t* a,
+                const std::uint64_t* b,
+                std::uint64_t* out,
+                std::size_t words) noexcept {
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 4 <= words; i += 4) {
+    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_and_si256(va, vb));
+  }
+#endif
+  for (; i < words; ++i) {
+    out[i] = a[i] & b[i];
+  }
+}
+
+// out |= src; returns true if out gained any bit
+inline bool OrInto(std::uint64_t* out, const std::uint64_t* src, std::size_t words) noexcept {
+  std::uint64_t gained = 0;
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  __m256i any = _mm256_setzero_si256();
+  for (; i + 4 <= words; i += 4) {
+    const __m256i vo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + i));
+    const __m256i vs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    any = _mm256_or_si256(any, _mm256_andnot_si256(vo, vs));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_or_si256(vo, vs));
+  }
+  gained |= !_mm256_testz_si256(any, any);
+#endif
+  for (; i < words; ++i) {
+    gained |= src[i] & ~out[i];
+    out[i] |= src[i];
+  }
+  return gained != 0;
+}
+
+// calls fn(i) for each set bit i of row, in increasing order
+template <typename Fn>
+void ForEachBit(const std::uint64_t* row, std::size_t words, Fn&& fn) {
+  for (std::size_t w = 0; w < words; ++w) {
+    for (std::uint64_t bits = row[w]; bits != 0; bits &= bits - 1) {
+      fn(w * 64 + static_cast<std::size_t>(__builtin_ctzll(bits)));
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_BIT_ROWS_H_
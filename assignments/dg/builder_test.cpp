@@ -0,0 +1,64 @@
+/*
+  GraphBuilder must build exactly the graph that InsertNode/InsertEdge would have, whatever
+  order the nodes and edges arrive in and however many threads sort them.
+*/
+
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/builder.h"
+#include "catch.h"
+
+SCENARIO("GraphBuilder builds the same graph as inserting edges one at a time") {
+  GIVEN("unsorted edges with duplicates and an isolated node") {
+    gdwg::GraphBuilder<std::string, int> builder;
+    builder.AddEdge("c", "a", 2);
+    builder.AddEdge("a", "b", 1);
+    builder.AddEdge("c", "a", 2);
+    builder.AddEdge("a", "b", -1);
+    builder.AddNode("z");
+    builder.AddNode("a");
+    WHEN("the graph is built") {
+      auto g = builder.Build();
+      THEN("it matches the graph built by InsertEdge") {
+        gdwg::Graph<std::string, int> expected{"a", "b", "c", "z"};
+        expected.InsertEdge("c", "a", 2);
+        expected.InsertEdge("a", "b", 1);
+        expected.InsertEdge("a", "b", -1);
+        REQUIRE(g == expected);
+        REQUIRE(g.NumEdges() == 3);
+      }
+    }
+  }
+  GIVEN("many random edges split over two merged builders") {
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> node(0, 300);
+    gdwg::GraphBuilder<int, int> first;
+    gdwg::GraphBuilder<int, int> second;
+    gdwg::Graph<int, int> expected;
+    for (int i = 0; i < 40000; ++i) {
+      const int src = node(rng);
+      const int dst = node(rng);
+      const int w = node(rng) % 4;
+      (i % 2 == 0 ? first : second).AddEdge(src, dst, w);
+      expected.InsertNode(src);
+      expected.InsertNode(dst);
+      expected.InsertEdge(src, dst, w);
+    }
+    first.Merge(std::move(second));
+    REQUIRE(first.NumEdges() == 40000);
+    WHEN("the snapshot is sorted on several threads") {
+      auto s = first.BuildSnapshot(4);
+      THEN("it holds the same edges as the inserted graph") {
+        REQUIRE(s.NumEdges() == expected.NumEdges());
+        REQUIRE(s.ToGraph() == expected);
+      }
+    }
+  }
+  GIVEN("an empty builder") {
+    gdwg::GraphBuilder<int, int> builder;
+    THEN("it builds an empty graph") { REQUIRE(builder.Build().IsEmpty()); }
+  }
+}
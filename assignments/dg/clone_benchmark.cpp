@@ -0,0 +1,64 @@
+// Cost of copying a large graph in each of the available ways: the deep copy constructor, a
+// deep Clone into a presized arena, a round trip through a Snapshot, and a SharedGraph copy
+// (O(1)) followed by the first write that forces it to copy. Prints JSON to stdout.
+//
+//   clone_benchmark [--edges=1000000] [--threads=<cores>]
+//
+// Pass --edges=10000000 for the 10M edge figures.
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/shared_graph.h"
+#include "assignments/dg/snapshot.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = float;
+  using Graph = gdwg::Graph<N, E>;
+  const auto edges = bm::Arg(argc, argv, "edges", 1000000);
+  gdwg::GeneratorOptions options;
+  options.threads = bm::Arg(argc, argv, "threads", gdwg::DefaultThreads());
+
+  const auto scale = static_cast<unsigned>(std::log2(edges / 16.0));
+  const Graph g = gdwg::Rmat<N, E>(scale, edges, gdwg::UniformWeights<E>(0, 1), options)
+                      .Build(options.threads);
+  const double m = g.NumEdges();
+  const bm::Fields params{{"nodes", g.NumNodes()}, {"edges", m}};
+  bm::Reporter reporter;
+
+  // times making a copy and then destroying it
+  auto run = [&](const std::string& name, auto&& copy) {
+    bm::Timer timer;
+    {
+      auto result = copy();
+      const double copy_seconds = timer.Seconds();
+      timer.Reset();
+      {
+        const auto discard = std::move(result);
+      }
+      reporter.Add(name, params,
+                   {{"copy_seconds", copy_seconds},
+                    {"edges_per_second", m / copy_seconds},
+                    {"destroy_seconds", timer.Seconds()}});
+    }
+  };
+
+  run("copy_constructor", [&] { return Graph{g}; });
+  run("clone_arena", [&] { return g.Clone(gdwg::ArenaOptions{}); });
+  run("snapshot_round_trip", [&] { return gdwg::Snapshot<N, E>{g}.ToGraph(); });
+
+  const gdwg::SharedGraph<N, E> shared{Graph{g}};
+  run("shared_copy", [&] { return shared; });
+  run("shared_first_write", [&] {
+    auto copy = shared;
+    copy.InsertNode(static_cast<N>(-1));
+    return copy;
+  });
+
+  reporter.Print(std::cout);
+}
@@ -0,0 +1,58 @@
+#ifndef ASSIGNMENTS_DG_CODEC_H_
+#define ASSIGNMENTS_DG_CODEC_H_
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace gdwg {
+
+// Codec<T> converts node and weight values to and from bytes for the binary file formats.
+// Trivially copyable types are copied byte for byte and std::string is length prefixed.
+// Specialize it to store any other type, e.g.
+//
+//   template <> struct gdwg::Codec<MyType> {
+//     static void Write(std::string& out, const MyType& val);
+//     static MyType Read(const char*& in, const char* end);
+//   };
+template <typename T, typename Enable = void>
+struct Codec;
+
+template <typename T>
+struct Codec<T, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+  static void Write(std::string& out, const T& val) {
+    out.append(reinterpret_cast<const char*>(&val), sizeof(T));
+  }
+  static T Read(const char*& in, const char* end) {
+    if (static_cast<std::size_t>(end - in) < sizeof(T)) {
+      throw std::runtime_error("Cannot decode a value past the end of the buffer");
+    }
+    T val;
+    std::memcpy(&val, in, sizeof(T));
+    in += sizeof(T);
+    return val;
+  }
+};
+
+template <>
+struct Codec<std::string> {
+  static void Write(std::string& out, const std::string& val) {
+    Codec<std::uint64_t>::Write(out, val.size());
+    out.append(val);
+  }
+  static std::string Read(const char*& in, const char* end) {
+    const auto size = Codec<std::uint64_t>::Read(in, end);
+    if (static_cast<std::uint64_t>(end - in) < size) {
+      throw std::runtime_error("Cannot decode a value past the end of the buffer");
+    }
+    std::string val{in, static_cast<std::size_t>(size)};
+    in += size;
+    return val;
+  }
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_CODEC_H_
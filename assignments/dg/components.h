@@ -0,0 +1,52 @@
+#ifndef ASSIGNMENTS_DG_COMPONENTS_H_
+#define ASSIGNMENTS_DG_COMPONENTS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/parallel.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+enum class ComponentsAlgorithm {
+  // every edge is a union, run over balanced ranges of edges on every worker
+  kUnionFind,
+  // Afforest (Sutton, Ben-Nun and Barak): a union of each node's first two edges finds most of
+  // the giant component cheaply, after which edges that start and end in it are only looked up
+  kAfforest,
+};
+
+struct Components {
+  // component of every node by its position in node order (the snapshot's NodeId), numbered
+  // from 0 in order of each component's first node
+  std::vector<std::uint32_t> component;
+  // number of nodes in each component
+  std::vector<std::size_t> sizes;
+};
+
+// The weakly connected components of a graph: nodes joined by edges in either direction. A
+// lock-free union-find does the work: each node starts as its own root, a union hooks the
+// larger of two roots under the smaller with a compare and swap (retrying if another worker
+// got there first), and finds halve the paths they walk, also by compare and swap. Roots are
+// so always the first node of their component, which makes the numbering deterministic
+// whatever the threads or algorithm.
+template <typename N, typename E>
+Components WeaklyConnectedComponents(const Snapshot<N, E>& snapshot,
+                                     ComponentsAlgorithm algorithm = ComponentsAlgorithm::kAfforest,
+                                     std::size_t threads = DefaultThreads());
+
+template <typename N, typename E>
+Components WeaklyConnectedComponents(const Graph<N, E>& g,
+                                     ComponentsAlgorithm algorithm = ComponentsAlgorithm::kAfforest,
+                                     std::size_t threads = DefaultThreads()) {
+  return WeaklyConnectedComponents(Snapshot<N, E>{g}, algorithm, threads);
+}
+
+}  // namespace gdwg
+
+#include "assignments/dg/components.tpp"
+
+#endif  // ASSIGNMENTS_DG_COMPONENTS_H_
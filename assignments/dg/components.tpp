@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <unordered_map>
+
+namespace gdwg {
+
+namespace detail {
+
+// a union-find that any number of workers can use at once; see WeaklyConnectedComponents
+class ConcurrentUnionFind {
+ public:
+  using NodeId = std::uint32_t;
+
+  explicit ConcurrentUnionFind(std::size_t n) : parent_(n) {
+    for (std::size_t v = 0; v < n; ++v) {
+      parent_[v].store(static_cast<NodeId>(v), std::memory_order_relaxed);
+    }
+  }
+
+  NodeId Find(NodeId v) noexcept {
+    NodeId parent = Parent(v);
+    while (parent != v) {
+      // halving: point v at its grandparent. Losing the race to another worker is harmless,
+      // since either way v still leads to the same root.
+      NodeId grandparent = Parent(parent);
+      parent_[v].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+      v = grandparent;
+      parent = Parent(v);
+    }
+    return v;
+  }
+
+  void Union(NodeId u, NodeId v) noexcept {
+    for (;;) {
+      u = Find(u);
+      v = Find(v);
+      if (u == v) {
+        return;
+      }
+      if (u < v) {
+        std::swap(u, v);
+      }
+      // u is the larger root; if it is still a root, hook it under v, else look again
+      NodeId expected = u;
+      if (parent_[u].compare_exchange_strong(expected, v, std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  NodeId Parent(NodeId v) const noexcept { return parent_[v].load(std::memory_order_relaxed); }
+
+ private:
+  std::vector<std::atomic<NodeId>> parent_;
+};
+
+}  // namespace detail
+
+template <typename N, typename E>
+Components WeaklyConnectedComponents(const Snapshot<N, E>& snapshot,
+                                     ComponentsAlgorithm algorithm,
+                                     std::size_t threads) {
+  using NodeId = typename Snapshot<N, E>::NodeId;
+  using EdgeId = typename Snapshot<N, E>::EdgeId;
+  const std::size_t n = snapshot.NumNodes();
+  threads = std::max<std::size_t>(threads, 1);
+  detail::ConcurrentUnionFind sets{n};
+  // a few ranges per worker, as ParallelFor hands them out round robin
+  const auto bounds = detail::EdgeBalancedRanges(snapshot.Offsets(), n, threads * 4);
+  // calls fn(v) for every node, over the ranges in parallel
+  auto for_each_node = [&](auto fn) {
+    ParallelFor(bounds.size() - 1,
+                [&](std::size_t i) {
+                  for (NodeId v = bounds[i]; v != bounds[i + 1]; ++v) {
+                    fn(v);
+                  }
+                },
+                threads);
+  };
+
+  // edges of each node from this index on are still to be joined
+  EdgeId skip = 0;
+  NodeId giant = 0;
+  bool sampled = false;
+  if (algorithm == ComponentsAlgorithm::kAfforest && n != 0) {
+    constexpr EdgeId kNeighbourRounds = 2;
+    constexpr std::size_t kSamples = 1024;
+    for (EdgeId round = 0; round < kNeighbourRounds; ++round) {
+      for_each_node([&](NodeId v) {
+        if (round < snapshot.Degree(v)) {
+          sets.Union(v, snapshot.Dst(snapshot.EdgeBegin(v) + round));
+        }
+      });
+    }
+    skip = kNeighbourRounds;
+    // the most common root among a sample of nodes is very likely the giant component's
+    std::mt19937 rng{1};
+    std::uniform_int_distribution<NodeId> node(0, static_cast<NodeId>(n - 1));
+    std::unordered_map<NodeId, std::size_t> counts;
+    std::size_t best = 0;
+    for (std::size_t i = 0; i < kSamples; ++i) {
+      const NodeId root = sets.Find(node(rng));
+      if (++counts[root] > best) {
+        best = counts[root];
+        giant = root;
+      }
+    }
+    sampled = true;
+  }
+  for_each_node([&](NodeId v) {
+    const EdgeId end = snapshot.EdgeEnd(v);
+    EdgeId e = snapshot.EdgeBegin(v) + std::min<EdgeId>(skip, snapshot.Degree(v));
+    if (sampled && sets.Find(v) == giant) {
+      // only edges leaving the giant component need a union. A snapshot has no in edges, so
+      // unlike Afforest on a symmetric graph these can't be skipped outright.
+      for (; e != end; ++e) {
+        if (sets.Find(snapshot.Dst(e)) != giant) {
+          sets.Union(v, snapshot.Dst(e));
+        }
+      }
+      return;
+    }
+    for (; e != end; ++e) {
+      sets.Union(v, snapshot.Dst(e));
+    }
+  });
+
+  // every root is the first node of its component, so a single pass in node order numbers
+  // each component before any of its other nodes looks it up
+  Components result;
+  result.component.resize(n);
+  for (NodeId v = 0; v < n; ++v) {
+    const NodeId root = sets.Find(v);
+    if (root == v) {
+      result.component[v] = static_cast<std::uint32_t>(result.sizes.size());
+      result.sizes.push_back(0);
+    } else {
+      result.component[v] = result.component[root];
+    }
+    ++result.sizes[result.component[v]];
+  }
+  return result;
+}
+
+}  // namespace gdwg
@@ -0,0 +1,57 @@
+// WeaklyConnectedComponents on an R-MAT graph, which has one giant component and many small
+// ones, by plain union-find and by Afforest on 1, 2, 4, ... threads up to --threads. Reports
+// the time, edges per second, speedup over one thread of the same algorithm, and the number
+// and largest size of the components found. Prints JSON to stdout.
+//
+//   components_benchmark [--scale=20] [--degree=16] [--threads=<cores>]
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/components.h"
+#include "assignments/dg/generators.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = float;
+  const auto scale = static_cast<unsigned>(bm::Arg(argc, argv, "scale", 20));
+  const auto degree = bm::Arg(argc, argv, "degree", 16);
+  const auto max_threads = bm::Arg(argc, argv, "threads", gdwg::DefaultThreads());
+
+  const auto snapshot =
+      gdwg::Rmat<N, E>(scale, (std::size_t{1} << scale) * degree, gdwg::ConstantWeights<E>(1))
+          .BuildSnapshot();
+  const double m = snapshot.NumEdges();
+  std::vector<std::size_t> thread_counts;
+  for (std::size_t t = 1; t < max_threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  bm::Reporter reporter;
+  for (const auto& [name, algorithm] :
+       {std::pair{"union_find", gdwg::ComponentsAlgorithm::kUnionFind},
+        std::pair{"afforest", gdwg::ComponentsAlgorithm::kAfforest}}) {
+    double one_thread = 0;
+    for (std::size_t threads : thread_counts) {
+      gdwg::Components result;
+      const double seconds = bm::Measure(
+          [&] { result = gdwg::WeaklyConnectedComponents(snapshot, algorithm, threads); });
+      one_thread = threads == 1 ? seconds : one_thread;
+      bm::Fields params;
+      params.emplace_back("nodes", snapshot.NumNodes());
+      params.emplace_back("edges", m);
+      params.emplace_back("threads", threads);
+      reporter.Add(name, params,
+                   {{"seconds", seconds},
+                    {"edges_per_second", m / seconds},
+                    {"speedup", one_thread / seconds},
+                    {"components", result.sizes.size()},
+                    {"largest", *std::max_element(result.sizes.begin(), result.sizes.end())}});
+    }
+  }
+  reporter.Print(std::cout);
+}
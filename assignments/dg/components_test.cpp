@@ -0,0 +1,100 @@
+/*
+  Tests for WeaklyConnectedComponents. Both algorithms, on one and on several threads, are
+  checked against a breadth first search that follows edges both ways, on random graphs sparse
+  enough to leave many components and dense enough to leave one giant one.
+*/
+
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/components.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+constexpr gdwg::ComponentsAlgorithm kAlgorithms[] = {gdwg::ComponentsAlgorithm::kUnionFind,
+                                                     gdwg::ComponentsAlgorithm::kAfforest};
+
+// components by breadth first search over edges in both directions, numbered as documented
+gdwg::Components Reference(const gdwg::Snapshot<int, int>& snapshot) {
+  const std::size_t n = snapshot.NumNodes();
+  std::vector<std::vector<std::uint32_t>> neighbours(n);
+  for (std::uint32_t v = 0; v < n; ++v) {
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      neighbours[v].push_back(snapshot.Dst(e));
+      neighbours[snapshot.Dst(e)].push_back(v);
+    }
+  }
+  constexpr auto kUnseen = ~std::uint32_t{0};
+  gdwg::Components result{std::vector<std::uint32_t>(n, kUnseen), {}};
+  for (std::uint32_t start = 0; start < n; ++start) {
+    if (result.component[start] != kUnseen) {
+      continue;
+    }
+    const auto id = static_cast<std::uint32_t>(result.sizes.size());
+    result.sizes.push_back(0);
+    std::queue<std::uint32_t> queue;
+    queue.push(start);
+    result.component[start] = id;
+    while (!queue.empty()) {
+      const auto v = queue.front();
+      queue.pop();
+      ++result.sizes[id];
+      for (auto w : neighbours[v]) {
+        if (result.component[w] == kUnseen) {
+          result.component[w] = id;
+          queue.push(w);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+SCENARIO("Components match a breadth first search both ways") {
+  for (int edges : {0, 500, 1500, 4000}) {
+    GIVEN("a random graph with 3000 nodes and " + std::to_string(edges) + " edges") {
+      const auto snapshot =
+          gdwg::testing::RandomSnapshot(3000, edges, static_cast<unsigned>(edges) + 5, 1, 1);
+      const auto expected = Reference(snapshot);
+      THEN("each algorithm gives the same numbering and sizes on 1, 3 and 8 threads") {
+        for (auto algorithm : kAlgorithms) {
+          for (std::size_t threads : {1, 3, 8}) {
+            const auto result = gdwg::WeaklyConnectedComponents(snapshot, algorithm, threads);
+            REQUIRE(result.component == expected.component);
+            REQUIRE(result.sizes == expected.sizes);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Components of a small graph") {
+  GIVEN("two islands linked one way, a separate pair, and a node on its own") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e", "f"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("c", "b", 1);
+    g.InsertEdge("e", "d", 1);
+    g.InsertEdge("f", "f", 1);
+    THEN("edges join their ends whichever way they point") {
+      for (auto algorithm : kAlgorithms) {
+        const auto result = gdwg::WeaklyConnectedComponents(g, algorithm, 2);
+        REQUIRE(result.component == std::vector<std::uint32_t>{0, 0, 0, 1, 1, 2});
+        REQUIRE(result.sizes == std::vector<std::size_t>{3, 2, 1});
+      }
+    }
+  }
+  GIVEN("an empty graph") {
+    THEN("there are no components") {
+      const auto result = gdwg::WeaklyConnectedComponents(gdwg::Graph<int, int>{});
+      REQUIRE(result.component.empty());
+      REQUIRE(result.sizes.empty());
+    }
+  }
+}
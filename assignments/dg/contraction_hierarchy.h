@@ -0,0 +1,108 @@
+#ifndef ASSIGNMENTS_DG_CONTRACTION_HIERARCHY_H_
+#define ASSIGNMENTS_DG_CONTRACTION_HIERARCHY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/parallel.h"
+#include "assignments/dg/path.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+struct ContractionOptions {
+  std::size_t threads = DefaultThreads();
+  // a witness search gives up (and the shortcut is added) after settling this many nodes
+  std::size_t witness_settle_limit = 500;
+  // the witness searches that estimate a node's priority only look for witnesses of up to this
+  // many edges, and of one edge around nodes with more than dense_degree in neighbours, whose
+  // searches cost the most. Priorities are recomputed for every neighbour of every contracted
+  // node, so these searches are most of the work, and cutting them short costs a few more
+  // shortcuts. Contraction itself searches without a limit on edges.
+  std::size_t priority_hop_limit = 3;
+  std::size_t dense_degree = 12;
+};
+
+// A contraction hierarchy (Geisberger et al.) for fast point to point shortest paths on road
+// network like graphs.
+//
+// Preprocessing removes ("contracts") the nodes one at a time, least important first. Removing
+// v adds a shortcut u -> w of weight d(u, v) + d(v, w) for each pair of its neighbours unless a
+// witness search, a Dijkstra from u that avoids v, finds a path that is no longer. The nodes'
+// order of importance is their edge difference (shortcuts added minus edges removed) plus the
+// number of neighbours already contracted, which spreads contraction evenly over the graph.
+// The shortcuts counted for a priority come from witness searches cut short (see
+// ContractionOptions::priority_hop_limit), so the order is cheap to keep up to date.
+//
+// Contraction goes in rounds. Each round takes every node whose priority is lower than all of
+// its neighbours'; no two of them are adjacent, so their witness searches run in parallel over
+// the graph without any of them, and their shortcuts are then added together.
+//
+// A query searches up the hierarchy from both ends at once, only ever following edges to nodes
+// contracted later, and meets at the highest node of the shortest path. Shortcuts remember the
+// node they bypass, so ShortestPath unpacks them back into edges of the graph.
+//
+// Weights must be non-negative and arithmetic; parallel edges and self loops are dropped, as
+// they are never on a shortest path.
+template <typename N, typename E>
+class ContractionHierarchy {
+  static_assert(std::is_arithmetic<E>::value, "ContractionHierarchy needs arithmetic weights");
+
+ public:
+  using NodeId = std::uint32_t;
+
+  explicit ContractionHierarchy(const Snapshot<N, E>& snapshot, ContractionOptions options = {});
+  explicit ContractionHierarchy(const Graph<N, E>& g, ContractionOptions options = {})
+    : ContractionHierarchy(Snapshot<N, E>{g}, options) {}
+
+  std::size_t NumNodes() const noexcept { return nodes_.size(); }
+  // shortcut edges added by contraction
+  std::size_t NumShortcuts() const noexcept { return shortcuts_; }
+  // edges of the upward and downward search graphs, shortcuts included
+  std::size_t NumArcs() const noexcept { return up_.size() + down_.size(); }
+  std::size_t Rounds() const noexcept { return rounds_; }
+  bool IsNode(const N& val) const;
+  NodeId Id(const N& val) const;
+
+  // length of a shortest path from src to dst, or nullopt if there is none
+  std::optional<E> Distance(const N& src, const N& dst) const;
+  // a shortest path from src to dst with its shortcuts unpacked, or nullopt if there is none
+  std::optional<Path<N, E>> ShortestPath(const N& src, const N& dst) const;
+
+ private:
+  static constexpr NodeId kNone = ~NodeId{0};
+
+  // an edge of the search graphs; middle is the node a shortcut bypasses, or kNone
+  struct Arc {
+    NodeId node;
+    NodeId middle;
+    E weight;
+  };
+
+  // the bidirectional upward search; appends the unpacked path to path if it isn't null
+  std::optional<E> Query(NodeId src, NodeId dst, std::vector<N>* path) const;
+  // the arc a -> b of the hierarchy, which must exist
+  const Arc& FindArc(NodeId a, NodeId b) const;
+  void Unpack(NodeId a, NodeId b, NodeId middle, std::vector<N>& out) const;
+
+  std::vector<N> nodes_;
+  // position of each node in the contraction order
+  std::vector<NodeId> rank_;
+  // up_ holds, for each node, its arcs to nodes contracted later; down_ the arcs from them
+  std::vector<std::uint64_t> up_offsets_;
+  std::vector<Arc> up_;
+  std::vector<std::uint64_t> down_offsets_;
+  std::vector<Arc> down_;
+  std::size_t shortcuts_ = 0;
+  std::size_t rounds_ = 0;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/contraction_hierarchy.tpp"
+
+#endif  // ASSIGNMENTS_DG_CONTRACTION_HIERARCHY_H_
@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+template <typename N, typename E>
+ContractionHierarchy<N, E>::ContractionHierarchy(const Snapshot<N, E>& snapshot,
+                                                 ContractionOptions options)
+  : nodes_(snapshot.Nodes(), snapshot.Nodes() + snapshot.NumNodes()),
+    rank_(snapshot.NumNodes()) {
+  constexpr E kInfinity = std::numeric_limits<E>::max();
+  const std::size_t n = nodes_.size();
+  const std::size_t threads = std::max<std::size_t>(1, options.threads);
+
+  // the graph that is left: one arc per pair of nodes not yet contracted, in both directions.
+  // A snapshot's edges are sorted by (dst, weight), so a pair's first edge is its lightest.
+  std::vector<std::vector<Arc>> out(n);
+  std::vector<std::vector<Arc>> in(n);
+  for (NodeId src = 0; src < n; ++src) {
+    for (auto e = snapshot.EdgeBegin(src); e != snapshot.EdgeEnd(src); ++e) {
+      const NodeId dst = snapshot.Dst(e);
+      const E w = snapshot.Weight(e);
+      if (w < E{}) {
+        throw std::invalid_argument(
+            "Cannot create a ContractionHierarchy of a graph with negative weights");
+      }
+      if (dst != src && (out[src].empty() || out[src].back().node != dst)) {
+        out[src].push_back({dst, kNone, w});
+        in[dst].push_back({src, kNone, w});
+      }
+    }
+  }
+
+  struct Shortcut {
+    NodeId from;
+    NodeId to;
+    E weight;
+  };
+  using Item = std::pair<E, NodeId>;
+  struct Workspace {
+    std::vector<E> dist;
+    // out neighbours of the node being contracted
+    std::vector<char> target;
+    // edges on the path the search found to each node
+    std::vector<std::uint32_t> hops;
+    std::vector<NodeId> touched;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  };
+  std::vector<Workspace> workspaces(threads);
+  for (auto& ws : workspaces) {
+    ws.dist.assign(n, kInfinity);
+    ws.target.assign(n, 0);
+    ws.hops.assign(n, 0);
+  }
+  // nodes of the current round. Contracting them one after another in order of id would give
+  // the same hierarchy, so a witness search for v avoids those before it, which would be gone,
+  // but may go through those after it. Shortcuts the ones before it would have added aren't
+  // there yet, so some witnesses are missed, which only costs shortcuts that aren't needed.
+  std::vector<char> contracting(n);
+
+  // the shortcuts that contracting v needs, counted and optionally collected. Witnesses of more
+  // than hop_limit edges aren't looked for, so more shortcuts may be counted than are needed.
+  auto find_shortcuts = [&](NodeId v, Workspace& ws, std::vector<Shortcut>* found,
+                            std::size_t hop_limit) {
+    std::size_t count = 0;
+    for (const Arc& second : out[v]) {
+      ws.target[second.node] = 1;
+    }
+    for (const Arc& first : in[v]) {
+      const NodeId u = first.node;
+      E limit{};
+      bool any = false;
+      for (const Arc& second : out[v]) {
+        if (second.node != u) {
+          limit = std::max(limit, first.weight + second.weight);
+          any = true;
+        }
+      }
+      if (!any) {
+        continue;
+      }
+      // Dijkstra from u without v, until every target is settled or it's past the longest path
+      // through v
+      std::size_t targets = out[v].size() - ws.target[u];
+      ws.dist[u] = E{};
+      ws.hops[u] = 0;
+      ws.touched.push_back(u);
+      ws.queue.emplace(E{}, u);
+      std::size_t settled = 0;
+      while (!ws.queue.empty() && targets > 0) {
+        const auto [d, x] = ws.queue.top();
+        ws.queue.pop();
+        if (d > ws.dist[x]) {
+          continue;
+        }
+        if (d > limit || ++settled > options.witness_settle_limit) {
+          break;
+        }
+        targets -= x != u && ws.target[x];
+        if (ws.hops[x] >= hop_limit) {
+          continue;
+        }
+        for (const Arc& arc : out[x]) {
+          if (arc.node == v || (contracting[arc.node] && arc.node < v)) {
+            continue;
+          }
+          const E next = d + arc.weight;
+          if (next < ws.dist[arc.node]) {
+            if (ws.dist[arc.node] == kInfinity) {
+              ws.touched.push_back(arc.node);
+            }
+            ws.dist[arc.node] = next;
+            ws.hops[arc.node] = ws.hops[x] + 1;
+            ws.queue.emplace(next, arc.node);
+          }
+        }
+      }
+      ws.queue = {};
+      // without a witness, a search that gave up early means a shortcut that may not be needed
+      for (const Arc& second : out[v]) {
+        if (second.node != u && ws.dist[second.node] > first.weight + second.weight) {
+          ++count;
+          if (found != nullptr) {
+            found->push_back({u, second.node, first.weight + second.weight});
+          }
+        }
+      }
+      for (NodeId x : ws.touched) {
+        ws.dist[x] = kInfinity;
+      }
+      ws.touched.clear();
+    }
+    for (const Arc& second : out[v]) {
+      ws.target[second.node] = 0;
+    }
+    return count;
+  };
+
+  std::vector<std::int64_t> priority(n);
+  std::vector<std::int64_t> contracted_neighbours(n);
+  std::vector<std::int64_t> depth(n);
+  auto update_priorities = [&](const std::vector<NodeId>& nodes) {
+    ParallelFor(threads,
+                [&](std::size_t t) {
+                  for (std::size_t i = t; i < nodes.size(); i += threads) {
+                    const NodeId v = nodes[i];
+                    const std::size_t hop_limit =
+                        in[v].size() > options.dense_degree
+                            ? std::min<std::size_t>(options.priority_hop_limit, 1)
+                            : options.priority_hop_limit;
+                    const auto shortcuts = static_cast<std::int64_t>(
+                        find_shortcuts(v, workspaces[t], nullptr, hop_limit));
+                    priority[v] = 2 * (shortcuts - static_cast<std::int64_t>(in[v].size()) -
+                                       static_cast<std::int64_t>(out[v].size())) +
+                                  contracted_neighbours[v] + depth[v];
+                  }
+                },
+                threads);
+  };
+  auto lower = [&](NodeId a, NodeId b) {
+    return priority[a] < priority[b] || (priority[a] == priority[b] && a < b);
+  };
+  // arcs are in no particular order, so one is erased by moving the last into its place
+  auto erase_arc = [](std::vector<Arc>& arcs, NodeId node) {
+    *std::find_if(arcs.begin(), arcs.end(), [node](const Arc& a) { return a.node == node; }) =
+        arcs.back();
+    arcs.pop_back();
+  };
+  // position + 1 in out[u] of each of u's out neighbours, while u's shortcuts are added
+  std::vector<std::size_t> position(n);
+  // adds shortcuts that all start at one node u, or lowers the arcs already there, finding
+  // each by position rather than searching u's arcs, which are long in a dense core
+  auto add_arcs = [&](const Shortcut* first, const Shortcut* last, NodeId middle) {
+    const NodeId u = first->from;
+    for (std::size_t i = 0; i < out[u].size(); ++i) {
+      position[out[u][i].node] = i + 1;
+    }
+    for (const Shortcut* s = first; s != last; ++s) {
+      if (position[s->to] == 0) {
+        position[s->to] = out[u].size() + 1;
+        out[u].push_back({s->to, middle, s->weight});
+        in[s->to].push_back({u, middle, s->weight});
+      } else if (Arc& arc = out[u][position[s->to] - 1]; s->weight < arc.weight) {
+        arc = {s->to, middle, s->weight};
+        *std::find_if(in[s->to].begin(), in[s->to].end(), [&](const Arc& a) {
+          return a.node == u;
+        }) = {u, middle, s->weight};
+      }
+    }
+    for (const Arc& arc : out[u]) {
+      position[arc.node] = 0;
+    }
+  };
+
+  std::vector<std::vector<Arc>> up(n);
+  std::vector<std::vector<Arc>> down(n);
+  std::vector<char> done(n);
+  std::vector<NodeId> remaining(n);
+  std::iota(remaining.begin(), remaining.end(), NodeId{0});
+  update_priorities(remaining);
+  NodeId next_rank = 0;
+  while (!remaining.empty()) {
+    ++rounds_;
+    std::vector<NodeId> batch;
+    for (NodeId v : remaining) {
+      auto below_v = [&](const Arc& a) { return lower(a.node, v); };
+      if (std::none_of(in[v].begin(), in[v].end(), below_v) &&
+          std::none_of(out[v].begin(), out[v].end(), below_v)) {
+        batch.push_back(v);
+        contracting[v] = 1;
+      }
+    }
+    std::vector<std::vector<Shortcut>> found(batch.size());
+    ParallelFor(threads,
+                [&](std::size_t t) {
+                  for (std::size_t i = t; i < batch.size(); i += threads) {
+                    find_shortcuts(batch[i], workspaces[t], &found[i],
+                                   std::numeric_limits<std::size_t>::max());
+                  }
+                },
+                threads);
+
+    std::vector<NodeId> neighbours;
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      const NodeId v = batch[i];
+      rank_[v] = next_rank++;
+      done[v] = 1;
+      for (const Arc& a : in[v]) {
+        erase_arc(out[a.node], v);
+        ++contracted_neighbours[a.node];
+        depth[a.node] = std::max(depth[a.node], depth[v] + 1);
+        neighbours.push_back(a.node);
+      }
+      for (const Arc& a : out[v]) {
+        erase_arc(in[a.node], v);
+        ++contracted_neighbours[a.node];
+        depth[a.node] = std::max(depth[a.node], depth[v] + 1);
+        neighbours.push_back(a.node);
+      }
+      // what is left around v is contracted later, so these are v's arcs up the hierarchy
+      up[v] = std::move(out[v]);
+      down[v] = std::move(in[v]);
+      const Shortcut* shortcuts = found[i].data();
+      for (std::size_t j = 0, k = 0; j < found[i].size(); j = k) {
+        while (k < found[i].size() && shortcuts[k].from == shortcuts[j].from) {
+          ++k;
+        }
+        add_arcs(shortcuts + j, shortcuts + k, v);
+      }
+      contracting[v] = 0;
+    }
+    remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                   [&](NodeId v) { return done[v] != 0; }),
+                    remaining.end());
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    update_priorities(neighbours);
+  }
+
+  auto flatten = [&](std::vector<std::vector<Arc>>& lists, std::vector<std::uint64_t>& offsets,
+                     std::vector<Arc>& arcs) {
+    offsets.reserve(n + 1);
+    offsets.push_back(0);
+    for (auto& list : lists) {
+      for (const Arc& a : list) {
+        arcs.push_back(a);
+        shortcuts_ += a.middle != kNone;
+      }
+      offsets.push_back(arcs.size());
+      std::vector<Arc>{}.swap(list);
+    }
+  };
+  flatten(up, up_offsets_, up_);
+  flatten(down, down_offsets_, down_);
+}
+
+template <typename N, typename E>
+bool ContractionHierarchy<N, E>::IsNode(const N& val) const {
+  return std::binary_search(nodes_.begin(), nodes_.end(), val);
+}
+
+template <typename N, typename E>
+typename ContractionHierarchy<N, E>::NodeId ContractionHierarchy<N, E>::Id(const N& val) const {
+  const auto it = std::lower_bound(nodes_.begin(), nodes_.end(), val);
+  if (it == nodes_.end() || val < *it) {
+    throw std::out_of_range("Cannot call ContractionHierarchy::Id on a node that doesn't exist");
+  }
+  return static_cast<NodeId>(it - nodes_.begin());
+}
+
+template <typename N, typename E>
+std::optional<E> ContractionHierarchy<N, E>::Distance(const N& src, const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::out_of_range(
+        "Cannot call ContractionHierarchy::Distance if src or dst node don't exist in the graph");
+  }
+  return Query(Id(src), Id(dst), nullptr);
+}
+
+template <typename N, typename E>
+std::optional<Path<N, E>> ContractionHierarchy<N, E>::ShortestPath(const N& src,
+                                                                   const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::out_of_range("Cannot call ContractionHierarchy::ShortestPath if src or dst node "
+                            "don't exist in the graph");
+  }
+  Path<N, E> path;
+  const auto weight = Query(Id(src), Id(dst), &path.nodes);
+  if (!weight) {
+    return std::nullopt;
+  }
+  path.weight = *weight;
+  return path;
+}
+
+template <typename N, typename E>
+std::optional<E> ContractionHierarchy<N, E>::Query(NodeId src,
+                                                   NodeId dst,
+                                                   std::vector<N>* path) const {
+  constexpr E kInfinity = std::numeric_limits<E>::max();
+  struct Label {
+    E dist = kInfinity;
+    NodeId parent = kNone;
+    NodeId middle = kNone;
+  };
+  using Item = std::pair<E, NodeId>;
+  // per thread and reused, so a query costs what it touches; it is left clean after each one
+  struct Workspace {
+    std::vector<Label> labels[2];
+    std::vector<NodeId> touched;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queues[2];
+  };
+  static thread_local Workspace ws;
+  for (auto& labels : ws.labels) {
+    if (labels.size() < nodes_.size()) {
+      labels.resize(nodes_.size());
+    }
+  }
+
+  // side 0 searches forwards from src over up_, side 1 backwards from dst over down_
+  const std::vector<std::uint64_t>* offsets[2] = {&up_offsets_, &down_offsets_};
+  const std::vector<Arc>* arcs[2] = {&up_, &down_};
+  ws.labels[0][src] = {E{}, kNone, kNone};
+  ws.labels[1][dst] = {E{}, kNone, kNone};
+  ws.touched.push_back(src);
+  ws.touched.push_back(dst);
+  ws.queues[0].emplace(E{}, src);
+  ws.queues[1].emplace(E{}, dst);
+  std::optional<E> best;
+  NodeId meet = kNone;
+  for (int side = 0; !ws.queues[0].empty() || !ws.queues[1].empty(); side ^= 1) {
+    auto& queue = ws.queues[side];
+    auto& labels = ws.labels[side];
+    if (queue.empty()) {
+      continue;
+    }
+    const auto [d, v] = queue.top();
+    queue.pop();
+    if (best && d >= *best) {
+      queue = {};  // nothing further up this side can be shorter
+      continue;
+    }
+    if (d > labels[v].dist) {
+      continue;
+    }
+    const E other = ws.labels[side ^ 1][v].dist;
+    if (other != kInfinity && (!best || d + other < *best)) {
+      best = d + other;
+      meet = v;
+    }
+    // stall on demand: if a node higher up reaches v by a shorter way than this search did,
+    // v can't be on a shortest path, so its arcs aren't followed
+    const auto& back_offsets = *offsets[side ^ 1];
+    const auto& back_arcs = *arcs[side ^ 1];
+    bool stalled = false;
+    for (auto i = back_offsets[v]; i != back_offsets[v + 1] && !stalled; ++i) {
+      const E via = labels[back_arcs[i].node].dist;
+      stalled = via != kInfinity && via + back_arcs[i].weight < d;
+    }
+    if (stalled) {
+      continue;
+    }
+    for (auto i = (*offsets[side])[v]; i != (*offsets[side])[v + 1]; ++i) {
+      const Arc& arc = (*arcs[side])[i];
+      const E next = d + arc.weight;
+      Label& label = labels[arc.node];
+      if (next < label.dist) {
+        if (ws.labels[0][arc.node].dist == kInfinity &&
+            ws.labels[1][arc.node].dist == kInfinity) {
+          ws.touched.push_back(arc.node);
+        }
+        label = {next, v, arc.middle};
+        queue.emplace(next, arc.node);
+      }
+    }
+  }
+
+  if (best && path != nullptr) {
+    // src up to meet, whose parents run backwards, then meet down to dst
+    std::vector<NodeId> climb;
+    for (NodeId v = meet; v != src; v = ws.labels[0][v].parent) {
+      climb.push_back(v);
+    }
+    path->push_back(nodes_[src]);
+    for (auto it = climb.rbegin(); it != climb.rend(); ++it) {
+      const Label& label = ws.labels[0][*it];
+      Unpack(label.parent, *it, label.middle, *path);
+    }
+    for (NodeId v = meet; v != dst; v = ws.labels[1][v].parent) {
+      Unpack(v, ws.labels[1][v].parent, ws.labels[1][v].middle, *path);
+    }
+  }
+  for (NodeId v : ws.touched) {
+    ws.labels[0][v] = {};
+    ws.labels[1][v] = {};
+  }
+  ws.touched.clear();
+  return best;
+}
+
+template <typename N, typename E>
+const typename ContractionHierarchy<N, E>::Arc& ContractionHierarchy<N, E>::FindArc(
+    NodeId a,
+    NodeId b) const {
+  // the arc was stored when the lower of its two ends was contracted
+  if (rank_[a] < rank_[b]) {
+    return *std::find_if(up_.begin() + static_cast<std::ptrdiff_t>(up_offsets_[a]),
+                         up_.begin() + static_cast<std::ptrdiff_t>(up_offsets_[a + 1]),
+                         [b](const Arc& arc) { return arc.node == b; });
+  }
+  return *std::find_if(down_.begin() + static_cast<std::ptrdiff_t>(down_offsets_[b]),
+                       down_.begin() + static_cast<std::ptrdiff_t>(down_offsets_[b + 1]),
+                       [a](const Arc& arc) { return arc.node == a; });
+}
+
+template <typename N, typename E>
+void ContractionHierarchy<N, E>::Unpack(NodeId a,
+                                        NodeId b,
+                                        NodeId middle,
+                                        std::vector<N>& out) const {
+  if (middle == kNone) {
+    out.push_back(nodes_[b]);
+    return;
+  }
+  Unpack(a, middle, FindArc(a, middle).middle, out);
+  Unpack(middle, b, FindArc(middle, b).middle, out);
+}
+
+}  // namespace gdwg
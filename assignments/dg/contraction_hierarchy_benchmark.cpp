@@ -0,0 +1,178 @@
+// ContractionHierarchy on road network like graphs: a grid with random weights, a planar
+// graph (a jittered grid with one random diagonal per cell, weighted by Euclidean length), and
+// roads, the planar graph with a hierarchy of faster roads along every 4th row and column,
+// faster again along every 16th and so on, at sides from half --side up to four times it.
+// Reports preprocessing time on one and on all threads, per node too, shortcuts added, and
+// query latency for distances and unpacked paths against a Dijkstra that stops at dst. Prints
+// JSON to stdout.
+//
+// Roads preprocess in close to linear time, as real ones do. Grids and planar graphs have no
+// such hierarchy: whatever the order, the last nodes contracted form a dense core, around a
+// separator of about the square root of the nodes, so they take longer per node as they grow.
+//
+//   contraction_hierarchy_benchmark [--side=80] [--queries=2000] [--threads=<cores>]
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/contraction_hierarchy.h"
+#include "assignments/dg/generators.h"
+
+namespace {
+
+using N = std::uint64_t;
+using E = double;
+namespace bm = gdwg::benchmark;
+
+// the planar graph, with roads at the speed of their row or column if highways is set
+gdwg::Snapshot<N, E> Planar(std::size_t side, bool highways) {
+  std::mt19937_64 rng{42};
+  std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+  std::vector<std::pair<double, double>> points(side * side);
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    points[i] = {static_cast<double>(i / side) + jitter(rng),
+                 static_cast<double>(i % side) + jitter(rng)};
+  }
+  // 1 on most rows and columns, 2 on every 4th, 4 on every 16th...
+  auto speed = [highways](std::size_t line) {
+    double s = 1;
+    for (std::size_t k = 4; highways && line % k == 0 && k <= line; k *= 4) {
+      s *= 2;
+    }
+    return s;
+  };
+  gdwg::GraphBuilder<N, E> builder;
+  auto link = [&](std::size_t a, std::size_t b, double s) {
+    const double w = std::hypot(points[a].first - points[b].first,
+                                points[a].second - points[b].second) /
+                     s;
+    builder.AddEdge(a, b, w);
+    builder.AddEdge(b, a, w);
+  };
+  std::bernoulli_distribution coin(0.5);
+  for (std::size_t v = 0; v < points.size(); ++v) {
+    builder.AddNode(v);
+    const std::size_t r = v / side;
+    const std::size_t c = v % side;
+    if (c + 1 < side) {
+      link(v, v + 1, speed(r));
+    }
+    if (r + 1 < side) {
+      link(v, v + side, speed(c));
+    }
+    if (r + 1 < side && c + 1 < side) {
+      coin(rng) ? link(v, v + side + 1, 1) : link(v + 1, v + side, 1);
+    }
+  }
+  return builder.BuildSnapshot();
+}
+
+void Run(bm::Reporter& reporter,
+         const std::string& name,
+         const gdwg::Snapshot<N, E>& snapshot,
+         std::size_t queries,
+         std::size_t threads) {
+  const bm::Fields params{{"nodes", snapshot.NumNodes()}, {"edges", snapshot.NumEdges()}};
+  for (std::size_t t : {std::size_t{1}, threads}) {
+    gdwg::ContractionOptions options;
+    options.threads = t;
+    bm::Timer timer;
+    const gdwg::ContractionHierarchy<N, E> ch{snapshot, options};
+    const double seconds = timer.Seconds();
+    reporter.Add(name + "/preprocess", params,
+                 {{"threads", t},
+                  {"seconds", seconds},
+                  {"us_per_node", 1e6 * seconds / static_cast<double>(snapshot.NumNodes())},
+                  {"shortcuts", ch.NumShortcuts()},
+                  {"rounds", ch.Rounds()}});
+    if (t != threads) {
+      continue;
+    }
+
+    std::mt19937_64 rng{7};
+    std::uniform_int_distribution<N> node(0, snapshot.NumNodes() - 1);
+    std::vector<std::pair<N, N>> pairs(queries);
+    for (auto& pair : pairs) {
+      pair = {node(rng), node(rng)};
+    }
+    double sum = 0;
+    const double distance_seconds = bm::Measure([&] {
+      for (const auto& [a, b] : pairs) {
+        sum += ch.Distance(a, b).value_or(0);
+      }
+    });
+    std::size_t hops = 0;
+    const double path_seconds = bm::Measure([&] {
+      for (const auto& [a, b] : pairs) {
+        hops += ch.ShortestPath(a, b)->nodes.size();
+      }
+    });
+    std::vector<E> dist(snapshot.NumNodes(), std::numeric_limits<E>::max());
+    std::vector<N> touched;
+    const double dijkstra_seconds = bm::Measure([&] {
+      for (const auto& [a, b] : pairs) {
+        using Item = std::pair<E, N>;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+        dist[a] = 0;
+        touched.push_back(a);
+        queue.emplace(0, a);
+        while (!queue.empty()) {
+          const auto [d, u] = queue.top();
+          queue.pop();
+          if (u == b) {
+            sum += d;
+            break;
+          }
+          if (d > dist[u]) {
+            continue;
+          }
+          for (auto e = snapshot.EdgeBegin(u); e != snapshot.EdgeEnd(u); ++e) {
+            const N v = snapshot.Dst(e);
+            if (d + snapshot.Weight(e) < dist[v]) {
+              if (dist[v] == std::numeric_limits<E>::max()) {
+                touched.push_back(v);
+              }
+              dist[v] = d + snapshot.Weight(e);
+              queue.emplace(dist[v], v);
+            }
+          }
+        }
+        for (N v : touched) {
+          dist[v] = std::numeric_limits<E>::max();
+        }
+        touched.clear();
+      }
+    });
+    bm::DoNotOptimize(sum);
+    reporter.Add(name + "/query", params,
+                 {{"distance_us", 1e6 * distance_seconds / queries},
+                  {"path_us", 1e6 * path_seconds / queries},
+                  {"dijkstra_us", 1e6 * dijkstra_seconds / queries},
+                  {"mean_path_nodes", static_cast<double>(hops) / queries}});
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto side = bm::Arg(argc, argv, "side", 80);
+  const auto queries = bm::Arg(argc, argv, "queries", 2000);
+  const auto threads = bm::Arg(argc, argv, "threads", gdwg::DefaultThreads());
+  bm::Reporter reporter;
+  Run(reporter, "grid",
+      gdwg::Grid2D<N, E>(side, side, gdwg::UniformWeights<E>(1, 10)).BuildSnapshot(), queries,
+      threads);
+  Run(reporter, "planar", Planar(side, false), queries, threads);
+  for (std::size_t s = side / 2; s <= 4 * side; s *= 2) {
+    Run(reporter, "roads", Planar(s, true), queries, threads);
+  }
+  reporter.Print(std::cout);
+}
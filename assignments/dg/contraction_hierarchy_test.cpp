@@ -0,0 +1,138 @@
+/*
+  Tests for ContractionHierarchy. Distances are checked against a Dijkstra of the graph for
+  every pair, and every unpacked path is checked to be made of real edges adding up to that
+  distance, on random graphs and on a grid, with one and with several threads and with the
+  witness searches of the order cut short.
+*/
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "assignments/dg/contraction_hierarchy.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+bool MatchesDijkstra(const gdwg::ContractionHierarchy<int, int>& ch,
+                     const gdwg::Graph<int, int>& g) {
+  for (int src : g.GetNodes()) {
+    const auto dist = gdwg::testing::Dijkstra(g, src);
+    for (int dst : g.GetNodes()) {
+      const auto it = dist.find(dst);
+      const auto distance = ch.Distance(src, dst);
+      const auto path = ch.ShortestPath(src, dst);
+      if (it == dist.end()) {
+        if (distance.has_value() || path.has_value()) {
+          return false;
+        }
+        continue;
+      }
+      if (distance != it->second || !path || path->weight != it->second ||
+          path->nodes.front() != src || path->nodes.back() != dst ||
+          gdwg::testing::Walk(g, path->nodes) != it->second) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+SCENARIO("A contraction hierarchy gives the same shortest paths as Dijkstra") {
+  for (int edges : {0, 50, 120, 300, 800}) {
+    GIVEN("a random graph with 70 nodes and " + std::to_string(edges) + " edges") {
+      const auto g =
+          gdwg::testing::RandomGraph(70, edges, static_cast<unsigned>(edges) + 1, 0, 20, 3);
+      for (std::size_t threads : {1, 4}) {
+        WHEN("it is contracted on " + std::to_string(threads) + " threads") {
+          gdwg::ContractionOptions options;
+          options.threads = threads;
+          const gdwg::ContractionHierarchy<int, int> ch{g, options};
+          THEN("every pair matches and every path is real") {
+            REQUIRE(ch.NumNodes() == 70);
+            REQUIRE(MatchesDijkstra(ch, g));
+          }
+        }
+      }
+    }
+  }
+  GIVEN("a 12 x 12 grid with edges both ways") {
+    gdwg::Graph<int, int> g;
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> weight(1, 9);
+    for (int i = 0; i < 144; ++i) {
+      g.InsertNode(i);
+    }
+    for (int r = 0; r < 12; ++r) {
+      for (int c = 0; c < 12; ++c) {
+        for (const auto& [dr, dc] : {std::pair{0, 1}, std::pair{1, 0}}) {
+          if (r + dr < 12 && c + dc < 12) {
+            const int w = weight(rng);
+            g.InsertEdge(r * 12 + c, (r + dr) * 12 + c + dc, w);
+            g.InsertEdge((r + dr) * 12 + c + dc, r * 12 + c, w);
+          }
+        }
+      }
+    }
+    WHEN("it is contracted") {
+      gdwg::ContractionOptions options;
+      options.witness_settle_limit = 5;
+      const gdwg::ContractionHierarchy<int, int> ch{g, options};
+      THEN("shortcuts were added, and even with short witness searches paths are exact") {
+        REQUIRE(ch.NumShortcuts() > 0);
+        REQUIRE(ch.Rounds() > 1);
+        REQUIRE(MatchesDijkstra(ch, g));
+      }
+    }
+    WHEN("it is ordered by priorities that look for no witnesses at all") {
+      gdwg::ContractionOptions options;
+      options.priority_hop_limit = 0;
+      const gdwg::ContractionHierarchy<int, int> ch{g, options};
+      THEN("paths are still exact, as contraction itself searches in full") {
+        REQUIRE(MatchesDijkstra(ch, g));
+      }
+    }
+  }
+}
+
+SCENARIO("Paths are unpacked into the graph's own nodes") {
+  GIVEN("a chain of strings with a heavy direct edge") {
+    gdwg::Graph<std::string, double> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("a", "d", 5);
+    g.InsertEdge("b", "b", 0);
+    const gdwg::ContractionHierarchy<std::string, double> ch{g};
+    THEN("the path goes the long way round, which is shorter") {
+      const auto path = ch.ShortestPath("a", "d");
+      REQUIRE(path);
+      REQUIRE(*path == gdwg::Path<std::string, double>{{"a", "b", "c", "d"}, 3});
+      REQUIRE(ch.ShortestPath("c", "c") == gdwg::Path<std::string, double>{{"c"}, 0});
+      REQUIRE(ch.ShortestPath("d", "a") == std::nullopt);
+    }
+  }
+}
+
+SCENARIO("Bad input to a contraction hierarchy is rejected") {
+  GIVEN("a graph with a negative weight") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, -1);
+    THEN("no hierarchy can be built") {
+      REQUIRE_THROWS_WITH((gdwg::ContractionHierarchy<int, int>{g}),
+                          "Cannot create a ContractionHierarchy of a graph with negative weights");
+    }
+  }
+  GIVEN("a hierarchy") {
+    const gdwg::ContractionHierarchy<int, int> ch{gdwg::Graph<int, int>{1, 2}};
+    THEN("queries about missing nodes throw") {
+      REQUIRE_THROWS_AS(ch.Distance(1, 3), std::out_of_range);
+      REQUIRE_THROWS_AS(ch.ShortestPath(3, 1), std::out_of_range);
+    }
+  }
+}
@@ -0,0 +1,112 @@
+#ifndef ASSIGNMENTS_DG_DENSE_GRAPH_H_
+#define ASSIGNMENTS_DG_DENSE_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/bit_rows.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// An immutable copy of a Graph as a packed bit adjacency matrix, for small dense graphs. Nodes
+// are numbered as in a Snapshot (sorted order). Row i has bit j set if there is at least one
+// edge i -> j, so IsConnected is a single bit test, and neighbour, common neighbour and
+// reachability queries are bitwise operations over whole rows (see bit_rows.h).
+//
+// Weights live in a side table in row-major order of the set bits: each row stores the number
+// of set bits before each of its words, so the weight slot of (i, j) is found in O(1). Only the
+// smallest weight of each pair lives there; the rest of a pair's parallel edges, which are rare
+// in practice, are kept in a separate sorted list.
+template <typename N, typename E>
+class DenseGraph {
+ public:
+  using NodeId = std::uint32_t;
+
+  DenseGraph() = default;
+  explicit DenseGraph(const Snapshot<N, E>& snapshot);
+  explicit DenseGraph(const Graph<N, E>& g) : DenseGraph(Snapshot<N, E>{g}) {}
+
+  std::size_t NumNodes() const noexcept { return nodes_.size(); }
+  // edges, counting parallel edges separately like Graph does
+  std::size_t NumEdges() const noexcept { return weights_.size() + extra_weights_.size(); }
+  bool IsEmpty() const noexcept { return nodes_.empty(); }
+  const N& Value(NodeId id) const noexcept { return nodes_[id]; }
+
+  // row id of the adjacency matrix, WordsPerRow() words long
+  const std::uint64_t* Row(NodeId id) const noexcept { return bits_.data() + id * words_; }
+  std::size_t WordsPerRow() const noexcept { return words_; }
+
+  // IsConnected by id
+  bool HasEdge(NodeId src, NodeId dst) const noexcept {
+    return detail::TestBit(Row(src), dst);
+  }
+  // distinct destinations of src
+  std::size_t Degree(NodeId src) const noexcept { return detail::PopCount(Row(src), words_); }
+  // nodes that both a and b have an edge to
+  std::size_t CountCommonNeighbors(NodeId a, NodeId b) const noexcept {
+    return detail::AndPopCount(Row(a), Row(b), words_);
+  }
+
+  bool IsNode(const N& val) const;
+  NodeId Id(const N& val) const;
+  std::vector<N> GetNodes() const { return nodes_; }
+  bool IsConnected(const N& src, const N& dst) const;
+  std::vector<N> GetConnected(const N& src) const;
+  std::vector<E> GetWeights(const N& src, const N& dst) const;
+  std::vector<N> GetCommonNeighbors(const N& a, const N& b) const;
+  // every node reachable from src by a path of one or more edges, in sorted order
+  std::vector<N> GetReachable(const N& src) const;
+
+  Graph<N, E> ToGraph() const;
+
+  // bytes held by the matrix, its rank directory and the weight tables
+  std::size_t MemoryUsage() const noexcept;
+  // what MemoryUsage would be for a graph of this size without parallel edges, without building
+  // it; each parallel edge adds sizeof(std::pair<std::uint64_t, E>) - sizeof(E)
+  static std::size_t EstimateBytes(std::size_t num_nodes, std::size_t num_edges) noexcept;
+
+ private:
+  const N* Find(const N& val) const;
+  // index of pair (src, dst) in weights_; the bit must be set
+  std::size_t Slot(NodeId src, NodeId dst) const noexcept {
+    return row_rank_[src] + word_rank_[src * words_ + dst / 64] +
+           detail::RankInWord(Row(src), dst);
+  }
+
+  std::vector<N> nodes_;
+  std::size_t words_ = 0;
+  std::vector<std::uint64_t> bits_;
+  // set bits in the matrix before each row, and in the row before each word
+  std::vector<std::uint64_t> row_rank_;
+  std::vector<std::uint32_t> word_rank_;
+  std::vector<E> weights_;
+  // (slot, weight) of every parallel edge after a pair's first, sorted
+  std::vector<std::pair<std::uint64_t, E>> extra_weights_;
+};
+
+enum class Representation { kSparse, kDense };
+
+struct RepresentationAdvice {
+  Representation representation;
+  // edges / nodes^2
+  double density;
+  // what the graph takes as a Graph (measured) and would take as a DenseGraph
+  std::size_t sparse_bytes;
+  std::size_t dense_bytes;
+};
+
+// Whether g would be better held as a DenseGraph. Dense is recommended when it takes less memory
+// than the Graph does and the density is at least 1/64, the point at which scanning a row of
+// the matrix touches no more words than a sparse representation touches edges.
+template <typename N, typename E>
+RepresentationAdvice AdviseRepresentation(const Graph<N, E>& g);
+
+}  // namespace gdwg
+
+#include "assignments/dg/dense_graph.tpp"
+
+#endif  // ASSIGNMENTS_DG_DENSE_GRAPH_H_
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+template <typename N, typename E>
+DenseGraph<N, E>::DenseGraph(const Snapshot<N, E>& snapshot)
+  : nodes_(snapshot.Nodes(), snapshot.Nodes() + snapshot.NumNodes()),
+    words_{detail::WordsFor(snapshot.NumNodes())}, bits_(nodes_.size() * words_),
+    row_rank_(nodes_.size() + 1), word_rank_(nodes_.size() * words_) {
+  weights_.reserve(snapshot.NumEdges());
+  for (NodeId src = 0; src < nodes_.size(); ++src) {
+    row_rank_[src] = weights_.size();
+    std::uint64_t* row = bits_.data() + src * words_;
+    // a snapshot's edges are sorted by (dst, weight), so a pair's first edge has its smallest
+    // weight and the pairs arrive in slot order
+    for (auto e = snapshot.EdgeBegin(src); e != snapshot.EdgeEnd(src); ++e) {
+      const NodeId dst = snapshot.Dst(e);
+      if (e != snapshot.EdgeBegin(src) && dst == snapshot.Dst(e - 1)) {
+        extra_weights_.emplace_back(weights_.size() - 1, snapshot.Weight(e));
+      } else {
+        detail::SetBit(row, dst);
+        weights_.push_back(snapshot.Weight(e));
+      }
+    }
+    std::uint32_t rank = 0;
+    for (std::size_t w = 0; w < words_; ++w) {
+      word_rank_[src * words_ + w] = rank;
+      rank += static_cast<std::uint32_t>(__builtin_popcountll(row[w]));
+    }
+  }
+  row_rank_[nodes_.size()] = weights_.size();
+  weights_.shrink_to_fit();
+  extra_weights_.shrink_to_fit();
+}
+
+template <typename N, typename E>
+const N* DenseGraph<N, E>::Find(const N& val) const {
+  const auto it = std::lower_bound(nodes_.begin(), nodes_.end(), val);
+  return (it != nodes_.end() && !(val < *it)) ? &*it : nullptr;
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::IsNode(const N& val) const {
+  return Find(val) != nullptr;
+}
+
+template <typename N, typename E>
+typename DenseGraph<N, E>::NodeId DenseGraph<N, E>::Id(const N& val) const {
+  const N* it = Find(val);
+  if (it == nullptr) {
+    throw std::out_of_range("Cannot call DenseGraph::Id on a node that doesn't exist");
+  }
+  return static_cast<NodeId>(it - nodes_.data());
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::IsConnected(const N& src, const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::runtime_error(
+        "Cannot call DenseGraph::IsConnected if src or dst node don't exist in the graph");
+  }
+  return HasEdge(Id(src), Id(dst));
+}
+
+template <typename N, typename E>
+std::vector<N> DenseGraph<N, E>::GetConnected(const N& src) const {
+  if (!IsNode(src)) {
+    throw std::out_of_range(
+        "Cannot call DenseGraph::GetConnected if src doesn't exist in the graph");
+  }
+  std::vector<N> connected;
+  detail::ForEachBit(Row(Id(src)), words_, [&](std::size_t dst) {
+    connected.push_back(nodes_[dst]);
+  });
+  return connected;
+}
+
+template <typename N, typename E>
+std::vector<E> DenseGraph<N, E>::GetWeights(const N& src, const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::out_of_range(
+        "Cannot call DenseGraph::GetWeights if src or dst node don't exist in the graph");
+  }
+  const NodeId s = Id(src);
+  const NodeId d = Id(dst);
+  std::vector<E> weights;
+  if (!HasEdge(s, d)) {
+    return weights;
+  }
+  const std::uint64_t slot = Slot(s, d);
+  weights.push_back(weights_[slot]);
+  auto it = std::lower_bound(extra_weights_.begin(), extra_weights_.end(), slot,
+                             [](const auto& extra, std::uint64_t s) { return extra.first < s; });
+  for (; it != extra_weights_.end() && it->first == slot; ++it) {
+    weights.push_back(it->second);
+  }
+  return weights;
+}
+
+template <typename N, typename E>
+std::vector<N> DenseGraph<N, E>::GetCommonNeighbors(const N& a, const N& b) const {
+  if (!IsNode(a) || !IsNode(b)) {
+    throw std::out_of_range(
+        "Cannot call DenseGraph::GetCommonNeighbors if a or b node don't exist in the graph");
+  }
+  std::vector<std::uint64_t> common(words_);
+  detail::And(Row(Id(a)), Row(Id(b)), common.data(), words_);
+  std::vector<N> nodes;
+  detail::ForEachBit(common.data(), words_, [&](std::size_t id) { nodes.push_back(nodes_[id]); });
+  return nodes;
+}
+
+template <typename N, typename E>
+std::vector<N> DenseGraph<N, E>::GetReachable(const N& src) const {
+  if (!IsNode(src)) {
+    throw std::out_of_range(
+        "Cannot call DenseGraph::GetReachable if src doesn't exist in the graph");
+  }
+  // breadth first, a frontier at a time: OR the rows of the frontier into the reached set, and
+  // the new frontier is whatever that added
+  std::vector<std::uint64_t> reached(Row(Id(src)), Row(Id(src)) + words_);
+  std::vector<std::uint64_t> frontier = reached;
+  std::vector<std::uint64_t> next(words_);
+  while (std::any_of(frontier.begin(), frontier.end(), [](std::uint64_t w) { return w != 0; })) {
+    std::fill(next.begin(), next.end(), 0);
+    detail::ForEachBit(frontier.data(), words_, [&](std::size_t id) {
+      detail::OrInto(next.data(), Row(static_cast<NodeId>(id)), words_);
+    });
+    for (std::size_t w = 0; w < words_; ++w) {
+      frontier[w] = next[w] & ~reached[w];
+      reached[w] |= next[w];
+    }
+  }
+  std::vector<N> nodes;
+  detail::ForEachBit(reached.data(), words_, [&](std::size_t id) { nodes.push_back(nodes_[id]); });
+  return nodes;
+}
+
+template <typename N, typename E>
+Graph<N, E> DenseGraph<N, E>::ToGraph() const {
+  std::vector<typename Snapshot<N, E>::EdgeId> offsets{0};
+  std::vector<typename Snapshot<N, E>::NodeId> dsts;
+  std::vector<E> weights;
+  offsets.reserve(NumNodes() + 1);
+  dsts.reserve(NumEdges());
+  weights.reserve(NumEdges());
+  auto extra = extra_weights_.begin();
+  std::uint64_t slot = 0;
+  for (NodeId src = 0; src < NumNodes(); ++src) {
+    detail::ForEachBit(Row(src), words_, [&](std::size_t dst) {
+      dsts.push_back(static_cast<NodeId>(dst));
+      weights.push_back(weights_[slot]);
+      for (; extra != extra_weights_.end() && extra->first == slot; ++extra) {
+        dsts.push_back(static_cast<NodeId>(dst));
+        weights.push_back(extra->second);
+      }
+      ++slot;
+    });
+    offsets.push_back(dsts.size());
+  }
+  return Snapshot<N, E>{nodes_, std::move(offsets), std::move(dsts), std::move(weights)}.ToGraph();
+}
+
+template <typename N, typename E>
+std::size_t DenseGraph<N, E>::MemoryUsage() const noexcept {
+  return nodes_.capacity() * sizeof(N) + bits_.capacity() * sizeof(std::uint64_t) +
+         row_rank_.capacity() * sizeof(std::uint64_t) +
+         word_rank_.capacity() * sizeof(std::uint32_t) + weights_.capacity() * sizeof(E) +
+         extra_weights_.capacity() * sizeof(std::pair<std::uint64_t, E>);
+}
+
+template <typename N, typename E>
+std::size_t DenseGraph<N, E>::EstimateBytes(std::size_t num_nodes,
+                                            std::size_t num_edges) noexcept {
+  const std::size_t words = num_nodes * detail::WordsFor(num_nodes);
+  return num_nodes * sizeof(N) + words * (sizeof(std::uint64_t) + sizeof(std::uint32_t)) +
+         (num_nodes + 1) * sizeof(std::uint64_t) + num_edges * sizeof(E);
+}
+
+template <typename N, typename E>
+RepresentationAdvice AdviseRepresentation(const Graph<N, E>& g) {
+  const std::size_t n = g.NumNodes();
+  const std::size_t m = g.NumEdges();
+  RepresentationAdvice advice{Representation::kSparse,
+                              n == 0 ? 0.0 : static_cast<double>(m) / n / n,
+                              g.MemoryUsage().Total(), DenseGraph<N, E>::EstimateBytes(n, m)};
+  if (advice.dense_bytes < advice.sparse_bytes && advice.density >= 1.0 / 64) {
+    advice.representation = Representation::kDense;
+  }
+  return advice;
+}
+
+}  // namespace gdwg
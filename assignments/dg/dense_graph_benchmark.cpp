@@ -0,0 +1,95 @@
+// DenseGraph against the sparse representations on dense random graphs: bytes per edge, and the
+// latency of edge tests and common neighbour counts. Prints JSON to stdout.
+//
+//   dense_graph_benchmark [--nodes=3000] [--density_percent=20] [--queries=100000]
+//                         [--threads=<cores>]
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/dense_graph.h"
+#include "assignments/dg/generators.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = float;
+  const auto nodes = bm::Arg(argc, argv, "nodes", 3000);
+  const double density = bm::Arg(argc, argv, "density_percent", 20) / 100.0;
+  const auto queries = bm::Arg(argc, argv, "queries", 100000);
+  gdwg::GeneratorOptions options;
+  options.threads = bm::Arg(argc, argv, "threads", gdwg::DefaultThreads());
+
+  const auto snapshot =
+      gdwg::ErdosRenyi<N, E>(nodes, density, gdwg::UniformWeights<E>(0, 1), options)
+          .BuildSnapshot(options.threads);
+  const auto g = snapshot.ToGraph();
+  bm::Timer timer;
+  const gdwg::DenseGraph<N, E> dense{snapshot};
+  const double build_seconds = timer.Seconds();
+  const double m = snapshot.NumEdges();
+  const bm::Fields params{{"nodes", nodes}, {"edges", m}};
+  bm::Reporter reporter;
+
+  const auto advice = gdwg::AdviseRepresentation(g);
+  reporter.Add("memory", params,
+               {{"graph_bytes_per_edge", advice.sparse_bytes / m},
+                {"snapshot_bytes_per_edge",
+                 (nodes * (sizeof(N) + 8.0) + m * (sizeof(N) + sizeof(E))) / m},
+                {"dense_bytes_per_edge", dense.MemoryUsage() / m},
+                {"dense_build_seconds", build_seconds},
+                {"recommends_dense", advice.representation == gdwg::Representation::kDense}});
+
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<N> node(0, static_cast<N>(nodes - 1));
+  std::vector<std::pair<N, N>> pairs(queries);
+  for (auto& pair : pairs) {
+    pair = {node(rng), node(rng)};
+  }
+
+  auto run = [&](const char* name, auto&& query) {
+    std::size_t sink = 0;
+    const double seconds = bm::Measure([&] {
+      for (const auto& [a, b] : pairs) {
+        sink += query(a, b);
+      }
+    });
+    bm::DoNotOptimize(sink);
+    reporter.Add(name, params, {{"ns_per_query", 1e9 * seconds / pairs.size()}});
+  };
+
+  run("is_connected/graph", [&](N a, N b) { return g.IsConnected(a, b); });
+  run("is_connected/snapshot", [&](N a, N b) {
+    return std::binary_search(snapshot.Dsts() + snapshot.EdgeBegin(a),
+                              snapshot.Dsts() + snapshot.EdgeEnd(a), b);
+  });
+  run("is_connected/dense", [&](N a, N b) { return dense.HasEdge(a, b); });
+
+  pairs.resize(std::min<std::size_t>(queries, 20000));
+  run("common_neighbors/snapshot", [&](N a, N b) {
+    // merge of the two sorted destination lists
+    const N* x = snapshot.Dsts() + snapshot.EdgeBegin(a);
+    const N* x_end = snapshot.Dsts() + snapshot.EdgeEnd(a);
+    const N* y = snapshot.Dsts() + snapshot.EdgeBegin(b);
+    const N* y_end = snapshot.Dsts() + snapshot.EdgeEnd(b);
+    std::size_t count = 0;
+    while (x != x_end && y != y_end) {
+      if (*x < *y) {
+        ++x;
+      } else if (*y < *x) {
+        ++y;
+      } else {
+        ++count;
+        ++x;
+        ++y;
+      }
+    }
+    return count;
+  });
+  run("common_neighbors/dense", [&](N a, N b) { return dense.CountCommonNeighbors(a, b); });
+
+  reporter.Print(std::cout);
+}
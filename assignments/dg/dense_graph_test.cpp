@@ -0,0 +1,147 @@
+/*
+  Tests for DenseGraph. Every query is checked against the Graph the dense copy was
+  made from, on random graphs with parallel edges and sizes that aren't a multiple
+  of the SIMD width, so the vector loops and their scalar tails are both exercised.
+*/
+
+#include <algorithm>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/dense_graph.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+// nodes reachable from src by one or more edges
+std::vector<int> Reachable(const gdwg::Graph<int, int>& g, int src) {
+  std::set<int> seen;
+  std::queue<int> queue;
+  queue.push(src);
+  while (!queue.empty()) {
+    for (int next : g.GetConnected(queue.front())) {
+      if (seen.insert(next).second) {
+        queue.push(next);
+      }
+    }
+    queue.pop();
+  }
+  return {seen.begin(), seen.end()};
+}
+
+}  // namespace
+
+SCENARIO("A DenseGraph answers queries exactly like the Graph it was made from") {
+  for (int nodes : {1, 63, 150, 300}) {
+    GIVEN("a random graph with " + std::to_string(nodes) + " nodes") {
+      const auto g = gdwg::testing::RandomGraph(nodes, nodes * nodes / 4,
+                                                static_cast<unsigned>(nodes), 0, 3, 3);
+      const gdwg::DenseGraph<int, int> dense{g};
+      THEN("sizes and node values match") {
+        REQUIRE(dense.NumNodes() == g.NumNodes());
+        REQUIRE(dense.NumEdges() == g.NumEdges());
+        REQUIRE(dense.GetNodes() == g.GetNodes());
+      }
+      THEN("edges, neighbours and weights match") {
+        for (int src : g.GetNodes()) {
+          const auto connected = g.GetConnected(src);
+          REQUIRE(dense.GetConnected(src) == connected);
+          REQUIRE(dense.Degree(dense.Id(src)) == connected.size());
+          for (int dst : g.GetNodes()) {
+            REQUIRE(dense.IsConnected(src, dst) == g.IsConnected(src, dst));
+            REQUIRE(dense.GetWeights(src, dst) == g.GetWeights(src, dst));
+          }
+        }
+      }
+      THEN("common neighbours are the intersection of the neighbour lists") {
+        const auto all = g.GetNodes();
+        for (std::size_t i = 0; i < all.size(); i += 7) {
+          const int a = all[i];
+          const int b = all[(i * 5 + 1) % all.size()];
+          const auto na = g.GetConnected(a);
+          const auto nb = g.GetConnected(b);
+          std::vector<int> common;
+          std::set_intersection(na.begin(), na.end(), nb.begin(), nb.end(),
+                                std::back_inserter(common));
+          REQUIRE(dense.GetCommonNeighbors(a, b) == common);
+          REQUIRE(dense.CountCommonNeighbors(dense.Id(a), dense.Id(b)) == common.size());
+        }
+      }
+      THEN("it converts back to an equal Graph") {
+        REQUIRE(dense.ToGraph() == g);
+      }
+    }
+  }
+}
+
+SCENARIO("GetReachable follows paths of any length") {
+  GIVEN("a sparse random graph, so reachability is more than one hop") {
+    const auto g = gdwg::testing::RandomGraph(200, 260, 7, 0, 3, 3);
+    const gdwg::DenseGraph<int, int> dense{g};
+    THEN("the reachable set matches a breadth first search") {
+      for (int src : g.GetNodes()) {
+        REQUIRE(dense.GetReachable(src) == Reachable(g, src));
+      }
+    }
+  }
+  GIVEN("a chain with a cycle at the end") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("d", "c", 1);
+    const gdwg::DenseGraph<std::string, int> dense{g};
+    THEN("a node is in its own reachable set only if it is on a cycle") {
+      REQUIRE(dense.GetReachable("a") == std::vector<std::string>{"b", "c", "d"});
+      REQUIRE(dense.GetReachable("c") == std::vector<std::string>{"c", "d"});
+    }
+  }
+}
+
+SCENARIO("Missing nodes are reported like Graph reports them") {
+  GIVEN("a dense graph") {
+    const gdwg::DenseGraph<int, int> dense{gdwg::Graph<int, int>{1, 2}};
+    THEN("queries about missing nodes throw") {
+      REQUIRE_THROWS_AS(dense.IsConnected(1, 5), std::runtime_error);
+      REQUIRE_THROWS_AS(dense.GetConnected(5), std::out_of_range);
+      REQUIRE_THROWS_AS(dense.GetWeights(5, 1), std::out_of_range);
+      REQUIRE_THROWS_WITH(dense.Id(5), "Cannot call DenseGraph::Id on a node that doesn't exist");
+    }
+  }
+}
+
+SCENARIO("AdviseRepresentation recommends dense only for dense graphs") {
+  GIVEN("a graph with 40% of all possible edges") {
+    const auto g = gdwg::testing::RandomGraph(200, 200 * 200 / 2, 1, 0, 3, 3);
+    const auto advice = gdwg::AdviseRepresentation(g);
+    THEN("dense is smaller and recommended") {
+      REQUIRE(advice.density > 0.3);
+      REQUIRE(advice.dense_bytes < advice.sparse_bytes);
+      REQUIRE(advice.representation == gdwg::Representation::kDense);
+    }
+  }
+  GIVEN("a graph without parallel edges") {
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < 100; ++i) {
+      g.InsertNode(i);
+    }
+    for (int i = 0; i < 100; ++i) {
+      for (int j = i % 3; j < 100; j += 3) {
+        g.InsertEdge(i, j, i + j);
+      }
+    }
+    THEN("the estimate is exactly what a DenseGraph takes") {
+      REQUIRE(gdwg::DenseGraph<int, int>{g}.MemoryUsage() ==
+              gdwg::DenseGraph<int, int>::EstimateBytes(g.NumNodes(), g.NumEdges()));
+    }
+  }
+  GIVEN("a large sparse graph") {
+    const auto g = gdwg::testing::RandomGraph(5000, 10000, 2, 0, 3, 3);
+    THEN("sparse is recommended") {
+      REQUIRE(gdwg::AdviseRepresentation(g).representation == gdwg::Representation::kSparse);
+    }
+  }
+}
@@ -0,0 +1,132 @@
+#ifndef ASSIGNMENTS_DG_DISTANCE_ORACLE_H_
+#define ASSIGNMENTS_DG_DISTANCE_ORACLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/intersect.h"
+#include "assignments/dg/serialize.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// Exact shortest path distances from a 2-hop label index (pruned landmark labeling, Akiba,
+// Iwata and Yoshida). Every node u keeps an out label of (hub, d(u, hub)) and an in label of
+// (hub, d(hub, u)), and the labels are built so that some shortest path from a to b always
+// passes through a hub in both out(a) and in(b). Distance(a, b) is then the smallest
+// d(a, hub) + d(hub, b) over the hubs the two labels share, found by merging the two sorted hub
+// arrays (see intersect.h).
+//
+// Nodes become hubs in order of decreasing degree. Each one runs a Dijkstra forwards and one
+// backwards, and a search is pruned at any node whose distance the hubs before it already
+// give, which keeps labels small on graphs with a few high degree nodes.
+//
+// Weights must be non-negative and arithmetic. Nodes are numbered as in a Snapshot, and like a
+// Snapshot the arrays are either owned or borrowed from an owner (see MapDistanceOracle).
+template <typename N, typename E>
+class DistanceOracle {
+  static_assert(std::is_arithmetic<E>::value, "DistanceOracle needs arithmetic weights");
+
+ public:
+  using NodeId = std::uint32_t;
+  // a label is the entries [offsets[u], offsets[u + 1]) of hubs (sorted) and dists
+  struct Labels {
+    const std::uint64_t* offsets;
+    const std::uint32_t* hubs;
+    const E* dists;
+  };
+
+  DistanceOracle();
+  explicit DistanceOracle(const Snapshot<N, E>& snapshot);
+  explicit DistanceOracle(const Graph<N, E>& g) : DistanceOracle(Snapshot<N, E>{g}) {}
+  // borrows the arrays; owner is kept alive for as long as any copy of the oracle exists
+  DistanceOracle(const N* nodes,
+                 std::size_t num_nodes,
+                 Labels out,
+                 Labels in,
+                 std::shared_ptr<const void> owner) noexcept
+    : nodes_{nodes}, num_nodes_{num_nodes}, out_{out}, in_{in}, owner_{std::move(owner)} {}
+
+  std::size_t NumNodes() const noexcept { return num_nodes_; }
+  const N& Value(NodeId id) const noexcept { return nodes_[id]; }
+  bool IsNode(const N& val) const;
+  NodeId Id(const N& val) const;
+
+  // length of a shortest path from src to dst (0 from a node to itself), or nullopt if there
+  // is none
+  std::optional<E> Distance(const N& src, const N& dst) const;
+  // Distance by id
+  std::optional<E> Query(NodeId src, NodeId dst) const noexcept;
+
+  // raw arrays, for the binary format
+  const N* Nodes() const noexcept { return nodes_; }
+  const Labels& OutLabels() const noexcept { return out_; }
+  const Labels& InLabels() const noexcept { return in_; }
+  // label entries over all nodes, in and out
+  std::size_t NumEntries() const noexcept {
+    return out_.offsets[num_nodes_] + in_.offsets[num_nodes_];
+  }
+  // bytes held by the labels, not counting the node table
+  std::size_t IndexBytes() const noexcept {
+    return 2 * (num_nodes_ + 1) * sizeof(std::uint64_t) +
+           NumEntries() * (sizeof(std::uint32_t) + sizeof(E));
+  }
+
+ private:
+  struct Storage;
+
+  const N* nodes_;
+  std::size_t num_nodes_;
+  Labels out_;
+  Labels in_;
+  std::shared_ptr<const void> owner_;
+};
+
+// Label file, version 1, laid out like the graph files of serialize.h (native endian, 64 byte
+// aligned sections) so that MapDistanceOracle answers queries straight from the mapping:
+//
+//   OracleHeader
+//   node table    num_nodes values, raw if N is trivially copyable, else Codec<N> records
+//   out offsets   num_nodes + 1 uint64_t, then out hubs (uint32_t) and out dists (E)
+//   in offsets    likewise
+struct OracleHeader {
+  static constexpr char kMagic[8] = {'G', 'D', 'W', 'G', 'P', 'L', 'L', '\0'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kEndian = 0x01020304;
+  static constexpr std::uint32_t kRawNodes = 1;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endian;
+  std::uint32_t flags;
+  std::uint32_t node_size;
+  std::uint32_t dist_size;
+  std::uint32_t reserved;
+  std::uint64_t num_nodes;
+  std::uint64_t nodes_offset;
+  std::uint64_t nodes_bytes;
+  // offsets, hubs and dists of the out labels, then of the in labels
+  std::uint64_t num_entries[2];
+  std::uint64_t label_offsets[2][3];
+};
+
+template <typename N, typename E>
+void SaveDistanceOracle(const DistanceOracle<N, E>& oracle, const std::string& path);
+
+// Maps a file written by SaveDistanceOracle. Labels are never copied; a node table that isn't
+// trivially copyable is decoded once with Codec. Like MapBinary, only the header and section
+// bounds are checked.
+template <typename N, typename E>
+DistanceOracle<N, E> MapDistanceOracle(const std::string& path);
+
+}  // namespace gdwg
+
+#include "assignments/dg/distance_oracle.tpp"
+
+#endif  // ASSIGNMENTS_DG_DISTANCE_ORACLE_H_
@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+template <typename N, typename E>
+struct DistanceOracle<N, E>::Storage {
+  struct Arrays {
+    std::vector<std::uint64_t> offsets{0};
+    std::vector<std::uint32_t> hubs;
+    std::vector<E> dists;
+
+    Labels View() const noexcept { return {offsets.data(), hubs.data(), dists.data()}; }
+  };
+
+  std::vector<N> nodes;
+  Arrays out;
+  Arrays in;
+};
+
+template <typename N, typename E>
+DistanceOracle<N, E>::DistanceOracle() {
+  auto storage = std::make_shared<Storage>();
+  nodes_ = storage->nodes.data();
+  num_nodes_ = 0;
+  out_ = storage->out.View();
+  in_ = storage->in.View();
+  owner_ = std::move(storage);
+}
+
+template <typename N, typename E>
+DistanceOracle<N, E>::DistanceOracle(const Snapshot<N, E>& snapshot) {
+  using EdgeId = typename Snapshot<N, E>::EdgeId;
+  using Entry = std::pair<std::uint32_t, E>;
+  constexpr E kInfinity = std::numeric_limits<E>::max();
+  const std::size_t n = snapshot.NumNodes();
+  const std::size_t m = snapshot.NumEdges();
+  for (EdgeId e = 0; e < m; ++e) {
+    if (snapshot.Weight(e) < E{}) {
+      throw std::invalid_argument(
+          "Cannot create a DistanceOracle of a graph with negative weights");
+    }
+  }
+
+  // the reverse graph, for the backward searches
+  std::vector<EdgeId> rev_offsets(n + 1);
+  std::vector<NodeId> rev_dsts(m);
+  std::vector<E> rev_weights(m);
+  for (EdgeId e = 0; e < m; ++e) {
+    ++rev_offsets[snapshot.Dst(e) + 1];
+  }
+  std::partial_sum(rev_offsets.begin(), rev_offsets.end(), rev_offsets.begin());
+  {
+    std::vector<EdgeId> next(rev_offsets.begin(), rev_offsets.end() - 1);
+    for (NodeId src = 0; src < n; ++src) {
+      for (auto e = snapshot.EdgeBegin(src); e != snapshot.EdgeEnd(src); ++e) {
+        const auto slot = next[snapshot.Dst(e)]++;
+        rev_dsts[slot] = src;
+        rev_weights[slot] = snapshot.Weight(e);
+      }
+    }
+  }
+
+  // hubs in order of decreasing degree; a hub is known by its position in that order, so each
+  // label is filled in sorted order
+  std::vector<NodeId> order(n);
+  std::iota(order.begin(), order.end(), NodeId{0});
+  std::stable_sort(order.begin(), order.end(), [&](NodeId a, NodeId b) {
+    return snapshot.Degree(a) + (rev_offsets[a + 1] - rev_offsets[a]) >
+           snapshot.Degree(b) + (rev_offsets[b + 1] - rev_offsets[b]);
+  });
+
+  std::vector<std::vector<Entry>> out_labels(n);
+  std::vector<std::vector<Entry>> in_labels(n);
+  std::vector<E> dist(n, kInfinity);
+  std::vector<char> settled(n);
+  std::vector<NodeId> touched;
+  // d(hub, root) or d(root, hub) for the hubs in the root's label, by hub
+  std::vector<E> root_dist(n, kInfinity);
+  using Item = std::pair<E, NodeId>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+
+  // Dijkstra from root over (offsets, dsts, weights), adding (hub, d) to labels[u] for each
+  // node u that the root's other label, root_label, and labels[u] don't already cover
+  auto search = [&](NodeId root, std::uint32_t hub, const EdgeId* offsets, const NodeId* dsts,
+                    const E* weights, const std::vector<Entry>& root_label,
+                    std::vector<std::vector<Entry>>& labels) {
+    for (const auto& [h, d] : root_label) {
+      root_dist[h] = d;
+    }
+    dist[root] = E{};
+    touched.push_back(root);
+    queue.emplace(E{}, root);
+    while (!queue.empty()) {
+      const auto [d, u] = queue.top();
+      queue.pop();
+      if (settled[u]) {
+        continue;
+      }
+      settled[u] = 1;
+      const bool covered = std::any_of(labels[u].begin(), labels[u].end(), [&](const Entry& x) {
+        return root_dist[x.first] != kInfinity && root_dist[x.first] + x.second <= d;
+      });
+      if (covered) {
+        continue;
+      }
+      labels[u].emplace_back(hub, d);
+      for (auto e = offsets[u]; e != offsets[u + 1]; ++e) {
+        const NodeId v = dsts[e];
+        const E next = d + weights[e];
+        if (next < dist[v]) {
+          if (dist[v] == kInfinity) {
+            touched.push_back(v);
+          }
+          dist[v] = next;
+          queue.emplace(next, v);
+        }
+      }
+    }
+    for (NodeId u : touched) {
+      dist[u] = kInfinity;
+      settled[u] = 0;
+    }
+    touched.clear();
+    for (const auto& [h, d] : root_label) {
+      root_dist[h] = kInfinity;
+    }
+  };
+  for (std::uint32_t hub = 0; hub < n; ++hub) {
+    const NodeId root = order[hub];
+    search(root, hub, snapshot.Offsets(), snapshot.Dsts(), snapshot.Weights(),
+           out_labels[root], in_labels);
+    search(root, hub, rev_offsets.data(), rev_dsts.data(), rev_weights.data(), in_labels[root],
+           out_labels);
+  }
+
+  auto storage = std::make_shared<Storage>();
+  storage->nodes.assign(snapshot.Nodes(), snapshot.Nodes() + n);
+  auto flatten = [n](std::vector<std::vector<Entry>>& labels, typename Storage::Arrays& out) {
+    std::size_t entries = 0;
+    for (const auto& label : labels) {
+      entries += label.size();
+    }
+    out.offsets.reserve(n + 1);
+    out.hubs.reserve(entries);
+    out.dists.reserve(entries);
+    for (auto& label : labels) {
+      for (const auto& [h, d] : label) {
+        out.hubs.push_back(h);
+        out.dists.push_back(d);
+      }
+      out.offsets.push_back(out.hubs.size());
+      std::vector<Entry>{}.swap(label);
+    }
+  };
+  flatten(out_labels, storage->out);
+  flatten(in_labels, storage->in);
+  nodes_ = storage->nodes.data();
+  num_nodes_ = n;
+  out_ = storage->out.View();
+  in_ = storage->in.View();
+  owner_ = std::move(storage);
+}
+
+template <typename N, typename E>
+bool DistanceOracle<N, E>::IsNode(const N& val) const {
+  const N* end = nodes_ + num_nodes_;
+  const N* it = std::lower_bound(nodes_, end, val);
+  return it != end && !(val < *it);
+}
+
+template <typename N, typename E>
+typename DistanceOracle<N, E>::NodeId DistanceOracle<N, E>::Id(const N& val) const {
+  const N* end = nodes_ + num_nodes_;
+  const N* it = std::lower_bound(nodes_, end, val);
+  if (it == end || val < *it) {
+    throw std::out_of_range("Cannot call DistanceOracle::Id on a node that doesn't exist");
+  }
+  return static_cast<NodeId>(it - nodes_);
+}
+
+template <typename N, typename E>
+std::optional<E> DistanceOracle<N, E>::Query(NodeId src, NodeId dst) const noexcept {
+  const auto out_begin = out_.offsets[src];
+  const auto in_begin = in_.offsets[dst];
+  std::optional<E> best;
+  detail::ForEachCommon(out_.hubs + out_begin, out_.offsets[src + 1] - out_begin,
+                        in_.hubs + in_begin, in_.offsets[dst + 1] - in_begin,
+                        [&](std::size_t i, std::size_t j) {
+                          const E d = out_.dists[out_begin + i] + in_.dists[in_begin + j];
+                          if (!best || d < *best) {
+                            best = d;
+                          }
+                        });
+  return best;
+}
+
+template <typename N, typename E>
+std::optional<E> DistanceOracle<N, E>::Distance(const N& src, const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::out_of_range(
+        "Cannot call DistanceOracle::Distance if src or dst node don't exist in the graph");
+  }
+  return Query(Id(src), Id(dst));
+}
+
+template <typename N, typename E>
+void SaveDistanceOracle(const DistanceOracle<N, E>& oracle, const std::string& path) {
+  std::ofstream os{path, std::ios::binary | std::ios::trunc};
+  if (!os) {
+    throw std::runtime_error(
+        "Cannot call gdwg::SaveDistanceOracle on a file that can't be opened: " + path);
+  }
+  OracleHeader header{};
+  std::memcpy(header.magic, OracleHeader::kMagic, sizeof(header.magic));
+  header.version = OracleHeader::kVersion;
+  header.endian = OracleHeader::kEndian;
+  if (std::is_trivially_copyable<N>::value) {
+    header.flags |= OracleHeader::kRawNodes;
+    header.node_size = sizeof(N);
+  }
+  header.dist_size = sizeof(E);
+  const std::size_t n = oracle.NumNodes();
+  header.num_nodes = n;
+
+  // the header is written again once the section offsets are known
+  std::uint64_t pos = 0;
+  detail::WriteBytes(os, pos, &header, sizeof(header));
+  detail::PadTo(os, pos);
+  header.nodes_offset = pos;
+  header.nodes_bytes = detail::WriteValues(os, pos, oracle.Nodes(), n);
+  const typename DistanceOracle<N, E>::Labels labels[2] = {oracle.OutLabels(),
+                                                           oracle.InLabels()};
+  for (int k = 0; k < 2; ++k) {
+    const auto entries = labels[k].offsets[n];
+    header.num_entries[k] = entries;
+    detail::PadTo(os, pos);
+    header.label_offsets[k][0] = pos;
+    detail::WriteBytes(os, pos, labels[k].offsets, (n + 1) * sizeof(std::uint64_t));
+    detail::PadTo(os, pos);
+    header.label_offsets[k][1] = pos;
+    detail::WriteBytes(os, pos, labels[k].hubs, entries * sizeof(std::uint32_t));
+    detail::PadTo(os, pos);
+    header.label_offsets[k][2] = pos;
+    detail::WriteBytes(os, pos, labels[k].dists, entries * sizeof(E));
+  }
+
+  os.seekp(0);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.flush();
+  if (!os) {
+    throw std::runtime_error("Cannot call gdwg::SaveDistanceOracle, writing failed: " + path);
+  }
+}
+
+template <typename N, typename E>
+DistanceOracle<N, E> MapDistanceOracle(const std::string& path) {
+  struct Owner {
+    std::shared_ptr<const MappedFile> file;
+    std::vector<N> nodes;
+  };
+  auto owner = std::make_shared<Owner>();
+  owner->file = std::make_shared<const MappedFile>(path);
+  const MappedFile& file = *owner->file;
+  auto fail = [&path](const std::string& why) {
+    return std::runtime_error("Cannot call gdwg::MapDistanceOracle on " + path + ": " + why);
+  };
+
+  OracleHeader header;
+  if (file.size() < sizeof(header)) {
+    throw fail("file is too small");
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, OracleHeader::kMagic, sizeof(header.magic)) != 0) {
+    throw fail("not a distance oracle file");
+  }
+  if (header.version != OracleHeader::kVersion) {
+    throw fail("unsupported version " + std::to_string(header.version));
+  }
+  if (header.endian != OracleHeader::kEndian) {
+    throw fail("written on a machine with different endianness");
+  }
+  const bool raw_nodes = std::is_trivially_copyable<N>::value;
+  if (((header.flags & OracleHeader::kRawNodes) != 0) != raw_nodes ||
+      (raw_nodes && header.node_size != sizeof(N)) || header.dist_size != sizeof(E)) {
+    throw fail("node or weight type doesn't match the file");
+  }
+  if (!detail::FitsIn<N>(file, header.nodes_offset, header.nodes_bytes)) {
+    throw fail("truncated or corrupt section table");
+  }
+  const std::uint64_t n = header.num_nodes;
+  const char* base = file.data();
+  typename DistanceOracle<N, E>::Labels labels[2];
+  for (int k = 0; k < 2; ++k) {
+    const auto* offsets = header.label_offsets[k];
+    const auto entries = header.num_entries[k];
+    if (!detail::FitsIn<std::uint64_t>(file, offsets[0], (n + 1) * sizeof(std::uint64_t)) ||
+        !detail::FitsIn<std::uint32_t>(file, offsets[1], entries * sizeof(std::uint32_t)) ||
+        !detail::FitsIn<E>(file, offsets[2], entries * sizeof(E))) {
+      throw fail("truncated or corrupt section table");
+    }
+    labels[k] = {reinterpret_cast<const std::uint64_t*>(base + offsets[0]),
+                 reinterpret_cast<const std::uint32_t*>(base + offsets[1]),
+                 reinterpret_cast<const E*>(base + offsets[2])};
+    if (labels[k].offsets[n] != entries) {
+      throw fail("label offsets don't match the entry count");
+    }
+  }
+
+  const N* nodes;
+  if constexpr (std::is_trivially_copyable<N>::value) {
+    if (header.nodes_bytes != n * sizeof(N)) {
+      throw fail("node table has the wrong size");
+    }
+    nodes = reinterpret_cast<const N*>(base + header.nodes_offset);
+  } else {
+    const char* in = base + header.nodes_offset;
+    const char* end = in + header.nodes_bytes;
+    owner->nodes.reserve(n);
+    for (std::uint64_t i = 0; i < n; ++i) {
+      owner->nodes.push_back(Codec<N>::Read(in, end));
+    }
+    nodes = owner->nodes.data();
+  }
+  return DistanceOracle<N, E>{nodes, static_cast<std::size_t>(n), labels[0], labels[1],
+                              std::move(owner)};
+}
+
+}  // namespace gdwg
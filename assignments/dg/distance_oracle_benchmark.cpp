@@ -0,0 +1,122 @@
+// DistanceOracle on a power-law (Barabasi-Albert, both directions) graph: build time, label
+// size, query latency against Dijkstra, and how long a saved oracle takes to come back.
+// Prints JSON to stdout.
+//
+//   distance_oracle_benchmark [--nodes=20000] [--m=3] [--queries=1000000]
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/distance_oracle.h"
+#include "assignments/dg/generators.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = std::uint32_t;
+  const auto nodes = bm::Arg(argc, argv, "nodes", 20000);
+  const auto m = bm::Arg(argc, argv, "m", 3);
+  const auto queries = bm::Arg(argc, argv, "queries", 1000000);
+
+  // preferential attachment only links new nodes to old ones, so add every edge both ways
+  const auto one_way =
+      gdwg::BarabasiAlbert<N, E>(nodes, m, gdwg::UniformWeights<E>(1, 100)).BuildSnapshot();
+  gdwg::GraphBuilder<N, E> builder;
+  for (N src = 0; src < one_way.NumNodes(); ++src) {
+    builder.AddNode(src);
+    for (auto e = one_way.EdgeBegin(src); e != one_way.EdgeEnd(src); ++e) {
+      builder.AddEdge(src, one_way.Dst(e), one_way.Weight(e));
+      builder.AddEdge(one_way.Dst(e), src, one_way.Weight(e));
+    }
+  }
+  const auto snapshot = builder.BuildSnapshot();
+  const bm::Fields params{{"nodes", nodes}, {"edges", snapshot.NumEdges()}};
+  bm::Reporter reporter;
+
+  bm::Timer timer;
+  const gdwg::DistanceOracle<N, E> oracle{snapshot};
+  reporter.Add("build", params,
+               {{"seconds", timer.Seconds()},
+                {"entries_per_node", static_cast<double>(oracle.NumEntries()) / nodes},
+                {"index_bytes", oracle.IndexBytes()},
+                {"graph_bytes", (nodes + 1) * 8.0 + snapshot.NumEdges() * 8.0}});
+
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<N> node(0, static_cast<N>(nodes - 1));
+  std::vector<std::pair<N, N>> pairs(queries);
+  for (auto& pair : pairs) {
+    pair = {node(rng), node(rng)};
+  }
+  auto run = [&](const char* name, const gdwg::DistanceOracle<N, E>& o) {
+    std::uint64_t sum = 0;
+    const double seconds = bm::Measure([&] {
+      for (const auto& [a, b] : pairs) {
+        sum += o.Query(a, b).value_or(0);
+      }
+    });
+    bm::DoNotOptimize(sum);
+    reporter.Add(name, params, {{"ns_per_query", 1e9 * seconds / pairs.size()}});
+  };
+  run("distance/oracle", oracle);
+
+  // a Dijkstra per query, stopping once dst is settled
+  const auto all_pairs = pairs;
+  pairs.resize(std::min<std::size_t>(queries, 100));
+  std::vector<E> dist(nodes, std::numeric_limits<E>::max());
+  const double dijkstra_seconds = bm::Measure([&] {
+    std::uint64_t sum = 0;
+    for (const auto& [a, b] : pairs) {
+      std::fill(dist.begin(), dist.end(), std::numeric_limits<E>::max());
+      using Item = std::pair<E, N>;
+      std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+      dist[a] = 0;
+      queue.emplace(0, a);
+      while (!queue.empty()) {
+        const auto [d, u] = queue.top();
+        queue.pop();
+        if (u == b) {
+          sum += d;
+          break;
+        }
+        if (d > dist[u]) {
+          continue;
+        }
+        for (auto e = snapshot.EdgeBegin(u); e != snapshot.EdgeEnd(u); ++e) {
+          if (d + snapshot.Weight(e) < dist[snapshot.Dst(e)]) {
+            dist[snapshot.Dst(e)] = d + snapshot.Weight(e);
+            queue.emplace(dist[snapshot.Dst(e)], snapshot.Dst(e));
+          }
+        }
+      }
+    }
+    bm::DoNotOptimize(sum);
+  });
+  reporter.Add("distance/dijkstra", params,
+               {{"ns_per_query", 1e9 * dijkstra_seconds / pairs.size()}});
+
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "distance_oracle_benchmark.pll").string();
+  timer.Reset();
+  gdwg::SaveDistanceOracle(oracle, path);
+  const double save_seconds = timer.Seconds();
+  timer.Reset();
+  const auto mapped = gdwg::MapDistanceOracle<N, E>(path);
+  reporter.Add("file", params,
+               {{"save_seconds", save_seconds},
+                {"map_seconds", timer.Seconds()},
+                {"file_bytes", std::filesystem::file_size(path)}});
+  pairs = all_pairs;
+  run("distance/mapped", mapped);
+  std::remove(path.c_str());
+
+  reporter.Print(std::cout);
+}
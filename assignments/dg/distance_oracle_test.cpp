@@ -0,0 +1,171 @@
+/*
+  Tests for DistanceOracle. Distances are checked against a Dijkstra of the graph for every
+  pair, on random graphs with zero weights, parallel edges and unreachable pairs, before and
+  after a round trip through SaveDistanceOracle and MapDistanceOracle. The id intersection the
+  queries use is checked against std::set_intersection on its own.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/distance_oracle.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+  return std::filesystem::temp_directory_path() / name;
+}
+
+bool MatchesDijkstra(const gdwg::DistanceOracle<int, int>& oracle,
+                     const gdwg::Graph<int, int>& g) {
+  for (int src : g.GetNodes()) {
+    const auto dist = gdwg::testing::Dijkstra(g, src);
+    for (int dst : g.GetNodes()) {
+      const auto it = dist.find(dst);
+      const auto actual = oracle.Distance(src, dst);
+      if (it == dist.end() ? actual.has_value() : actual != it->second) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+SCENARIO("ForEachCommon finds every id the two arrays share") {
+  GIVEN("random sorted arrays of many lengths") {
+    std::mt19937 rng{1};
+    THEN("the pairs it reports are those of std::set_intersection") {
+      for (int round = 0; round < 300; ++round) {
+        std::uniform_int_distribution<std::uint32_t> id(0, 60);
+        std::vector<std::uint32_t> a(round % 37);
+        std::vector<std::uint32_t> b(round % 23);
+        for (auto* v : {&a, &b}) {
+          std::generate(v->begin(), v->end(), [&] { return id(rng); });
+          std::sort(v->begin(), v->end());
+          v->erase(std::unique(v->begin(), v->end()), v->end());
+        }
+        std::vector<std::uint32_t> expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                              std::back_inserter(expected));
+        std::vector<std::uint32_t> found;
+        gdwg::detail::ForEachCommon(a.data(), a.size(), b.data(), b.size(),
+                                    [&](std::size_t i, std::size_t j) {
+                                      REQUIRE(a[i] == b[j]);
+                                      found.push_back(a[i]);
+                                    });
+        REQUIRE(found == expected);
+      }
+    }
+  }
+}
+
+SCENARIO("A DistanceOracle gives the same distances as Dijkstra") {
+  for (int edges : {0, 40, 150, 600}) {
+    GIVEN("a random graph with 80 nodes and " + std::to_string(edges) + " edges") {
+      const auto g = gdwg::testing::RandomGraph(80, edges, static_cast<unsigned>(edges), 0, 9, 2);
+      const gdwg::DistanceOracle<int, int> oracle{g};
+      THEN("every pair matches") {
+        REQUIRE(oracle.NumNodes() == 80);
+        REQUIRE(MatchesDijkstra(oracle, g));
+      }
+    }
+  }
+  GIVEN("a graph with a star centre and a long way round") {
+    gdwg::Graph<std::string, double> g{"hub", "a", "b", "c", "far"};
+    for (const std::string leaf : {"a", "b", "c"}) {
+      g.InsertEdge(leaf, "hub", 1);
+      g.InsertEdge("hub", leaf, 1.5);
+    }
+    g.InsertEdge("a", "b", 10);
+    g.InsertEdge("a", "b", 2);
+    const gdwg::DistanceOracle<std::string, double> oracle{g};
+    THEN("the shortest route and missing routes are found") {
+      REQUIRE(oracle.Distance("a", "b") == 2);
+      REQUIRE(oracle.Distance("a", "c") == 2.5);
+      REQUIRE(oracle.Distance("b", "b") == 0);
+      REQUIRE(oracle.Distance("a", "far") == std::nullopt);
+      REQUIRE(oracle.Distance("far", "far") == 0);
+    }
+  }
+}
+
+SCENARIO("Bad input is rejected") {
+  GIVEN("a graph with a negative weight") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, -1);
+    THEN("no oracle can be built") {
+      REQUIRE_THROWS_WITH((gdwg::DistanceOracle<int, int>{g}),
+                          "Cannot create a DistanceOracle of a graph with negative weights");
+    }
+  }
+  GIVEN("an oracle") {
+    const gdwg::DistanceOracle<int, int> oracle{gdwg::Graph<int, int>{1, 2}};
+    THEN("queries about missing nodes throw") {
+      REQUIRE_THROWS_AS(oracle.Distance(1, 3), std::out_of_range);
+      REQUIRE_THROWS_AS(oracle.Id(3), std::out_of_range);
+    }
+  }
+  GIVEN("the default oracle") {
+    const gdwg::DistanceOracle<int, int> oracle;
+    THEN("it is empty") {
+      REQUIRE(oracle.NumNodes() == 0);
+      REQUIRE(oracle.NumEntries() == 0);
+    }
+  }
+}
+
+SCENARIO("Oracles round trip through a file") {
+  GIVEN("an oracle of a random graph") {
+    const auto g = gdwg::testing::RandomGraph(60, 200, 4, 0, 9, 2);
+    const gdwg::DistanceOracle<int, int> oracle{g};
+    const auto path = TempPath("distance_oracle_test_ints.pll");
+    gdwg::SaveDistanceOracle(oracle, path);
+    WHEN("the file is mapped") {
+      const auto mapped = gdwg::MapDistanceOracle<int, int>(path);
+      THEN("it answers like the original") {
+        REQUIRE(mapped.NumEntries() == oracle.NumEntries());
+        REQUIRE(mapped.IndexBytes() == oracle.IndexBytes());
+        REQUIRE(MatchesDijkstra(mapped, g));
+      }
+    }
+    WHEN("it is mapped with the wrong weight type") {
+      THEN("mapping fails") {
+        REQUIRE_THROWS_AS((gdwg::MapDistanceOracle<int, double>(path)), std::runtime_error);
+      }
+    }
+    std::filesystem::remove(path);
+  }
+  GIVEN("an oracle with string nodes") {
+    gdwg::Graph<std::string, float> g{"x", "y", "z"};
+    g.InsertEdge("x", "y", 0.5f);
+    g.InsertEdge("y", "z", 0.25f);
+    const auto path = TempPath("distance_oracle_test_strings.pll");
+    gdwg::SaveDistanceOracle(gdwg::DistanceOracle<std::string, float>{g}, path);
+    THEN("the node table is decoded and queries work") {
+      const auto mapped = gdwg::MapDistanceOracle<std::string, float>(path);
+      REQUIRE(mapped.Distance("x", "z") == 0.75f);
+      REQUIRE(mapped.Distance("z", "x") == std::nullopt);
+    }
+    std::filesystem::remove(path);
+  }
+  GIVEN("a file that isn't an oracle") {
+    const auto path = TempPath("distance_oracle_test_bad.pll");
+    std::ofstream{path} << std::string(512, 'x');
+    THEN("mapping fails") {
+      REQUIRE_THROWS_WITH((gdwg::MapDistanceOracle<int, int>(path)),
+                          Catch::Contains("not a distance oracle file"));
+    }
+    std::filesystem::remove(path);
+  }
+}
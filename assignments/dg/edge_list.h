@@ -0,0 +1,160 @@
+#ifndef ASSIGNMENTS_DG_EDGE_LIST_H_
+#define ASSIGNMENTS_DG_EDGE_LIST_H_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "assignments/dg/builder.h"
+#include "assignments/dg/mapped_file.h"
+#include "assignments/dg/parallel.h"
+
+namespace gdwg {
+
+struct EdgeListOptions {
+  std::size_t threads = DefaultThreads();
+  // the input is cut into pieces of about this size (on line boundaries) that parse in parallel
+  std::size_t chunk_bytes = std::size_t{8} << 20;
+};
+
+namespace detail {
+
+// first '\n' in [p, end), or end; compares 16 bytes at a time where SSE2 is available
+inline const char* FindNewline(const char* p, const char* end) noexcept {
+#if defined(__SSE2__)
+  const __m128i newline = _mm_set1_epi8('\n');
+  for (; end - p >= 16; p += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+    if (mask != 0) {
+      return p + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+  }
+#endif
+  const void* hit = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+  return hit != nullptr ? static_cast<const char*>(hit) : end;
+}
+
+inline const char* SkipBlanks(const char* p, const char* end) noexcept {
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    ++p;
+  return p;
+}
+
+// parses one number at p, returning the end of it or nullptr if there isn't one
+template <typename T>
+const char* ParseNumber(const char* p, const char* end, T& out) noexcept {
+  if (p != end && *p == '+') {
+    ++p;  // from_chars doesn't accept a leading '+'
+  }
+  const auto result = std::from_chars(p, end, out);
+  return result.ec == std::errc{} ? result.ptr : nullptr;
+}
+
+// Matrix Market files start with a %%MatrixMarket banner and comments, followed by a
+// "rows cols entries" size line that isn't an edge. Returns where the edges begin.
+inline const char* SkipMatrixMarketHeader(const char* begin, const char* end) noexcept {
+  constexpr char kBanner[] = "%%MatrixMarket";
+  const auto banner_size = sizeof(kBanner) - 1;
+  if (static_cast<std::size_t>(end - begin) < banner_size ||
+      std::memcmp(begin, kBanner, banner_size) != 0) {
+    return begin;
+  }
+  for (const char* line = begin; line < end;) {
+    const char* eol = FindNewline(line, end);
+    const char* p = SkipBlanks(line, eol);
+    if (p != eol && *p != '%') {
+      return eol == end ? end : eol + 1;
+    }
+    line = eol + 1;
+  }
+  return end;
+}
+
+// Parses "src dst [weight]" lines in [begin, end). Blank lines and lines starting with '%' or
+// '#' are skipped and a missing weight is read as 1. file is only used for error positions.
+template <typename N, typename E>
+void ParseLines(const char* file, const char* begin, const char* end, GraphBuilder<N, E>& out) {
+  for (const char* line = begin; line < end;) {
+    const char* eol = FindNewline(line, end);
+    const char* p = SkipBlanks(line, eol);
+    if (p != eol && *p != '%' && *p != '#') {
+      N src{};
+      N dst{};
+      E weight{1};
+      const char* field_end = ParseNumber(p, eol, src);
+      p = field_end != nullptr ? SkipBlanks(field_end, eol) : nullptr;
+      field_end = (p != nullptr && p != field_end) ? ParseNumber(p, eol, dst) : nullptr;
+      p = field_end != nullptr ? SkipBlanks(field_end, eol) : nullptr;
+      if (p != nullptr && p != eol) {
+        field_end = p != field_end ? ParseNumber(p, eol, weight) : nullptr;
+        p = field_end != nullptr ? SkipBlanks(field_end, eol) : nullptr;
+      }
+      if (p != eol) {
+        throw std::runtime_error("Cannot parse edge list line at byte " +
+                                 std::to_string(line - file) + ": " + std::string{line, eol});
+      }
+      out.AddEdge(src, dst, weight);
+    }
+    line = eol + 1;
+  }
+}
+
+}  // namespace detail
+
+// Parses a SNAP or Matrix Market style edge list held in memory. The text is cut into chunks on
+// line boundaries, the chunks are parsed on separate threads with std::from_chars, and the
+// results are merged into one builder, ready for BuildSnapshot or Build.
+template <typename N, typename E>
+GraphBuilder<N, E> ParseEdgeList(const char* begin,
+                                 const char* end,
+                                 const EdgeListOptions& options = {}) {
+  static_assert(std::is_arithmetic<N>::value && std::is_arithmetic<E>::value,
+                "edge lists can only be parsed into numeric node and weight types");
+  const char* file = begin;
+  begin = detail::SkipMatrixMarketHeader(begin, end);
+
+  const std::size_t chunk_bytes = std::max<std::size_t>(options.chunk_bytes, 1);
+  std::vector<const char*> cuts{begin};
+  for (const char* p = begin; static_cast<std::size_t>(end - p) > chunk_bytes;) {
+    p = detail::FindNewline(p + chunk_bytes, end);
+    if (p == end) {
+      break;
+    }
+    cuts.push_back(++p);
+  }
+  cuts.push_back(end);
+
+  std::vector<GraphBuilder<N, E>> parts(cuts.size() - 1);
+  ParallelFor(parts.size(),
+              [&](std::size_t i) { detail::ParseLines(file, cuts[i], cuts[i + 1], parts[i]); },
+              options.threads);
+  GraphBuilder<N, E> builder;
+  for (auto& part : parts) {
+    builder.Merge(std::move(part));
+  }
+  return builder;
+}
+
+// Maps the file at path and parses it with ParseEdgeList.
+template <typename N, typename E>
+GraphBuilder<N, E> ReadEdgeList(const std::string& path, const EdgeListOptions& options = {}) {
+  MappedFile file{path};
+  file.AdviseSequential();
+  return ParseEdgeList<N, E>(file.data(), file.data() + file.size(), options);
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_EDGE_LIST_H_
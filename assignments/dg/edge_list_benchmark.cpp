@@ -0,0 +1,65 @@
+// Compares parsing a "src dst weight" edge list with std::ifstream >> against ReadEdgeList,
+// then times turning the parsed edges into a Snapshot. Prints JSON to stdout.
+//
+//   edge_list_benchmark [--nodes=1000000] [--edges=5000000] [--threads=<cores>]
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/builder.h"
+#include "assignments/dg/edge_list.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  const auto num_nodes = bm::Arg(argc, argv, "nodes", 1000000);
+  const auto num_edges = bm::Arg(argc, argv, "edges", 5000000);
+  gdwg::EdgeListOptions options;
+  options.threads = bm::Arg(argc, argv, "threads", gdwg::DefaultThreads());
+  const std::string path = std::filesystem::temp_directory_path() / "edge_list_benchmark.txt";
+
+  {
+    std::mt19937_64 rng{42};
+    std::uniform_int_distribution<std::uint64_t> node(0, num_nodes - 1);
+    std::uniform_real_distribution<double> weight(0, 1000);
+    std::ofstream text{path};
+    text << "# synthetic edge list\n";
+    for (std::size_t i = 0; i < num_edges; ++i)
+      text << node(rng) << '\t' << node(rng) << '\t' << weight(rng) << '\n';
+  }
+  const double mb = std::filesystem::file_size(path) / 1e6;
+  bm::Reporter reporter;
+  const bm::Fields params{{"edges", num_edges}, {"threads", options.threads}, {"file_mb", mb}};
+
+  bm::Timer timer;
+  {
+    gdwg::GraphBuilder<std::uint64_t, double> builder;
+    std::ifstream text{path};
+    std::string comment;
+    std::getline(text, comment);
+    std::uint64_t src;
+    std::uint64_t dst;
+    double w;
+    while (text >> src >> dst >> w)
+      builder.AddEdge(src, dst, w);
+    bm::DoNotOptimize(builder);
+  }
+  double seconds = timer.Seconds();
+  reporter.Add("iostream_parse", params, {{"seconds", seconds}, {"mb_per_second", mb / seconds}});
+
+  timer.Reset();
+  auto builder = gdwg::ReadEdgeList<std::uint64_t, double>(path, options);
+  seconds = timer.Seconds();
+  reporter.Add("read_edge_list", params, {{"seconds", seconds}, {"mb_per_second", mb / seconds}});
+
+  timer.Reset();
+  auto snapshot = builder.BuildSnapshot(options.threads);
+  reporter.Add("build_snapshot", params, {{"seconds", timer.Seconds()}});
+  bm::DoNotOptimize(snapshot);
+
+  reporter.Print(std::cout);
+  std::remove(path.c_str());
+}
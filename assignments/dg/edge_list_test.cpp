@@ -0,0 +1,91 @@
+/*
+  Parses small SNAP and Matrix Market style edge lists, including ones cut into many tiny
+  chunks so that the parallel path and chunk boundaries are exercised.
+*/
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "assignments/dg/edge_list.h"
+#include "catch.h"
+
+namespace {
+
+template <typename N, typename E>
+gdwg::Graph<N, E> Parse(const std::string& text, std::size_t chunk_bytes = 1 << 20) {
+  gdwg::EdgeListOptions options;
+  options.chunk_bytes = chunk_bytes;
+  options.threads = 3;
+  return gdwg::ParseEdgeList<N, E>(text.data(), text.data() + text.size(), options).Build();
+}
+
+}  // namespace
+
+SCENARIO("ParseEdgeList reads SNAP style edge lists") {
+  GIVEN("an edge list with comments, blank lines and a missing weight") {
+    const std::string text =
+        "# FromNodeId\tToNodeId\n"
+        "1 2 0.5\n"
+        "\n"
+        "  2\t3   -1.25  \r\n"
+        "3 1\n"
+        "1 2 +7e1";
+    THEN("every edge is parsed, with missing weights read as 1") {
+      gdwg::Graph<long, double> expected{1, 2, 3};
+      expected.InsertEdge(1, 2, 0.5);
+      expected.InsertEdge(2, 3, -1.25);
+      expected.InsertEdge(3, 1, 1);
+      expected.InsertEdge(1, 2, 70);
+      REQUIRE((Parse<long, double>(text)) == expected);
+      AND_THEN("the result is the same when every line is its own chunk") {
+        REQUIRE((Parse<long, double>(text, 1)) == expected);
+      }
+    }
+  }
+  GIVEN("many lines cut into small chunks") {
+    std::string text;
+    gdwg::Graph<int, int> expected;
+    for (int i = 0; i < 2000; ++i) {
+      text += std::to_string(i % 97) + ' ' + std::to_string(i % 89) + ' ' + std::to_string(i);
+      text += '\n';
+      expected.InsertNode(i % 97);
+      expected.InsertNode(i % 89);
+      expected.InsertEdge(i % 97, i % 89, i);
+    }
+    THEN("the chunks together give every edge") {
+      REQUIRE((Parse<int, int>(text, 100)) == expected);
+    }
+  }
+  GIVEN("malformed lines") {
+    THEN("parsing throws and names the line") {
+      REQUIRE_THROWS_WITH((Parse<int, int>("1 2 3\n1 x 3\n")),
+                          "Cannot parse edge list line at byte 6: 1 x 3");
+      REQUIRE_THROWS_AS((Parse<int, int>("12\n")), std::runtime_error);
+      REQUIRE_THROWS_AS((Parse<int, int>("1 2 3 4\n")), std::runtime_error);
+      REQUIRE_THROWS_AS((Parse<int, int>("1-2\n")), std::runtime_error);
+    }
+  }
+}
+
+SCENARIO("ReadEdgeList reads Matrix Market files") {
+  GIVEN("a coordinate matrix file") {
+    const std::string path = std::filesystem::temp_directory_path() / "edge_list_test.mtx";
+    std::ofstream{path} << "%%MatrixMarket matrix coordinate real general\n"
+                        << "% a comment\n"
+                        << "3 3 2\n"
+                        << "1 3 4.5\n"
+                        << "3 2 1\n";
+    WHEN("it is read") {
+      auto g = gdwg::ReadEdgeList<int, double>(path).Build();
+      THEN("the size line is skipped and the entries become edges") {
+        REQUIRE(g.GetNodes() == std::vector<int>{1, 2, 3});
+        REQUIRE(g.NumEdges() == 2);
+        REQUIRE(g.GetWeights(1, 3) == std::vector<double>{4.5});
+        REQUIRE(g.IsConnected(3, 2));
+      }
+    }
+    std::remove(path.c_str());
+  }
+}
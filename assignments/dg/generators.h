@@ -0,0 +1,230 @@
+#ifndef ASSIGNMENTS_DG_GENERATORS_H_
+#define ASSIGNMENTS_DG_GENERATORS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/builder.h"
+#include "assignments/dg/parallel.h"
+
+namespace gdwg {
+
+// Synthetic graph generators. Each returns a GraphBuilder filled with the generated edges, so
+// callers pick BuildSnapshot() or Build(). Nodes are the integers 0..n-1.
+//
+// Work is cut into blocks of about the same number of edges, each with its own random stream
+// derived from the seed, so the same seed gives the same graph whatever the number of threads.
+// Weights come from a callable taking a std::mt19937_64&, e.g. UniformWeights or
+// ConstantWeights below.
+struct GeneratorOptions {
+  std::uint64_t seed = 42;
+  std::size_t threads = DefaultThreads();
+};
+
+template <typename E>
+auto UniformWeights(E lo, E hi) {
+  return [lo, hi](std::mt19937_64& rng) {
+    if constexpr (std::is_integral<E>::value) {
+      return std::uniform_int_distribution<E>(lo, hi)(rng);
+    } else {
+      return std::uniform_real_distribution<E>(lo, hi)(rng);
+    }
+  };
+}
+
+template <typename E>
+auto ConstantWeights(E w) {
+  return [w](std::mt19937_64&) { return w; };
+}
+
+namespace detail {
+
+constexpr std::size_t kGeneratorBlock = 1 << 16;
+
+inline std::uint64_t SplitMix64(std::uint64_t x) noexcept {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// runs fill(builder, rng, begin, end) over [0, n) in blocks of block items and merges the
+// results. The block size must depend only on the generator's parameters, never on threads.
+template <typename N, typename E, typename Fill>
+GraphBuilder<N, E> Generate(std::size_t n,
+                            const GeneratorOptions& options,
+                            Fill fill,
+                            std::size_t block = kGeneratorBlock) {
+  static_assert(std::is_integral<N>::value, "generated graphs have integer nodes");
+  const std::size_t blocks = (n + block - 1) / block;
+  std::vector<GraphBuilder<N, E>> parts(blocks);
+  ParallelFor(blocks,
+              [&](std::size_t b) {
+                std::mt19937_64 rng{SplitMix64(options.seed ^ SplitMix64(b))};
+                const std::size_t begin = b * block;
+                fill(parts[b], rng, begin, std::min(n, begin + block));
+              },
+              options.threads);
+  GraphBuilder<N, E> builder;
+  for (auto& part : parts)
+    builder.Merge(std::move(part));
+  return builder;
+}
+
+}  // namespace detail
+
+// R-MAT (recursive matrix, a stochastic Kronecker graph) on 2^scale nodes: each edge picks a
+// quadrant of the adjacency matrix with probabilities a, b, c and 1 - a - b - c, scale times
+// over. The defaults are the Graph500 parameters, giving a skewed, power-law like graph.
+template <typename N, typename E, typename WeightFn>
+GraphBuilder<N, E> Rmat(unsigned scale,
+                        std::size_t num_edges,
+                        WeightFn weight,
+                        const GeneratorOptions& options = {},
+                        double a = 0.57,
+                        double b = 0.19,
+                        double c = 0.19) {
+  if (scale >= 8 * sizeof(N) - std::is_signed<N>::value || a + b + c > 1) {
+    throw std::invalid_argument("Cannot call gdwg::Rmat with that scale or those probabilities");
+  }
+  return detail::Generate<N, E>(
+      num_edges, options, [=](GraphBuilder<N, E>& out, std::mt19937_64& rng, std::size_t begin,
+                              std::size_t end) {
+        std::uniform_real_distribution<double> unit(0, 1);
+        out.Reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i) {
+          std::uint64_t src = 0;
+          std::uint64_t dst = 0;
+          for (unsigned bit = 0; bit < scale; ++bit) {
+            const double r = unit(rng);
+            src = (src << 1) | (r >= a + b);
+            dst = (dst << 1) | ((r >= a && r < a + b) || r >= a + b + c);
+          }
+          out.AddEdge(static_cast<N>(src), static_cast<N>(dst), weight(rng));
+        }
+      });
+}
+
+// Erdos-Renyi G(n, p): every ordered pair of distinct nodes is an edge with probability p.
+// Uses geometric skips between edges (Batagelj and Brandes), so the cost is O(n + edges). Blocks
+// are of sources expected to have kGeneratorBlock edges between them, so that a small dense
+// graph is still spread over the threads.
+template <typename N, typename E, typename WeightFn>
+GraphBuilder<N, E> ErdosRenyi(std::size_t n,
+                              double p,
+                              WeightFn weight,
+                              const GeneratorOptions& options = {}) {
+  if (p < 0 || p > 1) {
+    throw std::invalid_argument("Cannot call gdwg::ErdosRenyi with p outside [0, 1]");
+  }
+  const double per_source = p * static_cast<double>(n > 0 ? n - 1 : 0);
+  const auto block = static_cast<std::size_t>(std::clamp(
+      static_cast<double>(detail::kGeneratorBlock) / per_source, 1.0,
+      static_cast<double>(detail::kGeneratorBlock)));
+  auto builder = detail::Generate<N, E>(
+      n, options, [=](GraphBuilder<N, E>& out, std::mt19937_64& rng, std::size_t begin,
+                      std::size_t end) {
+        if (p == 0 || n < 2) {
+          return;
+        }
+        std::uniform_real_distribution<double> unit(0, 1);
+        const double log_q = std::log1p(-p);
+        for (std::size_t src = begin; src < end; ++src) {
+          // n - 1 candidate destinations, skipping src itself
+          for (std::size_t k = 0;; ++k) {
+            if (p < 1) {
+              const double skip = std::floor(std::log1p(-unit(rng)) / log_q);
+              if (skip >= static_cast<double>(n)) {
+                break;
+              }
+              k += static_cast<std::size_t>(skip);
+            }
+            if (k >= n - 1) {
+              break;
+            }
+            const std::size_t dst = k < src ? k : k + 1;
+            out.AddEdge(static_cast<N>(src), static_cast<N>(dst), weight(rng));
+          }
+        }
+      },
+      block);
+  for (std::size_t i = 0; i < n; ++i)
+    builder.AddNode(static_cast<N>(i));
+  return builder;
+}
+
+// Barabasi-Albert preferential attachment: node i adds m edges to earlier nodes chosen with
+// probability proportional to their degree. Every edge endpoint is a slot in one long list
+// and the target of edge e copies a uniformly random slot of the nodes before its source;
+// resolving those copies through a hash of the slot index (Sanders and Schulz) makes every
+// edge independent, so the edges can be generated in parallel. Node 0, with nothing before
+// it, adds no edges, but starts the list with m edges to itself, so node 1's all go to it.
+// Parallel edges collapse, so nodes can end up with fewer than m out edges.
+template <typename N, typename E, typename WeightFn>
+GraphBuilder<N, E> BarabasiAlbert(std::size_t n,
+                                  std::size_t m,
+                                  WeightFn weight,
+                                  const GeneratorOptions& options = {}) {
+  if (m == 0) {
+    throw std::invalid_argument("Cannot call gdwg::BarabasiAlbert with m = 0");
+  }
+  const std::uint64_t seed = detail::SplitMix64(options.seed + 1);
+  auto builder = detail::Generate<N, E>(
+      n * m, options, [=](GraphBuilder<N, E>& out, std::mt19937_64& rng, std::size_t begin,
+                          std::size_t end) {
+        out.Reserve(end - begin);
+        for (std::size_t e = std::max(begin, m); e < end; ++e) {
+          // slot 2e is the source of edge e (node e / m); slot 2e + 1 is its target, a copy of
+          // one of the 2m (e / m) slots before the source's first. Node 0's resolve to itself.
+          std::uint64_t slot = 2 * e + 1;
+          while (slot % 2 == 1 && slot / 2 >= m) {
+            slot = detail::SplitMix64(seed ^ slot) % (2 * m * (slot / 2 / m));
+          }
+          out.AddEdge(static_cast<N>(e / m), static_cast<N>(slot / 2 / m), weight(rng));
+        }
+      });
+  for (std::size_t i = 0; i < n; ++i)
+    builder.AddNode(static_cast<N>(i));
+  return builder;
+}
+
+// A rows x cols grid where node r * cols + c has edges to its right and lower neighbours, and
+// back from them when bidirectional.
+template <typename N, typename E, typename WeightFn>
+GraphBuilder<N, E> Grid2D(std::size_t rows,
+                          std::size_t cols,
+                          WeightFn weight,
+                          const GeneratorOptions& options = {},
+                          bool bidirectional = true) {
+  auto builder = detail::Generate<N, E>(
+      rows * cols, options, [=](GraphBuilder<N, E>& out, std::mt19937_64& rng,
+                                std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+          const std::size_t r = v / cols;
+          const std::size_t c = v % cols;
+          for (const std::size_t u : {c + 1 < cols ? v + 1 : v, r + 1 < rows ? v + cols : v}) {
+            if (u == v) {
+              continue;
+            }
+            out.AddEdge(static_cast<N>(v), static_cast<N>(u), weight(rng));
+            if (bidirectional) {
+              out.AddEdge(static_cast<N>(u), static_cast<N>(v), weight(rng));
+            }
+          }
+        }
+      });
+  for (std::size_t i = 0; i < rows * cols; ++i)
+    builder.AddNode(static_cast<N>(i));
+  return builder;
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_GENERATORS_H_
@@ -0,0 +1,48 @@
+// Generation throughput for each synthetic generator, and the time to sort the generated edges
+// into a Snapshot. Prints JSON to stdout.
+//
+//   generators_benchmark [--edges=2000000] [--threads=<cores>]
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  const auto edges = bm::Arg(argc, argv, "edges", 2000000);
+  gdwg::GeneratorOptions options;
+  options.threads = bm::Arg(argc, argv, "threads", gdwg::DefaultThreads());
+  const auto weights = gdwg::UniformWeights<float>(0, 1);
+  bm::Reporter reporter;
+
+  auto run = [&](const std::string& name, auto&& generate) {
+    bm::Timer timer;
+    auto builder = generate();
+    const double generate_seconds = timer.Seconds();
+    const double generated = builder.NumEdges();
+    timer.Reset();
+    auto snapshot = builder.BuildSnapshot(options.threads);
+    const double build_seconds = timer.Seconds();
+    reporter.Add(name, {{"edges", generated}, {"threads", options.threads}},
+                 {{"generate_seconds", generate_seconds},
+                  {"edges_per_second", generated / generate_seconds},
+                  {"build_snapshot_seconds", build_seconds},
+                  {"unique_edges", snapshot.NumEdges()}});
+  };
+
+  const auto scale = static_cast<unsigned>(std::log2(edges / 16.0));
+  run("rmat", [&] { return gdwg::Rmat<std::uint32_t, float>(scale, edges, weights, options); });
+  const std::size_t n = edges / 16;
+  run("erdos_renyi", [&] {
+    return gdwg::ErdosRenyi<std::uint32_t, float>(n, 16.0 / n, weights, options);
+  });
+  run("barabasi_albert",
+      [&] { return gdwg::BarabasiAlbert<std::uint32_t, float>(n, 16, weights, options); });
+  const auto side = static_cast<std::size_t>(std::sqrt(edges / 4.0));
+  run("grid_2d", [&] { return gdwg::Grid2D<std::uint32_t, float>(side, side, weights, options); });
+
+  reporter.Print(std::cout);
+}
@@ -0,0 +1,110 @@
+/*
+  Generators must be deterministic for a seed (whatever the thread count) and produce graphs
+  with the shape their model promises, such as preferential attachment never linking a node
+  to itself.
+*/
+
+#include <cstdint>
+#include <vector>
+
+#include "assignments/dg/generators.h"
+#include "catch.h"
+
+namespace {
+
+gdwg::GeneratorOptions Options(std::uint64_t seed, std::size_t threads) {
+  gdwg::GeneratorOptions options;
+  options.seed = seed;
+  options.threads = threads;
+  return options;
+}
+
+}  // namespace
+
+SCENARIO("Generators are deterministic for a given seed") {
+  GIVEN("an R-MAT graph generated with one thread and with four") {
+    const auto weights = gdwg::UniformWeights<int>(1, 100);
+    auto one = gdwg::Rmat<int, int>(12, 200000, weights, Options(7, 1)).Build();
+    auto four = gdwg::Rmat<int, int>(12, 200000, weights, Options(7, 4)).Build();
+    THEN("the graphs are identical") { REQUIRE(one == four); }
+    AND_WHEN("a different seed is used") {
+      auto other = gdwg::Rmat<int, int>(12, 200000, weights, Options(8, 4)).Build();
+      THEN("the graph differs") { REQUIRE(other != one); }
+    }
+  }
+  GIVEN("a small dense G(n, p) graph, which is cut into many blocks, on one thread and four") {
+    const auto weights = gdwg::UniformWeights<int>(1, 100);
+    auto one = gdwg::ErdosRenyi<int, int>(2000, 0.2, weights, Options(7, 1)).Build();
+    auto four = gdwg::ErdosRenyi<int, int>(2000, 0.2, weights, Options(7, 4)).Build();
+    THEN("the graphs are identical") { REQUIRE(one == four); }
+  }
+}
+
+SCENARIO("Generators produce the expected shapes") {
+  GIVEN("an R-MAT graph") {
+    auto s = gdwg::Rmat<std::uint32_t, double>(10, 20000, gdwg::UniformWeights(0.0, 1.0))
+                 .BuildSnapshot();
+    THEN("every node is below 2^scale and the degrees are skewed") {
+      REQUIRE(s.Value(static_cast<std::uint32_t>(s.NumNodes() - 1)) < 1024);
+      std::size_t max_degree = 0;
+      for (std::uint32_t i = 0; i < s.NumNodes(); ++i)
+        max_degree = std::max(max_degree, s.Degree(i));
+      REQUIRE(max_degree > 10 * s.NumEdges() / s.NumNodes());
+    }
+  }
+  GIVEN("a G(n, p) graph") {
+    const std::size_t n = 2000;
+    const double p = 0.01;
+    auto s = gdwg::ErdosRenyi<int, int>(n, p, gdwg::ConstantWeights(1)).BuildSnapshot();
+    THEN("all nodes exist and the edge count is close to n (n - 1) p") {
+      REQUIRE(s.NumNodes() == n);
+      const double expected = n * (n - 1) * p;
+      REQUIRE(s.NumEdges() > 0.9 * expected);
+      REQUIRE(s.NumEdges() < 1.1 * expected);
+      for (std::uint32_t i = 0; i < s.NumNodes(); ++i)
+        for (auto e = s.EdgeBegin(i); e != s.EdgeEnd(i); ++e)
+          REQUIRE(s.Dst(e) != i);
+    }
+    AND_THEN("p = 1 gives the complete graph") {
+      auto complete = gdwg::ErdosRenyi<int, int>(50, 1, gdwg::ConstantWeights(1)).BuildSnapshot();
+      REQUIRE(complete.NumEdges() == 50 * 49);
+    }
+  }
+  GIVEN("a preferential attachment graph") {
+    const std::size_t n = 5000;
+    const std::size_t m = 3;
+    auto s = gdwg::BarabasiAlbert<int, int>(n, m, gdwg::ConstantWeights(1)).BuildSnapshot();
+    THEN("each node links at most m earlier nodes and early nodes collect the most edges") {
+      REQUIRE(s.NumNodes() == n);
+      REQUIRE(s.Degree(0) == 0);
+      REQUIRE(s.Degree(1) == 1);
+      std::vector<std::size_t> in_degree(n);
+      for (std::uint32_t i = 1; i < s.NumNodes(); ++i) {
+        REQUIRE(s.Degree(i) >= 1);
+        REQUIRE(s.Degree(i) <= m);
+        for (auto e = s.EdgeBegin(i); e != s.EdgeEnd(i); ++e) {
+          REQUIRE(s.Dst(e) < i);
+          ++in_degree[s.Dst(e)];
+        }
+      }
+      std::size_t early = 0;
+      std::size_t late = 0;
+      for (std::size_t i = 0; i < 100; ++i) {
+        early += in_degree[i];
+        late += in_degree[n - 1 - i];
+      }
+      REQUIRE(early > 10 * late);
+    }
+  }
+  GIVEN("a 2D grid") {
+    auto g = gdwg::Grid2D<int, int>(4, 5, gdwg::ConstantWeights(2)).Build();
+    THEN("it has every horizontal and vertical edge in both directions") {
+      REQUIRE(g.NumNodes() == 20);
+      REQUIRE(g.NumEdges() == 2 * (4 * 4 + 3 * 5));
+      REQUIRE(g.IsConnected(6, 7));
+      REQUIRE(g.IsConnected(7, 6));
+      REQUIRE(g.IsConnected(6, 11));
+      REQUIRE_FALSE(g.IsConnected(4, 5));
+    }
+  }
+}
@@ -2,17 +2,33 @@
 #define ASSIGNMENTS_DG_GRAPH_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <set>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "assignments/dg/graph_memory.h"
+#include "assignments/dg/graph_stats.h"
+
 namespace gdwg {
 
+template <typename N, typename E>
+class Snapshot;
+
+// How Graph::Write formats arithmetic nodes and weights. kStream honours the target stream's
+// flags (precision, fixed, ...), exactly like operator<<. kToChars uses std::to_chars, which is
+// much faster and prints floating point values in their shortest round trip form.
+enum class NumberFormat { kStream, kToChars };
+
 template <typename N, typename E>
 class Graph {
  private:
@@ -21,15 +37,28 @@ class Graph {
     std::weak_ptr<N> dst_;
     std::shared_ptr<E> weight_;
     friend bool operator==(const Edge& lhs, const Edge& rhs) {
-      return *lhs.src_.lock() == *rhs.src_.lock() && *lhs.dst_.lock() == *rhs.dst_.lock() &&
-             *lhs.weight_ == *rhs.weight_;
+      return *detail::Lock(lhs.src_) == *detail::Lock(rhs.src_) &&
+             *detail::Lock(lhs.dst_) == *detail::Lock(rhs.dst_) && *lhs.weight_ == *rhs.weight_;
     }
   };
+  template <typename T, MemoryCategory C>
+  using Allocator = detail::TrackingAllocator<T, C>;
+
   class Node {
    public:
-    explicit Node(N value) : sptr_{std::make_shared<N>(value)} {};
+    // a temporary node for lookups, allocated outside the graph's accounting
+    explicit Node(N value) : sptr_{std::make_shared<N>(value)} {
+      GDWG_STATS_COUNT(node_allocations);
+      GDWG_STATS_COUNT(shared_ptr_creations);
+    };
+    // a node owned by the graph whose counters are given
+    Node(const N& value, detail::MemoryCounters* memory)
+      : sptr_{std::allocate_shared<N>(Allocator<N, MemoryCategory::kNodeValues>{memory}, value)} {
+      GDWG_STATS_COUNT(node_allocations);
+      GDWG_STATS_COUNT(shared_ptr_creations);
+    }
     N& operator*() const { return *sptr_; }
-    std::shared_ptr<N> get() const { return sptr_; }
+    const std::shared_ptr<N>& get() const { return sptr_; }
     friend bool operator==(const Node& lhs, const Node& rhs) { return *lhs.sptr_ == *rhs.sptr_; }
 
    private:
@@ -37,30 +66,46 @@ class Graph {
   };
 
   struct NodeCmp {
-    bool operator()(const Node& lhs, const Node& rhs) const { return *lhs < *rhs; }
+    bool operator()(const Node& lhs, const Node& rhs) const {
+      GDWG_STATS_COUNT(node_comparisons);
+      return *lhs < *rhs;
+    }
   };
 
   // this is the comparison as well as the ordering function for the set, cant seperate the two
   struct EdgeCmp {
-    bool operator()(const Edge lhs, const Edge rhs) const {
-      N src1 = *lhs.src_.lock();
-      N src2 = *rhs.src_.lock();
-      if (src1 == src2) {
-        N dst1 = *lhs.dst_.lock();
-        N dst2 = *rhs.dst_.lock();
-        if (dst1 == dst2) {
-          E w1 = *lhs.weight_;
-          E w2 = *rhs.weight_;
-          return w1 < w2;
+    bool operator()(const Edge& lhs, const Edge& rhs) const {
+      GDWG_STATS_COUNT(edge_comparisons);
+      const auto src1 = detail::Lock(lhs.src_);
+      const auto src2 = detail::Lock(rhs.src_);
+      if (*src1 == *src2) {
+        const auto dst1 = detail::Lock(lhs.dst_);
+        const auto dst2 = detail::Lock(rhs.dst_);
+        if (*dst1 == *dst2) {
+          return *lhs.weight_ < *rhs.weight_;
         }
-        return dst1 < dst2;
+        return *dst1 < *dst2;
       }
-      return src1 < src2;
+      return *src1 < *src2;
     }
   };
 
+  using EdgeSet = std::set<Edge, EdgeCmp, Allocator<Edge, MemoryCategory::kEdgeSets>>;
+  using NodeMap = std::map<Node,
+                           EdgeSet,
+                           NodeCmp,
+                           Allocator<std::pair<const Node, EdgeSet>, MemoryCategory::kNodeMap>>;
+
  public:
-  Graph() : edge_map_() {}
+  Graph() : Graph(std::pmr::get_default_resource()) {}
+  // allocates every node, edge and container from resource, which must outlive the graph
+  explicit Graph(std::pmr::memory_resource* resource)
+    : memory_{std::make_unique<detail::MemoryCounters>(resource)},
+      edge_map_{NodeCmp{}, typename NodeMap::allocator_type{memory_.get()}} {}
+  // allocates from an arena the graph owns, see ArenaOptions
+  explicit Graph(const ArenaOptions& arena)
+    : memory_{std::make_unique<detail::MemoryCounters>(arena)},
+      edge_map_{NodeCmp{}, typename NodeMap::allocator_type{memory_.get()}} {}
   Graph(typename std::vector<N>::const_iterator start, typename std::vector<N>::const_iterator end)
     : Graph() {
     for (auto it = start; it != end; it++)
@@ -84,33 +129,37 @@ class Graph {
     for (auto it = std::begin(il); it != std::end(il); ++it)
       InsertNode(*it);
   }
-  Graph(const Graph& other) : Graph() { edge_map_ = other.edge_map_; }
-  Graph(Graph&& other) : Graph() {
-    edge_map_ = std::move(other.edge_map_);
-    other.Clear();
+  // Node values and weights are copied, not shared, so the copy owns (and accounts for)
+  // everything it points at and is unaffected by later changes to other. Like a std::pmr
+  // container, the copy allocates from the default resource whatever other uses; see Clone to
+  // choose another. For cheap copies that share structure until written to, see SharedGraph.
+  Graph(const Graph& other) : Graph() {
+    GDWG_STATS_SCOPE(stats_, GraphOp::kCopy);
+    CopyFrom(other);
   }
+  Graph(Graph&& other) : Graph() { Swap(other); }
 
   ~Graph() {
     // not sure if default is enough or if clear is required
     Clear();
   }
 
-  Graph<N, E>& operator=(const Graph<N, E>& other) const {
-    /*
-      if (this != &other)
-        then do the bottom?
-     */
-    edge_map_ = other.edge_map_;
+  // keeps allocating from this graph's resource
+  Graph<N, E>& operator=(const Graph<N, E>& other) {
+    if (this != &other) {
+      GDWG_STATS_SCOPE(stats_, GraphOp::kCopy);
+      Clear();
+      CopyFrom(other);
+    }
     return *this;
   }
 
-  Graph<N, E>& operator=(Graph<N, E>&& other) const {
-    /*
-      if (this != &other)
-        then do the bottom?
-     */
-    edge_map_ = std::move(other.edge_map_);
-    other.Clear();
+  // takes other's resource (or arena) along with its contents
+  Graph<N, E>& operator=(Graph<N, E>&& other) {
+    if (this != &other) {
+      Swap(other);
+      other.Clear();
+    }
     return *this;
   }
 
@@ -127,7 +176,7 @@ class Graph {
       //      if(cur.src.expired() || cur.dst.expired()) {
       //        std::cout << "Expired ... " << std::endl;
       //      }
-      return {*cur.src_.lock(), *cur.dst_.lock(), *cur.weight_};
+      return {*detail::Lock(cur.src_), *detail::Lock(cur.dst_), *cur.weight_};
     }
 
     pointer operator->() const { return &(operator*()); }
@@ -189,13 +238,20 @@ class Graph {
     }
 
    private:
-    typename std::map<Node, std::set<Edge, EdgeCmp>, NodeCmp>::const_iterator outer_;
-    const typename std::map<Node, std::set<Edge, EdgeCmp>, NodeCmp>::const_iterator outer_begin_;
-    const typename std::map<Node, std::set<Edge, EdgeCmp>, NodeCmp>::const_iterator outer_end_;
-    typename std::set<Edge, EdgeCmp>::const_iterator inner_;
+    typename NodeMap::const_iterator outer_;
+    const typename NodeMap::const_iterator outer_begin_;
+    const typename NodeMap::const_iterator outer_end_;
+    typename EdgeSet::const_iterator inner_;
 
     friend class Graph;
 
+    // used by Partitions to start an iterator part way through a node's edges
+    const_iterator(const decltype(outer_)& outer,
+                   const decltype(outer_begin_)& outer_begin,
+                   const decltype(outer_end_)& outer_end,
+                   const decltype(inner_)& inner)
+      : outer_{outer}, outer_begin_{outer_begin}, outer_end_{outer_end}, inner_{inner} {}
+
     explicit const_iterator(const decltype(outer_)& outer,
                             const decltype(outer_begin_)& outer_begin,
                             const decltype(outer_end_)& outer_end)
@@ -214,6 +270,16 @@ class Graph {
     }
   };
 
+  // a contiguous run of edges [begin, end) in iteration order
+  struct EdgeRange {
+    const_iterator first;
+    const_iterator last;
+    std::size_t count;
+    const_iterator begin() const noexcept { return first; }
+    const_iterator end() const noexcept { return last; }
+    std::size_t size() const noexcept { return count; }
+  };
+
   // methods
   bool InsertNode(const N& val);
   bool InsertEdge(const N& src, const N& dst, const E& w);
@@ -229,12 +295,22 @@ class Graph {
   const_iterator cend() const noexcept;
   const_iterator erase(const_iterator it) noexcept;
   bool erase(const N& src, const N& dst, const E& w) noexcept;
+  std::vector<EdgeRange> Partitions(std::size_t k) const;
+  void Write(std::ostream& os, NumberFormat format = NumberFormat::kStream) const;
   // iterator methods
 
-  void Clear() { edge_map_.clear(); }
+  void Clear() {
+    if (memory_->IsArena()) {
+      ReleaseArena();
+    } else {
+      edge_map_.clear();
+    }
+  }
 
   const_iterator find(const N& src, const N& dst, const E& weight) const noexcept {
+    GDWG_STATS_SCOPE(stats_, GraphOp::kFind);
     for (auto it = cbegin(); it != cend(); ++it) {
+      GDWG_STATS_COUNT(edge_scans);
       if (*it == std::tie(src, dst, weight)) {
         return it;
       }
@@ -254,20 +330,14 @@ class Graph {
   // friends
 
   friend bool operator==(const gdwg::Graph<N, E>& g1, const gdwg::Graph<N, E>& g2) noexcept {
+    GDWG_STATS_SCOPE(g1.stats_, GraphOp::kEqual);
     return g1.edge_map_ == g2.edge_map_;
   }
   friend bool operator!=(const gdwg::Graph<N, E>& g1, const gdwg::Graph<N, E>& g2) noexcept {
     return !(g1 == g2);
   }
   friend std::ostream& operator<<(std::ostream& os, const gdwg::Graph<N, E>& g) noexcept {
-    for (const auto& [key, val] : g.edge_map_) {
-      std::cout << *key << " (\n";
-      std::set<Edge, EdgeCmp> node_to_edge = val;
-      for (const auto& [src, dst, weight] : node_to_edge) {
-        std::cout << "  " << *dst.lock() << " | " << *weight << "\n";
-      }
-      std::cout << ")\n";
-    }
+    g.Write(os);
     return os;
   }
 
@@ -283,8 +353,112 @@ class Graph {
     return sum;
   }
 
+  // A deep copy, like the copy constructor, that allocates from resource.
+  Graph Clone(std::pmr::memory_resource* resource) const {
+    Graph copy{resource};
+    GDWG_STATS_SCOPE(copy.stats_, GraphOp::kCopy);
+    copy.CopyFrom(*this);
+    return copy;
+  }
+  // A deep copy into an arena of its own. The arena's first block is made big enough for the
+  // whole graph, so the copy takes a single allocation from upstream.
+  Graph Clone(ArenaOptions arena) const {
+    const std::size_t bytes = MemoryUsage().Total();
+    arena.initial_bytes = std::max(arena.initial_bytes, bytes + bytes / 8);
+    Graph copy{arena};
+    GDWG_STATS_SCOPE(copy.stats_, GraphOp::kCopy);
+    copy.CopyFrom(*this);
+    return copy;
+  }
+
+  // bytes this graph has allocated, by category; see graph_memory.h for what is included
+  MemoryBreakdown MemoryUsage() const noexcept { return memory_->Breakdown(); }
+  // where this graph's memory comes from; its own arena in arena mode
+  std::pmr::memory_resource* Resource() const noexcept { return memory_->Resource(); }
+
+#ifdef GDWG_GRAPH_STATS
+  // counters since construction or the last ResetStats, see graph_stats.h
+  GraphStats Stats() const noexcept { return stats_; }
+  void ResetStats() noexcept { stats_ = GraphStats{}; }
+#endif
+
  private:
-  std::map<Node, std::set<Edge, EdgeCmp>, NodeCmp> edge_map_;
+  // declared before edge_map_ so it outlives every block charged to it
+  std::unique_ptr<detail::MemoryCounters> memory_;
+  NodeMap edge_map_;
+#ifdef GDWG_GRAPH_STATS
+  mutable GraphStats stats_;
+#endif
+
+  auto FindNode(const N& val) {
+    GDWG_STATS_COUNT(map_lookups);
+    return edge_map_.find(Node{val});
+  }
+  auto FindNode(const N& val) const {
+    GDWG_STATS_COUNT(map_lookups);
+    return edge_map_.find(Node{val});
+  }
+
+  // bulk loading, used by Snapshot::ToGraph. Nodes must be appended in increasing order and
+  // each node's edges in increasing (dst, weight) order, so every insert hits the end hint.
+  using node_iterator = typename NodeMap::iterator;
+  node_iterator AppendNode(const N& val) {
+    GDWG_STATS_COUNT(map_lookups);
+    return edge_map_.emplace_hint(edge_map_.end(), NewNode(val), NewEdgeSet());
+  }
+  void AppendEdge(node_iterator src, node_iterator dst, const E& w) {
+    auto& edge_set = src->second;
+    edge_set.emplace_hint(edge_set.end(), Edge{src->first.get(), dst->first.get(), NewWeight(w)});
+  }
+
+  // allocation of the graph's own blocks, charged to memory_
+  Node NewNode(const N& val) const { return Node{val, memory_.get()}; }
+  EdgeSet NewEdgeSet() const {
+    return EdgeSet{EdgeCmp{}, typename EdgeSet::allocator_type{memory_.get()}};
+  }
+  std::shared_ptr<E> NewWeight(const E& w) const {
+    GDWG_STATS_COUNT(edge_allocations);
+    GDWG_STATS_COUNT(shared_ptr_creations);
+    return std::allocate_shared<E>(Allocator<E, MemoryCategory::kWeights>{memory_.get()}, w);
+  }
+
+  // Copies other's nodes and edges into this (empty) graph in one pass over each. Both are
+  // already in order, so every insert hits the end hint, and edge endpoints are remapped by the
+  // address of other's node values rather than looked up by value.
+  void CopyFrom(const Graph& other) {
+    std::unordered_map<const N*, node_iterator> remap;
+    remap.reserve(other.edge_map_.size());
+    for (const auto& node : other.edge_map_) {
+      remap.emplace(&*node.first, AppendNode(*node.first));
+    }
+    auto src = edge_map_.begin();
+    for (const auto& node : other.edge_map_) {
+      for (const Edge& edge : node.second) {
+        AppendEdge(src, remap.find(detail::Lock(edge.dst_).get())->second, *edge.weight_);
+      }
+      ++src;
+    }
+  }
+
+  // Empties an arena graph. If destroying nodes and edges would do nothing but hand memory back
+  // to the arena (no weak_ptr or shared_ptr to them escapes the graph, so only N's and E's
+  // destructors matter) the map is abandoned instead of being torn down node by node.
+  void ReleaseArena() noexcept {
+    if constexpr (std::is_trivially_destructible_v<N> && std::is_trivially_destructible_v<E>) {
+      new (&edge_map_) NodeMap{NodeCmp{}, typename NodeMap::allocator_type{memory_.get()}};
+    } else {
+      edge_map_.clear();
+    }
+    memory_->ReleaseArena();
+  }
+
+  // swaps contents and accounting; allocators propagate on swap so each map keeps its counters
+  void Swap(Graph& other) noexcept {
+    std::swap(memory_, other.memory_);
+    edge_map_.swap(other.edge_map_);
+  }
+
+  friend class Snapshot<N, E>;
 };
 
 }  // namespace gdwg
@@ -1,38 +1,100 @@
+#include <charconv>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <set>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace gdwg {
 
+namespace detail {
+
+// a streambuf that appends everything written to it onto a string
+class StringAppendBuf : public std::streambuf {
+ public:
+  void Target(std::string* out) noexcept { out_ = out; }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      out_->push_back(traits_type::to_char_type(ch));
+    }
+    return traits_type::not_eof(ch);
+  }
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    out_->append(s, static_cast<std::size_t>(n));
+    return n;
+  }
+
+ private:
+  std::string* out_ = nullptr;
+};
+
+// character and bool types print differently through a stream, so they never use to_chars
+template <typename T>
+constexpr bool kToCharsFormattable =
+    std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+    !std::is_same<T, char>::value && !std::is_same<T, signed char>::value &&
+    !std::is_same<T, unsigned char>::value && !std::is_same<T, wchar_t>::value &&
+    !std::is_same<T, char16_t>::value && !std::is_same<T, char32_t>::value;
+
+// appends val to out, either through formatter (whose streambuf is sink) or with to_chars
+template <typename T>
+void AppendFormatted(std::string& out,
+                     const T& val,
+                     NumberFormat format,
+                     StringAppendBuf& sink,
+                     std::ostream& formatter) {
+  if constexpr (kToCharsFormattable<T>) {
+    if (format == NumberFormat::kToChars) {
+      char chars[64];
+      const auto result = std::to_chars(chars, chars + sizeof(chars), val);
+      out.append(chars, result.ptr);
+      return;
+    }
+  }
+  sink.Target(&out);
+  formatter << val;
+}
+
+}  // namespace detail
+
 template <typename N, typename E>
 bool Graph<N, E>::InsertNode(const N& val) {
-  if (edge_map_.find(Node{val}) != edge_map_.end()) {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kInsertNode);
+  if (FindNode(val) != edge_map_.end()) {
     return false;
   }
-  Node new_node{val};
-  std::set<Edge, EdgeCmp> edge_set;
-  edge_map_.emplace(new_node, edge_set);
+  GDWG_STATS_COUNT(map_lookups);
+  edge_map_.emplace(NewNode(val), NewEdgeSet());
   return true;
 }
 
 template <typename N, typename E>
 bool Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kInsertEdge);
   if (!IsNode(src) || !IsNode(dst)) {
     throw std::runtime_error(
         "Cannot call Graph::InsertEdge when either src or dst node does not exist");
   }
 
-  Node src_node = edge_map_.find(Node{src})->first;
-  Node dst_node = edge_map_.find(Node{dst})->first;
-  Edge e{src_node.get(), dst_node.get(), std::make_shared<E>(w)};
+  Node src_node = FindNode(src)->first;
+  Node dst_node = FindNode(dst)->first;
+  Edge e{src_node.get(), dst_node.get(), NewWeight(w)};
 
   // std::cout << "Inserting Edge: " << *src_sp << " " << *dst_sp << " " << w << "\n";
-  std::set<Edge, EdgeCmp>& edge_set = edge_map_.find(Node{src})->second;
+  EdgeSet& edge_set = FindNode(src)->second;
   for (const Edge& edge : edge_set) {
-    if (*edge.src_.lock() == src && *edge.dst_.lock() == dst && *edge.weight_ == w) {
+    GDWG_STATS_COUNT(edge_scans);
+    if (*detail::Lock(edge.src_) == src && *detail::Lock(edge.dst_) == dst
+        && *edge.weight_ == w) {
       return false;
     }
   }
@@ -42,13 +104,16 @@ bool Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
 
 template <typename N, typename E>
 bool Graph<N, E>::DeleteNode(const N& node) noexcept {
-  if (edge_map_.find(Node{node}) == edge_map_.end()) {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kDeleteNode);
+  if (FindNode(node) == edge_map_.end()) {
     return false;
   }
+  GDWG_STATS_COUNT(map_lookups);
   edge_map_.erase(Node{node});
   for (auto it = edge_map_.begin(); it != edge_map_.end(); ++it) {
-    std::set<Edge, EdgeCmp>& edge_set = it->second;
+    EdgeSet& edge_set = it->second;
     for (auto edge_it = edge_set.begin(); edge_it != edge_set.end();) {
+      GDWG_STATS_COUNT(edge_scans);
       if (edge_it->dst_.expired()) {
         edge_it = edge_set.erase(edge_it);
       } else {
@@ -61,18 +126,21 @@ bool Graph<N, E>::DeleteNode(const N& node) noexcept {
 
 template <typename N, typename E>
 bool Graph<N, E>::IsNode(const N& val) const noexcept {
-  return (edge_map_.find(Node{val}) != edge_map_.end());
+  GDWG_STATS_SCOPE(stats_, GraphOp::kIsNode);
+  return (FindNode(val) != edge_map_.end());
 }
 
 template <typename N, typename E>
 bool Graph<N, E>::IsConnected(const N& src, const N& dst) const {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kIsConnected);
   if (!IsNode(src) || !IsNode(dst)) {
     throw std::runtime_error(
         "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
   }
-  std::set<Edge, EdgeCmp> edge_set = edge_map_.find(Node{src})->second;
+  const EdgeSet& edge_set = FindNode(src)->second;
   for (const auto& [from, to, weight] : edge_set) {
-    if (dst == *to.lock()) {
+    GDWG_STATS_COUNT(edge_scans);
+    if (dst == *detail::Lock(to)) {
       return true;
     }
   }
@@ -81,6 +149,7 @@ bool Graph<N, E>::IsConnected(const N& src, const N& dst) const {
 
 template <typename N, typename E>
 std::vector<N> Graph<N, E>::GetNodes() const noexcept {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kGetNodes);
   std::vector<N> node_vector;
   for (const auto& key : edge_map_) {
     node_vector.push_back(*key.first);
@@ -90,13 +159,15 @@ std::vector<N> Graph<N, E>::GetNodes() const noexcept {
 
 template <typename N, typename E>
 std::vector<N> Graph<N, E>::GetConnected(const N& src) const {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kGetConnected);
   if (!IsNode(src)) {
     throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
   }
   std::set<N> seen_nodes;
   // std::set<Edge,
-  for (Edge e : edge_map_.find(Node{src})->second) {
-    seen_nodes.insert(*e.dst_.lock());
+  for (Edge e : FindNode(src)->second) {
+    GDWG_STATS_COUNT(edge_scans);
+    seen_nodes.insert(*detail::Lock(e.dst_));
   }
   std::vector<N> connected_nodes{seen_nodes.begin(), seen_nodes.end()};
   return connected_nodes;
@@ -104,13 +175,15 @@ std::vector<N> Graph<N, E>::GetConnected(const N& src) const {
 
 template <typename N, typename E>
 std::vector<E> Graph<N, E>::GetWeights(const N& src, const N& dst) const {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kGetWeights);
   if (!IsNode(src) || !IsNode(dst)) {
     throw std::out_of_range(
         "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
   }
   std::vector<E> weights;
-  for (Edge e : edge_map_.find(Node{src})->second) {
-    if (*e.dst_.lock() == dst) {
+  for (Edge e : FindNode(src)->second) {
+    GDWG_STATS_COUNT(edge_scans);
+    if (*detail::Lock(e.dst_) == dst) {
       weights.push_back(*e.weight_);
     }
   }
@@ -119,15 +192,16 @@ std::vector<E> Graph<N, E>::GetWeights(const N& src, const N& dst) const {
 
 template <typename N, typename E>
 bool Graph<N, E>::Replace(const N& oldData, const N& newData) {
-  if (edge_map_.find(Node{oldData}) == edge_map_.end()) {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kReplace);
+  if (FindNode(oldData) == edge_map_.end()) {
     throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
-  } else if (edge_map_.find(Node{newData}) != edge_map_.end()) {
+  } else if (FindNode(newData) != edge_map_.end()) {
     return false;
   }
   InsertNode(newData);
-  std::set<Edge, EdgeCmp> old_edges = edge_map_.find(Node{oldData})->second;
+  EdgeSet old_edges = FindNode(oldData)->second;
   for (const auto& Edge : old_edges) {
-    InsertEdge(newData, *Edge.dst_.lock(), *Edge.weight_);
+    InsertEdge(newData, *detail::Lock(Edge.dst_), *Edge.weight_);
   }
   return DeleteNode(oldData);
   // return true;
@@ -135,6 +209,7 @@ bool Graph<N, E>::Replace(const N& oldData, const N& newData) {
 
 template <typename N, typename E>
 void Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kMergeReplace);
   if (!IsNode(oldData) || !IsNode(newData)) {
     throw std::runtime_error(
         "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
@@ -142,18 +217,19 @@ void Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
 
   // get outgoing edges of src_node (src_node -> other_node)
   // replace src_node with dest node and insert new edge into graph
-  std::set<Edge, EdgeCmp> src_edges = edge_map_.find(Node{oldData})->second;
+  EdgeSet src_edges = FindNode(oldData)->second;
   for (const auto& e : src_edges) {
-    InsertEdge(newData, *e.dst_.lock(), *e.weight_);
+    InsertEdge(newData, *detail::Lock(e.dst_), *e.weight_);
   }
 
   // get incoming edges of src_node (other_node -> src_node)
   // replace src_node with dest node and insert new edge into graph
   for (auto it = edge_map_.begin(); it != edge_map_.end(); ++it) {
-    std::set<Edge, EdgeCmp>& edge_set = it->second;
+    EdgeSet& edge_set = it->second;
     for (auto edge_it = edge_set.begin(); edge_it != edge_set.end();) {
-      if (*edge_it->src_.lock() != newData && *edge_it->dst_.lock() == oldData) {
-        InsertEdge(*edge_it->src_.lock(), newData, *edge_it->weight_);
+      GDWG_STATS_COUNT(edge_scans);
+      if (*detail::Lock(edge_it->src_) != newData && *detail::Lock(edge_it->dst_) == oldData) {
+        InsertEdge(*detail::Lock(edge_it->src_), newData, *edge_it->weight_);
         edge_it = edge_set.erase(edge_it);
       } else {
         ++edge_it;
@@ -174,7 +250,7 @@ template <typename N, typename E>
 typename Graph<N, E>::const_iterator Graph<N, E>::cbegin() const noexcept {
   auto first_edge_it = std::find_if(
       edge_map_.cbegin(), edge_map_.cend(),
-      [](const std::pair<Node, std::set<Edge, EdgeCmp>>& item) { return !item.second.empty(); });
+      [](const typename NodeMap::value_type& item) { return !item.second.empty(); });
   return Graph<N, E>::const_iterator{first_edge_it, first_edge_it, edge_map_.cend()};
 }
 
@@ -182,13 +258,14 @@ template <typename N, typename E>
 typename Graph<N, E>::const_iterator Graph<N, E>::cend() const noexcept {
   auto first_edge_it = std::find_if(
       edge_map_.cbegin(), edge_map_.cend(),
-      [](const std::pair<Node, std::set<Edge, EdgeCmp>>& item) { return !item.second.empty(); });
+      [](const typename NodeMap::value_type& item) { return !item.second.empty(); });
   return Graph<N, E>::const_iterator{edge_map_.cend(), first_edge_it, edge_map_.cend()};
 }
 
 template <typename N, typename E>
 typename Graph<N, E>::const_iterator
 Graph<N, E>::erase(typename Graph<N, E>::const_iterator it) noexcept {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kErase);
   if (it == Graph<N, E>::cend()) {
     return it;
   }
@@ -210,15 +287,17 @@ Graph<N, E>::erase(typename Graph<N, E>::const_iterator it) noexcept {
 
 template <typename N, typename E>
 bool Graph<N, E>::erase(const N& src, const N& dst, const E& w) noexcept {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kErase);
   // if edge exists, delete it and return true. Else, false
-  auto it = edge_map_.find(Node{src});
+  auto it = FindNode(src);
   if (it == edge_map_.end()) {
     return false;
   }
 
-  std::set<Edge, EdgeCmp>& edge_set = it->second;
+  EdgeSet& edge_set = it->second;
   auto edge_it = std::find_if(edge_set.cbegin(), edge_set.cend(), [=](const Edge& e) {
-    return *e.dst_.lock() == dst && *e.weight_ == w;
+    GDWG_STATS_COUNT(edge_scans);
+    return *detail::Lock(e.dst_) == dst && *e.weight_ == w;
   });
 
   if (edge_it == edge_set.end()) {
@@ -236,4 +315,99 @@ bool Graph<N, E>::erase(const N& src, const N& dst, const E& w) noexcept {
   //    return erased;
 }
 
+template <typename N, typename E>
+std::vector<typename Graph<N, E>::EdgeRange> Graph<N, E>::Partitions(std::size_t k) const {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kPartitions);
+  if (k == 0) {
+    throw std::invalid_argument("Cannot call Graph::Partitions with zero partitions");
+  }
+  const std::size_t total = NumEdges();
+  const auto first = cbegin();
+  std::vector<const_iterator> bounds{first};
+  bounds.reserve(k + 1);
+
+  // walk the node map once, skipping whole edge sets by their size and only stepping
+  // through a set when a split point lands inside it
+  auto outer = first.outer_;
+  auto inner = first.inner_;
+  std::size_t pos = 0;
+  std::size_t offset = 0;
+  for (std::size_t i = 1; i < k; ++i) {
+    // floor(total * i / k) without overflowing
+    const std::size_t target = total / k * i + total % k * i / k;
+    if (target == total) {
+      bounds.push_back(cend());
+      continue;
+    }
+    while (pos + (outer->second.size() - offset) <= target) {
+      pos += outer->second.size() - offset;
+      offset = 0;
+      while ((++outer)->second.empty()) {
+      }
+      inner = outer->second.cbegin();
+    }
+    std::advance(inner, target - pos);
+    offset += target - pos;
+    pos = target;
+    bounds.push_back(const_iterator{outer, first.outer_begin_, edge_map_.cend(), inner});
+  }
+  bounds.push_back(cend());
+
+  std::vector<EdgeRange> ranges;
+  ranges.reserve(k);
+  for (std::size_t i = 0; i < k; ++i) {
+    const std::size_t size = total / k * (i + 1) + total % k * (i + 1) / k -
+                             (total / k * i + total % k * i / k);
+    ranges.push_back(EdgeRange{bounds[i], bounds[i + 1], size});
+  }
+  return ranges;
+}
+
+template <typename N, typename E>
+void Graph<N, E>::Write(std::ostream& os, NumberFormat format) const {
+  GDWG_STATS_SCOPE(stats_, GraphOp::kWrite);
+  // text is collected in a large buffer and handed to os in few big writes
+  constexpr std::size_t kFlushBytes = 1 << 16;
+  std::string buffer;
+  buffer.reserve(kFlushBytes + 1024);
+  detail::StringAppendBuf sink;
+  std::ostream formatter{&sink};
+  formatter.copyfmt(os);
+  // copyfmt copies os's tie too, which would then be flushed for every value formatted
+  formatter.tie(nullptr);
+  formatter.exceptions(std::ios::goodbit);
+  formatter.width(0);
+  auto flush_if_full = [&os, &buffer] {
+    if (buffer.size() >= kFlushBytes) {
+      os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+  };
+
+  // edges are sorted by dst, so each run of parallel edges locks and formats its dst once
+  std::string dst_text;
+  for (const auto& [node, edges] : edge_map_) {
+    detail::AppendFormatted(buffer, *node, format, sink, formatter);
+    buffer += " (\n";
+    const Edge* prev = nullptr;
+    for (const Edge& edge : edges) {
+      if (prev == nullptr || prev->dst_.owner_before(edge.dst_) ||
+          edge.dst_.owner_before(prev->dst_)) {
+        dst_text.clear();
+        detail::AppendFormatted(dst_text, *detail::Lock(edge.dst_), format, sink, formatter);
+      }
+      prev = &edge;
+      buffer += "  ";
+      buffer += dst_text;
+      buffer += " | ";
+      detail::AppendFormatted(buffer, *edge.weight_, format, sink, formatter);
+      buffer += '\n';
+      flush_if_full();
+    }
+    buffer += ")\n";
+    flush_if_full();
+  }
+  os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
 }  // namespace gdwg
@@ -0,0 +1,175 @@
+// Baseline timings for every public Graph operation, across graph sizes and degree
+// distributions. Results go to stdout as JSON (see benchmark.h) so runs from different releases
+// can be diffed; progress goes to stderr.
+//
+//   graph_benchmark [--min_edges=1000] [--max_edges=100000] [--degree=8]
+//                   [--max_insert_edges=1000000] [--queries=100000] [--seed=42]
+//
+// Sizes go up by 10x from min_edges to max_edges (pass --max_edges=10000000 for the full
+// 1e3..1e7 sweep). Graphs larger than max_insert_edges are built with GraphBuilder rather
+// than timed through InsertEdge.
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/builder.h"
+#include "assignments/dg/graph.h"
+
+namespace {
+
+namespace bm = gdwg::benchmark;
+
+enum class Distribution { kUniform, kPowerLaw };
+
+const char* NameOf(Distribution d) {
+  return d == Distribution::kUniform ? "uniform" : "power_law";
+}
+
+// Uniform picks both endpoints uniformly. PowerLaw picks sources with a Zipf-like skew
+// (P(node i) ~ 1 / (i + 1)), giving a few very high degree nodes and a long tail.
+std::vector<std::tuple<int, int, int>> MakeEdges(std::size_t num_edges,
+                                                 std::size_t num_nodes,
+                                                 Distribution distribution,
+                                                 std::mt19937_64& rng) {
+  std::uniform_int_distribution<int> uniform(0, static_cast<int>(num_nodes) - 1);
+  std::uniform_real_distribution<double> unit(0, 1);
+  std::uniform_int_distribution<int> weight(0, 99);
+  std::vector<std::tuple<int, int, int>> edges;
+  edges.reserve(num_edges);
+  for (std::size_t i = 0; i < num_edges; ++i) {
+    int src = uniform(rng);
+    if (distribution == Distribution::kPowerLaw) {
+      src = static_cast<int>(std::pow(static_cast<double>(num_nodes), unit(rng))) - 1;
+    }
+    edges.emplace_back(src, uniform(rng), weight(rng));
+  }
+  return edges;
+}
+
+template <typename T>
+const T& Pick(const std::vector<T>& values, std::mt19937_64& rng) {
+  return values[std::uniform_int_distribution<std::size_t>(0, values.size() - 1)(rng)];
+}
+
+void Run(std::size_t num_edges,
+         std::size_t degree,
+         Distribution distribution,
+         std::size_t max_insert_edges,
+         std::size_t queries,
+         std::mt19937_64& rng,
+         bm::Reporter& reporter) {
+  const std::size_t num_nodes = std::max<std::size_t>(2, num_edges / degree);
+  const auto edges = MakeEdges(num_edges, num_nodes, distribution, rng);
+  const std::string suffix = std::string{"/"} + NameOf(distribution);
+  const bm::Fields params{{"edges", num_edges}, {"nodes", num_nodes}};
+  auto report = [&](const std::string& op, double seconds, double ops) {
+    reporter.Add(op + suffix, params,
+                 {{"seconds", seconds}, {"ops", ops}, {"ns_per_op", seconds / ops * 1e9}});
+  };
+
+  gdwg::Graph<int, int> g;
+  bm::Timer timer;
+  for (std::size_t i = 0; i < num_nodes; ++i)
+    g.InsertNode(static_cast<int>(i));
+  report("InsertNode", timer.Seconds(), num_nodes);
+
+  if (num_edges <= max_insert_edges) {
+    timer.Reset();
+    for (const auto& [src, dst, w] : edges)
+      g.InsertEdge(src, dst, w);
+    report("InsertEdge", timer.Seconds(), num_edges);
+  } else {
+    gdwg::GraphBuilder<int, int> builder;
+    builder.Reserve(edges.size());
+    for (std::size_t i = 0; i < num_nodes; ++i)
+      builder.AddNode(static_cast<int>(i));
+    for (const auto& [src, dst, w] : edges)
+      builder.AddEdge(src, dst, w);
+    timer.Reset();
+    g = builder.Build();
+    report("GraphBuilder", timer.Seconds(), num_edges);
+  }
+  const auto nodes = g.GetNodes();
+
+  std::size_t hits = 0;
+  timer.Reset();
+  for (std::size_t i = 0; i < queries; ++i)
+    hits += g.IsConnected(Pick(nodes, rng), Pick(nodes, rng));
+  report("IsConnected", timer.Seconds(), queries);
+
+  timer.Reset();
+  for (std::size_t i = 0; i < queries; ++i)
+    hits += g.GetConnected(Pick(nodes, rng)).size();
+  report("GetConnected", timer.Seconds(), queries);
+
+  timer.Reset();
+  for (std::size_t i = 0; i < queries; ++i) {
+    const auto& [src, dst, w] = Pick(edges, rng);
+    hits += g.GetWeights(src, dst).size() + w;
+  }
+  report("GetWeights", timer.Seconds(), queries);
+
+  timer.Reset();
+  for (const auto& [src, dst, w] : g)
+    hits += src + dst + w;
+  report("Iterate", timer.Seconds(), g.NumEdges());
+  bm::DoNotOptimize(hits);
+
+  timer.Reset();
+  gdwg::Graph<int, int> copy{g};
+  report("Copy", timer.Seconds(), g.NumEdges());
+
+  timer.Reset();
+  const bool equal = copy == g;
+  report("Equal", timer.Seconds(), g.NumEdges());
+  bm::DoNotOptimize(equal);
+
+  // the rest mutate, and each call can scan the whole graph, so only a few are timed. They run
+  // on a copy, which is deep, so g is left as it was.
+  gdwg::Graph<int, int> victim{g};
+  constexpr std::size_t kMutations = 10;
+  timer.Reset();
+  for (std::size_t i = 0; i < kMutations; ++i)
+    victim.DeleteNode(Pick(nodes, rng));
+  report("DeleteNode", timer.Seconds(), kMutations);
+
+  int fresh = static_cast<int>(num_nodes);
+  timer.Reset();
+  for (std::size_t i = 0; i < kMutations; ++i) {
+    const int old_node = Pick(nodes, rng);
+    if (victim.IsNode(old_node))
+      victim.Replace(old_node, fresh++);
+  }
+  report("Replace", timer.Seconds(), kMutations);
+
+  timer.Reset();
+  for (std::size_t i = 0; i < kMutations; ++i) {
+    const int old_node = Pick(nodes, rng);
+    const int new_node = Pick(nodes, rng);
+    if (old_node != new_node && victim.IsNode(old_node) && victim.IsNode(new_node))
+      victim.MergeReplace(old_node, new_node);
+  }
+  report("MergeReplace", timer.Seconds(), kMutations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto min_edges = bm::Arg(argc, argv, "min_edges", 1000);
+  const auto max_edges = bm::Arg(argc, argv, "max_edges", 100000);
+  const auto degree = std::max<std::size_t>(1, bm::Arg(argc, argv, "degree", 8));
+  const auto max_insert_edges = bm::Arg(argc, argv, "max_insert_edges", 1000000);
+  const auto queries = bm::Arg(argc, argv, "queries", 100000);
+  std::mt19937_64 rng{bm::Arg(argc, argv, "seed", 42)};
+
+  bm::Reporter reporter;
+  for (std::size_t edges = min_edges; edges <= max_edges; edges *= 10) {
+    for (auto distribution : {Distribution::kUniform, Distribution::kPowerLaw})
+      Run(edges, degree, distribution, max_insert_edges, queries, rng, reporter);
+  }
+  reporter.Print(std::cout);
+}
@@ -0,0 +1,154 @@
+#ifndef ASSIGNMENTS_DG_GRAPH_MEMORY_H_
+#define ASSIGNMENTS_DG_GRAPH_MEMORY_H_
+
+// Memory accounting and allocation for Graph. Every container and heap block a Graph owns is
+// allocated through a TrackingAllocator tagged with one of the categories below, so
+// Graph::MemoryUsage() reports the bytes actually requested rather than an estimate. Heap memory
+// owned by the node and weight values themselves (a long std::string's buffer, say) isn't
+// included, and neither is allocator overhead (malloc headers and rounding).
+//
+// The blocks come from a std::pmr::memory_resource: the default resource unless the Graph was
+// given another one, or a monotonic arena the Graph owns (see ArenaOptions).
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+
+namespace gdwg {
+
+enum class MemoryCategory {
+  kNodeMap,     // std::map nodes: the Node handle and the (empty) edge set header per node
+  kEdgeSets,    // std::set nodes: the Edge (two weak_ptrs and a shared_ptr) per edge
+  kNodeValues,  // shared_ptr<N> control blocks, each holding one node value
+  kWeights,     // shared_ptr<E> control blocks, each holding one edge weight
+};
+constexpr std::size_t kNumMemoryCategories = static_cast<std::size_t>(MemoryCategory::kWeights) + 1;
+
+struct MemoryBreakdown {
+  std::size_t node_map = 0;
+  std::size_t edge_sets = 0;
+  std::size_t node_values = 0;
+  std::size_t weights = 0;
+
+  std::size_t Total() const noexcept { return node_map + edge_sets + node_values + weights; }
+
+  friend std::ostream& operator<<(std::ostream& os, const MemoryBreakdown& m) {
+    return os << "node_map=" << m.node_map << " edge_sets=" << m.edge_sets
+              << " node_values=" << m.node_values << " weights=" << m.weights
+              << " total=" << m.Total();
+  }
+};
+
+// A Graph built with these owns a std::pmr::monotonic_buffer_resource and takes every block
+// from it. Nothing is returned to the arena until the graph is cleared or destroyed, when the
+// whole arena is released at once; if N and E are trivially destructible that takes O(1) time
+// however big the graph is. Suits short-lived graphs that are built, queried and dropped.
+// Deleting nodes or edges doesn't free their memory, so long-lived graphs with a lot of churn
+// are better off with a pooling resource.
+struct ArenaOptions {
+  // size of the arena's first block; later blocks grow geometrically
+  std::size_t initial_bytes = 64 * 1024;
+  // where the arena gets its blocks, the default resource if null
+  std::pmr::memory_resource* upstream = nullptr;
+};
+
+namespace detail {
+
+// The resource a Graph allocates from and the bytes currently allocated in each category.
+// Lives on the heap so its address survives moving the Graph that owns it; every allocator (and
+// every shared_ptr control block) points at it.
+class MemoryCounters {
+ public:
+  explicit MemoryCounters(std::pmr::memory_resource* resource) noexcept : resource_{resource} {}
+  explicit MemoryCounters(const ArenaOptions& options) {
+    arena_.emplace(options.initial_bytes,
+                   options.upstream != nullptr ? options.upstream
+                                               : std::pmr::get_default_resource());
+    resource_ = &*arena_;
+  }
+  MemoryCounters(const MemoryCounters&) = delete;
+  MemoryCounters& operator=(const MemoryCounters&) = delete;
+
+  void* Allocate(MemoryCategory category, std::size_t bytes, std::size_t alignment) {
+    void* p = resource_->allocate(bytes, alignment);
+    bytes_[static_cast<std::size_t>(category)] += bytes;
+    return p;
+  }
+  void Deallocate(MemoryCategory category, void* p, std::size_t bytes, std::size_t alignment) {
+    bytes_[static_cast<std::size_t>(category)] -= bytes;
+    resource_->deallocate(p, bytes, alignment);
+  }
+
+  std::pmr::memory_resource* Resource() const noexcept { return resource_; }
+  bool IsArena() const noexcept { return arena_.has_value(); }
+  // Returns every block to the arena's upstream. Only call once nothing allocated from it is
+  // still in use.
+  void ReleaseArena() noexcept {
+    arena_->release();
+    bytes_ = {};
+  }
+
+  MemoryBreakdown Breakdown() const noexcept {
+    return {bytes_[0], bytes_[1], bytes_[2], bytes_[3]};
+  }
+
+ private:
+  std::optional<std::pmr::monotonic_buffer_resource> arena_;
+  std::pmr::memory_resource* resource_;
+  std::array<std::size_t, kNumMemoryCategories> bytes_{};
+};
+
+// Allocates from a MemoryCounters' resource and charges what it allocates to one of its
+// categories. The category is part of the type, so it survives the rebinding std::map, std::set
+// and std::allocate_shared do internally.
+template <typename T, MemoryCategory C>
+class TrackingAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  template <typename U>
+  struct rebind {
+    using other = TrackingAllocator<U, C>;
+  };
+
+  explicit TrackingAllocator(MemoryCounters* counters) noexcept : counters_{counters} {}
+  template <typename U>
+  TrackingAllocator(const TrackingAllocator<U, C>& other) noexcept
+    : counters_{other.counters_} {}
+
+  T* allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length{};
+    }
+    return static_cast<T*>(counters_->Allocate(C, n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, std::size_t n) noexcept {
+    counters_->Deallocate(C, p, n * sizeof(T), alignof(T));
+  }
+
+  friend bool operator==(const TrackingAllocator& lhs, const TrackingAllocator& rhs) noexcept {
+    return lhs.counters_ == rhs.counters_;
+  }
+  friend bool operator!=(const TrackingAllocator& lhs, const TrackingAllocator& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+ private:
+  MemoryCounters* counters_;
+
+  template <typename U, MemoryCategory D>
+  friend class TrackingAllocator;
+};
+
+}  // namespace detail
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_GRAPH_MEMORY_H_
@@ -0,0 +1,301 @@
+/*
+  Tests for Graph::MemoryUsage and the memory resources a Graph can allocate from.
+  Exact byte counts depend on the standard library, so these check how the breakdown
+  moves as the graph changes: it grows in the right category, returns to where it was
+  when something is removed, and follows the graph through copies and moves. A
+  counting memory_resource checks that every block really comes from the resource
+  (or arena) the graph was given.
+*/
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <utility>
+
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+SCENARIO("An empty graph has allocated nothing") {
+  GIVEN("a default constructed graph") {
+    gdwg::Graph<int, int> g;
+    THEN("every category is zero") {
+      REQUIRE(g.MemoryUsage().Total() == 0);
+    }
+  }
+}
+
+SCENARIO("Each kind of insertion is charged to its own category") {
+  GIVEN("a graph with one node") {
+    gdwg::Graph<int, double> g{1};
+    const auto one_node = g.MemoryUsage();
+    THEN("the node is in the node map and has a value block") {
+      REQUIRE(one_node.node_map > 0);
+      REQUIRE(one_node.node_values >= sizeof(int));
+      REQUIRE(one_node.edge_sets == 0);
+      REQUIRE(one_node.weights == 0);
+    }
+    WHEN("a second node and an edge are added") {
+      g.InsertNode(2);
+      g.InsertEdge(1, 2, 0.5);
+      const auto m = g.MemoryUsage();
+      THEN("nodes cost twice as much and the edge has a set node and a weight block") {
+        REQUIRE(m.node_map == 2 * one_node.node_map);
+        REQUIRE(m.node_values == 2 * one_node.node_values);
+        REQUIRE(m.edge_sets > 0);
+        REQUIRE(m.weights >= sizeof(double));
+      }
+      AND_WHEN("a duplicate edge is rejected") {
+        REQUIRE_FALSE(g.InsertEdge(1, 2, 0.5));
+        THEN("nothing is left allocated for it") {
+          REQUIRE(g.MemoryUsage().Total() == m.Total());
+        }
+      }
+      AND_WHEN("the edge is erased") {
+        g.erase(1, 2, 0.5);
+        THEN("the graph is back to two nodes' worth") {
+          REQUIRE(g.MemoryUsage().edge_sets == 0);
+          REQUIRE(g.MemoryUsage().weights == 0);
+          REQUIRE(g.MemoryUsage().node_map == m.node_map);
+        }
+      }
+      AND_WHEN("a node is deleted") {
+        g.DeleteNode(2);
+        THEN("its value block and its incoming edge are released") {
+          REQUIRE(g.MemoryUsage().Total() == one_node.Total());
+        }
+      }
+      AND_WHEN("the graph is cleared") {
+        g.Clear();
+        THEN("everything is released") {
+          REQUIRE(g.MemoryUsage().Total() == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Copies and moves carry their accounting with them") {
+  GIVEN("a graph with some edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 2);
+    g.InsertEdge("c", "a", 3);
+    const auto before = g.MemoryUsage();
+    WHEN("it is copied") {
+      gdwg::Graph<std::string, int> copy{g};
+      THEN("the copy owns an identical set of blocks") {
+        REQUIRE(copy == g);
+        REQUIRE(copy.MemoryUsage().Total() == before.Total());
+        REQUIRE(copy.MemoryUsage().node_values == before.node_values);
+        REQUIRE(g.MemoryUsage().Total() == before.Total());
+      }
+      AND_WHEN("the copy is changed") {
+        copy.DeleteNode("b");
+        THEN("the original is untouched") {
+          REQUIRE(g.IsConnected("a", "b"));
+          REQUIRE(g.NumEdges() == 3);
+          REQUIRE(g.MemoryUsage().Total() == before.Total());
+          REQUIRE(copy.MemoryUsage().Total() < before.Total());
+        }
+      }
+    }
+    WHEN("it is moved from") {
+      gdwg::Graph<std::string, int> moved{std::move(g)};
+      THEN("the usage moves with the contents") {
+        REQUIRE(moved.MemoryUsage().Total() == before.Total());
+        REQUIRE(g.MemoryUsage().Total() == 0);
+      }
+    }
+    WHEN("another graph is move assigned from it") {
+      gdwg::Graph<std::string, int> other{"x"};
+      other = std::move(g);
+      THEN("the target reports the moved contents") {
+        REQUIRE(other.MemoryUsage().Total() == before.Total());
+        REQUIRE(other.NumEdges() == 3);
+      }
+    }
+  }
+}
+
+namespace {
+
+// a memory_resource that forwards to new/delete and keeps count
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  std::size_t live_bytes = 0;
+  std::size_t allocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    live_bytes += bytes;
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    live_bytes -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+template <typename N>
+void AddRing(gdwg::Graph<N, int>& g, int n, N (*value)(int)) {
+  for (int i = 0; i < n; ++i) {
+    g.InsertNode(value(i));
+  }
+  for (int i = 0; i < n; ++i) {
+    g.InsertEdge(value(i), value((i + 1) % n), i);
+    g.InsertEdge(value(i), value((i + 2) % n), i);
+  }
+}
+
+int AsInt(int i) {
+  return i;
+}
+std::string AsString(int i) {
+  return "a node name too long for the small string buffer " + std::to_string(i);
+}
+
+}  // namespace
+
+SCENARIO("A graph allocates only from the resource it is given") {
+  GIVEN("a graph built on a counting resource") {
+    CountingResource resource;
+    {
+      gdwg::Graph<int, int> g{&resource};
+      AddRing(g, 100, AsInt);
+      THEN("the resource holds exactly what the graph accounts for") {
+        REQUIRE(g.Resource() == &resource);
+        REQUIRE(resource.live_bytes == g.MemoryUsage().Total());
+        REQUIRE(resource.allocations == 100 + 100 + 200 + 200);
+      }
+    }
+    WHEN("the graph is destroyed") {
+      THEN("everything has been handed back") {
+        REQUIRE(resource.live_bytes == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("An arena graph allocates in a few large blocks and releases them on Clear") {
+  GIVEN("an arena graph whose arena draws from a counting resource") {
+    CountingResource upstream;
+    gdwg::Graph<int, int> g{gdwg::ArenaOptions{1024, &upstream}};
+    AddRing(g, 1000, AsInt);
+    const auto usage = g.MemoryUsage();
+    THEN("thousands of nodes and edges took a handful of upstream allocations") {
+      REQUIRE(g.NumEdges() == 2000);
+      REQUIRE(upstream.allocations < 20);
+      REQUIRE(upstream.live_bytes >= usage.Total());
+      REQUIRE(g.Resource() != &upstream);
+    }
+    WHEN("it is cleared") {
+      g.Clear();
+      THEN("the arena is released in full") {
+        REQUIRE(g.IsEmpty());
+        REQUIRE(g.MemoryUsage().Total() == 0);
+        REQUIRE(upstream.live_bytes == 0);
+      }
+      AND_WHEN("it is rebuilt") {
+        AddRing(g, 1000, AsInt);
+        THEN("it is as good as new") {
+          REQUIRE(g.NumEdges() == 2000);
+          REQUIRE(g.IsConnected(999, 0));
+          REQUIRE(g.MemoryUsage().Total() == usage.Total());
+        }
+      }
+    }
+    WHEN("nodes and edges are removed") {
+      g.DeleteNode(0);
+      g.erase(1, 2, 1);
+      THEN("their accounting goes but the arena keeps the memory until Clear") {
+        REQUIRE(g.MemoryUsage().Total() < usage.Total());
+        REQUIRE(upstream.live_bytes >= usage.Total());
+      }
+    }
+  }
+}
+
+SCENARIO("Arena graphs with non-trivial values are cleared and destroyed safely") {
+  GIVEN("an arena graph with long string nodes") {
+    CountingResource upstream;
+    {
+      gdwg::Graph<std::string, int> g{gdwg::ArenaOptions{1024, &upstream}};
+      AddRing(g, 200, AsString);
+      WHEN("it is cleared and reused") {
+        g.Clear();
+        REQUIRE(upstream.live_bytes == 0);
+        AddRing(g, 10, AsString);
+        THEN("the new contents are intact") {
+          REQUIRE(g.NumNodes() == 10);
+          REQUIRE(g.GetConnected(AsString(9)).size() == 2);
+        }
+      }
+    }
+    THEN("destroying it returns the arena upstream") {
+      REQUIRE(upstream.live_bytes == 0);
+    }
+  }
+}
+
+SCENARIO("Copies and moves of arena graphs") {
+  GIVEN("an arena graph") {
+    CountingResource upstream;
+    gdwg::Graph<int, int> g{gdwg::ArenaOptions{1024, &upstream}};
+    AddRing(g, 50, AsInt);
+    WHEN("it is copied") {
+      const gdwg::Graph<int, int> copy{g};
+      THEN("the copy allocates from the default resource") {
+        REQUIRE(copy == g);
+        REQUIRE(copy.Resource() == std::pmr::get_default_resource());
+      }
+    }
+    WHEN("it is copy assigned to a graph on another resource") {
+      CountingResource resource;
+      gdwg::Graph<int, int> target{&resource};
+      target = g;
+      THEN("the target keeps its own resource") {
+        REQUIRE(target == g);
+        REQUIRE(target.Resource() == &resource);
+        REQUIRE(resource.live_bytes == target.MemoryUsage().Total());
+      }
+    }
+    WHEN("it is moved and the source cleared") {
+      gdwg::Graph<int, int> moved{std::move(g)};
+      g.Clear();
+      THEN("the arena moved with the contents") {
+        REQUIRE(moved.NumEdges() == 100);
+        REQUIRE(moved.IsConnected(49, 1));
+        REQUIRE(upstream.live_bytes >= moved.MemoryUsage().Total());
+      }
+    }
+  }
+}
+
+SCENARIO("Clone copies a graph onto the resource of your choice") {
+  GIVEN("a graph on the default resource") {
+    gdwg::Graph<std::string, int> g;
+    AddRing(g, 300, AsString);
+    WHEN("it is cloned onto a counting resource") {
+      CountingResource resource;
+      const auto copy = g.Clone(&resource);
+      THEN("the clone is equal and every block came from that resource") {
+        REQUIRE(copy == g);
+        REQUIRE(copy.Resource() == &resource);
+        REQUIRE(resource.live_bytes == copy.MemoryUsage().Total());
+        REQUIRE(copy.MemoryUsage().Total() == g.MemoryUsage().Total());
+      }
+    }
+    WHEN("it is cloned into an arena") {
+      CountingResource upstream;
+      const auto copy = g.Clone(gdwg::ArenaOptions{1024, &upstream});
+      THEN("the arena is sized up front, so the whole clone is one upstream allocation") {
+        REQUIRE(copy == g);
+        REQUIRE(upstream.allocations == 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,142 @@
+#ifndef ASSIGNMENTS_DG_GRAPH_STATS_H_
+#define ASSIGNMENTS_DG_GRAPH_STATS_H_
+
+// Opt-in operation counters for Graph. Build everything (every translation unit that includes
+// graph.h) with -DGDWG_GRAPH_STATS to turn them on; otherwise the hooks below compile to
+// nothing and Graph has no Stats() at all.
+//
+// Counts are kept per graph and per public method. Work done by a method on behalf of another
+// (e.g. the InsertEdge calls inside Replace) is charged to the outermost method. Counting isn't
+// synchronised, so don't read or reset a graph's stats while another thread uses the graph.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+namespace gdwg {
+
+enum class GraphOp {
+  kInsertNode,
+  kInsertEdge,
+  kDeleteNode,
+  kIsNode,
+  kIsConnected,
+  kGetNodes,
+  kGetConnected,
+  kGetWeights,
+  kReplace,
+  kMergeReplace,
+  kErase,
+  kFind,
+  kCopy,
+  kEqual,
+  kWrite,
+  kPartitions,
+};
+constexpr std::size_t kNumGraphOps = static_cast<std::size_t>(GraphOp::kPartitions) + 1;
+
+inline const char* NameOf(GraphOp op) noexcept {
+  constexpr const char* kNames[kNumGraphOps] = {
+      "InsertNode",   "InsertEdge", "DeleteNode", "IsNode", "IsConnected", "GetNodes",
+      "GetConnected", "GetWeights", "Replace",    "MergeReplace", "erase", "find",
+      "Copy",         "operator==", "Write",      "Partitions"};
+  return kNames[static_cast<std::size_t>(op)];
+}
+
+struct OpCounters {
+  std::uint64_t calls = 0;
+  // Node values made with make_shared, including the temporary Node every lookup builds
+  std::uint64_t node_allocations = 0;
+  // edge weights made with make_shared
+  std::uint64_t edge_allocations = 0;
+  // shared_ptr control blocks created (node_allocations + edge_allocations)
+  std::uint64_t shared_ptr_creations = 0;
+  // NodeCmp calls, i.e. node map nodes visited
+  std::uint64_t node_comparisons = 0;
+  // EdgeCmp calls, i.e. edge set nodes visited
+  std::uint64_t edge_comparisons = 0;
+  std::uint64_t weak_ptr_locks = 0;
+  // searches of the node map (find, emplace, erase by key)
+  std::uint64_t map_lookups = 0;
+  // edges stepped over by linear scans of edge sets
+  std::uint64_t edge_scans = 0;
+};
+
+struct GraphStats {
+  std::array<OpCounters, kNumGraphOps> ops{};
+
+  const OpCounters& operator[](GraphOp op) const noexcept {
+    return ops[static_cast<std::size_t>(op)];
+  }
+
+  // one line per method that was called, with every counter
+  friend std::ostream& operator<<(std::ostream& os, const GraphStats& stats) {
+    for (std::size_t i = 0; i < kNumGraphOps; ++i) {
+      const auto& c = stats.ops[i];
+      if (c.calls == 0) {
+        continue;
+      }
+      os << NameOf(static_cast<GraphOp>(i)) << ": calls=" << c.calls
+         << " node_allocations=" << c.node_allocations
+         << " edge_allocations=" << c.edge_allocations
+         << " shared_ptr_creations=" << c.shared_ptr_creations
+         << " node_comparisons=" << c.node_comparisons
+         << " edge_comparisons=" << c.edge_comparisons << " weak_ptr_locks=" << c.weak_ptr_locks
+         << " map_lookups=" << c.map_lookups << " edge_scans=" << c.edge_scans << '\n';
+    }
+    return os;
+  }
+};
+
+namespace detail {
+
+#ifdef GDWG_GRAPH_STATS
+// the counters of the outermost Graph method running on this thread, if any
+inline thread_local OpCounters* current_counters = nullptr;
+
+class OpScope {
+ public:
+  OpScope(GraphStats& stats, GraphOp op) noexcept : outermost_{current_counters == nullptr} {
+    if (outermost_) {
+      current_counters = &stats.ops[static_cast<std::size_t>(op)];
+      ++current_counters->calls;
+    }
+  }
+  OpScope(const OpScope&) = delete;
+  OpScope& operator=(const OpScope&) = delete;
+  ~OpScope() {
+    if (outermost_) {
+      current_counters = nullptr;
+    }
+  }
+
+ private:
+  const bool outermost_;
+};
+
+inline void Count(std::uint64_t OpCounters::*counter, std::uint64_t n = 1) noexcept {
+  if (current_counters != nullptr) {
+    current_counters->*counter += n;
+  }
+}
+
+#define GDWG_STATS_SCOPE(stats, op) const ::gdwg::detail::OpScope gdwg_stats_scope_{stats, op}
+#define GDWG_STATS_COUNT(counter) ::gdwg::detail::Count(&::gdwg::OpCounters::counter)
+#else
+#define GDWG_STATS_SCOPE(stats, op) static_cast<void>(0)
+#define GDWG_STATS_COUNT(counter) static_cast<void>(0)
+#endif
+
+// weak_ptr::lock, counted
+template <typename T>
+std::shared_ptr<T> Lock(const std::weak_ptr<T>& ptr) noexcept {
+  GDWG_STATS_COUNT(weak_ptr_locks);
+  return ptr.lock();
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_GRAPH_STATS_H_
@@ -0,0 +1,132 @@
+/*
+  Tests for the operation counters in graph_stats.h. This file is built with
+  -DGDWG_GRAPH_STATS; the counts checked here are the ones the current Graph
+  implementation performs, so a change that alters them should update this test.
+*/
+
+#include <sstream>
+#include <string>
+
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+using gdwg::GraphOp;
+
+SCENARIO("Each public method counts its own calls") {
+  GIVEN("a fresh graph") {
+    gdwg::Graph<std::string, int> g;
+    WHEN("a few methods are called") {
+      g.InsertNode("a");
+      g.InsertNode("b");
+      g.InsertEdge("a", "b", 1);
+      g.IsNode("a");
+      THEN("each is charged one call and nothing else is") {
+        const auto stats = g.Stats();
+        REQUIRE(stats[GraphOp::kInsertNode].calls == 2);
+        REQUIRE(stats[GraphOp::kInsertEdge].calls == 1);
+        REQUIRE(stats[GraphOp::kIsNode].calls == 1);
+        REQUIRE(stats[GraphOp::kDeleteNode].calls == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Nested calls are charged to the outermost method") {
+  GIVEN("a graph with an edge into the node being replaced") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 2);
+    g.ResetStats();
+    WHEN("MergeReplace calls InsertEdge and DeleteNode internally") {
+      g.MergeReplace("b", "c");
+      THEN("only MergeReplace has a call") {
+        const auto stats = g.Stats();
+        REQUIRE(stats[GraphOp::kMergeReplace].calls == 1);
+        REQUIRE(stats[GraphOp::kInsertEdge].calls == 0);
+        REQUIRE(stats[GraphOp::kDeleteNode].calls == 0);
+        REQUIRE(stats[GraphOp::kMergeReplace].edge_allocations == 2);
+      }
+    }
+  }
+}
+
+SCENARIO("InsertEdge's lookups and scans are counted") {
+  GIVEN("a source node with three outgoing edges") {
+    gdwg::Graph<int, int> g{1, 2, 3, 4};
+    g.InsertEdge(1, 2, 1);
+    g.InsertEdge(1, 3, 1);
+    g.InsertEdge(1, 4, 1);
+    g.ResetStats();
+    WHEN("a fourth edge is inserted") {
+      g.InsertEdge(1, 4, 2);
+      THEN("it searches the map five times and scans the whole edge set") {
+        const auto c = g.Stats()[GraphOp::kInsertEdge];
+        REQUIRE(c.calls == 1);
+        REQUIRE(c.map_lookups == 5);
+        REQUIRE(c.edge_scans == 3);
+        REQUIRE(c.edge_allocations == 1);
+        REQUIRE(c.shared_ptr_creations == c.node_allocations + c.edge_allocations);
+        REQUIRE(c.weak_ptr_locks >= 3);
+        REQUIRE(c.node_comparisons > 0);
+        REQUIRE(c.edge_comparisons > 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Lookups build a temporary Node") {
+  GIVEN("a graph") {
+    gdwg::Graph<int, int> g{1, 2, 3};
+    g.ResetStats();
+    WHEN("IsNode is called") {
+      g.IsNode(2);
+      THEN("it does one map lookup and allocates one node for it") {
+        const auto c = g.Stats()[GraphOp::kIsNode];
+        REQUIRE(c.map_lookups == 1);
+        REQUIRE(c.node_allocations == 1);
+        REQUIRE(c.edge_scans == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Stats can be reset and printed") {
+  GIVEN("a graph with some recorded work") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, 3);
+    WHEN("the stats are printed") {
+      std::ostringstream os;
+      os << g.Stats();
+      THEN("only methods that ran are listed") {
+        REQUIRE(os.str().find("InsertEdge: calls=1") != std::string::npos);
+        REQUIRE(os.str().find("DeleteNode") == std::string::npos);
+      }
+    }
+    WHEN("they are reset") {
+      g.ResetStats();
+      THEN("every counter is zero") {
+        for (const auto& c : g.Stats().ops) {
+          REQUIRE(c.calls == 0);
+          REQUIRE(c.map_lookups == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Const methods count through a const graph") {
+  GIVEN("a const graph") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, 3);
+    g.InsertEdge(1, 2, 4);
+    g.ResetStats();
+    const auto& cg = g;
+    WHEN("GetWeights is called on it") {
+      cg.GetWeights(1, 2);
+      THEN("the scan of the source's edges is counted") {
+        REQUIRE(cg.Stats()[GraphOp::kGetWeights].calls == 1);
+        REQUIRE(cg.Stats()[GraphOp::kGetWeights].edge_scans == 2);
+      }
+    }
+  }
+}
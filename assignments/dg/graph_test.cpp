@@ -464,6 +464,20 @@ SCENARIO("Graph copy constructor/assignment work") {
         REQUIRE(cp.GetConnected(s2)[0] == s3);
       }
     }
+
+    WHEN("a copy is changed") {
+      gdwg::Graph<std::string, double> cp{g};
+      cp.DeleteNode(s2);
+      cp.Replace(s1, "hi");
+      THEN("the original keeps its nodes and edges") {
+        REQUIRE(g.IsNode(s1));
+        REQUIRE(g.IsConnected(s1, s2));
+        REQUIRE(g.IsConnected(s2, s3));
+        REQUIRE(g.NumEdges() == 2);
+        REQUIRE(cp.NumEdges() == 0);
+        REQUIRE(cp.GetNodes() == std::vector<std::string>{"are", "hi"});
+      }
+    }
   }
 }
 
@@ -1150,13 +1164,153 @@ SCENARIO("Const graphs can call appropriate const member functions") {
       ss << g;
       std::string string1;
       int i = 0;
+      std::vector<std::string> expected = {
+          "1 (", "  5 | -1", ")",       "2 (",      "  1 | 1", "  4 | 2", ")",      "3 (",
+          "  2 | 2", "  6 | -8", ")",   "4 (",      "  1 | -4", "  5 | 3", ")",     "5 (",
+          "  2 | 7", ")",        "6 (", "  2 | -10", "  2 | 5", "  3 | 10", ")"};
       while (getline(ss, string1)) {
-        std::vector<std::string> expected = {
-            "1 (", "  5 | -1", ")",        "2 (", "  1 | 1", "  4 | 2",  ")",
-            "3 (", "  2 | 2",  "  6 | -8", ")",   "4 (",     "  1 | -4", "  5 | 3",
-            "5 (", "  2 | 7",  ")",        "6 (", "  2 | 5", "  3 | 10", ")"};
+        REQUIRE(i < static_cast<int>(expected.size()));
         REQUIRE(string1 == expected[i++]);
       }
+      REQUIRE(i == static_cast<int>(expected.size()));
+    }
+  }
+}
+
+SCENARIO("Graph Partitions splits edges into balanced ranges") {
+  GIVEN("Graph with uneven out degrees and empty nodes in between") {
+    gdwg::Graph<int, int> g{1, 2, 3, 4, 5, 6};
+    for (int w = 0; w < 7; ++w)
+      REQUIRE(g.InsertEdge(1, 2, w));
+    REQUIRE(g.InsertEdge(3, 1, 0));
+    REQUIRE(g.InsertEdge(5, 6, 1));
+    REQUIRE(g.InsertEdge(5, 6, 2));
+    WHEN("edges are split into 3 partitions") {
+      auto parts = g.Partitions(3);
+      THEN("partitions differ in size by at most one and cover every edge in order") {
+        REQUIRE(parts.size() == 3);
+        std::vector<std::tuple<int, int, int>> edges;
+        for (const auto& part : parts) {
+          REQUIRE(part.size() >= 3);
+          REQUIRE(part.size() <= 4);
+          std::size_t count = 0;
+          for (const auto& [from, to, weight] : part) {
+            edges.emplace_back(from, to, weight);
+            ++count;
+          }
+          REQUIRE(count == part.size());
+        }
+        std::vector<std::tuple<int, int, int>> expected{g.begin(), g.end()};
+        REQUIRE(edges == expected);
+      }
+    }
+    WHEN("a split point falls exactly on a node boundary") {
+      auto parts = g.Partitions(10);
+      THEN("every partition holds exactly one edge") {
+        for (const auto& part : parts) {
+          REQUIRE(part.size() == 1);
+          REQUIRE(std::next(part.begin()) == part.end());
+        }
+        REQUIRE(parts.back().end() == g.end());
+      }
+    }
+    WHEN("more partitions than edges are requested") {
+      auto parts = g.Partitions(25);
+      THEN("the extra partitions are empty") {
+        std::size_t total = 0;
+        for (const auto& part : parts) {
+          total += part.size();
+          if (part.size() == 0)
+            REQUIRE(part.begin() == part.end());
+        }
+        REQUIRE(parts.size() == 25);
+        REQUIRE(total == g.NumEdges());
+      }
+    }
+    THEN("asking for zero partitions throws") {
+      REQUIRE_THROWS_WITH(g.Partitions(0), "Cannot call Graph::Partitions with zero partitions");
+    }
+  }
+}
+
+SCENARIO("Graph Write formats into the given stream") {
+  GIVEN("Graph of doubles weighted by doubles") {
+    gdwg::Graph<double, double> g{0.5, 2};
+    g.InsertEdge(0.5, 2, 1.0 / 3);
+    g.InsertEdge(0.5, 2, 0.1);
+    g.InsertEdge(2, 2, 1e-7);
+    WHEN("operator<< is used") {
+      std::ostringstream os;
+      os << g;
+      THEN("the stream's default formatting is used") {
+        REQUIRE(os.str() == "0.5 (\n  2 | 0.1\n  2 | 0.333333\n)\n2 (\n  2 | 1e-07\n)\n");
+      }
+    }
+    WHEN("the stream has its own precision") {
+      std::ostringstream os;
+      os << std::fixed;
+      os.precision(2);
+      g.Write(os);
+      THEN("Write honours it") {
+        REQUIRE(os.str() == "0.50 (\n  2.00 | 0.10\n  2.00 | 0.33\n)\n2.00 (\n  2.00 | 0.00\n)\n");
+      }
+    }
+    WHEN("to_chars formatting is requested") {
+      std::ostringstream os;
+      g.Write(os, gdwg::NumberFormat::kToChars);
+      THEN("values are printed in their shortest round trip form") {
+        REQUIRE(os.str() ==
+                "0.5 (\n  2 | 0.1\n  2 | 0.3333333333333333\n)\n2 (\n  2 | 1e-07\n)\n");
+      }
+    }
+  }
+  GIVEN("Graph of chars weighted by strings") {
+    gdwg::Graph<char, std::string> g{'a', 'b'};
+    g.InsertEdge('a', 'b', "x");
+    g.InsertEdge('a', 'b', "y");
+    THEN("both formats print characters and strings through the stream") {
+      std::ostringstream stream;
+      std::ostringstream to_chars;
+      g.Write(stream);
+      g.Write(to_chars, gdwg::NumberFormat::kToChars);
+      REQUIRE(stream.str() == "a (\n  b | x\n  b | y\n)\nb (\n)\n");
+      REQUIRE(to_chars.str() == stream.str());
+    }
+  }
+  GIVEN("Graph large enough to need several buffer flushes") {
+    gdwg::Graph<int, int> g;
+    std::ostringstream expected;
+    for (int i = 0; i < 300; ++i) {
+      g.InsertNode(i);
+    }
+    for (int i = 0; i < 300; ++i) {
+      expected << i << " (\n";
+      for (int j = 0; j < 300; j += 7) {
+        g.InsertEdge(i, j, i - j);
+        expected << "  " << j << " | " << i - j << "\n";
+      }
+      expected << ")\n";
+    }
+    THEN("the output is complete and in order") {
+      std::ostringstream os;
+      os << g;
+      REQUIRE(os.str() == expected.str());
+    }
+    THEN("a stream tied to the output is flushed per big write, not per value") {
+      struct CountsSyncs : std::stringbuf {
+        int syncs = 0;
+        int sync() override {
+          ++syncs;
+          return 0;
+        }
+      };
+      CountsSyncs tied_buffer;
+      std::ostream tied{&tied_buffer};
+      std::ostringstream os;
+      os.tie(&tied);
+      os << g;
+      REQUIRE(os.str() == expected.str());
+      REQUIRE(tied_buffer.syncs < 10);
     }
   }
 }
@@ -0,0 +1,127 @@
+#ifndef ASSIGNMENTS_DG_INTERSECT_H_
+#define ASSIGNMENTS_DG_INTERSECT_H_
+
+// Intersection of two strictly increasing arrays of 32-bit ids, used to merge sorted label and
+// neighbour lists. On x86-64 (where SSE2 is always available) the arrays are walked four ids at
+// a time: each block of a is compared against all four rotations of the current block of b,
+// giving the matches among the 16 pairs in four compares, and whichever block ends lower is
+// advanced. What's left after the last full blocks is merged one id at a time.
+//
+// When one array is much shorter than the other, walking the longer one is wasted work, so
+// ForEachCommonAdaptive gallops instead: each id of the shorter array is looked for in the
+// longer by doubling steps then a binary search, for O(short * log(long / short)).
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace gdwg {
+namespace detail {
+
+// ForEachCommon below, one id at a time
+template <typename Fn>
+void ForEachCommonMerge(const std::uint32_t* a,
+                        std::size_t na,
+                        const std::uint32_t* b,
+                        std::size_t nb,
+                        Fn&& fn) {
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      fn(i++, j++);
+    }
+  }
+}
+
+// calls fn(i, j) for every a[i] == b[j], in increasing order
+template <typename Fn>
+void ForEachCommon(const std::uint32_t* a,
+                   std::size_t na,
+                   const std::uint32_t* b,
+                   std::size_t nb,
+                   Fn&& fn) {
+  std::size_t i = 0;
+  std::size_t j = 0;
+#if defined(__SSE2__)
+  while (i + 4 <= na && j + 4 <= nb) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+    const __m128i eq = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                     _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+        _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                     _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+    // bit k is set if a[i + k] is somewhere in b's block
+    for (int mask = _mm_movemask_ps(_mm_castsi128_ps(eq)); mask != 0; mask &= mask - 1) {
+      const std::size_t k = i + static_cast<std::size_t>(__builtin_ctz(mask));
+      std::size_t l = j;
+      while (b[l] != a[k]) {
+        ++l;
+      }
+      fn(k, l);
+    }
+    const std::uint32_t a_last = a[i + 3];
+    const std::uint32_t b_last = b[j + 3];
+    i += a_last <= b_last ? 4 : 0;
+    j += b_last <= a_last ? 4 : 0;
+  }
+#endif
+  ForEachCommonMerge(a + i, na - i, b + j, nb - j, [&](std::size_t k, std::size_t l) {
+    fn(i + k, j + l);
+  });
+}
+
+// ForEachCommon by galloping through b for each id of a, best when a is much the shorter
+template <typename Fn>
+void ForEachCommonGalloping(const std::uint32_t* a,
+                            std::size_t na,
+                            const std::uint32_t* b,
+                            std::size_t nb,
+                            Fn&& fn) {
+  std::size_t j = 0;
+  for (std::size_t i = 0; i < na && j < nb; ++i) {
+    // b[j + step / 2] < a[i], until b[j + step] isn't or runs off the end
+    std::size_t step = 1;
+    while (j + step < nb && b[j + step] < a[i]) {
+      step *= 2;
+    }
+    j = static_cast<std::size_t>(
+        std::lower_bound(b + j + step / 2, b + std::min(j + step, nb), a[i]) - b);
+    if (j < nb && b[j] == a[i]) {
+      fn(i, j++);
+    }
+  }
+}
+
+// one array at least this many times longer than the other is galloped through
+constexpr std::size_t kGallopRatio = 32;
+
+// ForEachCommon, or ForEachCommonGalloping through the longer array if the two differ enough
+template <typename Fn>
+void ForEachCommonAdaptive(const std::uint32_t* a,
+                           std::size_t na,
+                           const std::uint32_t* b,
+                           std::size_t nb,
+                           Fn&& fn) {
+  if (na * kGallopRatio <= nb) {
+    ForEachCommonGalloping(a, na, b, nb, fn);
+  } else if (nb * kGallopRatio <= na) {
+    ForEachCommonGalloping(b, nb, a, na, [&](std::size_t j, std::size_t i) { fn(i, j); });
+  } else {
+    ForEachCommon(a, na, b, nb, fn);
+  }
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_INTERSECT_H_
@@ -0,0 +1,458 @@
+#ifndef ASSIGNMENTS_DG_JOURNAL_H_
+#define ASSIGNMENTS_DG_JOURNAL_H_
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "assignments/dg/codec.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/mapped_file.h"
+#include "assignments/dg/serialize.h"
+
+namespace gdwg {
+
+struct JournalOptions {
+  // records are buffered and written (and synced) together once this many have built up
+  std::size_t group_commit_records = 128;
+  // fdatasync after every group; without it a crash of the machine (not just the process) can
+  // lose the most recent groups
+  bool sync = true;
+  // Compact() runs by itself once the log grows past this many bytes; 0 never compacts
+  std::uint64_t compact_bytes = std::uint64_t{64} << 20;
+};
+
+// A Graph whose mutations are journaled to disk so that it survives crashes.
+//
+// dir holds a binary snapshot (see SaveBinary) and an append-only log of the mutations made
+// since, both tagged with a generation number:
+//   snapshot-<gen>.gdwg   the graph when the generation started (absent for generation 0)
+//   journal-<gen>.log     records of [uint32 size][uint32 checksum][op][Codec encoded args]
+// Opening a JournaledGraph loads the newest snapshot and replays its log, dropping a torn
+// record at the end; a bad record with more of the log after it fails recovery instead, as
+// dropping it would lose committed records. Compact() saves a new snapshot and starts the
+// next generation with an empty log; files are only renamed into place once complete, so a
+// crash at any point recovers either the old or the new generation.
+//
+// Only mutations that changed the graph are logged. Records are durable once Commit() returns
+// (or once a group fills up and commits on its own); the destructor commits what's left. A
+// Commit that fails to write cuts the log back to what was committed before it and keeps the
+// records, so it can be retried. One that fails to sync can't know what reached the disk, so
+// every later mutation, Commit and Compact throws.
+template <typename N, typename E>
+class JournaledGraph {
+ public:
+  explicit JournaledGraph(std::string dir, JournalOptions options = {});
+  JournaledGraph(const JournaledGraph&) = delete;
+  JournaledGraph& operator=(const JournaledGraph&) = delete;
+  ~JournaledGraph();
+
+  const Graph<N, E>& GetGraph() const noexcept { return graph_; }
+  std::uint64_t Generation() const noexcept { return generation_; }
+  // size of the current log, including records not yet committed
+  std::uint64_t LogBytes() const noexcept { return log_bytes_ + pending_.size(); }
+
+  bool InsertNode(const N& val);
+  bool InsertEdge(const N& src, const N& dst, const E& w);
+  bool DeleteNode(const N& node);
+  bool Replace(const N& oldData, const N& newData);
+  void MergeReplace(const N& oldData, const N& newData);
+  bool erase(const N& src, const N& dst, const E& w);
+  void Clear();
+
+  void Commit();
+  void Compact();
+
+ private:
+  enum class Op : std::uint8_t {
+    kInsertNode = 1,
+    kInsertEdge,
+    kDeleteNode,
+    kReplace,
+    kMergeReplace,
+    kErase,
+    kClear,
+  };
+  static constexpr std::size_t kRecordHeader = 2 * sizeof(std::uint32_t);
+
+  static std::uint32_t Checksum(const char* data, std::size_t size) noexcept;
+  std::string PathOf(const char* kind, std::uint64_t gen) const;
+  void Recover();
+  void Replay(const std::string& path);
+  void Apply(const char* in, const char* end);
+  template <typename... Args>
+  void Append(Op op, const Args&... args);
+  void OpenLog();
+  // fsyncs the file or directory at path, opened with flags, closing it whether or not that
+  // fails
+  void SyncPath(const std::string& path, int flags, const std::string& what) const;
+  void SyncDir() const;
+  // throws if a failed sync left the log in a state that can't be built on
+  void CheckWritable() const;
+  [[noreturn]] void Fail(const std::string& what) const;
+
+  std::string dir_;
+  JournalOptions options_;
+  Graph<N, E> graph_;
+  std::uint64_t generation_ = 0;
+  int fd_ = -1;
+  std::uint64_t log_bytes_ = 0;
+  std::string pending_;
+  std::size_t pending_records_ = 0;
+  bool failed_ = false;
+};
+
+template <typename N, typename E>
+JournaledGraph<N, E>::JournaledGraph(std::string dir, JournalOptions options)
+  : dir_{std::move(dir)}, options_{options} {
+  Recover();
+}
+
+template <typename N, typename E>
+JournaledGraph<N, E>::~JournaledGraph() {
+  try {
+    Commit();
+  } catch (...) {
+    // nothing sensible to do in a destructor; the records are lost like on a crash
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+template <typename N, typename E>
+std::uint32_t JournaledGraph<N, E>::Checksum(const char* data, std::size_t size) noexcept {
+  // FNV-1a
+  std::uint32_t hash = 2166136261u;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+  }
+  return hash;
+}
+
+template <typename N, typename E>
+std::string JournaledGraph<N, E>::PathOf(const char* kind, std::uint64_t gen) const {
+  const char* ext = std::strcmp(kind, "snapshot") == 0 ? ".gdwg" : ".log";
+  return (std::filesystem::path{dir_} / (kind + ("-" + std::to_string(gen)) + ext)).string();
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::Fail(const std::string& what) const {
+  throw std::runtime_error("JournaledGraph " + dir_ + ": " + what + ": " + std::strerror(errno));
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::Recover() {
+  namespace fs = std::filesystem;
+  fs::create_directories(dir_);
+  // the newest complete snapshot decides the generation
+  for (const auto& entry : fs::directory_iterator{dir_}) {
+    const auto name = entry.path().filename().string();
+    if (name.rfind("snapshot-", 0) != 0) {
+      continue;
+    }
+    const std::uint64_t gen = std::strtoull(name.c_str() + std::strlen("snapshot-"), nullptr, 10);
+    if (name == "snapshot-" + std::to_string(gen) + ".gdwg" && gen > generation_) {
+      generation_ = gen;
+    }
+  }
+  if (generation_ > 0) {
+    graph_ = LoadBinaryGraph<N, E>(PathOf("snapshot", generation_));
+  }
+  const auto log = PathOf("journal", generation_);
+  if (fs::exists(log)) {
+    Replay(log);
+  }
+  // anything else is an older generation or an unfinished compaction
+  const auto snapshot = PathOf("snapshot", generation_);
+  for (const auto& entry : fs::directory_iterator{dir_}) {
+    const auto path = entry.path().string();
+    const auto name = entry.path().filename().string();
+    if (path != snapshot && path != log &&
+        (name.rfind("snapshot-", 0) == 0 || name.rfind("journal-", 0) == 0)) {
+      fs::remove(entry.path());
+    }
+  }
+  OpenLog();
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::Replay(const std::string& path) {
+  std::uint64_t good = 0;
+  {
+    MappedFile file{path};
+    file.AdviseSequential();
+    const char* const begin = file.data();
+    const char* const end = begin + file.size();
+    const char* p = begin;
+    while (static_cast<std::size_t>(end - p) >= kRecordHeader) {
+      std::uint32_t size;
+      std::uint32_t checksum;
+      std::memcpy(&size, p, sizeof(size));
+      std::memcpy(&checksum, p + sizeof(size), sizeof(checksum));
+      const char* body = p + kRecordHeader;
+      // a record cut short by the end of the file, or a bad last one, is a torn write at the
+      // tail; a bad one with more after it is corruption, and dropping the rest would lose
+      // committed records
+      if (static_cast<std::size_t>(end - body) < size) {
+        break;
+      }
+      if (Checksum(body, size) != checksum) {
+        if (static_cast<std::size_t>(end - body) == size) {
+          break;
+        }
+        throw std::runtime_error("JournaledGraph " + dir_ + ": corrupt record at byte " +
+                                 std::to_string(p - begin) + " of " + path +
+                                 ", with more of the log after it");
+      }
+      Apply(body, body + size);
+      p = body + size;
+    }
+    good = static_cast<std::uint64_t>(p - begin);
+    if (good == file.size()) {
+      return;
+    }
+  }
+  std::filesystem::resize_file(path, good);
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::Apply(const char* in, const char* end) {
+  const auto op = static_cast<Op>(Codec<std::uint8_t>::Read(in, end));
+  switch (op) {
+  case Op::kInsertNode:
+    graph_.InsertNode(Codec<N>::Read(in, end));
+    break;
+  case Op::kInsertEdge: {
+    const N src = Codec<N>::Read(in, end);
+    const N dst = Codec<N>::Read(in, end);
+    graph_.InsertEdge(src, dst, Codec<E>::Read(in, end));
+    break;
+  }
+  case Op::kDeleteNode:
+    graph_.DeleteNode(Codec<N>::Read(in, end));
+    break;
+  case Op::kReplace: {
+    const N old_data = Codec<N>::Read(in, end);
+    graph_.Replace(old_data, Codec<N>::Read(in, end));
+    break;
+  }
+  case Op::kMergeReplace: {
+    const N old_data = Codec<N>::Read(in, end);
+    graph_.MergeReplace(old_data, Codec<N>::Read(in, end));
+    break;
+  }
+  case Op::kErase: {
+    const N src = Codec<N>::Read(in, end);
+    const N dst = Codec<N>::Read(in, end);
+    graph_.erase(src, dst, Codec<E>::Read(in, end));
+    break;
+  }
+  case Op::kClear:
+    graph_.Clear();
+    break;
+  default:
+    throw std::runtime_error("JournaledGraph " + dir_ + ": unknown journal record");
+  }
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::OpenLog() {
+  const auto log = PathOf("journal", generation_);
+  fd_ = ::open(log.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    Fail("cannot open " + log);
+  }
+  log_bytes_ = std::filesystem::file_size(log);
+  SyncDir();
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::SyncDir() const {
+  if (!options_.sync) {
+    return;
+  }
+  SyncPath(dir_, O_RDONLY | O_DIRECTORY | O_CLOEXEC, "cannot sync directory");
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::CheckWritable() const {
+  if (failed_) {
+    throw std::runtime_error("JournaledGraph " + dir_ +
+                             ": cannot change a journal after a failed sync");
+  }
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::SyncPath(const std::string& path,
+                                    int flags,
+                                    const std::string& what) const {
+  const int fd = ::open(path.c_str(), flags);
+  if (fd < 0) {
+    Fail(what);
+  }
+  const bool synced = ::fsync(fd) == 0;
+  const int error = errno;
+  ::close(fd);
+  if (!synced) {
+    errno = error;  // Fail reports fsync's error, not close's
+    Fail(what);
+  }
+}
+
+template <typename N, typename E>
+template <typename... Args>
+void JournaledGraph<N, E>::Append(Op op, const Args&... args) {
+  const std::size_t start = pending_.size();
+  pending_.append(kRecordHeader, '\0');
+  Codec<std::uint8_t>::Write(pending_, static_cast<std::uint8_t>(op));
+  (Codec<Args>::Write(pending_, args), ...);
+  const auto size = static_cast<std::uint32_t>(pending_.size() - start - kRecordHeader);
+  const auto checksum = Checksum(pending_.data() + start + kRecordHeader, size);
+  std::memcpy(&pending_[start], &size, sizeof(size));
+  std::memcpy(&pending_[start + sizeof(size)], &checksum, sizeof(checksum));
+  if (++pending_records_ >= options_.group_commit_records) {
+    Commit();
+  }
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::Commit() {
+  CheckWritable();
+  if (pending_.empty()) {
+    return;
+  }
+  for (std::size_t done = 0; done < pending_.size();) {
+    const auto written = ::write(fd_, pending_.data() + done, pending_.size() - done);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // drop whatever part of the group did get written, so a retry appends it whole
+      const int error = errno;
+      if (::ftruncate(fd_, static_cast<off_t>(log_bytes_)) != 0) {
+        failed_ = true;
+      }
+      errno = error;
+      Fail("cannot append to the journal");
+    }
+    done += static_cast<std::size_t>(written);
+  }
+  if (options_.sync && ::fdatasync(fd_) != 0) {
+    // the kernel may have dropped the dirty pages, so neither a retry nor a rewrite is safe
+    failed_ = true;
+    Fail("cannot sync the journal");
+  }
+  log_bytes_ += pending_.size();
+  pending_.clear();
+  pending_records_ = 0;
+  if (options_.compact_bytes != 0 && log_bytes_ >= options_.compact_bytes) {
+    Compact();
+  }
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::Compact() {
+  CheckWritable();
+  if (!pending_.empty()) {
+    const auto compact_bytes = options_.compact_bytes;
+    options_.compact_bytes = 0;  // stop Commit from compacting recursively
+    Commit();
+    options_.compact_bytes = compact_bytes;
+  }
+  const auto next = generation_ + 1;
+  const auto snapshot = PathOf("snapshot", next);
+  const auto tmp = snapshot + ".tmp";
+  SaveBinary(graph_, tmp);
+  if (options_.sync) {
+    SyncPath(tmp, O_RDONLY | O_CLOEXEC, "cannot sync " + tmp);
+  }
+  std::filesystem::rename(tmp, snapshot);
+  SyncDir();
+
+  const auto old_snapshot = PathOf("snapshot", generation_);
+  const auto old_log = PathOf("journal", generation_);
+  ::close(fd_);
+  fd_ = -1;
+  generation_ = next;
+  OpenLog();
+  std::filesystem::remove(old_snapshot);
+  std::filesystem::remove(old_log);
+}
+
+template <typename N, typename E>
+bool JournaledGraph<N, E>::InsertNode(const N& val) {
+  CheckWritable();
+  if (!graph_.InsertNode(val)) {
+    return false;
+  }
+  Append(Op::kInsertNode, val);
+  return true;
+}
+
+template <typename N, typename E>
+bool JournaledGraph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  CheckWritable();
+  if (!graph_.InsertEdge(src, dst, w)) {
+    return false;
+  }
+  Append(Op::kInsertEdge, src, dst, w);
+  return true;
+}
+
+template <typename N, typename E>
+bool JournaledGraph<N, E>::DeleteNode(const N& node) {
+  CheckWritable();
+  if (!graph_.DeleteNode(node)) {
+    return false;
+  }
+  Append(Op::kDeleteNode, node);
+  return true;
+}
+
+template <typename N, typename E>
+bool JournaledGraph<N, E>::Replace(const N& oldData, const N& newData) {
+  CheckWritable();
+  if (!graph_.Replace(oldData, newData)) {
+    return false;
+  }
+  Append(Op::kReplace, oldData, newData);
+  return true;
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::MergeReplace(const N& oldData, const N& newData) {
+  CheckWritable();
+  graph_.MergeReplace(oldData, newData);
+  Append(Op::kMergeReplace, oldData, newData);
+}
+
+template <typename N, typename E>
+bool JournaledGraph<N, E>::erase(const N& src, const N& dst, const E& w) {
+  CheckWritable();
+  if (!graph_.erase(src, dst, w)) {
+    return false;
+  }
+  Append(Op::kErase, src, dst, w);
+  return true;
+}
+
+template <typename N, typename E>
+void JournaledGraph<N, E>::Clear() {
+  CheckWritable();
+  graph_.Clear();
+  Append(Op::kClear);
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_JOURNAL_H_
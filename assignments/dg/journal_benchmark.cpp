@@ -0,0 +1,90 @@
+// Mutation throughput with journaling off and on (for a few group commit sizes), then the time
+// to recover the graph from the log and from a compacted snapshot. Prints JSON to stdout.
+//
+//   journal_benchmark [--nodes=20000] [--edges=200000] [--sync=1]
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/journal.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  const auto num_nodes = bm::Arg(argc, argv, "nodes", 20000);
+  const auto num_edges = bm::Arg(argc, argv, "edges", 200000);
+  const bool sync = bm::Arg(argc, argv, "sync", 1) != 0;
+  const auto dir = std::filesystem::temp_directory_path() / "journal_benchmark";
+
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<int> node(0, static_cast<int>(num_nodes) - 1);
+  std::vector<std::tuple<int, int, int>> edges;
+  for (std::size_t i = 0; i < num_edges; ++i)
+    edges.emplace_back(node(rng), node(rng), node(rng));
+  const double mutations = static_cast<double>(num_nodes + num_edges);
+
+  bm::Reporter reporter;
+  auto apply = [&](auto& g) {
+    for (std::size_t i = 0; i < num_nodes; ++i)
+      g.InsertNode(static_cast<int>(i));
+    for (const auto& [src, dst, w] : edges)
+      g.InsertEdge(src, dst, w);
+  };
+
+  bm::Timer timer;
+  gdwg::Graph<int, int> plain;
+  apply(plain);
+  double seconds = timer.Seconds();
+  reporter.Add("mutate_unjournaled", {{"mutations", mutations}},
+               {{"seconds", seconds}, {"mutations_per_second", mutations / seconds}});
+
+  for (std::size_t group : {1, 64, 1024}) {
+    std::filesystem::remove_all(dir);
+    gdwg::JournalOptions options;
+    options.group_commit_records = group;
+    options.sync = sync;
+    options.compact_bytes = 0;
+    timer.Reset();
+    {
+      gdwg::JournaledGraph<int, int> g{dir.string(), options};
+      // syncing every record is slow enough that a sample is plenty
+      if (group == 1 && sync) {
+        for (std::size_t i = 0; i < 2000; ++i)
+          g.InsertNode(static_cast<int>(i));
+        seconds = timer.Seconds();
+        reporter.Add("mutate_journaled", {{"mutations", 2000}, {"group", 1}, {"sync", sync}},
+                     {{"seconds", seconds}, {"mutations_per_second", 2000 / seconds}});
+        continue;
+      }
+      apply(g);
+      g.Commit();
+    }
+    seconds = timer.Seconds();
+    reporter.Add("mutate_journaled", {{"mutations", mutations}, {"group", group}, {"sync", sync}},
+                 {{"seconds", seconds}, {"mutations_per_second", mutations / seconds}});
+  }
+
+  gdwg::JournalOptions options;
+  options.compact_bytes = 0;
+  timer.Reset();
+  {
+    gdwg::JournaledGraph<int, int> g{dir.string(), options};
+    reporter.Add("recover_from_log", {{"log_mb", g.LogBytes() / 1e6}},
+                 {{"seconds", timer.Seconds()}});
+    g.Compact();
+  }
+  timer.Reset();
+  {
+    gdwg::JournaledGraph<int, int> g{dir.string(), options};
+    bm::DoNotOptimize(g.GetGraph());
+  }
+  reporter.Add("recover_from_snapshot", {{"edges", plain.NumEdges()}},
+               {{"seconds", timer.Seconds()}});
+
+  reporter.Print(std::cout);
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,225 @@
+/*
+  Every test journals into its own fresh directory, closes the JournaledGraph (as a crash or
+  restart would) and checks what a new JournaledGraph recovers from the same directory. Full
+  disks are played by a file size limit, which cuts a commit's writes short wherever it is
+  set.
+*/
+
+#include <signal.h>
+#include <sys/resource.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "assignments/dg/journal.h"
+#include "catch.h"
+
+namespace {
+
+std::string FreshDir(const std::string& name) {
+  const auto dir = std::filesystem::temp_directory_path() / ("journal_test_" + name);
+  std::filesystem::remove_all(dir);
+  return dir.string();
+}
+
+gdwg::JournalOptions SmallGroups() {
+  gdwg::JournalOptions options;
+  options.group_commit_records = 3;
+  options.sync = false;
+  return options;
+}
+
+// caps the size of files this process writes until destroyed; writes past the cap fail with
+// EFBIG rather than raising SIGXFSZ
+class FileSizeLimit {
+ public:
+  explicit FileSizeLimit(rlim_t bytes) {
+    ::getrlimit(RLIMIT_FSIZE, &old_);
+    old_handler_ = ::signal(SIGXFSZ, SIG_IGN);
+    rlimit limit = old_;
+    limit.rlim_cur = bytes;
+    ::setrlimit(RLIMIT_FSIZE, &limit);
+  }
+  FileSizeLimit(const FileSizeLimit&) = delete;
+  FileSizeLimit& operator=(const FileSizeLimit&) = delete;
+  ~FileSizeLimit() {
+    ::setrlimit(RLIMIT_FSIZE, &old_);
+    ::signal(SIGXFSZ, old_handler_);
+  }
+
+ private:
+  rlimit old_;
+  void (*old_handler_)(int);
+};
+
+}  // namespace
+
+SCENARIO("JournaledGraph recovers every committed mutation") {
+  GIVEN("a journaled graph that sees every kind of mutation") {
+    const auto dir = FreshDir("replay");
+    gdwg::Graph<std::string, int> expected;
+    {
+      gdwg::JournaledGraph<std::string, int> g{dir, SmallGroups()};
+      for (const auto* n : {"a", "b", "c", "d", "e"})
+        REQUIRE(g.InsertNode(n));
+      REQUIRE_FALSE(g.InsertNode("a"));
+      REQUIRE(g.InsertEdge("a", "b", 1));
+      REQUIRE(g.InsertEdge("b", "c", 2));
+      REQUIRE(g.InsertEdge("c", "a", 3));
+      REQUIRE(g.InsertEdge("d", "a", 4));
+      REQUIRE(g.erase("b", "c", 2));
+      REQUIRE(g.DeleteNode("e"));
+      REQUIRE(g.Replace("d", "f"));
+      g.MergeReplace("c", "b");
+      REQUIRE_THROWS(g.InsertEdge("a", "zz", 1));
+      expected = g.GetGraph();
+    }
+    WHEN("the directory is opened again") {
+      gdwg::JournaledGraph<std::string, int> g{dir, SmallGroups()};
+      THEN("the graph is the same as before") {
+        REQUIRE(g.GetGraph() == expected);
+        REQUIRE(g.Generation() == 0);
+      }
+      AND_WHEN("the graph is cleared and reopened") {
+        g.Clear();
+        g.Commit();
+        gdwg::JournaledGraph<std::string, int> reopened{dir, SmallGroups()};
+        THEN("it is empty") { REQUIRE(reopened.GetGraph().IsEmpty()); }
+      }
+    }
+  }
+  GIVEN("a journal whose last record was torn by a crash") {
+    const auto dir = FreshDir("torn");
+    gdwg::Graph<int, double> expected;
+    {
+      gdwg::JournaledGraph<int, double> g{dir, SmallGroups()};
+      g.InsertNode(1);
+      g.InsertNode(2);
+      g.InsertEdge(1, 2, 0.5);
+      expected = g.GetGraph();
+    }
+    const auto log = (std::filesystem::path{dir} / "journal-0.log").string();
+    const auto good_size = std::filesystem::file_size(log);
+    std::ofstream{log, std::ios::app | std::ios::binary} << std::string("\x09\0\0\0\x01", 5);
+    WHEN("it is recovered") {
+      gdwg::JournaledGraph<int, double> g{dir, SmallGroups()};
+      THEN("the partial record is dropped and the log truncated") {
+        REQUIRE(g.GetGraph() == expected);
+        REQUIRE(std::filesystem::file_size(log) == good_size);
+        REQUIRE(g.InsertEdge(2, 1, 1.5));
+      }
+    }
+  }
+}
+
+SCENARIO("JournaledGraph compacts its log into a snapshot") {
+  GIVEN("a graph with a long log") {
+    const auto dir = FreshDir("compact");
+    gdwg::Graph<int, int> expected;
+    {
+      gdwg::JournaledGraph<int, int> g{dir, SmallGroups()};
+      for (int i = 0; i < 50; ++i) {
+        g.InsertNode(i);
+        if (i > 0)
+          g.InsertEdge(i - 1, i, i);
+      }
+      const auto bytes = g.LogBytes();
+      g.Compact();
+      REQUIRE(g.Generation() == 1);
+      REQUIRE(g.LogBytes() < bytes);
+      g.DeleteNode(10);
+      g.InsertEdge(49, 0, -1);
+      expected = g.GetGraph();
+    }
+    WHEN("it is reopened") {
+      gdwg::JournaledGraph<int, int> g{dir, SmallGroups()};
+      THEN("the snapshot plus the new log give the same graph") {
+        REQUIRE(g.GetGraph() == expected);
+        REQUIRE(g.Generation() == 1);
+        REQUIRE_FALSE(std::filesystem::exists(std::filesystem::path{dir} / "journal-0.log"));
+      }
+    }
+  }
+  GIVEN("a small compaction threshold") {
+    const auto dir = FreshDir("auto_compact");
+    auto options = SmallGroups();
+    options.compact_bytes = 256;
+    gdwg::Graph<int, int> expected;
+    {
+      gdwg::JournaledGraph<int, int> g{dir, options};
+      for (int i = 0; i < 100; ++i)
+        g.InsertNode(i);
+      REQUIRE(g.Generation() > 1);
+      expected = g.GetGraph();
+    }
+    THEN("compaction happens on its own and recovery still works") {
+      gdwg::JournaledGraph<int, int> g{dir, options};
+      REQUIRE(g.GetGraph() == expected);
+    }
+  }
+}
+
+SCENARIO("A commit that fails to write leaves the journal as it was") {
+  for (const bool mid_record : {true, false}) {
+    GIVEN(std::string{mid_record ? "a disk that fills up in the middle of a record"
+                                 : "a disk that fills up between two records"}) {
+      const auto dir = FreshDir("full");
+      gdwg::JournalOptions options;
+      options.group_commit_records = 1000;
+      gdwg::Graph<int, int> expected;
+      {
+        gdwg::JournaledGraph<int, int> g{dir, options};
+        for (int i = 0; i < 10; ++i)
+          g.InsertNode(i);
+        g.Commit();
+        const auto committed = g.LogBytes();
+        g.InsertNode(10);
+        const auto boundary = g.LogBytes();
+        g.Replace(10, 11);
+        g.InsertNode(12);
+        {
+          FileSizeLimit limit{static_cast<rlim_t>(boundary + (mid_record ? 3 : 0))};
+          REQUIRE_THROWS_AS(g.Commit(), std::runtime_error);
+        }
+        REQUIRE(std::filesystem::file_size(std::filesystem::path{dir} / "journal-0.log") ==
+                committed);
+        // once there is room again, the commit is retried and more is committed after it
+        g.Commit();
+        g.InsertNode(100);
+        g.Commit();
+        expected = g.GetGraph();
+      }
+      THEN("recovery gives every committed mutation once") {
+        gdwg::JournaledGraph<int, int> g{dir, options};
+        REQUIRE(g.GetGraph() == expected);
+        REQUIRE(g.GetGraph().IsNode(100));
+        REQUIRE(g.GetGraph().IsNode(11));
+        REQUIRE_FALSE(g.GetGraph().IsNode(10));
+      }
+    }
+  }
+}
+
+SCENARIO("A bad record in the middle of a journal fails recovery") {
+  GIVEN("a journal with a corrupted record before others") {
+    const auto dir = FreshDir("corrupt");
+    {
+      gdwg::JournaledGraph<int, int> g{dir, SmallGroups()};
+      for (int i = 0; i < 10; ++i)
+        g.InsertNode(i);
+    }
+    const auto log = (std::filesystem::path{dir} / "journal-0.log").string();
+    const auto size = std::filesystem::file_size(log);
+    {
+      std::fstream file{log, std::ios::in | std::ios::out | std::ios::binary};
+      file.seekp(8);  // the first record's body, just past its size and checksum
+      file.put('\x7f');
+    }
+    THEN("it is rejected, and nothing after the bad record is thrown away") {
+      REQUIRE_THROWS_WITH((gdwg::JournaledGraph<int, int>{dir, SmallGroups()}),
+                          Catch::Contains("corrupt record"));
+      REQUIRE(std::filesystem::file_size(log) == size);
+    }
+  }
+}
@@ -0,0 +1,177 @@
+#ifndef ASSIGNMENTS_DG_K_CORE_H_
+#define ASSIGNMENTS_DG_K_CORE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/parallel.h"
+#include "assignments/dg/snapshot.h"
+#include "assignments/dg/undirected.h"
+
+namespace gdwg {
+
+// Core numbers of the undirected graph underneath a graph (see UndirectedGraph). A node's core
+// number is the largest k for which it is in a subgraph where every node has k or more
+// neighbours; the k-core is the nodes with core number k or more.
+//
+// CoreNumbers peels in linear time (Batagelj and Zaversnik): nodes sit in buckets by their
+// remaining degree, and the lowest is removed over and over, each removal moving its remaining
+// neighbours down a bucket in O(1).
+std::vector<std::uint32_t> CoreNumbers(const UndirectedGraph& g);
+
+template <typename N, typename E>
+std::vector<std::uint32_t> CoreNumbers(const Graph<N, E>& g) {
+  return CoreNumbers(UndirectedGraph{Snapshot<N, E>{g}});
+}
+
+// CoreNumbers on up to `threads` workers, by levels (as in ParK and PKC): for k = 0, 1, ... a
+// scan collects the nodes left with degree k or less, which are removed together, in parallel,
+// and any neighbour that an atomic decrement takes down to k joins the next round of the same
+// level. Levels with no nodes are skipped, but each level scans every node, so this is
+// O(edges + nodes * levels) in all.
+std::vector<std::uint32_t> ParallelCoreNumbers(const UndirectedGraph& g,
+                                               std::size_t threads = DefaultThreads());
+
+template <typename N, typename E>
+std::vector<std::uint32_t> ParallelCoreNumbers(const Graph<N, E>& g,
+                                               std::size_t threads = DefaultThreads()) {
+  return ParallelCoreNumbers(UndirectedGraph{Snapshot<N, E>{g}, threads}, threads);
+}
+
+inline std::vector<std::uint32_t> CoreNumbers(const UndirectedGraph& g) {
+  using NodeId = UndirectedGraph::NodeId;
+  const std::size_t n = g.NumNodes();
+  std::vector<std::uint32_t> degree(n);
+  std::uint32_t max_degree = 0;
+  for (NodeId v = 0; v < n; ++v) {
+    degree[v] = static_cast<std::uint32_t>(g.Degree(v));
+    max_degree = std::max(max_degree, degree[v]);
+  }
+  // nodes sorted by degree, where each bucket starts, and where each node is
+  std::vector<std::size_t> start(max_degree + 2, 0);
+  for (NodeId v = 0; v < n; ++v) {
+    ++start[degree[v] + 1];
+  }
+  for (std::size_t d = 1; d < start.size(); ++d) {
+    start[d] += start[d - 1];
+  }
+  std::vector<NodeId> order(n);
+  std::vector<std::size_t> position(n);
+  {
+    std::vector<std::size_t> next(start.begin(), start.end() - 1);
+    for (NodeId v = 0; v < n; ++v) {
+      position[v] = next[degree[v]]++;
+      order[position[v]] = v;
+    }
+  }
+  // removing order[i] leaves degree[order[i]] as its core number
+  for (std::size_t i = 0; i < n; ++i) {
+    const NodeId v = order[i];
+    for (auto it = g.NeighboursBegin(v); it != g.NeighboursEnd(v); ++it) {
+      const NodeId w = *it;
+      if (degree[w] > degree[v]) {
+        // swap w with the first node of its bucket, then move the bucket's start past it
+        const std::size_t first = start[degree[w]];
+        const NodeId u = order[first];
+        std::swap(order[first], order[position[w]]);
+        std::swap(position[u], position[w]);
+        ++start[degree[w]];
+        --degree[w];
+      }
+    }
+  }
+  return degree;
+}
+
+inline std::vector<std::uint32_t> ParallelCoreNumbers(const UndirectedGraph& g,
+                                                      std::size_t threads) {
+  using NodeId = UndirectedGraph::NodeId;
+  constexpr auto kUnset = ~std::uint32_t{0};
+  threads = std::max<std::size_t>(threads, 1);
+  const std::size_t n = g.NumNodes();
+  std::vector<std::atomic<std::uint32_t>> degree(n);
+  std::vector<std::uint32_t> core(n, kUnset);
+  ParallelFor(n,
+              [&](std::size_t v) {
+                degree[v].store(static_cast<std::uint32_t>(g.Degree(static_cast<NodeId>(v))),
+                                std::memory_order_relaxed);
+              },
+              threads);
+  const std::size_t blocks = std::max<std::size_t>(1, std::min(n, threads * 16));
+  std::vector<std::vector<NodeId>> found(blocks);
+  std::vector<std::uint32_t> lowest(blocks);
+  std::vector<NodeId> frontier;
+  // gathers each block's finds into the frontier
+  auto gather = [&] {
+    frontier.clear();
+    for (auto& block : found) {
+      frontier.insert(frontier.end(), block.begin(), block.end());
+      block.clear();
+    }
+  };
+
+  std::size_t removed = 0;
+  std::uint32_t k = 0;
+  while (removed < n) {
+    // the nodes left at level k, and the lowest degree of those above it
+    ParallelFor(blocks,
+                [&](std::size_t b) {
+                  lowest[b] = kUnset;
+                  for (std::size_t v = n * b / blocks; v != n * (b + 1) / blocks; ++v) {
+                    if (core[v] == kUnset) {
+                      const auto d = degree[v].load(std::memory_order_relaxed);
+                      if (d <= k) {
+                        found[b].push_back(static_cast<NodeId>(v));
+                      } else {
+                        lowest[b] = std::min(lowest[b], d);
+                      }
+                    }
+                  }
+                },
+                threads);
+    gather();
+    if (frontier.empty()) {
+      // nothing changed since the scan, so no level below its lowest degree has any nodes
+      k = *std::min_element(lowest.begin(), lowest.end());
+      continue;
+    }
+    while (!frontier.empty()) {
+      removed += frontier.size();
+      for (NodeId v : frontier) {
+        core[v] = k;
+      }
+      ParallelFor(blocks,
+                  [&](std::size_t b) {
+                    const std::size_t size = frontier.size();
+                    for (std::size_t i = size * b / blocks; i != size * (b + 1) / blocks; ++i) {
+                      const NodeId v = frontier[i];
+                      for (auto it = g.NeighboursBegin(v); it != g.NeighboursEnd(v); ++it) {
+                        // nodes removed, now or before, are at k or less and left alone
+                        auto& d = degree[*it];
+                        if (d.load(std::memory_order_relaxed) > k) {
+                          const auto before = d.fetch_sub(1, std::memory_order_relaxed);
+                          if (before == k + 1) {
+                            found[b].push_back(*it);
+                          } else if (before <= k) {
+                            // another worker took it to k first
+                            d.fetch_add(1, std::memory_order_relaxed);
+                          }
+                        }
+                      }
+                    }
+                  },
+                  threads);
+      gather();
+    }
+    ++k;
+  }
+  return core;
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_K_CORE_H_
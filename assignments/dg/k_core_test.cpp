@@ -0,0 +1,92 @@
+/*
+  Tests for CoreNumbers and ParallelCoreNumbers. Both are checked against the definition: for
+  each k, nodes with fewer than k neighbours left are removed until none are, and a node's core
+  number is the last k it survives.
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/k_core.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+std::vector<std::uint32_t> Reference(const gdwg::UndirectedGraph& g) {
+  const std::size_t n = g.NumNodes();
+  std::vector<std::uint32_t> core(n, 0);
+  for (std::uint32_t k = 1;; ++k) {
+    std::vector<char> alive(n, 1);
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (std::uint32_t v = 0; v < n; ++v) {
+        std::uint32_t degree = 0;
+        for (auto it = g.NeighboursBegin(v); it != g.NeighboursEnd(v); ++it) {
+          degree += alive[*it];
+        }
+        if (alive[v] && degree < k) {
+          alive[v] = 0;
+          changed = true;
+        }
+      }
+    }
+    bool any = false;
+    for (std::uint32_t v = 0; v < n; ++v) {
+      if (alive[v]) {
+        core[v] = k;
+        any = true;
+      }
+    }
+    if (!any) {
+      return core;
+    }
+  }
+}
+
+// a dense corner on top of a sparse graph gives a spread of core numbers
+gdwg::UndirectedGraph CoredGraph(int nodes, int edges, unsigned seed) {
+  auto g = gdwg::testing::RandomGraph(nodes, edges, seed, 1, 1);
+  for (const auto& [src, dst, weight] : gdwg::testing::RandomGraph(15, edges, seed + 1, 1, 1)) {
+    g.InsertEdge(src, dst, weight);
+  }
+  return gdwg::UndirectedGraph{gdwg::Snapshot<int, int>{g}};
+}
+
+}  // namespace
+
+SCENARIO("Core numbers match peeling by the definition") {
+  for (int edges : {0, 60, 200, 600}) {
+    GIVEN("a random graph with 200 nodes and " + std::to_string(edges) + " edges each way") {
+      const auto g = CoredGraph(200, edges, static_cast<unsigned>(edges) + 8);
+      const auto expected = Reference(g);
+      THEN("peeling by buckets and by parallel levels on 1, 3 and 8 threads agree") {
+        REQUIRE(gdwg::CoreNumbers(g) == expected);
+        for (std::size_t threads : {1, 3, 8}) {
+          REQUIRE(gdwg::ParallelCoreNumbers(g, threads) == expected);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("The cores of a small graph") {
+  GIVEN("a clique of four with a path hanging off it, and a node on its own") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e", "f", "g"};
+    for (const auto* src : {"a", "b", "c", "d"}) {
+      for (const auto* dst : {"a", "b", "c", "d"}) {
+        if (std::string{src} < dst) {
+          g.InsertEdge(src, dst, 1);
+        }
+      }
+    }
+    g.InsertEdge("e", "d", 1);
+    g.InsertEdge("f", "e", 1);
+    THEN("the clique is the 3-core, the path the 1-core, and the loner the 0-core") {
+      const std::vector<std::uint32_t> expected{3, 3, 3, 3, 1, 1, 0};
+      REQUIRE(gdwg::CoreNumbers(g) == expected);
+      REQUIRE(gdwg::ParallelCoreNumbers(g, 2) == expected);
+    }
+  }
+}
@@ -0,0 +1,102 @@
+#ifndef ASSIGNMENTS_DG_K_SHORTEST_PATHS_H_
+#define ASSIGNMENTS_DG_K_SHORTEST_PATHS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/path.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// The loopless paths from src to dst in order of weight (Yen's algorithm), one per call to
+// Next(), so a caller that has found what it needs simply stops asking.
+//
+// Each path found is the shortest of a set of candidates. Its deviations become new
+// candidates: for every spur node on it, the path keeps the nodes up to the spur node (the
+// root) and goes on by a shortest path from there that leaves by an edge no path found so far
+// with the same root has taken, and that doesn't visit the root again. A spur search masks the
+// root's nodes and those edges out of the snapshot rather than changing the graph.
+//
+// Spur searches are done only from the node where a path left its parent onwards (Lawler):
+// the spurs before it share a root with the parent, whose own spur searches already found
+// those candidates. They are also only done when the next path is asked for, so the first path
+// costs one Dijkstra.
+//
+// Paths are node sequences, so parallel edges don't make a path twice; each step takes the
+// lightest edge. Weights must be non-negative and arithmetic.
+template <typename N, typename E>
+class KShortestPaths {
+  static_assert(std::is_arithmetic<E>::value, "KShortestPaths needs arithmetic weights");
+
+ public:
+  using NodeId = std::uint32_t;
+
+  KShortestPaths(Snapshot<N, E> snapshot, const N& src, const N& dst);
+  KShortestPaths(const Graph<N, E>& g, const N& src, const N& dst)
+    : KShortestPaths(Snapshot<N, E>{g}, src, dst) {}
+
+  // the next shortest loopless path, or nullopt once there are no more
+  std::optional<Path<N, E>> Next();
+
+  // paths returned by Next so far
+  std::size_t Found() const noexcept { return found_.size(); }
+  // shortest path searches done so far, one per spur node
+  std::size_t SpurSearches() const noexcept { return spur_searches_; }
+
+ private:
+  static constexpr NodeId kNone = ~NodeId{0};
+  static constexpr E kInfinity = std::numeric_limits<E>::max();
+
+  struct Candidate {
+    E weight;
+    std::vector<NodeId> nodes;
+    // weight of the path up to each of its nodes
+    std::vector<E> prefix;
+    // the index of the node where it left the path it was found from
+    std::size_t deviation;
+  };
+  struct CandidateCmp {
+    bool operator()(const Candidate& lhs, const Candidate& rhs) const {
+      return lhs.weight < rhs.weight || (lhs.weight == rhs.weight && lhs.nodes < rhs.nodes);
+    }
+  };
+  struct Label {
+    E dist = kInfinity;
+    NodeId parent = kNone;
+  };
+
+  // adds the deviations of found_[index] from its deviation node onwards as candidates
+  void Expand(std::size_t index);
+  // a shortest path from the root's last node to dst_ that avoids the masked nodes and doesn't
+  // leave by an edge to one of banned, added as a candidate after root
+  void Spur(const Candidate& root, std::size_t spur, const std::vector<NodeId>& banned);
+
+  Snapshot<N, E> snapshot_;
+  NodeId src_;
+  NodeId dst_;
+  bool started_ = false;
+  std::vector<Candidate> found_;
+  // paths of found_ whose deviations are candidates
+  std::size_t expanded_ = 0;
+  // ordered by weight; a path can only be a candidate once
+  std::set<Candidate, CandidateCmp> candidates_;
+  std::size_t spur_searches_ = 0;
+
+  // search state, reused and left clean after each search
+  std::vector<char> masked_;
+  std::vector<Label> labels_;
+  std::vector<NodeId> touched_;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/k_shortest_paths.tpp"
+
+#endif  // ASSIGNMENTS_DG_K_SHORTEST_PATHS_H_
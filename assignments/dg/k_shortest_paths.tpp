@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace gdwg {
+
+template <typename N, typename E>
+KShortestPaths<N, E>::KShortestPaths(Snapshot<N, E> snapshot, const N& src, const N& dst)
+  : snapshot_{std::move(snapshot)} {
+  if (!snapshot_.IsNode(src) || !snapshot_.IsNode(dst)) {
+    throw std::out_of_range(
+        "Cannot create KShortestPaths if src or dst node don't exist in the graph");
+  }
+  for (std::size_t e = 0; e < snapshot_.NumEdges(); ++e) {
+    if (snapshot_.Weight(e) < E{}) {
+      throw std::invalid_argument(
+          "Cannot create KShortestPaths of a graph with negative weights");
+    }
+  }
+  src_ = snapshot_.Id(src);
+  dst_ = snapshot_.Id(dst);
+  masked_.resize(snapshot_.NumNodes());
+  labels_.resize(snapshot_.NumNodes());
+}
+
+template <typename N, typename E>
+std::optional<Path<N, E>> KShortestPaths<N, E>::Next() {
+  if (!started_) {
+    started_ = true;
+    Spur(Candidate{E{}, {src_}, {E{}}, 0}, 0, {});
+  }
+  while (expanded_ < found_.size()) {
+    Expand(expanded_++);
+  }
+  if (candidates_.empty()) {
+    return std::nullopt;
+  }
+  found_.push_back(std::move(candidates_.extract(candidates_.begin()).value()));
+  const Candidate& best = found_.back();
+  Path<N, E> path{{}, best.weight};
+  path.nodes.reserve(best.nodes.size());
+  for (NodeId v : best.nodes) {
+    path.nodes.push_back(snapshot_.Value(v));
+  }
+  return path;
+}
+
+template <typename N, typename E>
+void KShortestPaths<N, E>::Expand(std::size_t index) {
+  const Candidate& path = found_[index];
+  std::vector<NodeId> banned;
+  for (std::size_t spur = path.deviation; spur + 1 < path.nodes.size(); ++spur) {
+    // the next node of every path found so far with the same root, this one included
+    banned.clear();
+    const auto root_end = path.nodes.begin() + static_cast<std::ptrdiff_t>(spur) + 1;
+    for (const Candidate& other : found_) {
+      if (other.nodes.size() > spur + 1 &&
+          std::equal(path.nodes.begin(), root_end, other.nodes.begin())) {
+        banned.push_back(other.nodes[spur + 1]);
+      }
+    }
+    Spur(path, spur, banned);
+  }
+}
+
+template <typename N, typename E>
+void KShortestPaths<N, E>::Spur(const Candidate& root,
+                                std::size_t spur,
+                                const std::vector<NodeId>& banned) {
+  ++spur_searches_;
+  for (std::size_t i = 0; i < spur; ++i) {
+    masked_[root.nodes[i]] = 1;
+  }
+  const NodeId start = root.nodes[spur];
+  using Item = std::pair<E, NodeId>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  labels_[start] = {E{}, kNone};
+  touched_.push_back(start);
+  queue.emplace(E{}, start);
+  bool reached = false;
+  while (!queue.empty()) {
+    const auto [d, v] = queue.top();
+    queue.pop();
+    if (d > labels_[v].dist) {
+      continue;
+    }
+    if (v == dst_) {
+      reached = true;
+      break;
+    }
+    for (auto e = snapshot_.EdgeBegin(v); e != snapshot_.EdgeEnd(v); ++e) {
+      const NodeId x = snapshot_.Dst(e);
+      if (masked_[x] ||
+          (v == start && std::find(banned.begin(), banned.end(), x) != banned.end())) {
+        continue;
+      }
+      const E next = d + snapshot_.Weight(e);
+      if (next < labels_[x].dist) {
+        if (labels_[x].dist == kInfinity) {
+          touched_.push_back(x);
+        }
+        labels_[x] = {next, v};
+        queue.emplace(next, x);
+      }
+    }
+  }
+
+  if (reached) {
+    const auto root_end = static_cast<std::ptrdiff_t>(spur) + 1;
+    Candidate candidate{E{},
+                        {root.nodes.begin(), root.nodes.begin() + root_end},
+                        {root.prefix.begin(), root.prefix.begin() + root_end},
+                        spur};
+    // the spur path runs backwards from dst_ along the parents
+    for (NodeId v = dst_; v != start; v = labels_[v].parent) {
+      candidate.nodes.push_back(v);
+      candidate.prefix.push_back(root.prefix[spur] + labels_[v].dist);
+    }
+    std::reverse(candidate.nodes.begin() + root_end, candidate.nodes.end());
+    std::reverse(candidate.prefix.begin() + root_end, candidate.prefix.end());
+    candidate.weight = candidate.prefix.back();
+    candidates_.insert(std::move(candidate));
+  }
+  for (NodeId v : touched_) {
+    labels_[v] = {};
+  }
+  touched_.clear();
+  for (std::size_t i = 0; i < spur; ++i) {
+    masked_[root.nodes[i]] = 0;
+  }
+}
+
+}  // namespace gdwg
@@ -0,0 +1,56 @@
+// KShortestPaths on a grid with random weights: the time to get the first k paths between
+// random pairs of nodes, for k from 1 to 100, and the spur searches that took. Since paths come
+// out one at a time, one run per pair gives every k. Prints JSON to stdout.
+//
+//   k_shortest_paths_benchmark [--side=100] [--pairs=20] [--k=100]
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/k_shortest_paths.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = double;
+  const auto side = bm::Arg(argc, argv, "side", 100);
+  const auto pairs = bm::Arg(argc, argv, "pairs", 20);
+  const auto k = bm::Arg(argc, argv, "k", 100);
+
+  const auto snapshot =
+      gdwg::Grid2D<N, E>(side, side, gdwg::UniformWeights<E>(1, 10)).BuildSnapshot();
+  const bm::Fields params{{"nodes", snapshot.NumNodes()}, {"edges", snapshot.NumEdges()}};
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<N> node(0, static_cast<N>(snapshot.NumNodes() - 1));
+
+  // totals over all pairs of the time and spur searches to get the first i + 1 paths
+  std::vector<double> seconds(k);
+  std::vector<double> searches(k);
+  for (std::size_t p = 0; p < pairs; ++p) {
+    const N src = node(rng);
+    const N dst = node(rng);
+    bm::Timer timer;
+    gdwg::KShortestPaths<N, E> paths{snapshot, src, dst};
+    for (std::size_t i = 0; i < k && paths.Next(); ++i) {
+      seconds[i] += timer.Seconds();
+      searches[i] += static_cast<double>(paths.SpurSearches());
+    }
+  }
+
+  bm::Reporter reporter;
+  for (std::size_t i = 0; i < k; ++i) {
+    const std::size_t found = i + 1;
+    if (found == 1 || found == 2 || found % 10 == 0 || found == k) {
+      auto with_k = params;
+      with_k.emplace_back("k", found);
+      reporter.Add("k_shortest_paths", with_k,
+                   {{"ms_for_k", 1e3 * seconds[i] / pairs},
+                    {"us_per_path", 1e6 * seconds[i] / pairs / found},
+                    {"spur_searches_per_path", searches[i] / pairs / found}});
+    }
+  }
+  reporter.Print(std::cout);
+}
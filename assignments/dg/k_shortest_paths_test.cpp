@@ -0,0 +1,144 @@
+/*
+  Tests for KShortestPaths. On small random graphs every loopless path is listed by a depth first
+  search, and the paths Next() returns must be exactly those, each once, in order of weight.
+  The example from the literature checks the order of the first few paths by hand, and the
+  counters check that the work is only done when a path is asked for.
+*/
+
+#include <algorithm>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/k_shortest_paths.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+// weight of the lightest edge from a to b
+int Lightest(const gdwg::Graph<int, int>& g, int a, int b) {
+  const auto weights = g.GetWeights(a, b);
+  return *std::min_element(weights.begin(), weights.end());
+}
+
+// every loopless path from the last node of path to dst, as (weight, nodes)
+void AllPaths(const gdwg::Graph<int, int>& g,
+              int dst,
+              std::vector<int>& path,
+              int weight,
+              std::set<std::pair<int, std::vector<int>>>& out) {
+  if (path.back() == dst) {
+    out.emplace(weight, path);
+    return;
+  }
+  for (int next : g.GetConnected(path.back())) {
+    if (std::find(path.begin(), path.end(), next) == path.end()) {
+      const int w = Lightest(g, path.back(), next);
+      path.push_back(next);
+      AllPaths(g, dst, path, weight + w, out);
+      path.pop_back();
+    }
+  }
+}
+
+// true if Next() gives the loopless paths from src to dst, each once and in order of weight
+bool MatchesAllPaths(const gdwg::Graph<int, int>& g, int src, int dst) {
+  std::set<std::pair<int, std::vector<int>>> expected;
+  std::vector<int> path{src};
+  AllPaths(g, dst, path, 0, expected);
+
+  gdwg::KShortestPaths<int, int> paths{g, src, dst};
+  std::set<std::pair<int, std::vector<int>>> seen;
+  int last = 0;
+  while (const auto next = paths.Next()) {
+    if (next->weight < last || !seen.emplace(next->weight, next->nodes).second) {
+      return false;
+    }
+    last = next->weight;
+  }
+  return seen == expected && paths.Found() == expected.size() && !paths.Next();
+}
+
+}  // namespace
+
+SCENARIO("Paths come out in order of weight, and every loopless path comes out once") {
+  for (int edges : {0, 10, 20, 30}) {
+    GIVEN("a random graph with 8 nodes and " + std::to_string(edges) + " edges") {
+      const auto g = gdwg::testing::RandomGraph(8, edges, static_cast<unsigned>(edges) + 5, 0, 9);
+      THEN("every pair of nodes gets all of its paths") {
+        bool all = true;
+        for (int src = 0; src < 8; ++src) {
+          for (int dst = 0; dst < 8; ++dst) {
+            all = all && MatchesAllPaths(g, src, dst);
+          }
+        }
+        REQUIRE(all);
+      }
+    }
+  }
+}
+
+SCENARIO("The k shortest paths of the textbook example") {
+  GIVEN("the graph from Yen's algorithm's usual example") {
+    gdwg::Graph<std::string, int> g{"C", "D", "E", "F", "G", "H"};
+    g.InsertEdge("C", "D", 3);
+    g.InsertEdge("C", "E", 2);
+    g.InsertEdge("D", "F", 4);
+    g.InsertEdge("E", "D", 1);
+    g.InsertEdge("E", "F", 2);
+    g.InsertEdge("E", "G", 3);
+    g.InsertEdge("F", "G", 2);
+    g.InsertEdge("F", "H", 1);
+    g.InsertEdge("G", "H", 2);
+    g.InsertEdge("F", "H", 6);
+    gdwg::KShortestPaths<std::string, int> paths{g, "C", "H"};
+    WHEN("only the first path is asked for") {
+      const auto first = paths.Next();
+      THEN("it is the shortest, found by one search") {
+        REQUIRE(first == gdwg::Path<std::string, int>{{"C", "E", "F", "H"}, 5});
+        REQUIRE(paths.Found() == 1);
+        REQUIRE(paths.SpurSearches() == 1);
+      }
+    }
+    WHEN("the next ones are asked for") {
+      paths.Next();
+      THEN("they follow in order, ties broken by node order, and parallel edges don't repeat") {
+        REQUIRE(paths.Next() == gdwg::Path<std::string, int>{{"C", "E", "G", "H"}, 7});
+        REQUIRE(paths.Next() == gdwg::Path<std::string, int>{{"C", "D", "F", "H"}, 8});
+        REQUIRE(paths.Next() == gdwg::Path<std::string, int>{{"C", "E", "D", "F", "H"}, 8});
+        REQUIRE(paths.Next() == gdwg::Path<std::string, int>{{"C", "E", "F", "G", "H"}, 8});
+        REQUIRE(paths.Next() == gdwg::Path<std::string, int>{{"C", "D", "F", "G", "H"}, 11});
+        REQUIRE(paths.Next() == gdwg::Path<std::string, int>{{"C", "E", "D", "F", "G", "H"}, 11});
+        REQUIRE(paths.Next() == std::nullopt);
+        REQUIRE(paths.Found() == 7);
+      }
+    }
+    THEN("a node's only path to itself is the node") {
+      gdwg::KShortestPaths<std::string, int> itself{g, "D", "D"};
+      REQUIRE(itself.Next() == gdwg::Path<std::string, int>{{"D"}, 0});
+      REQUIRE(itself.Next() == std::nullopt);
+    }
+  }
+}
+
+SCENARIO("Bad input to KShortestPaths is rejected") {
+  GIVEN("a graph with a negative weight") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, -1);
+    THEN("its paths can't be listed") {
+      REQUIRE_THROWS_WITH((gdwg::KShortestPaths<int, int>{g, 1, 2}),
+                          "Cannot create KShortestPaths of a graph with negative weights");
+    }
+  }
+  GIVEN("a graph") {
+    const gdwg::Graph<int, int> g{1, 2};
+    THEN("paths from or to a missing node throw") {
+      REQUIRE_THROWS_WITH((gdwg::KShortestPaths<int, int>{g, 1, 3}),
+                          "Cannot create KShortestPaths if src or dst node don't exist in the "
+                          "graph");
+    }
+  }
+}
@@ -0,0 +1,124 @@
+#ifndef ASSIGNMENTS_DG_MAX_FLOW_H_
+#define ASSIGNMENTS_DG_MAX_FLOW_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+enum class FlowAlgorithm { kPushRelabel, kDinic };
+
+template <typename N, typename E>
+struct FlowResult {
+  E value;
+  // flow over each connected pair of distinct nodes (parallel edges summed), in graph order
+  std::vector<std::tuple<N, N, E>> flows;
+  // a minimum cut: the nodes src can still reach through unsaturated edges, and the rest
+  std::vector<N> source_side;
+  std::vector<N> sink_side;
+};
+
+// Maximum flow and minimum cut between any two nodes of a graph whose weights are capacities.
+// The residual graph is built once from a Snapshot: each connected pair of nodes becomes one
+// arc whose capacity is the sum of the pair's edges, paired with a reverse arc of capacity 0,
+// and self loops are dropped. Every MaxFlow starts again from zero flow, so one network
+// answers any number of queries.
+//
+// Push-relabel (Goldberg and Tarjan) keeps a preflow and a height per node, and discharges the
+// highest active node first, pushing its excess downhill and relabelling it when it can't.
+// Heights are reset to exact distances to dst by a backwards breadth first search (a global
+// relabel) at the start and after every NumNodes() relabels, and when no node is left at some
+// height below NumNodes() (a gap) every node above it is lifted out of reach at once. The
+// excess left stranded on the source side is then returned to src by the same procedure
+// aimed at src, so the flows are a valid flow and not just a preflow.
+//
+// Dinic's algorithm instead augments along shortest paths one breadth first level graph at a
+// time, each blocking flow found by an iterative depth first search.
+//
+// Capacities must be non-negative and arithmetic; with integers the results are exact.
+// MaxFlow reuses the residual graph, so it isn't const and a network is for one thread at a
+// time.
+template <typename N, typename E>
+class FlowNetwork {
+  static_assert(std::is_arithmetic<E>::value, "FlowNetwork needs arithmetic capacities");
+
+ public:
+  using NodeId = std::uint32_t;
+
+  explicit FlowNetwork(const Snapshot<N, E>& snapshot);
+  explicit FlowNetwork(const Graph<N, E>& g) : FlowNetwork(Snapshot<N, E>{g}) {}
+
+  std::size_t NumNodes() const noexcept { return nodes_.size(); }
+  // connected pairs of distinct nodes, each of which is an arc of the residual graph
+  std::size_t NumPairs() const noexcept { return pairs_.size(); }
+
+  FlowResult<N, E> MaxFlow(const N& src,
+                           const N& dst,
+                           FlowAlgorithm algorithm = FlowAlgorithm::kPushRelabel);
+
+ private:
+  using ArcId = std::uint64_t;
+
+  struct Arc {
+    NodeId head;
+    // the arc the other way, whose capacity grows as this one's shrinks
+    ArcId reverse;
+    // residual capacity
+    E capacity;
+  };
+  struct Pair {
+    NodeId src;
+    NodeId dst;
+    ArcId arc;
+  };
+
+  NodeId Tail(ArcId a) const noexcept { return arcs_[arcs_[a].reverse].head; }
+  void PushRelabel(NodeId src, NodeId dst);
+  // moves all excess (on nodes other than src and dst) to target, never through avoid
+  void Drain(NodeId target, NodeId avoid);
+  void GlobalRelabel(NodeId target, NodeId avoid);
+  void Relabel(NodeId v);
+  void Dinic(NodeId src, NodeId dst);
+
+  std::vector<N> nodes_;
+  // arcs_[offsets_[v], offsets_[v + 1]) leave v
+  std::vector<ArcId> offsets_;
+  std::vector<Arc> arcs_;
+  // capacity of every arc before any flow
+  std::vector<E> capacities_;
+  std::vector<Pair> pairs_;
+
+  // push-relabel and Dinic state, reused between calls
+  std::vector<NodeId> height_;
+  std::vector<E> excess_;
+  std::vector<ArcId> current_;
+  // active_[h] holds nodes activated at height h (lazily: they may have moved since);
+  // level_[h] holds every node at height h below NumNodes(), at index where_[v]
+  std::vector<std::vector<NodeId>> active_;
+  std::vector<std::vector<NodeId>> level_;
+  std::vector<std::size_t> where_;
+  std::size_t max_active_ = 0;
+  std::size_t max_level_ = 0;
+  std::size_t relabels_ = 0;
+};
+
+// MaxFlow of a one-off FlowNetwork of g; build a FlowNetwork to ask about many pairs
+template <typename N, typename E>
+FlowResult<N, E> MaxFlow(const Graph<N, E>& g,
+                         const N& src,
+                         const N& dst,
+                         FlowAlgorithm algorithm = FlowAlgorithm::kPushRelabel) {
+  return FlowNetwork<N, E>{g}.MaxFlow(src, dst, algorithm);
+}
+
+}  // namespace gdwg
+
+#include "assignments/dg/max_flow.tpp"
+
+#endif  // ASSIGNMENTS_DG_MAX_FLOW_H_
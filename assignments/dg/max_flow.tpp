@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace gdwg {
+
+template <typename N, typename E>
+FlowNetwork<N, E>::FlowNetwork(const Snapshot<N, E>& snapshot)
+  : nodes_(snapshot.Nodes(), snapshot.Nodes() + snapshot.NumNodes()),
+    offsets_(snapshot.NumNodes() + 1) {
+  const std::size_t n = nodes_.size();
+  // a snapshot's edges are sorted by destination, so a pair's parallel edges are together
+  std::vector<E> sums;
+  for (NodeId src = 0; src < n; ++src) {
+    for (auto e = snapshot.EdgeBegin(src); e != snapshot.EdgeEnd(src); ++e) {
+      const NodeId dst = snapshot.Dst(e);
+      const E capacity = snapshot.Weight(e);
+      if (capacity < E{}) {
+        throw std::invalid_argument(
+            "Cannot create a FlowNetwork of a graph with negative capacities");
+      }
+      if (dst == src) {
+        continue;
+      }
+      if (!pairs_.empty() && pairs_.back().src == src && pairs_.back().dst == dst) {
+        sums.back() += capacity;
+      } else {
+        pairs_.push_back({src, dst, 0});
+        sums.push_back(capacity);
+        ++offsets_[src + 1];
+        ++offsets_[dst + 1];
+      }
+    }
+  }
+  std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+  arcs_.resize(offsets_[n]);
+  std::vector<ArcId> next(offsets_.begin(), offsets_.end() - 1);
+  for (std::size_t i = 0; i < pairs_.size(); ++i) {
+    const ArcId forward = next[pairs_[i].src]++;
+    const ArcId backward = next[pairs_[i].dst]++;
+    arcs_[forward] = {pairs_[i].dst, backward, sums[i]};
+    arcs_[backward] = {pairs_[i].src, forward, E{}};
+    pairs_[i].arc = forward;
+  }
+  capacities_.reserve(arcs_.size());
+  for (const Arc& arc : arcs_) {
+    capacities_.push_back(arc.capacity);
+  }
+}
+
+template <typename N, typename E>
+FlowResult<N, E> FlowNetwork<N, E>::MaxFlow(const N& src, const N& dst, FlowAlgorithm algorithm) {
+  const auto s = std::lower_bound(nodes_.begin(), nodes_.end(), src);
+  const auto t = std::lower_bound(nodes_.begin(), nodes_.end(), dst);
+  if (s == nodes_.end() || src < *s || t == nodes_.end() || dst < *t) {
+    throw std::out_of_range(
+        "Cannot call FlowNetwork::MaxFlow if src or dst node don't exist in the graph");
+  }
+  if (s == t) {
+    throw std::invalid_argument("Cannot call FlowNetwork::MaxFlow with src the same as dst");
+  }
+  for (std::size_t a = 0; a < arcs_.size(); ++a) {
+    arcs_[a].capacity = capacities_[a];
+  }
+  const auto src_id = static_cast<NodeId>(s - nodes_.begin());
+  const auto dst_id = static_cast<NodeId>(t - nodes_.begin());
+  if (algorithm == FlowAlgorithm::kPushRelabel) {
+    PushRelabel(src_id, dst_id);
+  } else {
+    Dinic(src_id, dst_id);
+  }
+
+  FlowResult<N, E> result{E{}, {}, {}, {}};
+  result.flows.reserve(pairs_.size());
+  for (const Pair& pair : pairs_) {
+    const E flow = capacities_[pair.arc] - arcs_[pair.arc].capacity;
+    result.flows.emplace_back(nodes_[pair.src], nodes_[pair.dst], flow);
+    if (pair.dst == dst_id) {
+      result.value += flow;
+    } else if (pair.src == dst_id) {
+      result.value -= flow;
+    }
+  }
+  // the cut is between what src reaches in the residual graph and the rest
+  std::vector<char> reached(nodes_.size());
+  std::vector<NodeId> queue{src_id};
+  reached[src_id] = 1;
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    const NodeId v = queue[i];
+    for (ArcId a = offsets_[v]; a != offsets_[v + 1]; ++a) {
+      if (arcs_[a].capacity > E{} && !reached[arcs_[a].head]) {
+        reached[arcs_[a].head] = 1;
+        queue.push_back(arcs_[a].head);
+      }
+    }
+  }
+  for (NodeId v = 0; v < nodes_.size(); ++v) {
+    (reached[v] ? result.source_side : result.sink_side).push_back(nodes_[v]);
+  }
+  return result;
+}
+
+template <typename N, typename E>
+void FlowNetwork<N, E>::PushRelabel(NodeId src, NodeId dst) {
+  const std::size_t n = nodes_.size();
+  height_.assign(n, 0);
+  excess_.assign(n, E{});
+  current_.resize(n);
+  active_.resize(n);
+  level_.resize(n);
+  where_.resize(n);
+  for (ArcId a = offsets_[src]; a != offsets_[src + 1]; ++a) {
+    Arc& arc = arcs_[a];
+    if (arc.capacity > E{}) {
+      excess_[arc.head] += arc.capacity;
+      excess_[src] -= arc.capacity;
+      arcs_[arc.reverse].capacity += arc.capacity;
+      arc.capacity = E{};
+    }
+  }
+  // a maximum preflow, then what couldn't reach dst goes back
+  Drain(dst, src);
+  Drain(src, dst);
+}
+
+template <typename N, typename E>
+void FlowNetwork<N, E>::Drain(NodeId target, NodeId avoid) {
+  const std::size_t n = nodes_.size();
+  GlobalRelabel(target, avoid);
+  for (;;) {
+    while (max_active_ > 0 && active_[max_active_].empty()) {
+      --max_active_;
+    }
+    if (active_[max_active_].empty()) {
+      return;
+    }
+    const NodeId v = active_[max_active_].back();
+    active_[max_active_].pop_back();
+    if (height_[v] != max_active_ || !(excess_[v] > E{})) {
+      continue;
+    }
+    while (excess_[v] > E{}) {
+      if (current_[v] == offsets_[v + 1]) {
+        Relabel(v);
+        if (height_[v] >= n) {
+          break;
+        }
+        continue;
+      }
+      Arc& arc = arcs_[current_[v]];
+      if (arc.capacity > E{} && height_[v] == height_[arc.head] + 1) {
+        const E amount = std::min(excess_[v], arc.capacity);
+        arc.capacity -= amount;
+        arcs_[arc.reverse].capacity += amount;
+        excess_[v] -= amount;
+        if (arc.head != target && arc.head != avoid && !(excess_[arc.head] > E{})) {
+          active_[height_[arc.head]].push_back(arc.head);
+          max_active_ = std::max<std::size_t>(max_active_, height_[arc.head]);
+        }
+        excess_[arc.head] += amount;
+      } else {
+        ++current_[v];
+      }
+    }
+    if (relabels_ >= n) {
+      GlobalRelabel(target, avoid);
+    }
+  }
+}
+
+template <typename N, typename E>
+void FlowNetwork<N, E>::GlobalRelabel(NodeId target, NodeId avoid) {
+  const std::size_t n = nodes_.size();
+  relabels_ = 0;
+  // exact distances to target over arcs that still have capacity, found backwards
+  height_.assign(n, static_cast<NodeId>(n));
+  height_[target] = 0;
+  std::vector<NodeId> queue{target};
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    const NodeId v = queue[i];
+    for (ArcId a = offsets_[v]; a != offsets_[v + 1]; ++a) {
+      const NodeId u = arcs_[a].head;
+      if (height_[u] == n && u != avoid && arcs_[arcs_[a].reverse].capacity > E{}) {
+        height_[u] = height_[v] + 1;
+        queue.push_back(u);
+      }
+    }
+  }
+  for (std::size_t h = 0; h < n; ++h) {
+    active_[h].clear();
+    level_[h].clear();
+  }
+  max_active_ = 0;
+  max_level_ = 0;
+  for (NodeId v = 0; v < n; ++v) {
+    current_[v] = offsets_[v];
+    const std::size_t h = height_[v];
+    if (h < n) {
+      where_[v] = level_[h].size();
+      level_[h].push_back(v);
+      max_level_ = std::max(max_level_, h);
+      if (v != target && v != avoid && excess_[v] > E{}) {
+        active_[h].push_back(v);
+        max_active_ = std::max(max_active_, h);
+      }
+    }
+  }
+}
+
+template <typename N, typename E>
+void FlowNetwork<N, E>::Relabel(NodeId v) {
+  const std::size_t n = nodes_.size();
+  ++relabels_;
+  const std::size_t old = height_[v];
+  auto& old_level = level_[old];
+  where_[old_level.back()] = where_[v];
+  old_level[where_[v]] = old_level.back();
+  old_level.pop_back();
+  if (old_level.empty()) {
+    // a gap: nothing above it can reach the target any more
+    for (std::size_t h = old + 1; h <= max_level_; ++h) {
+      for (NodeId u : level_[h]) {
+        height_[u] = static_cast<NodeId>(n);
+      }
+      level_[h].clear();
+    }
+    max_level_ = old - 1;
+    height_[v] = static_cast<NodeId>(n);
+    return;
+  }
+  std::size_t lowest = n;
+  for (ArcId a = offsets_[v]; a != offsets_[v + 1]; ++a) {
+    if (arcs_[a].capacity > E{}) {
+      lowest = std::min<std::size_t>(lowest, height_[arcs_[a].head] + 1);
+    }
+  }
+  height_[v] = static_cast<NodeId>(lowest);
+  if (lowest < n) {
+    where_[v] = level_[lowest].size();
+    level_[lowest].push_back(v);
+    max_level_ = std::max(max_level_, lowest);
+    current_[v] = offsets_[v];
+  }
+}
+
+template <typename N, typename E>
+void FlowNetwork<N, E>::Dinic(NodeId src, NodeId dst) {
+  const std::size_t n = nodes_.size();
+  const auto unreached = static_cast<NodeId>(n);
+  height_.resize(n);
+  current_.resize(n);
+  std::vector<NodeId> queue;
+  std::vector<ArcId> path;
+  for (;;) {
+    // levels by distance from src over arcs with capacity left
+    std::fill(height_.begin(), height_.end(), unreached);
+    height_[src] = 0;
+    queue.assign(1, src);
+    for (std::size_t i = 0; i < queue.size() && height_[dst] == unreached; ++i) {
+      const NodeId v = queue[i];
+      for (ArcId a = offsets_[v]; a != offsets_[v + 1]; ++a) {
+        if (arcs_[a].capacity > E{} && height_[arcs_[a].head] == unreached) {
+          height_[arcs_[a].head] = height_[v] + 1;
+          queue.push_back(arcs_[a].head);
+        }
+      }
+    }
+    if (height_[dst] == unreached) {
+      return;
+    }
+    std::copy(offsets_.begin(), offsets_.end() - 1, current_.begin());
+
+    // a blocking flow: follow current arcs up the levels, augmenting whenever dst is reached
+    // and backing off dead ends, so that every arc is given up on at most once
+    NodeId v = src;
+    path.clear();
+    for (;;) {
+      if (v == dst) {
+        E amount = arcs_[path.front()].capacity;
+        for (ArcId a : path) {
+          amount = std::min(amount, arcs_[a].capacity);
+        }
+        std::size_t saturated = path.size();
+        for (std::size_t i = 0; i < path.size(); ++i) {
+          Arc& arc = arcs_[path[i]];
+          arc.capacity -= amount;
+          arcs_[arc.reverse].capacity += amount;
+          if (saturated == path.size() && !(arc.capacity > E{})) {
+            saturated = i;
+          }
+        }
+        v = Tail(path[saturated]);
+        path.resize(saturated);
+        continue;
+      }
+      ArcId& a = current_[v];
+      while (a != offsets_[v + 1] &&
+             !(arcs_[a].capacity > E{} && height_[arcs_[a].head] == height_[v] + 1)) {
+        ++a;
+      }
+      if (a != offsets_[v + 1]) {
+        path.push_back(a);
+        v = arcs_[a].head;
+      } else if (v == src) {
+        break;
+      } else {
+        v = Tail(path.back());
+        path.pop_back();
+        ++current_[v];
+      }
+    }
+  }
+}
+
+}  // namespace gdwg
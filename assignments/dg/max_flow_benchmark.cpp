@@ -0,0 +1,72 @@
+// FlowNetwork on layered networks: a source feeding every node of the first layer, each node
+// linked to random nodes of the next layer, and every node of the last layer draining into a
+// sink, with random capacities. Reports the time to build the residual graph and to find the
+// maximum flow by push-relabel and by Dinic's algorithm. Prints JSON to stdout.
+//
+//   max_flow_benchmark [--layers=100] [--width=1000] [--fanout=4]
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/builder.h"
+#include "assignments/dg/max_flow.h"
+
+namespace {
+
+using N = std::uint32_t;
+using E = std::int64_t;
+namespace bm = gdwg::benchmark;
+
+// node 0 is the source, then the layers in order, then the sink
+gdwg::Snapshot<N, E> Layered(std::size_t layers, std::size_t width, std::size_t fanout) {
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<E> capacity(1, 100);
+  std::uniform_int_distribution<std::size_t> column(0, width - 1);
+  const auto sink = static_cast<N>(layers * width + 1);
+  auto id = [width](std::size_t layer, std::size_t col) {
+    return static_cast<N>(1 + layer * width + col);
+  };
+  gdwg::GraphBuilder<N, E> builder;
+  for (N v = 0; v <= sink; ++v) {
+    builder.AddNode(v);
+  }
+  for (std::size_t col = 0; col < width; ++col) {
+    builder.AddEdge(0, id(0, col), capacity(rng));
+    builder.AddEdge(id(layers - 1, col), sink, capacity(rng));
+  }
+  for (std::size_t layer = 0; layer + 1 < layers; ++layer) {
+    for (std::size_t col = 0; col < width; ++col) {
+      for (std::size_t i = 0; i < fanout; ++i) {
+        builder.AddEdge(id(layer, col), id(layer + 1, column(rng)), capacity(rng));
+      }
+    }
+  }
+  return builder.BuildSnapshot();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto layers = bm::Arg(argc, argv, "layers", 100);
+  const auto width = bm::Arg(argc, argv, "width", 1000);
+  const auto fanout = bm::Arg(argc, argv, "fanout", 4);
+
+  const auto snapshot = Layered(layers, width, fanout);
+  const N sink = static_cast<N>(snapshot.NumNodes() - 1);
+  const bm::Fields params{{"nodes", snapshot.NumNodes()}, {"edges", snapshot.NumEdges()}};
+  bm::Reporter reporter;
+  bm::Timer timer;
+  gdwg::FlowNetwork<N, E> network{snapshot};
+  reporter.Add("build", params,
+               {{"seconds", timer.Seconds()}, {"pairs", network.NumPairs()}});
+  for (const auto& [name, algorithm] :
+       {std::pair{"push_relabel", gdwg::FlowAlgorithm::kPushRelabel},
+        std::pair{"dinic", gdwg::FlowAlgorithm::kDinic}}) {
+    E value = 0;
+    const double seconds = bm::Measure([&] { value = network.MaxFlow(0, sink, algorithm).value; });
+    reporter.Add(name, params, {{"seconds", seconds}, {"flow", static_cast<double>(value)}});
+  }
+  reporter.Print(std::cout);
+}
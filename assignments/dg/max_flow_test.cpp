@@ -0,0 +1,219 @@
+/*
+  Tests for FlowNetwork. On random multigraphs both algorithms are checked for every pair of
+  nodes: the flow value must match a simple augmenting path solver, the flows must respect the
+  summed capacities and be conserved at every node but src and dst, and the cut must separate
+  src from dst with capacity equal to the flow.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/max_flow.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+using Capacities = std::map<std::pair<int, int>, std::int64_t>;
+
+constexpr gdwg::FlowAlgorithm kAlgorithms[] = {gdwg::FlowAlgorithm::kPushRelabel,
+                                               gdwg::FlowAlgorithm::kDinic};
+
+// summed capacity of every pair of distinct connected nodes
+Capacities Summed(const gdwg::Graph<int, std::int64_t>& g) {
+  Capacities capacities;
+  for (const auto& [src, dst, w] : g) {
+    if (src != dst) {
+      capacities[{src, dst}] += w;
+    }
+  }
+  return capacities;
+}
+
+// the maximum flow by breadth first augmenting paths over a residual map
+std::int64_t Reference(const Capacities& capacities, int src, int dst) {
+  Capacities residual;
+  for (const auto& [pair, c] : capacities) {
+    residual[pair] += c;
+    residual[{pair.second, pair.first}] += 0;
+  }
+  std::int64_t total = 0;
+  for (;;) {
+    std::map<int, int> parent{{src, src}};
+    std::vector<int> queue{src};
+    for (std::size_t i = 0; i < queue.size() && parent.count(dst) == 0; ++i) {
+      for (const auto& [pair, c] : residual) {
+        if (pair.first == queue[i] && c > 0 && parent.emplace(pair.second, pair.first).second) {
+          queue.push_back(pair.second);
+        }
+      }
+    }
+    if (parent.count(dst) == 0) {
+      return total;
+    }
+    std::int64_t amount = -1;
+    for (int v = dst; v != src; v = parent[v]) {
+      const auto c = residual[{parent[v], v}];
+      amount = amount < 0 ? c : std::min(amount, c);
+    }
+    for (int v = dst; v != src; v = parent[v]) {
+      residual[{parent[v], v}] -= amount;
+      residual[{v, parent[v]}] += amount;
+    }
+    total += amount;
+  }
+}
+
+// true if result is a flow of the given value from src to dst with a cut of the same capacity,
+// which makes both of them maximum
+bool IsMaxFlow(const gdwg::FlowResult<int, std::int64_t>& result,
+               std::int64_t value,
+               const Capacities& capacities,
+               const std::vector<int>& nodes,
+               int src,
+               int dst) {
+  if (result.value != value ||
+      result.flows.size() != capacities.size()) {
+    return false;
+  }
+  std::map<int, std::int64_t> net;
+  for (const auto& [a, b, flow] : result.flows) {
+    const auto it = capacities.find({a, b});
+    if (it == capacities.end() || flow < 0 || flow > it->second) {
+      return false;
+    }
+    net[a] -= flow;
+    net[b] += flow;
+  }
+  for (int v : nodes) {
+    const auto expected = v == dst ? result.value : v == src ? -result.value : 0;
+    if (net[v] != expected) {
+      return false;
+    }
+  }
+  const std::set<int> source_side(result.source_side.begin(), result.source_side.end());
+  if (source_side.count(src) == 0 || source_side.count(dst) != 0 ||
+      result.source_side.size() + result.sink_side.size() != nodes.size()) {
+    return false;
+  }
+  std::int64_t cut = 0;
+  for (const auto& [pair, c] : capacities) {
+    if (source_side.count(pair.first) != 0 && source_side.count(pair.second) == 0) {
+      cut += c;
+    }
+  }
+  return cut == result.value;
+}
+
+}  // namespace
+
+SCENARIO("Both algorithms find a maximum flow and a minimum cut") {
+  for (int edges : {0, 15, 40, 90, 200}) {
+    GIVEN("a random multigraph with 12 nodes and " + std::to_string(edges) + " edges") {
+      const auto g = gdwg::testing::RandomGraph<std::int64_t>(
+          12, edges, static_cast<unsigned>(edges) + 9, 0, 15);
+      const auto capacities = Summed(g);
+      const auto nodes = g.GetNodes();
+      gdwg::FlowNetwork<int, std::int64_t> network{g};
+      THEN("every pair of nodes gets a maximum flow from each") {
+        REQUIRE(network.NumPairs() == capacities.size());
+        bool all = true;
+        for (int src : nodes) {
+          for (int dst : nodes) {
+            if (src != dst) {
+              const auto value = Reference(capacities, src, dst);
+              for (auto algorithm : kAlgorithms) {
+                all = all && IsMaxFlow(network.MaxFlow(src, dst, algorithm), value, capacities,
+                                       nodes, src, dst);
+              }
+            }
+          }
+        }
+        REQUIRE(all);
+      }
+    }
+  }
+  GIVEN("a larger random multigraph, where push-relabel needs its gap and global relabels") {
+    const auto g = gdwg::testing::RandomGraph<std::int64_t>(300, 2400, 77, 0, 15);
+    const auto capacities = Summed(g);
+    const auto nodes = g.GetNodes();
+    gdwg::FlowNetwork<int, std::int64_t> network{g};
+    THEN("both algorithms agree, and each flow has a cut to prove it maximum") {
+      std::mt19937 rng{3};
+      std::uniform_int_distribution<int> node(0, 299);
+      bool all = true;
+      for (int i = 0; i < 30; ++i) {
+        const int src = node(rng);
+        const int dst = (src + 1 + node(rng) % 299) % 300;
+        const auto value = network.MaxFlow(src, dst, gdwg::FlowAlgorithm::kDinic).value;
+        for (auto algorithm : kAlgorithms) {
+          all = all && IsMaxFlow(network.MaxFlow(src, dst, algorithm), value, capacities, nodes,
+                                 src, dst);
+        }
+      }
+      REQUIRE(all);
+    }
+  }
+}
+
+SCENARIO("Capacity between data centers") {
+  GIVEN("links between sites, two of them doubled up") {
+    gdwg::Graph<std::string, std::int64_t> g{"syd", "mel", "per", "sin", "lax"};
+    g.InsertEdge("syd", "mel", 40);
+    g.InsertEdge("syd", "mel", 60);
+    g.InsertEdge("syd", "sin", 30);
+    g.InsertEdge("mel", "per", 50);
+    g.InsertEdge("per", "sin", 80);
+    g.InsertEdge("sin", "lax", 70);
+    g.InsertEdge("sin", "lax", 20);
+    g.InsertEdge("mel", "lax", 10);
+    g.InsertEdge("lax", "lax", 99);
+    WHEN("the flow from syd to lax is found") {
+      const auto result = gdwg::MaxFlow(g, std::string{"syd"}, std::string{"lax"});
+      THEN("the cut is the links out of syd and mel that are full") {
+        REQUIRE(result.value == 90);
+        REQUIRE(result.source_side == std::vector<std::string>{"mel", "syd"});
+        REQUIRE(result.sink_side == std::vector<std::string>{"lax", "per", "sin"});
+        const auto it = std::find_if(result.flows.begin(), result.flows.end(), [](const auto& f) {
+          return std::get<0>(f) == "sin" && std::get<1>(f) == "lax";
+        });
+        REQUIRE(it != result.flows.end());
+        REQUIRE(std::get<2>(*it) == 80);
+      }
+    }
+    WHEN("Dinic's algorithm is used instead") {
+      const auto result = gdwg::MaxFlow(g, std::string{"syd"}, std::string{"per"},
+                                        gdwg::FlowAlgorithm::kDinic);
+      THEN("per is cut off by its one incoming link") {
+        REQUIRE(result.value == 50);
+        REQUIRE(result.sink_side == std::vector<std::string>{"per"});
+      }
+    }
+  }
+}
+
+SCENARIO("Bad input to a flow network is rejected") {
+  GIVEN("a graph with a negative capacity") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, -1);
+    THEN("no network can be built") {
+      REQUIRE_THROWS_WITH((gdwg::FlowNetwork<int, int>{g}),
+                          "Cannot create a FlowNetwork of a graph with negative capacities");
+    }
+  }
+  GIVEN("a network") {
+    gdwg::FlowNetwork<int, int> network{gdwg::Graph<int, int>{1, 2}};
+    THEN("flows from or to missing nodes, or from a node to itself, throw") {
+      REQUIRE_THROWS_AS(network.MaxFlow(1, 3), std::out_of_range);
+      REQUIRE_THROWS_WITH(network.MaxFlow(2, 2),
+                          "Cannot call FlowNetwork::MaxFlow with src the same as dst");
+    }
+  }
+}
@@ -0,0 +1,59 @@
+// Bytes per edge of Graph, broken down by Graph::MemoryUsage, next to the compact layouts the
+// same edges can be held in: a Snapshot (CSR) and a GraphBuilder's flat edge list. Prints JSON
+// to stdout.
+//
+//   memory_benchmark [--edges=1000000] [--threads=<cores>]
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/snapshot.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = float;
+  const auto edges = bm::Arg(argc, argv, "edges", 1000000);
+  gdwg::GeneratorOptions options;
+  options.threads = bm::Arg(argc, argv, "threads", gdwg::DefaultThreads());
+  const auto weights = gdwg::UniformWeights<E>(0, 1);
+  bm::Reporter reporter;
+
+  auto run = [&](const std::string& name, gdwg::GraphBuilder<N, E> builder) {
+    const auto g = builder.Build(options.threads);
+    const double m = g.NumEdges();
+    const double n = g.NumNodes();
+    const auto usage = g.MemoryUsage();
+    const bm::Fields params{{"nodes", n}, {"edges", m}};
+    reporter.Add(name + "/graph", params,
+                 {{"bytes_per_edge", usage.Total() / m},
+                  {"node_map_bytes_per_edge", usage.node_map / m},
+                  {"edge_sets_bytes_per_edge", usage.edge_sets / m},
+                  {"node_values_bytes_per_edge", usage.node_values / m},
+                  {"weights_bytes_per_edge", usage.weights / m},
+                  {"bytes_per_node", usage.node_map / n + usage.node_values / n}});
+
+    // the CSR arrays: one value per node, NumNodes() + 1 offsets, a dst and a weight per edge
+    using Snapshot = gdwg::Snapshot<N, E>;
+    const Snapshot snapshot{g};
+    const double csr_bytes =
+        snapshot.NumNodes() * (sizeof(N) + sizeof(Snapshot::EdgeId)) + sizeof(Snapshot::EdgeId) +
+        snapshot.NumEdges() * (sizeof(Snapshot::NodeId) + sizeof(E));
+    reporter.Add(name + "/snapshot", params, {{"bytes_per_edge", csr_bytes / m}});
+
+    // one (src, dst, weight) tuple per edge, as GraphBuilder and ParseEdgeList hold them
+    reporter.Add(name + "/edge_list", params,
+                 {{"bytes_per_edge", static_cast<double>(sizeof(std::tuple<N, N, E>))}});
+  };
+
+  const auto scale = static_cast<unsigned>(std::log2(edges / 16.0));
+  run("rmat", gdwg::Rmat<N, E>(scale, edges, weights, options));
+  const auto side = static_cast<std::size_t>(std::sqrt(edges / 4.0));
+  run("grid_2d", gdwg::Grid2D<N, E>(side, side, weights, options));
+
+  reporter.Print(std::cout);
+}
@@ -0,0 +1,138 @@
+#ifndef ASSIGNMENTS_DG_MIN_COST_FLOW_H_
+#define ASSIGNMENTS_DG_MIN_COST_FLOW_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+template <typename N, typename E>
+struct CostFlowResult {
+  // units sent, and what they cost
+  std::int64_t flow;
+  E cost;
+  // (src, dst, cost, units) for every edge that carries flow, in graph order
+  std::vector<std::tuple<N, N, E, std::int64_t>> flows;
+};
+
+// Minimum cost flows over a graph whose weights are costs per unit of flow. Every edge is its
+// own arc, parallel edges included, so a pair of nodes can offer several prices; capacities
+// come from a callback, capacity(src, dst, cost), or an array in the order of the snapshot's
+// edges. Self loops never help and are dropped.
+//
+// Solves by successive shortest paths with node potentials (primal-dual): a Dijkstra over the
+// reduced costs, which potentials keep non-negative, finds the cheapest way to send more, then
+// a blocking flow (as in Dinic's algorithm) sends as much as possible along every path of that
+// cost at once before the next Dijkstra. Each Dijkstra stops once it settles the sink.
+//
+// Costs must be non-negative (of a signed arithmetic type), and so must capacities. Bipartite
+// assignment problems are solved faster by MinCostAssignment below.
+template <typename N, typename E>
+class MinCostFlow {
+  // potentials, and so reduced costs, can go below zero
+  static_assert(std::is_arithmetic<E>::value && std::is_signed<E>::value,
+                "MinCostFlow needs signed arithmetic costs");
+
+ public:
+  using Capacity = std::int64_t;
+  static constexpr Capacity kUnlimited = std::numeric_limits<Capacity>::max();
+
+  // capacities[e] is the capacity of the snapshot's edge e
+  MinCostFlow(const Snapshot<N, E>& snapshot, std::vector<Capacity> capacities);
+  template <typename CapacityFn,
+            typename = std::enable_if_t<
+                std::is_invocable_r_v<Capacity, CapacityFn, const N&, const N&, const E&>>>
+  MinCostFlow(const Snapshot<N, E>& snapshot, CapacityFn&& capacity)
+    : MinCostFlow(snapshot, EdgeCapacities(snapshot, capacity)) {}
+  // either of the above for a snapshot of g
+  template <typename CapacitySource>
+  MinCostFlow(const Graph<N, E>& g, CapacitySource&& capacities)
+    : MinCostFlow(Snapshot<N, E>{g}, std::forward<CapacitySource>(capacities)) {}
+
+  // sends up to amount from src to dst as cheaply as possible; by default as much as it can
+  CostFlowResult<N, E> Solve(const N& src, const N& dst, Capacity amount = kUnlimited);
+  // a transportation problem: nodes with positive supply send it, those with negative supply
+  // take that much. Supplies must add up to zero; a flow short of the total supply means the
+  // demands can't all be met.
+  CostFlowResult<N, E> Solve(const std::map<N, Capacity>& supplies);
+
+ private:
+  using NodeId = std::uint32_t;
+  using ArcId = std::uint64_t;
+  static constexpr NodeId kNone = ~NodeId{0};
+
+  struct Arc {
+    NodeId head;
+    ArcId reverse;
+    Capacity capacity;
+    E cost;
+  };
+
+  template <typename CapacityFn>
+  static std::vector<Capacity> EdgeCapacities(const Snapshot<N, E>& snapshot,
+                                              CapacityFn& capacity);
+  // the id of val, or throws out_of_range with message
+  NodeId Id(const N& val, const char* message) const;
+  // min cost flow of up to amount over the graph plus the extra arcs (tail, head, capacity),
+  // from src to dst, which may be nodes past the graph's
+  CostFlowResult<N, E> Run(NodeId src,
+                           NodeId dst,
+                           Capacity amount,
+                           const std::vector<std::tuple<NodeId, NodeId, Capacity>>& extra);
+  // one Dijkstra over reduced costs, then potentials updated; false if dst can't be reached
+  bool Reprice(NodeId src, NodeId dst);
+  // sends up to amount along arcs of zero reduced cost, shortest first, returning what it sent
+  Capacity Augment(NodeId src, NodeId dst, Capacity amount);
+
+  Snapshot<N, E> snapshot_;
+  // (src, dst, capacity) of the edges kept, in snapshot order
+  std::vector<std::tuple<NodeId, NodeId, Capacity>> edges_;
+  std::vector<E> costs_;
+
+  // residual graph and search state of a solve
+  std::size_t num_nodes_ = 0;
+  std::vector<ArcId> offsets_;
+  std::vector<Arc> arcs_;
+  std::vector<E> potential_;
+  std::vector<E> dist_;
+  std::vector<ArcId> parent_;
+  std::vector<NodeId> level_;
+  std::vector<ArcId> current_;
+};
+
+template <typename N, typename E>
+struct Assignment {
+  E cost;
+  // (worker, job) for every node with out edges, in node order
+  std::vector<std::pair<N, N>> pairs;
+};
+
+// The cheapest way to pair every node that has out edges with a distinct node that has in
+// edges, using the lightest edge between them, or nullopt if there is no such pairing. No node
+// may have both. This is a min cost flow with unit capacities, but solved directly (the
+// Hungarian method, sparse): one Dijkstra per worker over alternating paths, which stops at
+// the first free job it reaches, with potentials that start at the cheapest edge out of each
+// worker so that negative costs are fine too.
+template <typename N, typename E>
+std::optional<Assignment<N, E>> MinCostAssignment(const Snapshot<N, E>& snapshot);
+
+template <typename N, typename E>
+std::optional<Assignment<N, E>> MinCostAssignment(const Graph<N, E>& g) {
+  return MinCostAssignment(Snapshot<N, E>{g});
+}
+
+}  // namespace gdwg
+
+#include "assignments/dg/min_cost_flow.tpp"
+
+#endif  // ASSIGNMENTS_DG_MIN_COST_FLOW_H_
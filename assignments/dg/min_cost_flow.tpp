@@ -0,0 +1,406 @@
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+
+namespace gdwg {
+
+template <typename N, typename E>
+MinCostFlow<N, E>::MinCostFlow(const Snapshot<N, E>& snapshot, std::vector<Capacity> capacities)
+  : snapshot_{snapshot} {
+  if (capacities.size() != snapshot.NumEdges()) {
+    throw std::invalid_argument("Cannot create a MinCostFlow without one capacity per edge");
+  }
+  for (NodeId src = 0; src < snapshot.NumNodes(); ++src) {
+    for (auto e = snapshot.EdgeBegin(src); e != snapshot.EdgeEnd(src); ++e) {
+      if (snapshot.Weight(e) < E{}) {
+        throw std::invalid_argument("Cannot create a MinCostFlow of a graph with negative costs");
+      }
+      if (capacities[e] < 0) {
+        throw std::invalid_argument("Cannot create a MinCostFlow with negative capacities");
+      }
+      if (snapshot.Dst(e) != src) {
+        edges_.emplace_back(src, snapshot.Dst(e), capacities[e]);
+        costs_.push_back(snapshot.Weight(e));
+      }
+    }
+  }
+}
+
+template <typename N, typename E>
+template <typename CapacityFn>
+std::vector<typename MinCostFlow<N, E>::Capacity>
+MinCostFlow<N, E>::EdgeCapacities(const Snapshot<N, E>& snapshot, CapacityFn& capacity) {
+  std::vector<Capacity> capacities;
+  capacities.reserve(snapshot.NumEdges());
+  for (NodeId src = 0; src < snapshot.NumNodes(); ++src) {
+    for (auto e = snapshot.EdgeBegin(src); e != snapshot.EdgeEnd(src); ++e) {
+      capacities.push_back(
+          capacity(snapshot.Value(src), snapshot.Value(snapshot.Dst(e)), snapshot.Weight(e)));
+    }
+  }
+  return capacities;
+}
+
+template <typename N, typename E>
+typename MinCostFlow<N, E>::NodeId MinCostFlow<N, E>::Id(const N& val,
+                                                         const char* message) const {
+  if (!snapshot_.IsNode(val)) {
+    throw std::out_of_range(message);
+  }
+  return snapshot_.Id(val);
+}
+
+template <typename N, typename E>
+CostFlowResult<N, E> MinCostFlow<N, E>::Solve(const N& src, const N& dst, Capacity amount) {
+  constexpr const char* kMissing =
+      "Cannot call MinCostFlow::Solve if src or dst node don't exist in the graph";
+  const NodeId s = Id(src, kMissing);
+  const NodeId t = Id(dst, kMissing);
+  if (s == t) {
+    throw std::invalid_argument("Cannot call MinCostFlow::Solve with src the same as dst");
+  }
+  return Run(s, t, amount, {});
+}
+
+template <typename N, typename E>
+CostFlowResult<N, E> MinCostFlow<N, E>::Solve(const std::map<N, Capacity>& supplies) {
+  // a super source feeds the supplies and a super sink drains the demands
+  const auto source = static_cast<NodeId>(snapshot_.NumNodes());
+  const auto sink = source + 1;
+  std::vector<std::tuple<NodeId, NodeId, Capacity>> extra;
+  Capacity total = 0;
+  for (const auto& [node, supply] : supplies) {
+    const NodeId v =
+        Id(node, "Cannot call MinCostFlow::Solve with a supply for a node that doesn't exist");
+    total += supply;
+    if (supply > 0) {
+      extra.emplace_back(source, v, supply);
+    } else if (supply < 0) {
+      extra.emplace_back(v, sink, -supply);
+    }
+  }
+  if (total != 0) {
+    throw std::invalid_argument(
+        "Cannot call MinCostFlow::Solve with supplies that don't add up to zero");
+  }
+  return Run(source, sink, kUnlimited, extra);
+}
+
+template <typename N, typename E>
+CostFlowResult<N, E> MinCostFlow<N, E>::Run(
+    NodeId src,
+    NodeId dst,
+    Capacity amount,
+    const std::vector<std::tuple<NodeId, NodeId, Capacity>>& extra) {
+  // the graph's nodes and the two that a transportation problem adds
+  num_nodes_ = snapshot_.NumNodes() + 2;
+  offsets_.assign(num_nodes_ + 1, 0);
+  for (const auto* list : {&std::as_const(edges_), &extra}) {
+    for (const auto& [tail, head, capacity] : *list) {
+      ++offsets_[tail + 1];
+      ++offsets_[head + 1];
+    }
+  }
+  std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+  arcs_.resize(offsets_[num_nodes_]);
+  std::vector<ArcId> next(offsets_.begin(), offsets_.end() - 1);
+  std::vector<ArcId> edge_arcs;
+  edge_arcs.reserve(edges_.size());
+  auto add = [&](NodeId tail, NodeId head, Capacity capacity, E cost) {
+    const ArcId forward = next[tail]++;
+    const ArcId backward = next[head]++;
+    arcs_[forward] = {head, backward, capacity, cost};
+    arcs_[backward] = {tail, forward, 0, -cost};
+    return forward;
+  };
+  for (std::size_t i = 0; i < edges_.size(); ++i) {
+    const auto& [tail, head, capacity] = edges_[i];
+    edge_arcs.push_back(add(tail, head, capacity, costs_[i]));
+  }
+  for (const auto& [tail, head, capacity] : extra) {
+    add(tail, head, capacity, E{});
+  }
+  // costs are non-negative, so zero potentials start every reduced cost non-negative
+  potential_.assign(num_nodes_, E{});
+  dist_.resize(num_nodes_);
+  parent_.resize(num_nodes_);
+  level_.assign(num_nodes_, static_cast<NodeId>(num_nodes_));
+  current_.resize(num_nodes_);
+
+  CostFlowResult<N, E> result{0, E{}, {}};
+  while (result.flow < amount && Reprice(src, dst)) {
+    result.flow += Augment(src, dst, amount - result.flow);
+  }
+  for (std::size_t i = 0; i < edges_.size(); ++i) {
+    const auto& [tail, head, capacity] = edges_[i];
+    const Capacity units = capacity - arcs_[edge_arcs[i]].capacity;
+    if (units > 0) {
+      result.cost += static_cast<E>(units) * costs_[i];
+      result.flows.emplace_back(snapshot_.Value(tail), snapshot_.Value(head), costs_[i], units);
+    }
+  }
+  return result;
+}
+
+template <typename N, typename E>
+bool MinCostFlow<N, E>::Reprice(NodeId src, NodeId dst) {
+  constexpr E kInfinity = std::numeric_limits<E>::max();
+  std::fill(dist_.begin(), dist_.end(), kInfinity);
+  using Item = std::pair<E, NodeId>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  std::vector<NodeId> settled;
+  dist_[src] = E{};
+  queue.emplace(E{}, src);
+  while (!queue.empty()) {
+    const auto [d, v] = queue.top();
+    queue.pop();
+    if (d > dist_[v]) {
+      continue;
+    }
+    settled.push_back(v);
+    if (v == dst) {
+      break;
+    }
+    for (ArcId a = offsets_[v]; a != offsets_[v + 1]; ++a) {
+      const Arc& arc = arcs_[a];
+      if (arc.capacity > 0) {
+        // never below zero but for rounding
+        const E reduced = std::max(E{}, arc.cost + potential_[v] - potential_[arc.head]);
+        if (d + reduced < dist_[arc.head]) {
+          dist_[arc.head] = d + reduced;
+          parent_[arc.head] = a;
+          queue.emplace(dist_[arc.head], arc.head);
+        }
+      }
+    }
+  }
+  if (dist_[dst] == kInfinity) {
+    return false;
+  }
+  // potential += min(dist, dist to dst), less the dist to dst everywhere, which changes no
+  // reduced cost but leaves every node the search didn't settle as it was
+  for (NodeId v : settled) {
+    potential_[v] += dist_[v] - dist_[dst];
+  }
+  return true;
+}
+
+template <typename N, typename E>
+typename MinCostFlow<N, E>::Capacity MinCostFlow<N, E>::Augment(NodeId src,
+                                                               NodeId dst,
+                                                               Capacity amount) {
+  const auto unreached = static_cast<NodeId>(num_nodes_);
+  auto tail = [&](ArcId a) { return arcs_[arcs_[a].reverse].head; };
+  auto admissible = [&](NodeId v, const Arc& arc) {
+    return arc.capacity > 0 && !(arc.cost + potential_[v] - potential_[arc.head] > E{});
+  };
+  Capacity sent = 0;
+  std::vector<NodeId> queue;
+  std::vector<ArcId> path;
+  // a phase can take hundreds of rounds that each reach few nodes, so only those are reset
+  auto reset = [&] {
+    for (NodeId v : queue) {
+      level_[v] = unreached;
+    }
+  };
+  while (sent < amount) {
+    // hops to dst over the arcs on cheapest paths, found backwards: forwards would cover every
+    // cheapest path out of src, most of which lead elsewhere
+    reset();
+    level_[dst] = 0;
+    current_[dst] = offsets_[dst];
+    queue.assign(1, dst);
+    for (std::size_t i = 0; i < queue.size() && level_[src] == unreached; ++i) {
+      const NodeId v = queue[i];
+      for (ArcId a = offsets_[v]; a != offsets_[v + 1]; ++a) {
+        const NodeId from = arcs_[a].head;
+        if (admissible(from, arcs_[arcs_[a].reverse]) && level_[from] == unreached) {
+          level_[from] = level_[v] + 1;
+          current_[from] = offsets_[from];
+          queue.push_back(from);
+        }
+      }
+    }
+    if (level_[src] == unreached) {
+      break;
+    }
+    NodeId v = src;
+    path.clear();
+    while (sent < amount) {
+      if (v == dst) {
+        Capacity units = amount - sent;
+        for (ArcId a : path) {
+          units = std::min(units, arcs_[a].capacity);
+        }
+        std::size_t saturated = path.size();
+        for (std::size_t i = 0; i < path.size(); ++i) {
+          arcs_[path[i]].capacity -= units;
+          arcs_[arcs_[path[i]].reverse].capacity += units;
+          if (saturated == path.size() && arcs_[path[i]].capacity == 0) {
+            saturated = i;
+          }
+        }
+        sent += units;
+        if (saturated == path.size()) {
+          break;
+        }
+        v = tail(path[saturated]);
+        path.resize(saturated);
+        continue;
+      }
+      ArcId& a = current_[v];
+      while (a != offsets_[v + 1] &&
+             !(admissible(v, arcs_[a]) && level_[arcs_[a].head] + 1 == level_[v])) {
+        ++a;
+      }
+      if (a != offsets_[v + 1]) {
+        path.push_back(a);
+        v = arcs_[a].head;
+      } else if (v == src) {
+        break;
+      } else {
+        v = tail(path.back());
+        path.pop_back();
+        ++current_[v];
+      }
+    }
+  }
+  reset();
+  if (sent == 0) {
+    // rounding hid a path that Dijkstra found, so send along its parents
+    Capacity units = amount;
+    for (NodeId v = dst; v != src; v = tail(parent_[v])) {
+      units = std::min(units, arcs_[parent_[v]].capacity);
+    }
+    for (NodeId v = dst; v != src; v = tail(parent_[v])) {
+      arcs_[parent_[v]].capacity -= units;
+      arcs_[arcs_[parent_[v]].reverse].capacity += units;
+    }
+    sent = units;
+  }
+  return sent;
+}
+
+template <typename N, typename E>
+std::optional<Assignment<N, E>> MinCostAssignment(const Snapshot<N, E>& snapshot) {
+  static_assert(std::is_arithmetic<E>::value && std::is_signed<E>::value,
+                "MinCostAssignment needs signed arithmetic costs");
+  using NodeId = typename Snapshot<N, E>::NodeId;
+  using EdgeId = typename Snapshot<N, E>::EdgeId;
+  constexpr NodeId kNone = ~NodeId{0};
+  constexpr E kInfinity = std::numeric_limits<E>::max();
+  const auto n = static_cast<NodeId>(snapshot.NumNodes());
+
+  // a worker's potential starts at minus its cheapest edge out, so every reduced cost starts at
+  // >= 0. Jobs start at zero, and only change once matched, so every free job has the same
+  // potential and a search can stop at whichever it reaches first.
+  std::vector<E> potential(n, E{});
+  std::vector<char> is_job(n);
+  for (NodeId v = 0; v < n; ++v) {
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      if (e == snapshot.EdgeBegin(v) || snapshot.Weight(e) < -potential[v]) {
+        potential[v] = -snapshot.Weight(e);
+      }
+      is_job[snapshot.Dst(e)] = 1;
+    }
+  }
+  for (NodeId v = 0; v < n; ++v) {
+    if (is_job[v] && snapshot.Degree(v) != 0) {
+      throw std::invalid_argument("Cannot call gdwg::MinCostAssignment on a graph with a node "
+                                  "that has both in and out edges");
+    }
+  }
+
+  // a worker's match is a job and a job's match is a worker
+  std::vector<NodeId> match(n, kNone);
+  std::vector<EdgeId> match_edge(n);
+  std::vector<E> dist(n, kInfinity);
+  // the edge by which the search reached each job
+  std::vector<EdgeId> via(n);
+  std::vector<NodeId> via_worker(n);
+  std::vector<NodeId> settled;
+  std::vector<NodeId> touched;
+  using Item = std::pair<E, NodeId>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  for (NodeId root = 0; root < n; ++root) {
+    if (snapshot.Degree(root) == 0) {
+      continue;
+    }
+    // Dijkstra over alternating paths: a worker's edges to jobs, and a job's match back
+    dist[root] = E{};
+    touched.push_back(root);
+    queue.emplace(E{}, root);
+    NodeId free_job = kNone;
+    while (!queue.empty()) {
+      const auto [d, v] = queue.top();
+      queue.pop();
+      if (d > dist[v]) {
+        continue;
+      }
+      settled.push_back(v);
+      if (is_job[v]) {
+        if (match[v] == kNone) {
+          free_job = v;
+          break;
+        }
+        const NodeId worker = match[v];
+        if (d < dist[worker]) {
+          if (dist[worker] == kInfinity) {
+            touched.push_back(worker);
+          }
+          dist[worker] = d;
+          queue.emplace(d, worker);
+        }
+        continue;
+      }
+      for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+        const NodeId job = snapshot.Dst(e);
+        const E reduced = std::max(E{}, snapshot.Weight(e) + potential[v] - potential[job]);
+        if (d + reduced < dist[job]) {
+          if (dist[job] == kInfinity) {
+            touched.push_back(job);
+          }
+          dist[job] = d + reduced;
+          via[job] = e;
+          via_worker[job] = v;
+          queue.emplace(dist[job], job);
+        }
+      }
+    }
+    if (free_job == kNone) {
+      return std::nullopt;
+    }
+    // as in MinCostFlow::Reprice
+    for (NodeId v : settled) {
+      potential[v] += dist[v] - dist[free_job];
+    }
+    // flip the matches along the path back to root
+    for (NodeId job = free_job; job != kNone;) {
+      const NodeId worker = via_worker[job];
+      const NodeId previous = worker == root ? kNone : match[worker];
+      match[job] = worker;
+      match[worker] = job;
+      match_edge[worker] = via[job];
+      job = previous;
+    }
+    for (NodeId v : touched) {
+      dist[v] = kInfinity;
+    }
+    touched.clear();
+    settled.clear();
+    queue = {};
+  }
+
+  Assignment<N, E> assignment{E{}, {}};
+  for (NodeId worker = 0; worker < n; ++worker) {
+    if (snapshot.Degree(worker) != 0) {
+      assignment.cost += snapshot.Weight(match_edge[worker]);
+      assignment.pairs.emplace_back(snapshot.Value(worker), snapshot.Value(match[worker]));
+    }
+  }
+  return assignment;
+}
+
+}  // namespace gdwg
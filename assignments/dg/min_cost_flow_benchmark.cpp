@@ -0,0 +1,108 @@
+// MinCostFlow and MinCostAssignment on generated instances. The transportation instance is an
+// Erdos-Renyi graph with random costs and capacities, where the first terminals nodes each
+// supply units and the last terminals nodes each take as many. The assignment instance pairs
+// workers with as many jobs, worker i linked to job i and to degree - 1 random others, so a
+// full pairing always exists; it is solved directly and as a unit capacity min cost flow.
+// Pass --nodes=100000 or --degree=100 for instances of 1e6 arcs. Prints JSON to stdout.
+//
+//   min_cost_flow_benchmark [--nodes=10000] [--degree=10] [--terminals=100] [--units=50]
+//                           [--workers=10000]
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/builder.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/min_cost_flow.h"
+
+namespace {
+
+using N = std::uint32_t;
+using E = std::int64_t;
+using Flow = gdwg::MinCostFlow<N, E>;
+namespace bm = gdwg::benchmark;
+
+// workers are 0..workers-1 and jobs workers..2*workers-1
+gdwg::Snapshot<N, E> Bipartite(std::size_t workers, std::size_t degree) {
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<E> cost(1, 1000);
+  std::uniform_int_distribution<std::size_t> job(0, workers - 1);
+  gdwg::GraphBuilder<N, E> builder;
+  for (N v = 0; v < 2 * workers; ++v) {
+    builder.AddNode(v);
+  }
+  for (std::size_t w = 0; w < workers; ++w) {
+    builder.AddEdge(static_cast<N>(w), static_cast<N>(workers + w), cost(rng));
+    for (std::size_t i = 1; i < degree; ++i) {
+      builder.AddEdge(static_cast<N>(w), static_cast<N>(workers + job(rng)), cost(rng));
+    }
+  }
+  return builder.BuildSnapshot();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto nodes = bm::Arg(argc, argv, "nodes", 10000);
+  const auto degree = bm::Arg(argc, argv, "degree", 10);
+  const auto terminals = bm::Arg(argc, argv, "terminals", 100);
+  const auto units = bm::Arg(argc, argv, "units", 50);
+  const auto workers = bm::Arg(argc, argv, "workers", 10000);
+  bm::Reporter reporter;
+
+  {
+    const auto snapshot =
+        gdwg::ErdosRenyi<N, E>(nodes, static_cast<double>(degree) / static_cast<double>(nodes),
+                               gdwg::UniformWeights<E>(1, 100))
+            .BuildSnapshot();
+    std::mt19937_64 rng{7};
+    std::uniform_int_distribution<Flow::Capacity> capacity(1, 20);
+    std::vector<Flow::Capacity> capacities(snapshot.NumEdges());
+    for (auto& c : capacities) {
+      c = capacity(rng);
+    }
+    std::map<N, Flow::Capacity> supplies;
+    for (std::size_t i = 0; i < terminals; ++i) {
+      supplies[static_cast<N>(i)] = static_cast<Flow::Capacity>(units);
+      supplies[static_cast<N>(nodes - 1 - i)] = -static_cast<Flow::Capacity>(units);
+    }
+    bm::Fields params;
+    params.emplace_back("nodes", snapshot.NumNodes());
+    params.emplace_back("arcs", snapshot.NumEdges());
+    params.emplace_back("terminals", terminals);
+    Flow solver{snapshot, capacities};
+    gdwg::CostFlowResult<N, E> result{};
+    const double seconds = bm::Measure([&] { result = solver.Solve(supplies); });
+    reporter.Add("transportation", params,
+                 {{"seconds", seconds},
+                  {"flow", static_cast<double>(result.flow)},
+                  {"cost", static_cast<double>(result.cost)}});
+  }
+
+  {
+    const auto snapshot = Bipartite(workers, degree);
+    bm::Fields params;
+    params.emplace_back("workers", workers);
+    params.emplace_back("arcs", snapshot.NumEdges());
+    std::optional<gdwg::Assignment<N, E>> assignment;
+    const double seconds = bm::Measure([&] { assignment = gdwg::MinCostAssignment(snapshot); });
+    reporter.Add("assignment_hungarian", params,
+                 {{"seconds", seconds}, {"cost", static_cast<double>(assignment->cost)}});
+
+    std::map<N, Flow::Capacity> supplies;
+    for (std::size_t w = 0; w < workers; ++w) {
+      supplies[static_cast<N>(w)] = 1;
+      supplies[static_cast<N>(workers + w)] = -1;
+    }
+    Flow solver{snapshot, std::vector<Flow::Capacity>(snapshot.NumEdges(), 1)};
+    gdwg::CostFlowResult<N, E> result{};
+    const double flow_seconds = bm::Measure([&] { result = solver.Solve(supplies); });
+    reporter.Add("assignment_min_cost_flow", params,
+                 {{"seconds", flow_seconds}, {"cost", static_cast<double>(result.cost)}});
+  }
+  reporter.Print(std::cout);
+}
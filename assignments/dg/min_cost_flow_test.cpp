@@ -0,0 +1,252 @@
+/*
+  Tests for MinCostFlow and MinCostAssignment. Flows on random multigraphs are checked against a
+  plain successive shortest path solver (Bellman-Ford, one path at a time): the same amount at
+  the same cost, within capacities and conserved at every node. Assignments are checked against
+  every permutation of small instances.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/min_cost_flow.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+using Flow = gdwg::MinCostFlow<int, int>;
+using Capacity = Flow::Capacity;
+
+// capacity of each edge, from its ends and cost
+Capacity CapacityOf(int src, int dst, int cost) {
+  return (src * 7 + dst * 3 + cost) % 6;
+}
+
+// (flow, cost) of a min cost flow of up to amount, found one cheapest path at a time
+std::pair<Capacity, std::int64_t> Reference(const gdwg::Graph<int, int>& g,
+                                            int src,
+                                            int dst,
+                                            Capacity amount) {
+  struct Arc {
+    int tail;
+    int head;
+    Capacity capacity;
+    int cost;
+  };
+  std::vector<Arc> arcs;
+  for (const auto& [a, b, w] : g) {
+    if (a != b) {
+      arcs.push_back({a, b, CapacityOf(a, b, w), w});
+      arcs.push_back({b, a, 0, -w});
+    }
+  }
+  Capacity flow = 0;
+  std::int64_t cost = 0;
+  while (flow < amount) {
+    std::map<int, std::int64_t> dist{{src, 0}};
+    std::map<int, std::size_t> parent;
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (std::size_t i = 0; i < arcs.size(); ++i) {
+        const auto it = dist.find(arcs[i].tail);
+        if (arcs[i].capacity > 0 && it != dist.end()) {
+          const auto d = it->second + arcs[i].cost;
+          const auto head = dist.find(arcs[i].head);
+          if (head == dist.end() || d < head->second) {
+            dist[arcs[i].head] = d;
+            parent[arcs[i].head] = i;
+            changed = true;
+          }
+        }
+      }
+    }
+    if (dist.count(dst) == 0) {
+      break;
+    }
+    Capacity units = amount - flow;
+    for (int v = dst; v != src; v = arcs[parent[v]].tail) {
+      units = std::min(units, arcs[parent[v]].capacity);
+    }
+    for (int v = dst; v != src; v = arcs[parent[v]].tail) {
+      arcs[parent[v]].capacity -= units;
+      arcs[parent[v] ^ 1].capacity += units;
+    }
+    flow += units;
+    cost += units * dist[dst];
+  }
+  return {flow, cost};
+}
+
+// true if the flows are within capacity and conserved everywhere but src and dst
+bool IsFlow(const gdwg::CostFlowResult<int, int>& result, const std::vector<int>& nodes) {
+  std::map<int, Capacity> net;
+  std::int64_t cost = 0;
+  for (const auto& [a, b, w, units] : result.flows) {
+    if (units <= 0 || units > CapacityOf(a, b, w)) {
+      return false;
+    }
+    net[a] -= units;
+    net[b] += units;
+    cost += units * w;
+  }
+  const auto unbalanced = std::count_if(nodes.begin(), nodes.end(), [&](int v) {
+    return net[v] != 0;
+  });
+  return cost == result.cost && unbalanced <= 2;
+}
+
+}  // namespace
+
+SCENARIO("Min cost flows match one cheapest path at a time") {
+  for (int edges : {0, 20, 50, 120}) {
+    GIVEN("a random multigraph with 10 nodes and " + std::to_string(edges) + " edges") {
+      const auto g =
+          gdwg::testing::RandomGraph(10, edges, static_cast<unsigned>(edges) + 21, 0, 12);
+      const auto nodes = g.GetNodes();
+      Flow solver{g, CapacityOf};
+      THEN("every pair gets the same flow and cost, unlimited and limited to 3 units") {
+        bool all = true;
+        for (int src : nodes) {
+          for (int dst : nodes) {
+            for (Capacity amount : {Flow::kUnlimited, Capacity{3}}) {
+              if (src != dst) {
+                const auto result = solver.Solve(src, dst, amount);
+                const auto [flow, cost] = Reference(g, src, dst, amount);
+                all = all && result.flow == flow && result.cost == cost && IsFlow(result, nodes);
+              }
+            }
+          }
+        }
+        REQUIRE(all);
+      }
+    }
+  }
+}
+
+SCENARIO("A transportation problem") {
+  GIVEN("two warehouses, three shops and a depot between them") {
+    gdwg::Graph<std::string, double> g{"north", "south", "depot", "a", "b", "c"};
+    g.InsertEdge("north", "a", 4);
+    g.InsertEdge("north", "depot", 1);
+    g.InsertEdge("south", "depot", 2);
+    g.InsertEdge("south", "c", 3);
+    g.InsertEdge("depot", "a", 1);
+    g.InsertEdge("depot", "b", 2);
+    g.InsertEdge("depot", "c", 2.5);
+    // the depot takes at most 10 a day on each route out
+    const std::vector<gdwg::MinCostFlow<std::string, double>::Capacity> capacities{
+        10, 10, 10, 10, 10, 20, 10};
+    gdwg::MinCostFlow<std::string, double> solver{g, capacities};
+    WHEN("north has 15 to ship, south 10, and the shops want 8, 9 and 8") {
+      const auto result = solver.Solve({{"north", 15}, {"south", 10}, {"a", -8}, {"b", -9},
+                                        {"c", -8}});
+      THEN("everything is delivered at the least cost") {
+        REQUIRE(result.flow == 25);
+        // north can only send 10 through the depot, so 5 go straight to a; the depot takes the
+        // rest of a's and most of b's, and c is served straight from south
+        REQUIRE(result.cost == Approx(5 * 4 + 3 * 2 + 7 * 3 + 2 * 4 + 8 * 3));
+      }
+    }
+    WHEN("the shops want more than there is") {
+      THEN("the supplies don't balance") {
+        REQUIRE_THROWS_WITH(solver.Solve({{"north", 15}, {"a", -16}}),
+                            "Cannot call MinCostFlow::Solve with supplies that don't add up to "
+                            "zero");
+      }
+    }
+  }
+}
+
+SCENARIO("Assignments are the cheapest pairings") {
+  for (int workers : {1, 3, 5, 6}) {
+    GIVEN(std::to_string(workers) + " workers with random costs for 6 jobs, some missing") {
+      std::mt19937 rng{static_cast<unsigned>(workers)};
+      std::uniform_int_distribution<int> cost(-5, 20);
+      std::bernoulli_distribution present(0.7);
+      gdwg::Graph<int, int> g;
+      for (int v = 0; v < workers + 6; ++v) {
+        g.InsertNode(v);
+      }
+      for (int w = 0; w < workers; ++w) {
+        for (int j = workers; j < workers + 6; ++j) {
+          if (present(rng)) {
+            g.InsertEdge(w, j, cost(rng));
+            g.InsertEdge(w, j, cost(rng));
+          }
+        }
+      }
+      const auto assignment = gdwg::MinCostAssignment(g);
+      THEN("it matches the best permutation") {
+        std::vector<int> jobs(6);
+        std::iota(jobs.begin(), jobs.end(), workers);
+        std::optional<int> best;
+        do {
+          int total = 0;
+          bool possible = true;
+          for (int w = 0; w < workers && possible; ++w) {
+            const auto weights = g.IsConnected(w, jobs[w]) ? g.GetWeights(w, jobs[w])
+                                                            : std::vector<int>{};
+            possible = !weights.empty();
+            total += possible ? *std::min_element(weights.begin(), weights.end()) : 0;
+          }
+          if (possible && (!best || total < *best)) {
+            best = total;
+          }
+        } while (std::next_permutation(jobs.begin(), jobs.end()));
+        REQUIRE(assignment.has_value() == best.has_value());
+        if (best) {
+          REQUIRE(assignment->cost == *best);
+          REQUIRE(assignment->pairs.size() == static_cast<std::size_t>(workers));
+          int total = 0;
+          for (const auto& [w, j] : assignment->pairs) {
+            const auto weights = g.GetWeights(w, j);
+            total += *std::min_element(weights.begin(), weights.end());
+          }
+          REQUIRE(total == *best);
+        }
+      }
+    }
+  }
+  GIVEN("a graph where a node has edges in and out") {
+    gdwg::Graph<int, int> g{1, 2, 3};
+    g.InsertEdge(1, 2, 0);
+    g.InsertEdge(2, 3, 0);
+    THEN("it isn't an assignment problem") {
+      REQUIRE_THROWS_AS(gdwg::MinCostAssignment(g), std::invalid_argument);
+    }
+  }
+}
+
+SCENARIO("Bad input to a min cost flow is rejected") {
+  GIVEN("a graph with a negative cost") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, -1);
+    THEN("no solver can be built") {
+      REQUIRE_THROWS_WITH((Flow{g, CapacityOf}),
+                          "Cannot create a MinCostFlow of a graph with negative costs");
+    }
+  }
+  GIVEN("a graph with one edge") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, 1);
+    THEN("capacities must be one per edge and not negative") {
+      REQUIRE_THROWS_AS((Flow{g, std::vector<Capacity>{}}), std::invalid_argument);
+      REQUIRE_THROWS_WITH((Flow{g, std::vector<Capacity>{-1}}),
+                          "Cannot create a MinCostFlow with negative capacities");
+    }
+    THEN("solves with missing nodes, or from a node to itself, throw") {
+      Flow solver{g, std::vector<Capacity>{1}};
+      REQUIRE_THROWS_AS(solver.Solve(1, 3), std::out_of_range);
+      REQUIRE_THROWS_AS(solver.Solve({{3, 1}, {1, -1}}), std::out_of_range);
+      REQUIRE_THROWS_AS(solver.Solve(1, 1), std::invalid_argument);
+    }
+  }
+}
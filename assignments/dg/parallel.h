@@ -0,0 +1,213 @@
+#ifndef ASSIGNMENTS_DG_PARALLEL_H_
+#define ASSIGNMENTS_DG_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// Number of workers to use when the caller doesn't say. hardware_concurrency may report 0.
+inline std::size_t DefaultThreads() noexcept {
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Runs fn(i) for every i in [0, n) on up to `threads` workers. The first exception thrown by
+// any fn is rethrown on the calling thread once every worker has finished.
+template <typename Fn>
+void ParallelFor(std::size_t n, Fn fn, std::size_t threads = DefaultThreads()) {
+  threads = std::min(std::max<std::size_t>(threads, 1), n);
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < n; ++i)
+      fn(i);
+    return;
+  }
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  auto work = [&](std::size_t t) {
+    try {
+      for (std::size_t i = t; i < n; i += threads)
+        fn(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock{error_mutex};
+      if (!error)
+        error = std::current_exception();
+    }
+  };
+  for (std::size_t t = 1; t < threads; ++t)
+    workers.emplace_back(work, t);
+  work(0);
+  for (auto& worker : workers)
+    worker.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+// Calls fn(src, dst, weight) for every edge of g, splitting the edges into balanced
+// Graph::Partitions so that each worker scans about the same number of edges. fn must be safe
+// to call concurrently; the graph must not be modified until this returns.
+template <typename N, typename E, typename Fn>
+void ParallelForEachEdge(const Graph<N, E>& g, Fn fn, std::size_t threads = DefaultThreads()) {
+  const auto ranges = g.Partitions(std::max<std::size_t>(threads, 1));
+  ParallelFor(ranges.size(),
+              [&](std::size_t i) {
+                for (auto it = ranges[i].begin(); it != ranges[i].end(); ++it)
+                  std::apply(fn, *it);
+              },
+              threads);
+}
+
+// A fixed set of workers that run one job after another, for code with many short parallel
+// phases (the supersteps of a Pregel computation, say) that would otherwise spend much of its
+// time starting and joining threads. The calling thread works too, as worker 0, and each job
+// ends with every worker having finished it, a barrier. Jobs run one at a time: RunOnEach and
+// For must not be called from inside a job, or from two threads at once.
+class ThreadPool {
+ public:
+  explicit ThreadPool(std::size_t threads = DefaultThreads()) {
+    for (std::size_t worker = 1; worker < std::max<std::size_t>(threads, 1); ++worker)
+      workers_.emplace_back([this, worker] { Work(worker); });
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stopping_ = true;
+    }
+    start_.notify_all();
+    for (auto& worker : workers_)
+      worker.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // workers, the calling thread included
+  std::size_t Size() const noexcept { return workers_.size() + 1; }
+
+  // Runs fn(worker) once on each worker, 0 to Size() - 1, and returns once all have finished.
+  // The first exception thrown by any is rethrown here.
+  template <typename Fn>
+  void RunOnEach(Fn fn) {
+    if (workers_.empty()) {
+      fn(std::size_t{0});
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      job_ = [&fn](std::size_t worker) { fn(worker); };
+      error_ = nullptr;
+      running_ = workers_.size();
+      ++generation_;
+    }
+    start_.notify_all();
+    Execute(0);
+    std::unique_lock<std::mutex> lock{mutex_};
+    done_.wait(lock, [this] { return running_ == 0; });
+    job_ = nullptr;
+    if (error_)
+      std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+
+  // Runs fn(i, worker) for every i in [0, n), each worker taking the next `grain` indices
+  // whenever it finishes its last, so that uneven work evens out.
+  template <typename Fn>
+  void For(std::size_t n, Fn fn, std::size_t grain = 1) {
+    grain = std::max<std::size_t>(grain, 1);
+    std::atomic<std::size_t> next{0};
+    RunOnEach([&](std::size_t worker) {
+      for (auto begin = next.fetch_add(grain); begin < n; begin = next.fetch_add(grain)) {
+        for (auto i = begin; i < std::min(begin + grain, n); ++i)
+          fn(i, worker);
+      }
+    });
+  }
+
+ private:
+  void Work(std::size_t worker) {
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock{mutex_};
+    for (;;) {
+      start_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+      if (stopping_)
+        return;
+      seen = generation_;
+      lock.unlock();
+      Execute(worker);
+      lock.lock();
+      if (--running_ == 0)
+        done_.notify_one();
+    }
+  }
+
+  void Execute(std::size_t worker) {
+    try {
+      job_(worker);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (!error_)
+        error_ = std::current_exception();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  std::function<void(std::size_t)> job_;
+  std::size_t generation_ = 0;
+  std::size_t running_ = 0;
+  bool stopping_ = false;
+  std::exception_ptr error_;
+};
+
+namespace detail {
+
+// Splits nodes [0, n) into at most `parts` ranges with about the same number of edges each,
+// given a CSR offsets array, returned as parts + 1 boundaries. Boundaries other than n are
+// multiples of align, so that ranges can own whole words of a bitmap.
+inline std::vector<std::uint32_t> EdgeBalancedRanges(const std::uint64_t* offsets,
+                                                     std::size_t n,
+                                                     std::size_t parts,
+                                                     std::size_t align = 1) {
+  std::vector<std::uint32_t> bounds{0};
+  const std::uint64_t edges = offsets[n];
+  for (std::size_t i = 1; i < parts; ++i) {
+    // the first node whose edges start at or past the i-th share, counting a node as an edge
+    // so that ranges of edgeless nodes get split too
+    const std::uint64_t target = (edges + n) * i / parts;
+    std::size_t lo = bounds.back();
+    std::size_t hi = n;
+    while (lo < hi) {
+      const std::size_t mid = lo + (hi - lo) / 2;
+      if (offsets[mid] + mid < target)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    lo -= lo % align;
+    if (lo > bounds.back())
+      bounds.push_back(static_cast<std::uint32_t>(lo));
+  }
+  bounds.push_back(static_cast<std::uint32_t>(n));
+  return bounds;
+}
+
+}  // namespace detail
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_PARALLEL_H_
@@ -0,0 +1,118 @@
+/*
+  Tests for the helpers in parallel.h. ParallelForEachEdge is checked against a
+  sequential scan of the same graph, and ParallelFor against its exception contract. A
+  ThreadPool must run every job on every worker, many jobs in a row, and pass exceptions on.
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/parallel.h"
+#include "catch.h"
+
+SCENARIO("ParallelFor visits every index once") {
+  GIVEN("a range of indices") {
+    std::vector<std::atomic<int>> seen(1000);
+    WHEN("it is run on several threads") {
+      gdwg::ParallelFor(seen.size(), [&](std::size_t i) { ++seen[i]; }, 4);
+      THEN("each index was visited exactly once") {
+        for (const auto& s : seen)
+          REQUIRE(s == 1);
+      }
+    }
+    WHEN("a worker throws") {
+      auto run = [&] {
+        gdwg::ParallelFor(seen.size(),
+                          [](std::size_t i) {
+                            if (i == 500)
+                              throw std::runtime_error("boom");
+                          },
+                          4);
+      };
+      THEN("the exception reaches the caller") { REQUIRE_THROWS_WITH(run(), "boom"); }
+    }
+  }
+}
+
+SCENARIO("ParallelForEachEdge aggregates the same result as a sequential scan") {
+  GIVEN("a graph with many edges") {
+    gdwg::Graph<int, long> g;
+    for (int i = 0; i < 50; ++i)
+      g.InsertNode(i);
+    long expected = 0;
+    for (int i = 0; i < 50; ++i) {
+      for (int j = 0; j < i; j += 3) {
+        g.InsertEdge(i, j, i * j);
+        expected += i * j;
+      }
+    }
+    WHEN("weights are summed in parallel") {
+      std::atomic<long> sum{0};
+      std::atomic<std::size_t> count{0};
+      gdwg::ParallelForEachEdge(g,
+                                [&](const int&, const int&, const long& w) {
+                                  sum += w;
+                                  ++count;
+                                },
+                                3);
+      THEN("every edge was visited once") {
+        REQUIRE(count == g.NumEdges());
+        REQUIRE(sum == expected);
+      }
+    }
+  }
+  GIVEN("a graph with nodes but no edges") {
+    gdwg::Graph<std::string, int> g{"a", "b"};
+    THEN("fn is never called") {
+      bool called = false;
+      gdwg::ParallelForEachEdge(g, [&](const auto&, const auto&, const auto&) { called = true; });
+      REQUIRE_FALSE(called);
+    }
+  }
+}
+
+SCENARIO("A ThreadPool runs job after job on the same workers") {
+  for (std::size_t threads : {1, 3, 8}) {
+    GIVEN("a pool of " + std::to_string(threads) + " workers") {
+      gdwg::ThreadPool pool{threads};
+      REQUIRE(pool.Size() == threads);
+      THEN("RunOnEach calls every worker once") {
+        std::vector<std::atomic<int>> calls(threads);
+        pool.RunOnEach([&](std::size_t worker) { ++calls[worker]; });
+        for (const auto& c : calls)
+          REQUIRE(c == 1);
+      }
+      THEN("a hundred For jobs in a row each visit every index once, with any grain") {
+        std::vector<std::atomic<int>> seen(1000);
+        std::atomic<bool> workers_in_range{true};
+        for (std::size_t job = 0; job < 100; ++job) {
+          pool.For(seen.size(),
+                   [&](std::size_t i, std::size_t worker) {
+                     ++seen[i];
+                     if (worker >= threads)
+                       workers_in_range = false;
+                   },
+                   job % 7);
+        }
+        for (const auto& s : seen)
+          REQUIRE(s == 100);
+        REQUIRE(workers_in_range);
+      }
+      THEN("an exception reaches the caller, and the pool still works after") {
+        auto run = [&] {
+          pool.For(100, [](std::size_t i, std::size_t) {
+            if (i == 50)
+              throw std::runtime_error("boom");
+          });
+        };
+        REQUIRE_THROWS_WITH(run(), "boom");
+        std::atomic<std::uint64_t> sum{0};
+        pool.For(100, [&](std::size_t i, std::size_t) { sum += i; });
+        REQUIRE(sum == 4950);
+      }
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#ifndef ASSIGNMENTS_DG_PARTITION_H_
+#define ASSIGNMENTS_DG_PARTITION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// what each part should hold about the same amount of
+enum class PartitionBalance {
+  // nodes
+  kNodes,
+  // edges, each counted with its source node, the shard that stores it
+  kEdges,
+};
+
+struct PartitionOptions {
+  std::size_t parts = 2;
+  PartitionBalance balance = PartitionBalance::kNodes;
+  // no part may weigh more than (1 + imbalance) times its share
+  double imbalance = 0.03;
+  std::uint64_t seed = 42;
+  // refinement passes at each level at most; a level stops early once a pass gains little
+  int refine_passes = 8;
+  // partitions of the coarsest graph to try, keeping the best
+  int initial_tries = 4;
+};
+
+struct Partitioning {
+  // part of every node by its position in node order (the snapshot's NodeId)
+  std::vector<std::uint32_t> part;
+  // total node or edge weight of each part, as balanced
+  std::vector<std::uint64_t> weights;
+  // edges whose ends are in different parts, self loops never among them
+  std::uint64_t edge_cut = 0;
+  // the heaviest part's weight over the average part's: 1 is perfect balance
+  double balance = 1;
+};
+
+// A k-way partition of a graph's nodes with few edges between parts, by the multilevel method
+// of METIS (Karypis and Kumar). Direction is ignored, and every edge counts, parallel or not.
+//
+// Coarsening matches each node with the unmatched neighbour it has the heaviest edge to,
+// visiting nodes in random order, and merges matched pairs, summing node and edge weights,
+// until the graph is small or stops shrinking. Nodes left over, such as the leaves around a hub
+// or nodes with no edges, are paired with another left over next to the same neighbour, or with
+// no neighbours at all, so that power-law graphs keep shrinking. The coarsest graph is split by
+// growing each part in turn from a random node, always adding the node with the heaviest edges
+// into the part, the best of a few tries kept. Each level's partition is then projected onto
+// the finer graph and refined by Fiduccia-Mattheyses passes (the k-way form of Kernighan-Lin):
+// boundary nodes move to whichever part most reduces the cut, best first, even when that makes
+// the cut worse for a while, and the moves after the best cut seen are undone. Moves that would
+// overfill a part are never made, and any part over its limit is first drained into the others.
+template <typename N, typename E>
+Partitioning PartitionGraph(const Snapshot<N, E>& snapshot, const PartitionOptions& options = {});
+
+template <typename N, typename E>
+Partitioning PartitionGraph(const Graph<N, E>& g, const PartitionOptions& options = {}) {
+  return PartitionGraph(Snapshot<N, E>{g}, options);
+}
+
+// The weights, edge cut and balance of any assignment of nodes to options.parts parts, such as
+// a hash of each node, to compare with PartitionGraph's.
+template <typename N, typename E>
+Partitioning EvaluatePartition(const Snapshot<N, E>& snapshot,
+                               std::vector<std::uint32_t> part,
+                               const PartitionOptions& options = {});
+
+}  // namespace gdwg
+
+#include "assignments/dg/partition.tpp"
+
+#endif  // ASSIGNMENTS_DG_PARTITION_H_
@@ -0,0 +1,549 @@
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace gdwg {
+
+namespace detail {
+
+constexpr std::uint32_t kNoPart = ~std::uint32_t{0};
+
+// One level of the multilevel partitioner: an undirected graph with weights on its nodes and
+// edges, each edge in the lists of both its ends.
+struct WeightedGraph {
+  std::vector<std::uint64_t> offsets{0};
+  std::vector<std::uint32_t> adj;
+  std::vector<std::uint64_t> edge_weight;
+  std::vector<std::uint64_t> node_weight;
+
+  std::size_t NumNodes() const noexcept { return node_weight.size(); }
+  std::size_t Degree(std::uint32_t v) const noexcept { return offsets[v + 1] - offsets[v]; }
+};
+
+// the snapshot with each edge's weight the number of edges either way between its ends
+template <typename N, typename E>
+WeightedGraph ToWeightedGraph(const Snapshot<N, E>& snapshot, PartitionBalance balance) {
+  const std::size_t n = snapshot.NumNodes();
+  std::vector<std::uint64_t> offsets(n + 1, 0);
+  for (std::uint32_t v = 0; v < n; ++v) {
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      if (snapshot.Dst(e) != v) {
+        ++offsets[v + 1];
+        ++offsets[snapshot.Dst(e) + 1];
+      }
+    }
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<std::uint32_t> all(offsets[n]);
+  std::vector<std::uint64_t> next(offsets.begin(), offsets.end() - 1);
+  for (std::uint32_t v = 0; v < n; ++v) {
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      if (snapshot.Dst(e) != v) {
+        all[next[v]++] = snapshot.Dst(e);
+        all[next[snapshot.Dst(e)]++] = v;
+      }
+    }
+  }
+  WeightedGraph g;
+  g.offsets.reserve(n + 1);
+  g.node_weight.reserve(n);
+  for (std::uint32_t v = 0; v < n; ++v) {
+    const auto begin = all.begin() + static_cast<std::ptrdiff_t>(offsets[v]);
+    const auto end = all.begin() + static_cast<std::ptrdiff_t>(offsets[v + 1]);
+    std::sort(begin, end);
+    for (auto it = begin; it != end; ++it) {
+      if (it == begin || *it != *(it - 1)) {
+        g.adj.push_back(*it);
+        g.edge_weight.push_back(0);
+      }
+      ++g.edge_weight.back();
+    }
+    g.offsets.push_back(g.adj.size());
+    g.node_weight.push_back(balance == PartitionBalance::kNodes ? 1 : snapshot.Degree(v));
+  }
+  return g;
+}
+
+// The next coarser level: heavy edge matching, then the leftovers paired up by a neighbour in
+// common or by having none. cmap is set to the coarse node each node is merged into.
+inline WeightedGraph Coarsen(const WeightedGraph& g,
+                             std::uint64_t max_node_weight,
+                             std::mt19937_64& rng,
+                             std::vector<std::uint32_t>& cmap) {
+  constexpr auto kUnmatched = kNoPart;
+  const std::size_t n = g.NumNodes();
+  std::vector<std::uint32_t> order(n);
+  std::iota(order.begin(), order.end(), std::uint32_t{0});
+  std::shuffle(order.begin(), order.end(), rng);
+  std::vector<std::uint32_t> match(n, kUnmatched);
+  auto fits = [&](std::uint32_t u, std::uint32_t v) {
+    return g.node_weight[u] + g.node_weight[v] <= max_node_weight;
+  };
+  for (auto u : order) {
+    if (match[u] != kUnmatched) {
+      continue;
+    }
+    auto best = u;
+    std::uint64_t best_weight = 0;
+    for (auto e = g.offsets[u]; e != g.offsets[u + 1]; ++e) {
+      const auto v = g.adj[e];
+      if (match[v] == kUnmatched && fits(u, v) &&
+          (g.edge_weight[e] > best_weight ||
+           (g.edge_weight[e] == best_weight && g.node_weight[v] < g.node_weight[best]))) {
+        best = v;
+        best_weight = g.edge_weight[e];
+      }
+    }
+    if (best != u) {
+      match[u] = best;
+      match[best] = u;
+    }
+  }
+  // leftovers wait at their first neighbour (or with the nodes with none) for a partner
+  std::vector<std::uint32_t> waiting(n + 1, kUnmatched);
+  for (auto u : order) {
+    if (match[u] != kUnmatched) {
+      continue;
+    }
+    const auto at = g.Degree(u) == 0 ? n : g.adj[g.offsets[u]];
+    const auto partner = waiting[at];
+    if (partner != kUnmatched && fits(u, partner)) {
+      match[u] = partner;
+      match[partner] = u;
+      waiting[at] = kUnmatched;
+    } else {
+      waiting[at] = u;
+    }
+  }
+
+  // coarse nodes numbered in order of their first member
+  cmap.assign(n, kUnmatched);
+  std::vector<std::uint32_t> first;
+  for (std::uint32_t v = 0; v < n; ++v) {
+    if (cmap[v] == kUnmatched) {
+      cmap[v] = static_cast<std::uint32_t>(first.size());
+      if (match[v] != kUnmatched) {
+        cmap[match[v]] = cmap[v];
+      }
+      first.push_back(v);
+    }
+  }
+  WeightedGraph coarse;
+  coarse.offsets.reserve(first.size() + 1);
+  coarse.node_weight.reserve(first.size());
+  // where each coarse neighbour is in the current node's list, if it is in it
+  constexpr auto kNowhere = std::numeric_limits<std::uint64_t>::max();
+  std::vector<std::uint64_t> where(first.size(), kNowhere);
+  for (std::uint32_t c = 0; c < first.size(); ++c) {
+    const std::uint64_t start = coarse.adj.size();
+    std::uint64_t weight = 0;
+    for (const auto v : {first[c], match[first[c]]}) {
+      if (v == kUnmatched) {
+        continue;
+      }
+      weight += g.node_weight[v];
+      for (auto e = g.offsets[v]; e != g.offsets[v + 1]; ++e) {
+        const auto d = cmap[g.adj[e]];
+        if (d == c) {
+          continue;
+        }
+        if (where[d] == kNowhere || where[d] < start) {
+          where[d] = coarse.adj.size();
+          coarse.adj.push_back(d);
+          coarse.edge_weight.push_back(g.edge_weight[e]);
+        } else {
+          coarse.edge_weight[where[d]] += g.edge_weight[e];
+        }
+      }
+    }
+    coarse.offsets.push_back(coarse.adj.size());
+    coarse.node_weight.push_back(weight);
+  }
+  return coarse;
+}
+
+// The partition being refined at one level, with each part's weight and scratch space for the
+// edge weight from one node into each part.
+class PartitionState {
+ public:
+  PartitionState(const WeightedGraph& g, std::size_t parts, std::uint64_t max_weight)
+    : g_(g), max_weight_(max_weight), weights_(parts, 0), conn_(parts, 0) {}
+
+  void Assign(std::vector<std::uint32_t> part) {
+    part_ = std::move(part);
+    std::fill(weights_.begin(), weights_.end(), 0);
+    for (std::uint32_t v = 0; v < part_.size(); ++v) {
+      weights_[part_[v]] += g_.node_weight[v];
+    }
+  }
+
+  const std::vector<std::uint32_t>& Parts() const noexcept { return part_; }
+  std::vector<std::uint32_t>& Parts() noexcept { return part_; }
+
+  std::uint64_t Cut() const {
+    std::uint64_t cut = 0;
+    for (std::uint32_t v = 0; v < part_.size(); ++v) {
+      for (auto e = g_.offsets[v]; e != g_.offsets[v + 1]; ++e) {
+        cut += part_[g_.adj[e]] != part_[v] ? g_.edge_weight[e] : 0;
+      }
+    }
+    return cut / 2;
+  }
+
+  std::uint64_t Overweight() const {
+    std::uint64_t over = 0;
+    for (auto w : weights_) {
+      over += w > max_weight_ ? w - max_weight_ : 0;
+    }
+    return over;
+  }
+
+  // Moves any node in an overfull part to the part it has the heaviest edges into that has
+  // room for it, or else to the lightest part if that has room, until no part is overfull.
+  void Balance(std::mt19937_64& rng) {
+    std::vector<std::uint32_t> order(part_.size());
+    std::iota(order.begin(), order.end(), std::uint32_t{0});
+    for (int round = 0; round < 2 && Overweight() > 0; ++round) {
+      std::shuffle(order.begin(), order.end(), rng);
+      for (auto v : order) {
+        if (weights_[part_[v]] <= max_weight_) {
+          continue;
+        }
+        auto target = BestMove(v).first;
+        if (target == kNoPart) {
+          const auto lightest = static_cast<std::uint32_t>(
+              std::min_element(weights_.begin(), weights_.end()) - weights_.begin());
+          target = Fits(v, lightest) ? lightest : kNoPart;
+        }
+        if (target != kNoPart) {
+          Move(v, target);
+        }
+      }
+    }
+  }
+
+  // Fiduccia-Mattheyses passes until one gains little. Returns how much the cut fell.
+  std::uint64_t Refine(int passes) {
+    std::uint64_t gained = 0;
+    auto cut = Cut();
+    for (int pass = 0; pass < passes; ++pass) {
+      const auto gain = RefinePass();
+      gained += gain;
+      cut -= gain;
+      // a pass that took less than a thousandth off the cut is not worth following up
+      if (gain == 0 || gain * 1000 < cut) {
+        break;
+      }
+    }
+    return gained;
+  }
+
+ private:
+  bool Fits(std::uint32_t v, std::uint32_t part) const {
+    return part != part_[v] && weights_[part] + g_.node_weight[v] <= max_weight_;
+  }
+
+  void Move(std::uint32_t v, std::uint32_t part) {
+    weights_[part_[v]] -= g_.node_weight[v];
+    weights_[part] += g_.node_weight[v];
+    part_[v] = part;
+  }
+
+  // the part (with room for v, if room) that v has the heaviest edges into, and how much moving
+  // v there would reduce the cut; kNoPart if v has no edges into any such part
+  std::pair<std::uint32_t, std::int64_t> BestMove(std::uint32_t v, bool room = true) {
+    touched_.clear();
+    for (auto e = g_.offsets[v]; e != g_.offsets[v + 1]; ++e) {
+      const auto p = part_[g_.adj[e]];
+      if (conn_[p] == 0) {
+        touched_.push_back(p);
+      }
+      conn_[p] += g_.edge_weight[e];
+    }
+    auto best = kNoPart;
+    for (auto p : touched_) {
+      if ((room ? Fits(v, p) : p != part_[v]) &&
+          (best == kNoPart || conn_[p] > conn_[best] ||
+           (conn_[p] == conn_[best] && weights_[p] < weights_[best]))) {
+        best = p;
+      }
+    }
+    const std::int64_t gain = best == kNoPart ? 0
+                                              : static_cast<std::int64_t>(conn_[best]) -
+                                                    static_cast<std::int64_t>(conn_[part_[v]]);
+    for (auto p : touched_) {
+      conn_[p] = 0;
+    }
+    return {best, gain};
+  }
+
+  // One pass: each node moves at most once, the move that most reduces the cut first, until
+  // the cut has not improved for a while. Moves after the lowest cut are undone.
+  //
+  // Rather than rescan every neighbour of a node that moves, the queue holds an upper bound on
+  // each node's gain: a neighbour moving out of w's part raises w's gain by at most twice the
+  // edge between them, and one moving between two other parts by at most the edge. A node at
+  // the top is only rescanned if a neighbour has moved since it last was, and goes back in with
+  // its true gain if that is lower. A node whose best part is full waits on that part, and
+  // waiting nodes are let back in, best first, as moves out of the part make room, so that
+  // moves alternate as in two-way FM rather than stopping once the parts fill up.
+  std::uint64_t RefinePass() {
+    using Entry = std::pair<std::int64_t, std::uint32_t>;
+    constexpr auto kNoBound = std::numeric_limits<std::int64_t>::min();
+    const std::size_t n = part_.size();
+    const std::size_t stall = 100 + n / 100;
+    // nodes of far higher degree than usual, whose many neighbours would requeue them over and
+    // over, are only brought up to date when they reach the top
+    const std::size_t hub = 8 * g_.adj.size() / std::max<std::size_t>(n, 1) + 16;
+    std::priority_queue<Entry> heap;
+    std::vector<std::priority_queue<Entry>> waiting(weights_.size());
+    std::vector<std::int64_t> bound(n, kNoBound);
+    // the part the bound is the exact gain of moving to, while no neighbour has moved since
+    std::vector<std::uint32_t> exact(n, kNoPart);
+    for (std::uint32_t v = 0; v < n; ++v) {
+      const auto [target, gain] = BestMove(v, false);
+      if (target != kNoPart) {
+        bound[v] = gain;
+        exact[v] = target;
+        heap.emplace(gain, v);
+      }
+    }
+    std::vector<char> locked(n, 0);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> moves;
+    std::int64_t change = 0;
+    std::int64_t best_change = 0;
+    std::size_t best_moves = 0;
+    while (!heap.empty() && moves.size() - best_moves < stall) {
+      const auto [queued, v] = heap.top();
+      heap.pop();
+      if (locked[v] || queued != bound[v]) {
+        continue;
+      }
+      const auto [target, gain] =
+          exact[v] != kNoPart ? std::pair{exact[v], queued} : BestMove(v, false);
+      bound[v] = target == kNoPart ? kNoBound : gain;
+      exact[v] = target;
+      if (target == kNoPart) {
+        continue;
+      }
+      if (gain < queued) {
+        heap.emplace(gain, v);
+        continue;
+      }
+      if (!Fits(v, target)) {
+        waiting[target].emplace(gain, v);
+        continue;
+      }
+      const auto from = part_[v];
+      moves.emplace_back(v, from);
+      Move(v, target);
+      locked[v] = 1;
+      change -= gain;
+      if (change < best_change) {
+        best_change = change;
+        best_moves = moves.size();
+      }
+      for (auto e = g_.offsets[v]; e != g_.offsets[v + 1]; ++e) {
+        const auto w = g_.adj[e];
+        if (locked[w]) {
+          continue;
+        }
+        exact[w] = kNoPart;
+        if (part_[w] == target || g_.Degree(w) > hub) {
+          continue;
+        }
+        if (bound[w] == kNoBound) {
+          std::tie(exact[w], bound[w]) = BestMove(w, false);
+        } else {
+          const auto weight = static_cast<std::int64_t>(g_.edge_weight[e]);
+          bound[w] += part_[w] == from ? 2 * weight : weight;
+        }
+        heap.emplace(bound[w], w);
+      }
+      // as many waiting nodes as there is now room for, best first
+      auto room = max_weight_ - weights_[from];
+      for (auto& queue = waiting[from]; !queue.empty();) {
+        const auto [w_gain, w] = queue.top();
+        if (locked[w] || bound[w] != w_gain) {
+          queue.pop();
+        } else if (g_.node_weight[w] <= room) {
+          room -= g_.node_weight[w];
+          heap.emplace(w_gain, w);
+          queue.pop();
+        } else {
+          break;
+        }
+      }
+    }
+    while (moves.size() > best_moves) {
+      const auto [v, from] = moves.back();
+      moves.pop_back();
+      Move(v, from);
+    }
+    return static_cast<std::uint64_t>(-best_change);
+  }
+
+  const WeightedGraph& g_;
+  std::uint64_t max_weight_;
+  std::vector<std::uint32_t> part_;
+  std::vector<std::uint64_t> weights_;
+  std::vector<std::uint64_t> conn_;
+  std::vector<std::uint32_t> touched_;
+};
+
+// Grows parts 0 to parts - 2 one at a time to their share of what is left, from a random node,
+// always adding the unassigned node with the heaviest edges into the part (a fresh random node
+// when none has any). What remains is the last part.
+inline std::vector<std::uint32_t> GrowParts(const WeightedGraph& g,
+                                            std::size_t parts,
+                                            std::mt19937_64& rng) {
+  const std::size_t n = g.NumNodes();
+  std::vector<std::uint32_t> part(n, kNoPart);
+  std::vector<std::uint32_t> seeds(n);
+  std::iota(seeds.begin(), seeds.end(), std::uint32_t{0});
+  std::shuffle(seeds.begin(), seeds.end(), rng);
+  auto next_seed = seeds.begin();
+  std::vector<std::uint64_t> conn(n, 0);
+  std::vector<std::uint32_t> touched;
+  std::uint64_t left = std::accumulate(g.node_weight.begin(), g.node_weight.end(),
+                                       std::uint64_t{0});
+  for (std::uint32_t p = 0; p + 1 < parts; ++p) {
+    const double share = static_cast<double>(left) / static_cast<double>(parts - p);
+    std::uint64_t weight = 0;
+    std::priority_queue<std::pair<std::uint64_t, std::uint32_t>> heap;
+    while (static_cast<double>(weight) < share) {
+      if (heap.empty()) {
+        while (next_seed != seeds.end() && part[*next_seed] != kNoPart) {
+          ++next_seed;
+        }
+        if (next_seed == seeds.end()) {
+          break;
+        }
+        heap.emplace(0, *next_seed);
+      }
+      const auto [c, v] = heap.top();
+      heap.pop();
+      if (part[v] != kNoPart || c != conn[v]) {
+        continue;
+      }
+      part[v] = p;
+      weight += g.node_weight[v];
+      for (auto e = g.offsets[v]; e != g.offsets[v + 1]; ++e) {
+        const auto w = g.adj[e];
+        if (part[w] == kNoPart) {
+          touched.push_back(w);
+          conn[w] += g.edge_weight[e];
+          heap.emplace(conn[w], w);
+        }
+      }
+    }
+    for (auto w : touched) {
+      conn[w] = 0;
+    }
+    touched.clear();
+    left -= weight;
+  }
+  for (auto& p : part) {
+    p = p == kNoPart ? static_cast<std::uint32_t>(parts - 1) : p;
+  }
+  return part;
+}
+
+}  // namespace detail
+
+template <typename N, typename E>
+Partitioning PartitionGraph(const Snapshot<N, E>& snapshot, const PartitionOptions& options) {
+  if (options.parts == 0) {
+    throw std::invalid_argument("Cannot call gdwg::PartitionGraph with no parts");
+  }
+  const std::size_t parts = options.parts;
+  std::vector<detail::WeightedGraph> levels;
+  levels.push_back(detail::ToWeightedGraph(snapshot, options.balance));
+  const std::uint64_t total = std::accumulate(
+      levels[0].node_weight.begin(), levels[0].node_weight.end(), std::uint64_t{0});
+  // the limit rounds down, unless that leaves no room for every part's exact share
+  const auto max_weight = std::max<std::uint64_t>(
+      static_cast<std::uint64_t>((1 + options.imbalance) * static_cast<double>(total) / parts),
+      (total + parts - 1) / parts);
+  std::mt19937_64 rng{options.seed};
+
+  // coarsen until there are few nodes for each part, keeping coarse nodes small enough to leave
+  // the partition room to balance
+  const std::size_t coarsest = std::max<std::size_t>(20 * parts, 100);
+  const auto max_node_weight =
+      std::max<std::uint64_t>(static_cast<std::uint64_t>(1.5 * total / coarsest), 1);
+  std::vector<std::vector<std::uint32_t>> cmaps;
+  while (levels.back().NumNodes() > coarsest) {
+    std::vector<std::uint32_t> cmap;
+    auto coarse = detail::Coarsen(levels.back(), max_node_weight, rng, cmap);
+    if (coarse.NumNodes() * 20 > levels.back().NumNodes() * 19) {
+      break;
+    }
+    levels.push_back(std::move(coarse));
+    cmaps.push_back(std::move(cmap));
+  }
+
+  // the best of a few initial partitions, fewest overweight first, then smallest cut
+  std::vector<std::uint32_t> part;
+  std::pair<std::uint64_t, std::uint64_t> best_score;
+  for (int attempt = 0; attempt < std::max(options.initial_tries, 1); ++attempt) {
+    detail::PartitionState state{levels.back(), parts, max_weight};
+    state.Assign(detail::GrowParts(levels.back(), parts, rng));
+    state.Balance(rng);
+    state.Refine(options.refine_passes);
+    const std::pair score{state.Overweight(), state.Cut()};
+    if (attempt == 0 || score < best_score) {
+      best_score = score;
+      part = std::move(state.Parts());
+    }
+  }
+
+  for (std::size_t level = cmaps.size(); level-- > 0;) {
+    std::vector<std::uint32_t> finer(cmaps[level].size());
+    for (std::size_t v = 0; v < finer.size(); ++v) {
+      finer[v] = part[cmaps[level][v]];
+    }
+    detail::PartitionState state{levels[level], parts, max_weight};
+    state.Assign(std::move(finer));
+    state.Balance(rng);
+    state.Refine(options.refine_passes);
+    part = std::move(state.Parts());
+  }
+  return EvaluatePartition(snapshot, std::move(part), options);
+}
+
+template <typename N, typename E>
+Partitioning EvaluatePartition(const Snapshot<N, E>& snapshot,
+                               std::vector<std::uint32_t> part,
+                               const PartitionOptions& options) {
+  const std::size_t n = snapshot.NumNodes();
+  if (part.size() != n ||
+      std::any_of(part.begin(), part.end(), [&](std::uint32_t p) { return p >= options.parts; })) {
+    throw std::invalid_argument("Cannot call gdwg::EvaluatePartition without a part below "
+                                "options.parts for every node");
+  }
+  Partitioning result;
+  result.weights.assign(options.parts, 0);
+  for (std::uint32_t v = 0; v < n; ++v) {
+    result.weights[part[v]] += options.balance == PartitionBalance::kNodes ? 1 : snapshot.Degree(v);
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      result.edge_cut += part[snapshot.Dst(e)] != part[v];
+    }
+  }
+  const std::uint64_t total =
+      std::accumulate(result.weights.begin(), result.weights.end(), std::uint64_t{0});
+  if (total > 0) {
+    result.balance = static_cast<double>(
+                         *std::max_element(result.weights.begin(), result.weights.end())) *
+                     static_cast<double>(options.parts) / static_cast<double>(total);
+  }
+  result.part = std::move(part);
+  return result;
+}
+
+}  // namespace gdwg
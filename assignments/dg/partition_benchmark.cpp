@@ -0,0 +1,66 @@
+// PartitionGraph against hashing nodes into parts on an R-MAT graph, a skewed, power-law like
+// graph, for 2, 4, ... parts up to --parts, balancing nodes and then edges. Reports the time
+// taken, the edges cut (and as a fraction of all edges) and the balance of each, and how many
+// times fewer edges the partitioner cuts than hashing. Prints JSON to stdout.
+//
+//   partition_benchmark [--scale=18] [--degree=16] [--parts=64]
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/partition.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = float;
+  const auto scale = static_cast<unsigned>(bm::Arg(argc, argv, "scale", 18));
+  const auto degree = bm::Arg(argc, argv, "degree", 16);
+  const auto max_parts = bm::Arg(argc, argv, "parts", 64);
+
+  const auto snapshot =
+      gdwg::Rmat<N, E>(scale, (std::size_t{1} << scale) * degree, gdwg::ConstantWeights<E>(1))
+          .BuildSnapshot();
+  const double m = snapshot.NumEdges();
+  bm::Reporter reporter;
+  for (const auto& [name, balance] : {std::pair{"nodes", gdwg::PartitionBalance::kNodes},
+                                      std::pair{"edges", gdwg::PartitionBalance::kEdges}}) {
+    for (std::size_t parts = 2; parts <= max_parts; parts *= 2) {
+      gdwg::PartitionOptions options;
+      options.parts = parts;
+      options.balance = balance;
+      bm::Fields params;
+      params.emplace_back("nodes", snapshot.NumNodes());
+      params.emplace_back("edges", m);
+      params.emplace_back("parts", parts);
+
+      bm::Timer timer;
+      // a multiplicative hash, as a shard router would use
+      std::vector<std::uint32_t> hashed(snapshot.NumNodes());
+      for (std::uint32_t v = 0; v < hashed.size(); ++v) {
+        hashed[v] = static_cast<std::uint32_t>(v * std::uint64_t{2654435761} % parts);
+      }
+      const auto hashing = gdwg::EvaluatePartition(snapshot, std::move(hashed), options);
+      reporter.Add(std::string{"hash_by_"} + name, params,
+                   {{"seconds", timer.Seconds()},
+                    {"edge_cut", hashing.edge_cut},
+                    {"cut_fraction", hashing.edge_cut / m},
+                    {"balance", hashing.balance}});
+
+      timer.Reset();
+      const auto multilevel = gdwg::PartitionGraph(snapshot, options);
+      reporter.Add(std::string{"multilevel_by_"} + name, params,
+                   {{"seconds", timer.Seconds()},
+                    {"edge_cut", multilevel.edge_cut},
+                    {"cut_fraction", multilevel.edge_cut / m},
+                    {"balance", multilevel.balance},
+                    {"cut_reduction", static_cast<double>(hashing.edge_cut) /
+                                          static_cast<double>(multilevel.edge_cut)}});
+    }
+  }
+  reporter.Print(std::cout);
+}
@@ -0,0 +1,158 @@
+/*
+  Tests for PartitionGraph and EvaluatePartition. On graphs with an obvious best partition, two
+  cliques joined by an edge and a grid, the partitioner must find it or come close. On random
+  graphs it must give every node a part, stay within the imbalance allowed, report what
+  EvaluatePartition does, and cut fewer edges than hashing nodes into parts.
+*/
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/builder.h"
+#include "assignments/dg/partition.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+// a quarter of the edges land anywhere and the rest near their source, so there is structure
+// to find
+gdwg::Snapshot<int, int> LocalGraph(int nodes, int edges, unsigned seed) {
+  auto g = gdwg::testing::RandomGraph(nodes, edges / 4, seed, 0, edges);
+  std::mt19937 rng{seed + 1};
+  std::uniform_int_distribution<int> node(0, nodes - 1);
+  for (int i = edges / 4; i < edges; ++i) {
+    const int src = node(rng);
+    g.InsertEdge(src, (src + node(rng) % 20) % nodes, i);
+  }
+  return gdwg::Snapshot<int, int>{g};
+}
+
+}  // namespace
+
+SCENARIO("The partitioner finds obvious partitions") {
+  GIVEN("two cliques of 20 joined by a single edge") {
+    gdwg::GraphBuilder<int, int> builder;
+    for (int a = 0; a < 40; ++a) {
+      for (int b = 0; b < 40; ++b) {
+        if (a != b && a / 20 == b / 20) {
+          builder.AddEdge(a, b, 1);
+        }
+      }
+    }
+    builder.AddEdge(3, 33, 1);
+    const auto snapshot = builder.BuildSnapshot();
+    WHEN("it is split in two") {
+      const auto result = gdwg::PartitionGraph(snapshot);
+      THEN("the cliques are the parts, and only the joining edge is cut") {
+        REQUIRE(result.edge_cut == 1);
+        REQUIRE(result.weights == std::vector<std::uint64_t>{20, 20});
+        REQUIRE(result.balance == 1);
+        for (int v = 0; v < 40; ++v) {
+          REQUIRE(result.part[static_cast<std::size_t>(v)] == result.part[v < 20 ? 0 : 39]);
+        }
+      }
+    }
+  }
+  GIVEN("a 32 x 32 grid with edges both ways") {
+    gdwg::GraphBuilder<int, int> builder;
+    for (int r = 0; r < 32; ++r) {
+      for (int c = 0; c < 32; ++c) {
+        if (c + 1 < 32) {
+          builder.AddEdge(r * 32 + c, r * 32 + c + 1, 1);
+          builder.AddEdge(r * 32 + c + 1, r * 32 + c, 1);
+        }
+        if (r + 1 < 32) {
+          builder.AddEdge(r * 32 + c, (r + 1) * 32 + c, 1);
+          builder.AddEdge((r + 1) * 32 + c, r * 32 + c, 1);
+        }
+      }
+    }
+    const auto snapshot = builder.BuildSnapshot();
+    WHEN("it is split in four") {
+      gdwg::PartitionOptions options;
+      options.parts = 4;
+      const auto result = gdwg::PartitionGraph(snapshot, options);
+      THEN("the cut is near that of four quadrants, 128 edges, and the parts near equal") {
+        REQUIRE(result.edge_cut <= 192);
+        REQUIRE(result.balance <= 1.03);
+      }
+    }
+  }
+}
+
+SCENARIO("Partitions of random graphs are valid, balanced and better than hashing") {
+  const auto snapshot = LocalGraph(2000, 12000, 3);
+  for (auto balance : {gdwg::PartitionBalance::kNodes, gdwg::PartitionBalance::kEdges}) {
+    for (std::size_t parts : {1, 2, 3, 8}) {
+      GIVEN("the graph split into " + std::to_string(parts) + " parts by " +
+            (balance == gdwg::PartitionBalance::kNodes ? "nodes" : "edges")) {
+        gdwg::PartitionOptions options;
+        options.parts = parts;
+        options.balance = balance;
+        const auto result = gdwg::PartitionGraph(snapshot, options);
+        THEN("every node has a part, and the parts are balanced") {
+          REQUIRE(result.part.size() == 2000);
+          REQUIRE(result.weights.size() == parts);
+          REQUIRE(result.balance <= 1 + options.imbalance);
+          std::uint64_t total = 0;
+          for (auto weight : result.weights) {
+            total += weight;
+          }
+          REQUIRE(total == (balance == gdwg::PartitionBalance::kNodes ? 2000 : 12000));
+        }
+        THEN("the weights and cut are as EvaluatePartition reports them") {
+          const auto evaluated = gdwg::EvaluatePartition(snapshot, result.part, options);
+          REQUIRE(evaluated.weights == result.weights);
+          REQUIRE(evaluated.edge_cut == result.edge_cut);
+          REQUIRE(evaluated.balance == result.balance);
+        }
+        THEN("fewer edges are cut than by hashing nodes into parts") {
+          std::vector<std::uint32_t> hashed(2000);
+          for (std::uint32_t v = 0; v < 2000; ++v) {
+            hashed[v] = static_cast<std::uint32_t>(v * 2654435761u % parts);
+          }
+          const auto hashing = gdwg::EvaluatePartition(snapshot, hashed, options);
+          REQUIRE(result.edge_cut <= hashing.edge_cut / 2);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Partitioning a Graph, and what the partitioner won't do") {
+  GIVEN("a graph of strings: a triangle, a pair, and a node on its own") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e", "f"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 1);
+    g.InsertEdge("d", "e", 1);
+    g.InsertEdge("e", "d", 2);
+    THEN("split in two, no edge is cut and the parts are equal") {
+      const auto result = gdwg::PartitionGraph(g);
+      REQUIRE(result.edge_cut == 0);
+      REQUIRE(result.weights == std::vector<std::uint64_t>{3, 3});
+    }
+    THEN("no parts, or a part out of range, is an error") {
+      const gdwg::Snapshot<std::string, int> snapshot{g};
+      gdwg::PartitionOptions options;
+      options.parts = 0;
+      REQUIRE_THROWS_AS(gdwg::PartitionGraph(g, options), std::invalid_argument);
+      REQUIRE_THROWS_AS(gdwg::EvaluatePartition(snapshot, {0, 1, 0, 1, 2, 0}),
+                        std::invalid_argument);
+      REQUIRE_THROWS_AS(gdwg::EvaluatePartition(snapshot, {0, 1}), std::invalid_argument);
+    }
+  }
+  GIVEN("an empty graph") {
+    const gdwg::Snapshot<int, int> snapshot{gdwg::Graph<int, int>{}};
+    THEN("its partition is empty") {
+      const auto result = gdwg::PartitionGraph(snapshot);
+      REQUIRE(result.part.empty());
+      REQUIRE(result.edge_cut == 0);
+      REQUIRE(result.balance == 1);
+    }
+  }
+}
@@ -0,0 +1,23 @@
+#ifndef ASSIGNMENTS_DG_PATH_H_
+#define ASSIGNMENTS_DG_PATH_H_
+
+#include <vector>
+
+namespace gdwg {
+
+// A path found by one of the shortest path searches: the nodes from src to dst, both included
+// (just src for the path from a node to itself), and the sum of the weights along it.
+template <typename N, typename E>
+struct Path {
+  std::vector<N> nodes;
+  E weight;
+
+  bool operator==(const Path& other) const {
+    return nodes == other.nodes && weight == other.weight;
+  }
+  bool operator!=(const Path& other) const { return !(*this == other); }
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_PATH_H_
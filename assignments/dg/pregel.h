@@ -0,0 +1,194 @@
+#ifndef ASSIGNMENTS_DG_PREGEL_H_
+#define ASSIGNMENTS_DG_PREGEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/bit_rows.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/parallel.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// Message combiners for Pregel: each folds two messages to the same node into one, and must be
+// commutative and associative, as messages are folded in no particular order.
+template <typename M>
+struct SumCombiner {
+  M operator()(const M& a, const M& b) const { return a + b; }
+};
+
+template <typename M>
+struct MinCombiner {
+  M operator()(const M& a, const M& b) const { return b < a ? b : a; }
+};
+
+template <typename M>
+struct MaxCombiner {
+  M operator()(const M& a, const M& b) const { return a < b ? b : a; }
+};
+
+// no combiner: every message is delivered as sent
+struct NoCombiner {};
+
+// A bulk synchronous, vertex centric compute engine after Pregel (Malewicz et al.). A run is a
+// sequence of supersteps. In each, a user compute function is called once for every node that
+// is active or has messages, and may read the messages sent to it in the superstep before,
+// update the node's value, send messages along its out-edges or to any node, and vote to halt.
+// A node that votes to halt is inactive until a message wakes it. The run ends when every node
+// is inactive and no messages are in flight.
+//
+// Nodes are split into ranges of about the same number of edges, many more than workers,
+// handed out to the workers of a ThreadPool as each finishes its last. Each range's active
+// nodes are a bitmap whose words the range owns outright. Messages are double buffered: those
+// sent in a superstep go to the sending worker's outbox for the range of their destination,
+// while the superstep reads the inbox filled at the end of the superstep before. At the
+// barrier, each range empties every worker's outbox for it into its inbox, so no message is
+// ever written by two threads at once and nothing is locked. With a combiner, the inbox holds
+// one message per node, folded in as messages arrive; without one, every message is kept,
+// grouped by node by a counting sort.
+template <typename N, typename E, typename V, typename M, typename Combiner = NoCombiner>
+class Pregel {
+ public:
+  using NodeId = std::uint32_t;
+  using EdgeId = std::uint64_t;
+
+  // the messages sent to a node in the superstep before, in no particular order
+  class Messages {
+   public:
+    Messages(const M* first, const M* last) noexcept : first_(first), last_(last) {}
+    const M* begin() const noexcept { return first_; }
+    const M* end() const noexcept { return last_; }
+    std::size_t size() const noexcept { return static_cast<std::size_t>(last_ - first_); }
+    bool empty() const noexcept { return first_ == last_; }
+    const M& operator[](std::size_t i) const noexcept { return first_[i]; }
+
+   private:
+    const M* first_;
+    const M* last_;
+  };
+
+  // What compute sees of the engine while running on one node. Only valid during that call.
+  class Context {
+   public:
+    NodeId Id() const noexcept { return v_; }
+    const N& Node() const noexcept { return engine_.graph_->Value(v_); }
+    V& Value() noexcept { return engine_.values_[v_]; }
+    // 0 for the first superstep of a run
+    std::size_t Superstep() const noexcept { return engine_.superstep_; }
+    std::size_t NumNodes() const noexcept { return engine_.values_.size(); }
+
+    // the node's out-edges, as for Snapshot
+    EdgeId EdgeBegin() const noexcept { return engine_.graph_->EdgeBegin(v_); }
+    EdgeId EdgeEnd() const noexcept { return engine_.graph_->EdgeEnd(v_); }
+    std::size_t Degree() const noexcept { return engine_.graph_->Degree(v_); }
+    NodeId Dst(EdgeId e) const noexcept { return engine_.graph_->Dst(e); }
+    const E& Weight(EdgeId e) const noexcept { return engine_.graph_->Weight(e); }
+
+    // delivers message to dst at the start of the next superstep
+    void SendTo(NodeId dst, const M& message);
+    // sends message along every out-edge, so once to each neighbour per edge
+    void SendToNeighbours(const M& message);
+    // makes the node inactive after this call, until a message arrives for it
+    void VoteToHalt() noexcept { halted_ = true; }
+
+    // adds x to a sum over the superstep, which Aggregated returns in the next
+    void Aggregate(double x) noexcept { sum_ += x; }
+    // the sum of what was aggregated in the superstep before (0 in the first)
+    double Aggregated() const noexcept { return engine_.aggregated_; }
+
+   private:
+    friend class Pregel;
+    Context(Pregel& engine, std::size_t worker) : engine_(engine), worker_(worker) {}
+
+    Pregel& engine_;
+    std::size_t worker_;
+    NodeId v_ = 0;
+    bool halted_ = false;
+    double sum_ = 0;
+    std::uint64_t sent_ = 0;
+  };
+
+  // Every node starts active with value `initial`. The snapshot must outlive the engine.
+  explicit Pregel(const Snapshot<N, E>& snapshot,
+                  V initial = V{},
+                  std::size_t threads = DefaultThreads(),
+                  Combiner combiner = Combiner{});
+  // runs on a snapshot of g, which the engine keeps
+  explicit Pregel(const Graph<N, E>& g,
+                  V initial = V{},
+                  std::size_t threads = DefaultThreads(),
+                  Combiner combiner = Combiner{});
+  Pregel(const Pregel&) = delete;
+  Pregel& operator=(const Pregel&) = delete;
+
+  // Runs supersteps of compute(Context&, const Messages&) until every node has halted with no
+  // messages in flight, or max_supersteps more have run. Returns the number run. A later Run
+  // carries on from where this one stopped, nodes keeping their values and whether they are
+  // active, but counts supersteps from 0 again.
+  template <typename Compute>
+  std::size_t Run(Compute compute,
+                  std::size_t max_supersteps = std::numeric_limits<std::size_t>::max());
+
+  std::size_t NumNodes() const noexcept { return values_.size(); }
+  // values by the snapshot's NodeId
+  const std::vector<V>& Values() const noexcept { return values_; }
+  std::vector<V>& Values() noexcept { return values_; }
+  const V& Value(const N& node) const;
+  bool IsActive(NodeId v) const noexcept { return detail::TestBit(active_.data(), v); }
+  // messages sent over every Run so far
+  std::uint64_t MessagesSent() const noexcept { return messages_sent_; }
+
+ private:
+  static constexpr bool kCombines = !std::is_same<Combiner, NoCombiner>::value;
+
+  void Init(V initial);
+  // delivers every outbox for range r into its inbox; returns how many messages there were
+  std::uint64_t Deliver(std::size_t r);
+  Messages MessagesFor(std::size_t r, NodeId v) const noexcept;
+
+  // what one worker has counted over a superstep, padded so workers don't share a cache line
+  struct alignas(64) Totals {
+    double aggregated = 0;
+    std::uint64_t sent = 0;
+    std::uint64_t active = 0;
+    std::uint64_t delivered = 0;
+  };
+
+  std::optional<Snapshot<N, E>> owned_;
+  const Snapshot<N, E>* graph_;
+  ThreadPool pool_;
+  Combiner combine_;
+  // range r is nodes [bounds_[r], bounds_[r + 1])
+  std::vector<NodeId> bounds_;
+  // the range of each word of the bitmaps, as ranges own whole words
+  std::vector<std::uint32_t> word_range_;
+  std::vector<V> values_;
+  std::vector<std::uint64_t> active_;
+  // outboxes_[worker][range]: messages sent by worker to nodes in range, not yet delivered
+  std::vector<std::vector<std::vector<std::pair<NodeId, M>>>> outboxes_;
+  // with a combiner: a message for each node, if has_message_ is set
+  std::vector<M> combined_;
+  std::vector<std::uint64_t> has_message_;
+  // without: each range's messages grouped by node, node v's in inboxes_[range] ending at
+  // offsets_[v] and starting where the node before's end (or at 0, for the range's first)
+  std::vector<std::vector<M>> inboxes_;
+  std::vector<std::uint64_t> offsets_;
+  std::vector<Totals> totals_;
+  std::uint64_t active_nodes_ = 0;
+  std::uint64_t in_flight_ = 0;
+  std::size_t superstep_ = 0;
+  double aggregated_ = 0;
+  std::uint64_t messages_sent_ = 0;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/pregel.tpp"
+
+#endif  // ASSIGNMENTS_DG_PREGEL_H_
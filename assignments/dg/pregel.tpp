@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <stdexcept>
+
+namespace gdwg {
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+void Pregel<N, E, V, M, Combiner>::Context::SendTo(NodeId dst, const M& message) {
+  engine_.outboxes_[worker_][engine_.word_range_[dst / 64]].emplace_back(dst, message);
+  ++sent_;
+}
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+void Pregel<N, E, V, M, Combiner>::Context::SendToNeighbours(const M& message) {
+  const auto& graph = *engine_.graph_;
+  for (auto e = graph.EdgeBegin(v_); e < graph.EdgeEnd(v_); ++e) {
+    SendTo(graph.Dst(e), message);
+  }
+}
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+Pregel<N, E, V, M, Combiner>::Pregel(const Snapshot<N, E>& snapshot,
+                                     V initial,
+                                     std::size_t threads,
+                                     Combiner combiner)
+  : graph_(&snapshot), pool_(threads), combine_(std::move(combiner)) {
+  Init(std::move(initial));
+}
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+Pregel<N, E, V, M, Combiner>::Pregel(const Graph<N, E>& g,
+                                     V initial,
+                                     std::size_t threads,
+                                     Combiner combiner)
+  : owned_(std::in_place, g), graph_(&*owned_), pool_(threads), combine_(std::move(combiner)) {
+  Init(std::move(initial));
+}
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+void Pregel<N, E, V, M, Combiner>::Init(V initial) {
+  const std::size_t n = graph_->NumNodes();
+  // several ranges a worker, so that one heavy with active nodes doesn't hold up the rest
+  bounds_ = detail::EdgeBalancedRanges(graph_->Offsets(), n, pool_.Size() * 8, 64);
+  const std::size_t ranges = bounds_.size() - 1;
+  word_range_.resize(detail::WordsFor(n));
+  for (std::size_t r = 0; r < ranges; ++r) {
+    std::fill(word_range_.begin() + bounds_[r] / 64,
+              word_range_.begin() + static_cast<std::ptrdiff_t>(detail::WordsFor(bounds_[r + 1])),
+              static_cast<std::uint32_t>(r));
+  }
+
+  values_.assign(n, std::move(initial));
+  active_.assign(detail::WordsFor(n), ~std::uint64_t{0});
+  if (n % 64 != 0) {
+    active_.back() = (std::uint64_t{1} << (n % 64)) - 1;
+  }
+  active_nodes_ = n;
+  has_message_.assign(detail::WordsFor(n), 0);
+  outboxes_.assign(pool_.Size(), std::vector<std::vector<std::pair<NodeId, M>>>(ranges));
+  if constexpr (kCombines) {
+    combined_.resize(n);
+  } else {
+    inboxes_.resize(ranges);
+    offsets_.resize(n);
+  }
+  totals_.resize(pool_.Size());
+}
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+template <typename Compute>
+std::size_t Pregel<N, E, V, M, Combiner>::Run(Compute compute, std::size_t max_supersteps) {
+  const std::size_t ranges = bounds_.size() - 1;
+  aggregated_ = 0;
+  for (superstep_ = 0; superstep_ < max_supersteps; ++superstep_) {
+    if (active_nodes_ == 0 && in_flight_ == 0) {
+      break;
+    }
+    std::fill(totals_.begin(), totals_.end(), Totals{});
+
+    // compute: every node active or with messages, reading the inbox and writing outboxes
+    pool_.For(ranges, [&](std::size_t r, std::size_t worker) {
+      Context context{*this, worker};
+      std::uint64_t active = 0;
+      const std::size_t last = detail::WordsFor(bounds_[r + 1]);
+      for (std::size_t w = bounds_[r] / 64; w < last; ++w) {
+        for (auto bits = active_[w] | has_message_[w]; bits != 0; bits &= bits - 1) {
+          const auto bit = static_cast<unsigned>(__builtin_ctzll(bits));
+          context.v_ = static_cast<NodeId>(w * 64 + bit);
+          context.halted_ = false;
+          compute(context, MessagesFor(r, context.v_));
+          if (context.halted_) {
+            active_[w] &= ~(std::uint64_t{1} << bit);
+          } else {
+            active_[w] |= std::uint64_t{1} << bit;
+            ++active;
+          }
+        }
+      }
+      auto& totals = totals_[worker];
+      totals.aggregated += context.sum_;
+      totals.sent += context.sent_;
+      totals.active += active;
+    });
+
+    // the barrier: each range takes the messages every worker sent it into its inbox
+    pool_.For(ranges,
+              [&](std::size_t r, std::size_t worker) { totals_[worker].delivered += Deliver(r); });
+
+    aggregated_ = 0;
+    active_nodes_ = 0;
+    in_flight_ = 0;
+    for (const auto& totals : totals_) {
+      aggregated_ += totals.aggregated;
+      messages_sent_ += totals.sent;
+      active_nodes_ += totals.active;
+      in_flight_ += totals.delivered;
+    }
+  }
+  return superstep_;
+}
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+std::uint64_t Pregel<N, E, V, M, Combiner>::Deliver(std::size_t r) {
+  const NodeId lo = bounds_[r];
+  const NodeId hi = bounds_[r + 1];
+  std::fill(has_message_.begin() + lo / 64,
+            has_message_.begin() + static_cast<std::ptrdiff_t>(detail::WordsFor(hi)), 0);
+  std::uint64_t delivered = 0;
+  if constexpr (kCombines) {
+    for (auto& outbox : outboxes_) {
+      for (const auto& [dst, message] : outbox[r]) {
+        if (detail::TestBit(has_message_.data(), dst)) {
+          combined_[dst] = combine_(combined_[dst], message);
+        } else {
+          combined_[dst] = message;
+          detail::SetBit(has_message_.data(), dst);
+        }
+      }
+      delivered += outbox[r].size();
+      outbox[r].clear();
+    }
+  } else {
+    // a counting sort by destination: count, turn counts into starts, then place each message
+    // at its node's start and bump it, which leaves every node's offset at its end
+    std::fill(offsets_.begin() + lo, offsets_.begin() + hi, 0);
+    for (const auto& outbox : outboxes_) {
+      for (const auto& sent : outbox[r]) {
+        ++offsets_[sent.first];
+      }
+      delivered += outbox[r].size();
+    }
+    std::uint64_t start = 0;
+    for (NodeId v = lo; v < hi; ++v) {
+      if (offsets_[v] != 0) {
+        detail::SetBit(has_message_.data(), v);
+      }
+      start += std::exchange(offsets_[v], start);
+    }
+    auto& inbox = inboxes_[r];
+    inbox.resize(delivered);
+    for (auto& outbox : outboxes_) {
+      for (auto& [dst, message] : outbox[r]) {
+        inbox[offsets_[dst]++] = std::move(message);
+      }
+      outbox[r].clear();
+    }
+  }
+  return delivered;
+}
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+typename Pregel<N, E, V, M, Combiner>::Messages
+Pregel<N, E, V, M, Combiner>::MessagesFor(std::size_t r, NodeId v) const noexcept {
+  if (!detail::TestBit(has_message_.data(), v)) {
+    return Messages{nullptr, nullptr};
+  }
+  if constexpr (kCombines) {
+    return Messages{&combined_[v], &combined_[v] + 1};
+  } else {
+    const M* inbox = inboxes_[r].data();
+    const std::uint64_t start = v == bounds_[r] ? 0 : offsets_[v - 1];
+    return Messages{inbox + start, inbox + offsets_[v]};
+  }
+}
+
+template <typename N, typename E, typename V, typename M, typename Combiner>
+const V& Pregel<N, E, V, M, Combiner>::Value(const N& node) const {
+  if (!graph_->IsNode(node)) {
+    throw std::out_of_range("Cannot call Pregel::Value on a node that doesn't exist");
+  }
+  return values_[graph_->Id(node)];
+}
+
+}  // namespace gdwg
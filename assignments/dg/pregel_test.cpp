@@ -0,0 +1,248 @@
+/*
+  Tests for Pregel. Shortest paths with a min combiner, labels spread to find components, and
+  PageRank with a sum combiner and an aggregator must give what direct algorithms do, on one
+  worker and on several. Without a combiner every message must arrive as sent. Nodes that vote
+  to halt must stay halted until a message wakes them, and a run must end when none is active
+  and no message is in flight, or after the supersteps allowed.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/components.h"
+#include "assignments/dg/pregel.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+constexpr auto kUnreached = std::numeric_limits<std::uint64_t>::max();
+
+// g with each edge also added the other way
+gdwg::Snapshot<int, int> BothWays(const gdwg::Graph<int, int>& g) {
+  auto symmetric = g;
+  for (const auto& [src, dst, weight] : g) {
+    symmetric.InsertEdge(dst, src, weight);
+  }
+  return gdwg::Snapshot<int, int>{symmetric};
+}
+
+std::vector<std::uint64_t> Dijkstra(const gdwg::Snapshot<int, int>& snapshot, std::uint32_t src) {
+  std::vector<std::uint64_t> dist(snapshot.NumNodes(), kUnreached);
+  using Item = std::pair<std::uint64_t, std::uint32_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  dist[src] = 0;
+  queue.emplace(0, src);
+  while (!queue.empty()) {
+    const auto [d, v] = queue.top();
+    queue.pop();
+    if (d != dist[v]) {
+      continue;
+    }
+    for (auto e = snapshot.EdgeBegin(v); e < snapshot.EdgeEnd(v); ++e) {
+      const auto u = snapshot.Dst(e);
+      const auto through = d + static_cast<std::uint64_t>(snapshot.Weight(e));
+      if (through < dist[u]) {
+        dist[u] = through;
+        queue.emplace(through, u);
+      }
+    }
+  }
+  return dist;
+}
+
+}  // namespace
+
+SCENARIO("Pregel computations give what direct algorithms do, on any number of workers") {
+  const auto directed = gdwg::testing::RandomSnapshot(3000, 9000, 5, 1, 20);
+  const auto symmetric = BothWays(gdwg::testing::RandomGraph(3000, 1400, 6, 1, 20));
+  for (std::size_t threads : {1, 3, 8}) {
+    GIVEN("an engine with " + std::to_string(threads) + " workers") {
+      WHEN("it finds shortest paths from node 0, keeping the least distance sent to each node") {
+        gdwg::Pregel<int, int, std::uint64_t, std::uint64_t, gdwg::MinCombiner<std::uint64_t>>
+            engine{directed, kUnreached, threads};
+        const auto supersteps = engine.Run([](auto& node, const auto& messages) {
+          auto best = node.Superstep() == 0 && node.Id() == 0 ? 0 : kUnreached;
+          for (auto dist : messages) {
+            best = std::min(best, dist);
+          }
+          if (best < node.Value()) {
+            node.Value() = best;
+            for (auto e = node.EdgeBegin(); e < node.EdgeEnd(); ++e) {
+              node.SendTo(node.Dst(e), best + static_cast<std::uint64_t>(node.Weight(e)));
+            }
+          }
+          node.VoteToHalt();
+        });
+        THEN("the distances are Dijkstra's, and every node has halted") {
+          REQUIRE(engine.Values() == Dijkstra(directed, 0));
+          REQUIRE(supersteps > 2);
+          for (std::uint32_t v = 0; v < engine.NumNodes(); ++v) {
+            REQUIRE_FALSE(engine.IsActive(v));
+          }
+        }
+      }
+      WHEN("every node spreads the least node id it has heard of over a symmetric graph") {
+        gdwg::Pregel<int, int, std::uint32_t, std::uint32_t, gdwg::MinCombiner<std::uint32_t>>
+            engine{symmetric, 0, threads};
+        engine.Run([](auto& node, const auto& messages) {
+          if (node.Superstep() == 0) {
+            node.Value() = node.Id();
+            node.SendToNeighbours(node.Value());
+          } else if (messages[0] < node.Value()) {
+            node.Value() = messages[0];
+            node.SendToNeighbours(node.Value());
+          }
+          node.VoteToHalt();
+        });
+        THEN("the labels are the weakly connected components, each its first node") {
+          const auto components = gdwg::WeaklyConnectedComponents(symmetric);
+          std::vector<std::uint32_t> first(components.sizes.size(), 0);
+          for (auto v = static_cast<std::uint32_t>(symmetric.NumNodes()); v-- > 0;) {
+            first[components.component[v]] = v;
+          }
+          for (std::uint32_t v = 0; v < symmetric.NumNodes(); ++v) {
+            REQUIRE(engine.Values()[v] == first[components.component[v]]);
+          }
+        }
+      }
+      WHEN("it runs 30 supersteps of PageRank, dangling nodes' rank spread by an aggregator") {
+        const std::size_t n = directed.NumNodes();
+        gdwg::Pregel<int, int, double, double, gdwg::SumCombiner<double>> engine{
+            directed, 1.0 / static_cast<double>(n), threads};
+        const auto supersteps = engine.Run(
+            [n](auto& node, const auto& messages) {
+              if (node.Superstep() > 0) {
+                const double in = messages.empty() ? 0 : messages[0];
+                node.Value() = 0.15 / static_cast<double>(n) +
+                               0.85 * (in + node.Aggregated() / static_cast<double>(n));
+              }
+              if (node.Degree() == 0) {
+                node.Aggregate(node.Value());
+              } else {
+                node.SendToNeighbours(node.Value() / static_cast<double>(node.Degree()));
+              }
+            },
+            30);
+        THEN("the ranks are those of the same iterations done directly") {
+          REQUIRE(supersteps == 30);
+          std::vector<double> rank(n, 1.0 / static_cast<double>(n));
+          for (int i = 1; i < 30; ++i) {
+            std::vector<double> next(n, 0);
+            double dangling = 0;
+            for (std::uint32_t v = 0; v < n; ++v) {
+              if (directed.Degree(v) == 0) {
+                dangling += rank[v];
+              }
+              for (auto e = directed.EdgeBegin(v); e < directed.EdgeEnd(v); ++e) {
+                next[directed.Dst(e)] += rank[v] / static_cast<double>(directed.Degree(v));
+              }
+            }
+            for (std::uint32_t v = 0; v < n; ++v) {
+              next[v] = 0.15 / static_cast<double>(n) +
+                        0.85 * (next[v] + dangling / static_cast<double>(n));
+            }
+            rank = std::move(next);
+          }
+          for (std::uint32_t v = 0; v < n; ++v) {
+            REQUIRE(engine.Values()[v] == Approx(rank[v]).epsilon(1e-9));
+          }
+        }
+      }
+      WHEN("every node sends its id along each out-edge, without a combiner") {
+        gdwg::Pregel<int, int, std::vector<std::uint32_t>, std::uint32_t> engine{
+            directed, {}, threads};
+        const auto supersteps = engine.Run([](auto& node, const auto& messages) {
+          if (node.Superstep() == 0) {
+            node.SendToNeighbours(node.Id());
+          } else {
+            node.Value().assign(messages.begin(), messages.end());
+          }
+          node.VoteToHalt();
+        });
+        THEN("each node gets one message from each in-edge, and then the run ends") {
+          REQUIRE(supersteps == 2);
+          REQUIRE(engine.MessagesSent() == directed.NumEdges());
+          std::vector<std::vector<std::uint32_t>> in(directed.NumNodes());
+          for (std::uint32_t v = 0; v < directed.NumNodes(); ++v) {
+            for (auto e = directed.EdgeBegin(v); e < directed.EdgeEnd(v); ++e) {
+              in[directed.Dst(e)].push_back(v);
+            }
+          }
+          for (std::uint32_t v = 0; v < directed.NumNodes(); ++v) {
+            auto got = engine.Values()[v];
+            std::sort(got.begin(), got.end());
+            REQUIRE(got == in[v]);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Nodes halt until woken, and runs stop when nothing is left to do") {
+  GIVEN("a chain of strings a -> b -> c -> d and an engine counting calls on each") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "d", 1);
+    gdwg::Pregel<std::string, int, int, int> engine{g, 0, 2};
+    // a token passed down the chain, each node counting the times it is called
+    auto pass = [](auto& node, const auto& messages) {
+      ++node.Value();
+      if ((node.Superstep() == 0 && node.Node() == "a") || !messages.empty()) {
+        node.SendToNeighbours(1);
+      }
+      node.VoteToHalt();
+    };
+    WHEN("it runs at most two supersteps") {
+      const auto supersteps = engine.Run(pass, 2);
+      THEN("every node was called first, and then only b, which the token woke") {
+        REQUIRE(supersteps == 2);
+        REQUIRE(engine.Value("a") == 1);
+        REQUIRE(engine.Value("b") == 2);
+        REQUIRE(engine.Value("c") == 1);
+        REQUIRE(engine.Value("d") == 1);
+        REQUIRE_FALSE(engine.IsActive(0));
+      }
+      AND_WHEN("it runs on without a limit") {
+        const auto more = engine.Run(pass);
+        THEN("the token reaches d, whose send goes nowhere, and the run stops") {
+          REQUIRE(more == 2);
+          REQUIRE(engine.Value("c") == 2);
+          REQUIRE(engine.Value("d") == 2);
+          REQUIRE(engine.MessagesSent() == 3);
+          REQUIRE(engine.Run(pass) == 0);
+        }
+      }
+    }
+    THEN("asking for the value of a node that doesn't exist is an error") {
+      REQUIRE_THROWS_WITH(engine.Value("z"),
+                          "Cannot call Pregel::Value on a node that doesn't exist");
+    }
+  }
+  GIVEN("a node that never halts") {
+    gdwg::Graph<int, int> g{7};
+    gdwg::Pregel<int, int, int, int> engine{g};
+    THEN("only the superstep limit ends the run") {
+      REQUIRE(engine.Run([](auto& node, const auto&) { ++node.Value(); }, 5) == 5);
+      REQUIRE(engine.Value(7) == 5);
+      REQUIRE(engine.IsActive(0));
+    }
+  }
+  GIVEN("an empty graph") {
+    gdwg::Pregel<int, int, int, int> engine{gdwg::Graph<int, int>{}};
+    THEN("a run does nothing") {
+      REQUIRE(engine.NumNodes() == 0);
+      REQUIRE(engine.Run([](auto&, const auto&) {}) == 0);
+    }
+  }
+}
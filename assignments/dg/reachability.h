@@ -0,0 +1,88 @@
+#ifndef ASSIGNMENTS_DG_REACHABILITY_H_
+#define ASSIGNMENTS_DG_REACHABILITY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/bit_rows.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// A Graph together with an index that answers "is there a path from a to b" in O(log n): a
+// lookup of each node's strongly connected component, then a single bit test.
+//
+// The graph is condensed into its strongly connected components (Tarjan), and each component
+// keeps a row of bits (see bit_rows.h) marking every component it can reach, so the index
+// takes components^2 / 8 bytes. A path has one or more edges, so a node reaches itself only if
+// it is on a cycle, as in DenseGraph::GetReachable.
+//
+// Mutations go through this class so that the index keeps up:
+//  - InsertNode and InsertEdge update the index in place, except for an edge that closes a
+//    cycle: that merges components, and marks the index stale instead.
+//  - DeleteNode, Replace, MergeReplace and erase (of a pair's last edge) mark the index stale.
+// A stale index is rebuilt from scratch (O(nodes + edges + components^2 / 64)) by the next
+// query, so any number of deletions in a row cost one rebuild.
+//
+// Queries on a stale index rebuild it, so concurrent queries are only safe once the index is
+// fresh (IsStale() is false, e.g. right after Rebuild()).
+template <typename N, typename E>
+class ReachabilityIndex {
+ public:
+  ReachabilityIndex() = default;
+  explicit ReachabilityIndex(Graph<N, E> g) : graph_{std::move(g)} { Rebuild(); }
+
+  const Graph<N, E>& GetGraph() const noexcept { return graph_; }
+
+  bool InsertNode(const N& val);
+  bool InsertEdge(const N& src, const N& dst, const E& w);
+  bool DeleteNode(const N& node);
+  bool Replace(const N& old_data, const N& new_data);
+  void MergeReplace(const N& old_data, const N& new_data);
+  bool erase(const N& src, const N& dst, const E& w);
+  void Clear();
+
+  // true if there is a path of one or more edges from src to dst
+  bool IsReachable(const N& src, const N& dst) const;
+  // every node reachable from src, in sorted order
+  std::vector<N> GetReachable(const N& src) const;
+
+  // rebuilds the index now rather than on the next query
+  void Rebuild() const;
+  bool IsStale() const noexcept { return stale_; }
+  // times the index has been built from scratch, including by the constructor
+  std::size_t Rebuilds() const noexcept { return rebuilds_; }
+  std::size_t NumComponents() const;
+  // bytes held by the closure rows and the node to component lookup
+  std::size_t IndexBytes() const noexcept;
+
+ private:
+  using Component = std::uint32_t;
+
+  void Refresh() const {
+    if (stale_) {
+      Rebuild();
+    }
+  }
+  std::uint64_t* Row(Component c) const noexcept { return bits_.data() + c * words_; }
+  Component AddComponent();
+
+  Graph<N, E> graph_;
+  mutable std::map<N, Component> component_of_;
+  mutable std::size_t num_components_ = 0;
+  mutable std::size_t words_ = 0;
+  // row c, words_ long, has bit d set if component c reaches component d
+  mutable std::vector<std::uint64_t> bits_;
+  mutable bool stale_ = false;
+  mutable std::size_t rebuilds_ = 0;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/reachability.tpp"
+
+#endif  // ASSIGNMENTS_DG_REACHABILITY_H_
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+template <typename N, typename E>
+bool ReachabilityIndex<N, E>::InsertNode(const N& val) {
+  if (!graph_.InsertNode(val)) {
+    return false;
+  }
+  if (!stale_) {
+    component_of_.emplace(val, AddComponent());
+  }
+  return true;
+}
+
+template <typename N, typename E>
+bool ReachabilityIndex<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  if (!graph_.InsertEdge(src, dst, w)) {
+    return false;
+  }
+  if (stale_) {
+    return true;
+  }
+  const Component a = component_of_.find(src)->second;
+  const Component b = component_of_.find(dst)->second;
+  if (detail::TestBit(Row(a), b)) {
+    return true;  // already reachable, so nothing new is
+  }
+  if (a == b) {
+    detail::SetBit(Row(a), a);  // a self loop; whatever reaches a already reached it
+    return true;
+  }
+  if (detail::TestBit(Row(b), a)) {
+    stale_ = true;  // closes a cycle, which merges components
+    return true;
+  }
+  // whatever reaches a, and a itself, now reaches b and everything b reaches
+  for (Component x = 0; x < num_components_; ++x) {
+    if (x == a || detail::TestBit(Row(x), a)) {
+      detail::SetBit(Row(x), b);
+      detail::OrInto(Row(x), Row(b), words_);
+    }
+  }
+  return true;
+}
+
+template <typename N, typename E>
+bool ReachabilityIndex<N, E>::DeleteNode(const N& node) {
+  if (!graph_.DeleteNode(node)) {
+    return false;
+  }
+  stale_ = true;
+  return true;
+}
+
+template <typename N, typename E>
+bool ReachabilityIndex<N, E>::Replace(const N& old_data, const N& new_data) {
+  if (!graph_.Replace(old_data, new_data)) {
+    return false;
+  }
+  // Graph::Replace keeps only the old node's outgoing edges, so paths into it are lost
+  stale_ = true;
+  return true;
+}
+
+template <typename N, typename E>
+void ReachabilityIndex<N, E>::MergeReplace(const N& old_data, const N& new_data) {
+  graph_.MergeReplace(old_data, new_data);
+  stale_ = true;
+}
+
+template <typename N, typename E>
+bool ReachabilityIndex<N, E>::erase(const N& src, const N& dst, const E& w) {
+  if (!graph_.erase(src, dst, w)) {
+    return false;
+  }
+  // a parallel edge left behind keeps every path
+  if (!graph_.IsConnected(src, dst)) {
+    stale_ = true;
+  }
+  return true;
+}
+
+template <typename N, typename E>
+void ReachabilityIndex<N, E>::Clear() {
+  graph_.Clear();
+  component_of_.clear();
+  num_components_ = 0;
+  words_ = 0;
+  bits_.clear();
+  stale_ = false;
+}
+
+template <typename N, typename E>
+bool ReachabilityIndex<N, E>::IsReachable(const N& src, const N& dst) const {
+  Refresh();
+  const auto s = component_of_.find(src);
+  const auto d = component_of_.find(dst);
+  if (s == component_of_.end() || d == component_of_.end()) {
+    throw std::runtime_error(
+        "Cannot call ReachabilityIndex::IsReachable if src or dst node don't exist in the graph");
+  }
+  return detail::TestBit(Row(s->second), d->second);
+}
+
+template <typename N, typename E>
+std::vector<N> ReachabilityIndex<N, E>::GetReachable(const N& src) const {
+  Refresh();
+  const auto s = component_of_.find(src);
+  if (s == component_of_.end()) {
+    throw std::out_of_range(
+        "Cannot call ReachabilityIndex::GetReachable if src doesn't exist in the graph");
+  }
+  const std::uint64_t* row = Row(s->second);
+  std::vector<N> nodes;
+  for (const auto& [node, component] : component_of_) {
+    if (detail::TestBit(row, component)) {
+      nodes.push_back(node);
+    }
+  }
+  return nodes;
+}
+
+template <typename N, typename E>
+void ReachabilityIndex<N, E>::Rebuild() const {
+  using NodeId = typename Snapshot<N, E>::NodeId;
+  using EdgeId = typename Snapshot<N, E>::EdgeId;
+  constexpr NodeId kUnvisited = std::numeric_limits<NodeId>::max();
+  constexpr Component kOnStack = std::numeric_limits<Component>::max();
+  const Snapshot<N, E> snapshot{graph_};
+  const std::size_t n = snapshot.NumNodes();
+
+  // Tarjan's algorithm without recursion. Components are numbered in the order they complete,
+  // which is a reverse topological order: every edge between two components goes to the one
+  // with the lower number. The nodes of component c are members[member_begin[c]..[c + 1]).
+  std::vector<NodeId> order(n, kUnvisited);
+  std::vector<NodeId> low(n);
+  std::vector<Component> component(n, kOnStack);
+  std::vector<NodeId> stack;
+  std::vector<std::pair<NodeId, EdgeId>> calls;
+  std::vector<NodeId> members;
+  std::vector<std::size_t> member_begin{0};
+  members.reserve(n);
+  NodeId next_order = 0;
+  for (NodeId root = 0; root < n; ++root) {
+    if (order[root] != kUnvisited) {
+      continue;
+    }
+    order[root] = low[root] = next_order++;
+    stack.push_back(root);
+    calls.emplace_back(root, snapshot.EdgeBegin(root));
+    while (!calls.empty()) {
+      const NodeId v = calls.back().first;
+      if (calls.back().second != snapshot.EdgeEnd(v)) {
+        const NodeId w = snapshot.Dst(calls.back().second++);
+        if (order[w] == kUnvisited) {
+          order[w] = low[w] = next_order++;
+          stack.push_back(w);
+          calls.emplace_back(w, snapshot.EdgeBegin(w));
+        } else if (component[w] == kOnStack) {
+          low[v] = std::min(low[v], order[w]);
+        }
+        continue;
+      }
+      calls.pop_back();
+      if (!calls.empty()) {
+        low[calls.back().first] = std::min(low[calls.back().first], low[v]);
+      }
+      if (low[v] == order[v]) {
+        const auto c = static_cast<Component>(member_begin.size() - 1);
+        NodeId w;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          component[w] = c;
+          members.push_back(w);
+        } while (w != v);
+        member_begin.push_back(members.size());
+      }
+    }
+  }
+
+  // closure rows in completion order, so every row a component points to is already done
+  num_components_ = member_begin.size() - 1;
+  words_ = detail::WordsFor(num_components_);
+  bits_.assign(num_components_ * words_, 0);
+  for (Component c = 0; c < num_components_; ++c) {
+    std::uint64_t* row = Row(c);
+    if (member_begin[c + 1] - member_begin[c] > 1) {
+      detail::SetBit(row, c);
+    }
+    for (auto m = member_begin[c]; m != member_begin[c + 1]; ++m) {
+      for (auto e = snapshot.EdgeBegin(members[m]); e != snapshot.EdgeEnd(members[m]); ++e) {
+        const Component d = component[snapshot.Dst(e)];
+        if (d == c) {
+          detail::SetBit(row, c);
+        } else if (!detail::TestBit(row, d)) {
+          // if d was already set, so was everything d reaches
+          detail::SetBit(row, d);
+          detail::OrInto(row, Row(d), words_);
+        }
+      }
+    }
+  }
+
+  component_of_.clear();
+  for (NodeId id = 0; id < n; ++id) {
+    component_of_.emplace_hint(component_of_.end(), snapshot.Value(id), component[id]);
+  }
+  stale_ = false;
+  ++rebuilds_;
+}
+
+template <typename N, typename E>
+std::size_t ReachabilityIndex<N, E>::NumComponents() const {
+  Refresh();
+  return num_components_;
+}
+
+template <typename N, typename E>
+std::size_t ReachabilityIndex<N, E>::IndexBytes() const noexcept {
+  // a std::map node is the value plus three pointers and a colour
+  constexpr std::size_t kMapNode = sizeof(typename decltype(component_of_)::value_type) +
+                                   4 * sizeof(void*);
+  return bits_.capacity() * sizeof(std::uint64_t) + component_of_.size() * kMapNode;
+}
+
+template <typename N, typename E>
+typename ReachabilityIndex<N, E>::Component ReachabilityIndex<N, E>::AddComponent() {
+  const auto c = static_cast<Component>(num_components_++);
+  if (num_components_ > words_ * 64) {
+    // rows are a fixed number of words, so widening them moves every row
+    const std::size_t words = std::max<std::size_t>(1, 2 * words_);
+    std::vector<std::uint64_t> bits(num_components_ * words);
+    for (Component r = 0; r < c; ++r) {
+      std::copy(Row(r), Row(r) + words_, bits.data() + r * words);
+    }
+    bits_ = std::move(bits);
+    words_ = words;
+  } else {
+    bits_.resize(num_components_ * words_);
+  }
+  return c;
+}
+
+}  // namespace gdwg
@@ -0,0 +1,110 @@
+// ReachabilityIndex on an R-MAT graph: build time, index size, IsReachable latency against a
+// breadth first search, and the cost of keeping the index up to date. Prints JSON to stdout.
+//
+//   reachability_benchmark [--scale=14] [--edge_factor=2] [--queries=1000000]
+
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/reachability.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = float;
+  const auto scale = static_cast<unsigned>(bm::Arg(argc, argv, "scale", 14));
+  const std::size_t nodes = std::size_t{1} << scale;
+  const auto edges = nodes * bm::Arg(argc, argv, "edge_factor", 2);
+  const auto queries = bm::Arg(argc, argv, "queries", 1000000);
+
+  auto builder = gdwg::Rmat<N, E>(scale, edges, gdwg::UniformWeights<E>(0, 1));
+  for (N i = 0; i < nodes; ++i) {
+    builder.AddNode(i);
+  }
+  const auto snapshot = builder.BuildSnapshot();
+  bm::Timer timer;
+  gdwg::ReachabilityIndex<N, E> index{snapshot.ToGraph()};
+  const double build_seconds = timer.Seconds();
+  const bm::Fields params{{"nodes", nodes}, {"edges", snapshot.NumEdges()}};
+  bm::Reporter reporter;
+  reporter.Add("build", params,
+               {{"seconds", build_seconds},
+                {"components", index.NumComponents()},
+                {"index_bytes", index.IndexBytes()},
+                {"index_bytes_per_node", static_cast<double>(index.IndexBytes()) / nodes}});
+
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<N> node(0, static_cast<N>(nodes - 1));
+  std::vector<std::pair<N, N>> pairs(queries);
+  for (auto& pair : pairs) {
+    pair = {node(rng), node(rng)};
+  }
+  std::size_t reachable = 0;
+  const double seconds = bm::Measure([&] {
+    reachable = 0;
+    for (const auto& [a, b] : pairs) {
+      reachable += index.IsReachable(a, b);
+    }
+  });
+  reporter.Add("is_reachable/index", params,
+               {{"ns_per_query", 1e9 * seconds / pairs.size()},
+                {"reachable_fraction", static_cast<double>(reachable) / pairs.size()}});
+
+  // the same question answered by a search of the snapshot, stopping at dst
+  pairs.resize(std::min<std::size_t>(queries, 200));
+  std::vector<std::uint32_t> seen(nodes);
+  std::uint32_t mark = 0;
+  const double search_seconds = bm::Measure([&] {
+    std::size_t found = 0;
+    for (const auto& [a, b] : pairs) {
+      ++mark;
+      std::queue<N> queue;
+      queue.push(a);
+      bool hit = false;
+      while (!queue.empty() && !hit) {
+        const N v = queue.front();
+        queue.pop();
+        for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+          const N w = snapshot.Dst(e);
+          hit = hit || w == b;
+          if (seen[w] != mark) {
+            seen[w] = mark;
+            queue.push(w);
+          }
+        }
+      }
+      found += hit;
+    }
+    bm::DoNotOptimize(found);
+  });
+  reporter.Add("is_reachable/search", params,
+               {{"ns_per_query", 1e9 * search_seconds / pairs.size()}});
+
+  // edges that don't close a cycle are folded into the index; a deletion costs a full rebuild
+  const std::size_t inserts = 1000;
+  std::size_t folded = 0;
+  timer.Reset();
+  for (std::size_t i = 0; i < inserts; ++i) {
+    const N a = node(rng);
+    const N b = node(rng);
+    if (!index.IsReachable(b, a)) {
+      index.InsertEdge(a, b, 0);
+      ++folded;
+    }
+  }
+  reporter.Add("insert_edge", params,
+               {{"us_per_insert", 1e6 * timer.Seconds() / inserts},
+                {"folded", static_cast<double>(folded)},
+                {"rebuilds", static_cast<double>(index.Rebuilds() - 1)}});
+  index.DeleteNode(node(rng));
+  timer.Reset();
+  index.Rebuild();
+  reporter.Add("rebuild_after_delete", params, {{"seconds", timer.Seconds()}});
+
+  reporter.Print(std::cout);
+}
@@ -0,0 +1,201 @@
+/*
+  Tests for ReachabilityIndex. Every answer is checked against a breadth first search of the
+  index's own graph, after it is built and after each kind of mutation, and the tests check
+  which mutations are applied in place and which leave a rebuild for the next query.
+*/
+
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/reachability.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+// nodes reachable from src by one or more edges
+std::vector<int> Reachable(const gdwg::Graph<int, int>& g, int src) {
+  std::set<int> seen;
+  std::queue<int> queue;
+  queue.push(src);
+  while (!queue.empty()) {
+    for (int next : g.GetConnected(queue.front())) {
+      if (seen.insert(next).second) {
+        queue.push(next);
+      }
+    }
+    queue.pop();
+  }
+  return {seen.begin(), seen.end()};
+}
+
+bool MatchesSearch(const gdwg::ReachabilityIndex<int, int>& index) {
+  const auto& g = index.GetGraph();
+  for (int src : g.GetNodes()) {
+    const auto reachable = Reachable(g, src);
+    if (index.GetReachable(src) != reachable) {
+      return false;
+    }
+    for (int dst : g.GetNodes()) {
+      const bool expected = std::binary_search(reachable.begin(), reachable.end(), dst);
+      if (index.IsReachable(src, dst) != expected) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+SCENARIO("A built index agrees with a search of the graph") {
+  for (int edges : {0, 60, 120, 400}) {
+    GIVEN("a random graph with 130 nodes and " + std::to_string(edges) + " edges") {
+      const gdwg::ReachabilityIndex<int, int> index{
+          gdwg::testing::RandomGraph(130, edges, 3, 0, 2)};
+      THEN("every pair is answered like a breadth first search") {
+        REQUIRE(index.Rebuilds() == 1);
+        REQUIRE(MatchesSearch(index));
+        REQUIRE(index.NumComponents() <= 130);
+      }
+    }
+  }
+  GIVEN("a cycle, a self loop and a chain") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "a", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "c", 1);
+    g.InsertEdge("c", "d", 1);
+    const gdwg::ReachabilityIndex<std::string, int> index{g};
+    THEN("a node reaches itself only on a cycle") {
+      REQUIRE(index.NumComponents() == 4);
+      REQUIRE(index.IsReachable("a", "a"));
+      REQUIRE(index.IsReachable("c", "c"));
+      REQUIRE_FALSE(index.IsReachable("d", "d"));
+      REQUIRE(index.GetReachable("a") == std::vector<std::string>{"a", "b", "c", "d"});
+      REQUIRE(index.GetReachable("e").empty());
+      REQUIRE_FALSE(index.IsReachable("d", "a"));
+    }
+  }
+}
+
+SCENARIO("Insertions are applied to the index in place") {
+  GIVEN("an empty index") {
+    gdwg::ReachabilityIndex<int, int> index;
+    WHEN("nodes and edges that never close a cycle are inserted") {
+      std::mt19937 rng{5};
+      for (int i = 0; i < 150; ++i) {
+        index.InsertNode(i);
+        std::uniform_int_distribution<int> earlier(0, i);
+        for (int k = 0; k < 2; ++k) {
+          // edges only go from lower to higher values, so there are no cycles
+          const int src = earlier(rng);
+          if (src != i) {
+            index.InsertEdge(src, i, k);
+          }
+        }
+      }
+      THEN("it agrees with a search and was never rebuilt") {
+        REQUIRE(index.Rebuilds() == 0);
+        REQUIRE_FALSE(index.IsStale());
+        REQUIRE(MatchesSearch(index));
+        REQUIRE(index.NumComponents() == 150);
+      }
+    }
+  }
+  GIVEN("an index of a chain") {
+    gdwg::ReachabilityIndex<int, int> index{gdwg::Graph<int, int>{1, 2, 3, 4}};
+    index.InsertEdge(1, 2, 0);
+    index.InsertEdge(2, 3, 0);
+    index.InsertEdge(3, 4, 0);
+    WHEN("a self loop is added") {
+      index.InsertEdge(2, 2, 0);
+      THEN("the node reaches itself without a rebuild") {
+        REQUIRE_FALSE(index.IsStale());
+        REQUIRE(index.IsReachable(2, 2));
+        REQUIRE(MatchesSearch(index));
+      }
+    }
+    WHEN("an edge closes a cycle") {
+      index.InsertEdge(4, 2, 0);
+      THEN("the index is rebuilt by the next query, once") {
+        REQUIRE(index.IsStale());
+        REQUIRE(index.IsReachable(4, 3));
+        REQUIRE(index.IsReachable(3, 3));
+        REQUIRE_FALSE(index.IsReachable(4, 1));
+        REQUIRE(index.Rebuilds() == 2);
+        REQUIRE(index.NumComponents() == 2);
+        REQUIRE(MatchesSearch(index));
+        REQUIRE(index.Rebuilds() == 2);
+      }
+    }
+  }
+}
+
+SCENARIO("Deletions leave the index to be rebuilt lazily") {
+  GIVEN("an index of a random graph") {
+    gdwg::ReachabilityIndex<int, int> index{gdwg::testing::RandomGraph(100, 150, 9, 0, 2)};
+    WHEN("several nodes and edges are removed") {
+      for (int i = 0; i < 100; i += 7) {
+        index.DeleteNode(i);
+      }
+      const auto g = index.GetGraph();
+      for (auto it = g.cbegin(); it != g.cend(); ++it) {
+        const auto& [src, dst, w] = *it;
+        if ((src + dst) % 4 == 0) {
+          index.erase(src, dst, w);
+        }
+      }
+      index.MergeReplace(1, 2);
+      index.Replace(3, 1000);
+      THEN("one rebuild brings it up to date") {
+        REQUIRE(index.IsStale());
+        REQUIRE(index.Rebuilds() == 1);
+        REQUIRE(MatchesSearch(index));
+        REQUIRE(index.Rebuilds() == 2);
+      }
+    }
+    WHEN("one of two parallel edges is erased") {
+      index.InsertEdge(3, 4, 100);
+      index.InsertEdge(3, 4, 101);
+      index.Rebuild();
+      index.erase(3, 4, 100);
+      THEN("no path is lost, so the index is still fresh") {
+        REQUIRE_FALSE(index.IsStale());
+        REQUIRE(index.IsReachable(3, 4));
+      }
+    }
+    WHEN("mutations that change nothing are made") {
+      REQUIRE_FALSE(index.DeleteNode(1000));
+      REQUIRE_FALSE(index.erase(3, 4, 1000));
+      THEN("the index is still fresh") {
+        REQUIRE_FALSE(index.IsStale());
+      }
+    }
+    WHEN("it is cleared") {
+      index.Clear();
+      index.InsertNode(1);
+      THEN("it is empty and fresh") {
+        REQUIRE_FALSE(index.IsStale());
+        REQUIRE(index.NumComponents() == 1);
+        REQUIRE(index.GetReachable(1).empty());
+      }
+    }
+  }
+}
+
+SCENARIO("Queries about missing nodes throw like Graph's") {
+  GIVEN("an index") {
+    const gdwg::ReachabilityIndex<int, int> index{gdwg::Graph<int, int>{1, 2}};
+    THEN("missing nodes are reported") {
+      REQUIRE_THROWS_WITH(
+          index.IsReachable(1, 3),
+          "Cannot call ReachabilityIndex::IsReachable if src or dst node don't exist in the graph");
+      REQUIRE_THROWS_AS(index.GetReachable(3), std::out_of_range);
+    }
+  }
+}
@@ -0,0 +1,53 @@
+#ifndef ASSIGNMENTS_DG_REORDER_H_
+#define ASSIGNMENTS_DG_REORDER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "assignments/dg/snapshot.h"
+#include "assignments/dg/undirected.h"
+
+namespace gdwg {
+
+// Ways to renumber a graph's nodes so that nodes used together sit together in memory. A
+// snapshot numbers nodes in the order of N's operator<, which usually has nothing to do with
+// the graph's shape. Each works on the undirected graph underneath (see UndirectedGraph).
+enum class Reordering {
+  // by degree, highest first: the hubs that most edges lead to share cache lines
+  kDegree,
+  // breadth first from the highest degree node of each component in turn
+  kBfs,
+  // reverse Cuthill-McKee: breadth first from a node at the far edge of each component,
+  // visiting neighbours lowest degree first, then reversed. Keeps the ids at either end of an
+  // edge close together, which suits meshes and road networks.
+  kReverseCuthillMcKee,
+  // Gorder (Wei, Yu, Lu and Lin): greedily places next whichever node has the most edges to,
+  // and neighbours in common with, the last `window` nodes placed
+  kGorder,
+};
+
+struct NodeOrder {
+  // new id of each node, by its snapshot NodeId
+  std::vector<std::uint32_t> rank;
+  // snapshot NodeId of the node given each new id
+  std::vector<std::uint32_t> node;
+};
+
+// a new numbering of the snapshot's nodes. window is only used by kGorder.
+template <typename N, typename E>
+NodeOrder OrderNodes(const Snapshot<N, E>& snapshot,
+                     Reordering reordering,
+                     std::size_t window = 5);
+
+// A copy of the snapshot with node v renamed order.rank[v], edges and all. A snapshot keeps its
+// nodes sorted, so the copy's nodes are the new ids themselves; snapshot.Value(order.node[i])
+// is the node that was renamed i.
+template <typename N, typename E>
+Snapshot<std::uint32_t, E> Reorder(const Snapshot<N, E>& snapshot, const NodeOrder& order);
+
+}  // namespace gdwg
+
+#include "assignments/dg/reorder.tpp"
+
+#endif  // ASSIGNMENTS_DG_REORDER_H_
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace gdwg {
+
+namespace detail {
+
+using OrderId = std::uint32_t;
+constexpr OrderId kNoNode = ~OrderId{0};
+
+// nodes by degree, highest first, ties in id order
+inline std::vector<OrderId> ByDegree(const UndirectedGraph& g) {
+  std::vector<OrderId> nodes(g.NumNodes());
+  std::iota(nodes.begin(), nodes.end(), OrderId{0});
+  std::stable_sort(nodes.begin(), nodes.end(), [&g](OrderId a, OrderId b) {
+    return g.Degree(a) > g.Degree(b);
+  });
+  return nodes;
+}
+
+// the nodes of start's component in breadth first order, marking them visited; neighbours are
+// taken lowest degree first if by_degree, else in id order
+inline void BreadthFirst(const UndirectedGraph& g,
+                         OrderId start,
+                         bool by_degree,
+                         std::vector<char>& visited,
+                         std::vector<OrderId>& out) {
+  std::size_t i = out.size();
+  visited[start] = 1;
+  out.push_back(start);
+  for (; i < out.size(); ++i) {
+    const std::size_t first = out.size();
+    for (auto it = g.NeighboursBegin(out[i]); it != g.NeighboursEnd(out[i]); ++it) {
+      if (!visited[*it]) {
+        visited[*it] = 1;
+        out.push_back(*it);
+      }
+    }
+    if (by_degree) {
+      std::stable_sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(),
+                       [&g](OrderId a, OrderId b) { return g.Degree(a) < g.Degree(b); });
+    }
+  }
+}
+
+// a node about as far from the rest of its component as any (George and Liu): from start,
+// repeatedly move to the lowest degree node of the last breadth first level while that level
+// gets further away
+inline OrderId PeripheralNode(const UndirectedGraph& g,
+                              OrderId start,
+                              std::vector<OrderId>& level) {
+  constexpr int kMaxSteps = 4;
+  std::vector<OrderId> queue;
+  std::size_t eccentricity = 0;
+  for (int step = 0; step < kMaxSteps; ++step) {
+    queue.assign(1, start);
+    level[start] = 0;
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      for (auto it = g.NeighboursBegin(queue[i]); it != g.NeighboursEnd(queue[i]); ++it) {
+        if (level[*it] == kNoNode) {
+          level[*it] = level[queue[i]] + 1;
+          queue.push_back(*it);
+        }
+      }
+    }
+    const OrderId last = level[queue.back()];
+    OrderId next = queue.back();
+    for (auto it = queue.rbegin(); it != queue.rend() && level[*it] == last; ++it) {
+      next = g.Degree(*it) < g.Degree(next) ? *it : next;
+    }
+    for (OrderId v : queue) {
+      level[v] = kNoNode;
+    }
+    if (step != 0 && last <= eccentricity) {
+      break;
+    }
+    eccentricity = last;
+    start = next;
+  }
+  return start;
+}
+
+// A max-priority queue of nodes by a small integer key that changes one at a time, as in
+// Gorder: a list of nodes per key, so that each change and each pop is O(1) (amortised over
+// the pops for the fall of the highest key).
+class UnitHeap {
+ public:
+  // every node with key 0, to be popped (while keys are equal) in the order given
+  explicit UnitHeap(const std::vector<OrderId>& nodes)
+    : key_(nodes.size(), 0), next_(nodes.size()), prev_(nodes.size()), head_{kNoNode} {
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+      PushFront(*it);
+    }
+  }
+
+  void Add(OrderId v, int delta) {
+    Unlink(v);
+    key_[v] = static_cast<OrderId>(static_cast<int>(key_[v]) + delta);
+    PushFront(v);
+  }
+
+  void Remove(OrderId v) { Unlink(v); }
+
+  // the node with the highest key; there must be one
+  OrderId Top() {
+    while (head_[top_] == kNoNode) {
+      --top_;
+    }
+    return head_[top_];
+  }
+
+ private:
+  void PushFront(OrderId v) {
+    if (key_[v] >= head_.size()) {
+      head_.resize(key_[v] + 1, kNoNode);
+    }
+    next_[v] = head_[key_[v]];
+    prev_[v] = kNoNode;
+    if (next_[v] != kNoNode) {
+      prev_[next_[v]] = v;
+    }
+    head_[key_[v]] = v;
+    top_ = std::max<std::size_t>(top_, key_[v]);
+  }
+
+  void Unlink(OrderId v) {
+    if (prev_[v] != kNoNode) {
+      next_[prev_[v]] = next_[v];
+    } else {
+      head_[key_[v]] = next_[v];
+    }
+    if (next_[v] != kNoNode) {
+      prev_[next_[v]] = prev_[v];
+    }
+  }
+
+  std::vector<OrderId> key_;
+  std::vector<OrderId> next_;
+  std::vector<OrderId> prev_;
+  // first node with each key
+  std::vector<OrderId> head_;
+  // no key above this has any nodes
+  std::size_t top_ = 0;
+};
+
+inline std::vector<OrderId> GorderSequence(const UndirectedGraph& g, std::size_t window) {
+  const std::size_t n = g.NumNodes();
+  const auto by_degree = ByDegree(g);
+  // as in Gorder, neighbours in common through a hub are too many to count and say little
+  const auto hub = static_cast<std::size_t>(std::sqrt(static_cast<double>(n))) + 1;
+  std::vector<char> placed(n, 0);
+  UnitHeap heap{by_degree};
+  // adds delta to the score of every unplaced node that u shares an edge or a neighbour with
+  auto score = [&](OrderId u, int delta) {
+    for (auto it = g.NeighboursBegin(u); it != g.NeighboursEnd(u); ++it) {
+      if (!placed[*it]) {
+        heap.Add(*it, delta);
+      }
+      if (g.Degree(*it) <= hub) {
+        for (auto jt = g.NeighboursBegin(*it); jt != g.NeighboursEnd(*it); ++jt) {
+          if (!placed[*jt]) {
+            heap.Add(*jt, delta);
+          }
+        }
+      }
+    }
+  };
+  std::vector<OrderId> sequence;
+  sequence.reserve(n);
+  while (sequence.size() < n) {
+    const OrderId v = heap.Top();
+    heap.Remove(v);
+    placed[v] = 1;
+    sequence.push_back(v);
+    score(v, 1);
+    if (sequence.size() > window) {
+      score(sequence[sequence.size() - 1 - window], -1);
+    }
+  }
+  return sequence;
+}
+
+}  // namespace detail
+
+template <typename N, typename E>
+NodeOrder OrderNodes(const Snapshot<N, E>& snapshot, Reordering reordering, std::size_t window) {
+  const UndirectedGraph g{snapshot};
+  const std::size_t n = g.NumNodes();
+  NodeOrder order;
+  switch (reordering) {
+    case Reordering::kDegree:
+      order.node = detail::ByDegree(g);
+      break;
+    case Reordering::kBfs:
+    case Reordering::kReverseCuthillMcKee: {
+      const bool rcm = reordering == Reordering::kReverseCuthillMcKee;
+      auto starts = detail::ByDegree(g);
+      if (rcm) {
+        std::reverse(starts.begin(), starts.end());
+      }
+      std::vector<char> visited(n, 0);
+      std::vector<detail::OrderId> level(n, detail::kNoNode);
+      order.node.reserve(n);
+      for (auto start : starts) {
+        if (!visited[start]) {
+          start = rcm ? detail::PeripheralNode(g, start, level) : start;
+          detail::BreadthFirst(g, start, rcm, visited, order.node);
+        }
+      }
+      if (rcm) {
+        std::reverse(order.node.begin(), order.node.end());
+      }
+      break;
+    }
+    case Reordering::kGorder:
+      order.node = detail::GorderSequence(g, std::max<std::size_t>(window, 1));
+      break;
+  }
+  order.rank.resize(n);
+  for (std::size_t r = 0; r < n; ++r) {
+    order.rank[order.node[r]] = static_cast<std::uint32_t>(r);
+  }
+  return order;
+}
+
+template <typename N, typename E>
+Snapshot<std::uint32_t, E> Reorder(const Snapshot<N, E>& snapshot, const NodeOrder& order) {
+  using EdgeId = typename Snapshot<N, E>::EdgeId;
+  const std::size_t n = snapshot.NumNodes();
+  if (order.rank.size() != n || order.node.size() != n) {
+    throw std::invalid_argument("Cannot call gdwg::Reorder with an order of a different number "
+                                "of nodes");
+  }
+  std::vector<std::uint32_t> nodes(n);
+  std::iota(nodes.begin(), nodes.end(), std::uint32_t{0});
+  std::vector<EdgeId> offsets(n + 1, 0);
+  for (std::size_t r = 0; r < n; ++r) {
+    offsets[r + 1] = offsets[r] + snapshot.Degree(order.node[r]);
+  }
+  std::vector<std::uint32_t> dsts(snapshot.NumEdges());
+  std::vector<E> weights;
+  weights.reserve(snapshot.NumEdges());
+  std::vector<std::pair<std::uint32_t, EdgeId>> edges;
+  for (std::size_t r = 0; r < n; ++r) {
+    const auto v = order.node[r];
+    // renamed destinations are out of order, so sort them again, by (dst, weight) as before
+    edges.clear();
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      edges.emplace_back(order.rank[snapshot.Dst(e)], e);
+    }
+    std::sort(edges.begin(), edges.end(), [&snapshot](const auto& a, const auto& b) {
+      return a.first != b.first ? a.first < b.first
+                                : snapshot.Weight(a.second) < snapshot.Weight(b.second);
+    });
+    for (const auto& [dst, e] : edges) {
+      dsts[weights.size()] = dst;
+      weights.push_back(snapshot.Weight(e));
+    }
+  }
+  return Snapshot<std::uint32_t, E>{std::move(nodes), std::move(offsets), std::move(dsts),
+                                    std::move(weights)};
+}
+
+}  // namespace gdwg
@@ -0,0 +1,185 @@
+// Node orderings on an R-MAT graph and a 2D grid, each first renamed at random as a graph read
+// from an arbitrary source would be. For the random names and for each Reordering, reports the
+// time to order and reorder the snapshot, then the runtime of a breadth first search and of
+// push PageRank over the result, the mean distance between the ids at either end of an edge,
+// and the cache misses of both: hardware counters are not to be had everywhere, so misses are
+// counted by running each kernel's accesses to its per-node array (the CSR arrays themselves
+// are read in order) through a model of a set associative LRU cache. Prints JSON to stdout.
+//
+//   reorder_benchmark [--scale=18] [--degree=16] [--side=700] [--cache_kib=256]
+//                     [--iterations=10]
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/reorder.h"
+
+namespace {
+
+namespace bm = gdwg::benchmark;
+using E = float;
+using Reordered = gdwg::Snapshot<std::uint32_t, E>;
+
+// An LRU cache of 64 byte lines, 8 ways to a set, counting the misses of the byte offsets given
+class CacheModel {
+ public:
+  explicit CacheModel(std::size_t bytes) : sets_(bytes / kLine / kWays), tags_(sets_ * kWays) {}
+
+  void Access(std::uint64_t offset) {
+    const std::uint64_t line = offset / kLine;
+    auto* set = &tags_[(line % sets_) * kWays];
+    std::size_t way = 0;
+    while (way + 1 < kWays && set[way] != line) {
+      ++way;
+    }
+    misses_ += set[way] != line;
+    // most recent first: move the line to the front, dropping the last if it missed
+    for (; way > 0; --way) {
+      set[way] = set[way - 1];
+    }
+    set[0] = line;
+  }
+
+  std::uint64_t Misses() const { return misses_; }
+
+ private:
+  static constexpr std::size_t kLine = 64;
+  static constexpr std::size_t kWays = 8;
+  std::size_t sets_;
+  std::vector<std::uint64_t> tags_ = {};
+  std::uint64_t misses_ = 0;
+};
+
+// breadth first search from source over out-edges, calling access(dst) for each edge scanned
+template <typename Access>
+std::uint32_t Bfs(const Reordered& g, std::uint32_t source, Access access) {
+  constexpr auto kUnseen = std::numeric_limits<std::uint32_t>::max();
+  std::vector<std::uint32_t> depth(g.NumNodes(), kUnseen);
+  std::vector<std::uint32_t> queue{source};
+  depth[source] = 0;
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    const auto v = queue[i];
+    for (auto e = g.EdgeBegin(v); e != g.EdgeEnd(v); ++e) {
+      access(g.Dst(e));
+      if (depth[g.Dst(e)] == kUnseen) {
+        depth[g.Dst(e)] = depth[v] + 1;
+        queue.push_back(g.Dst(e));
+      }
+    }
+  }
+  return depth[queue.back()];
+}
+
+// PageRank by pushing each node's share along its out-edges, calling access(dst) for each
+template <typename Access>
+std::vector<float> PageRank(const Reordered& g, int iterations, Access access) {
+  constexpr float kDamping = 0.85f;
+  const auto n = static_cast<float>(g.NumNodes());
+  std::vector<float> rank(g.NumNodes(), 1 / n);
+  std::vector<float> next(g.NumNodes());
+  for (int i = 0; i < iterations; ++i) {
+    std::fill(next.begin(), next.end(), (1 - kDamping) / n);
+    for (std::uint32_t v = 0; v < g.NumNodes(); ++v) {
+      if (g.Degree(v) == 0) {
+        continue;
+      }
+      const float share = kDamping * rank[v] / static_cast<float>(g.Degree(v));
+      for (auto e = g.EdgeBegin(v); e != g.EdgeEnd(v); ++e) {
+        access(g.Dst(e));
+        next[g.Dst(e)] += share;
+      }
+    }
+    rank.swap(next);
+  }
+  return rank;
+}
+
+// nodes numbered at random
+template <typename N>
+gdwg::NodeOrder RandomOrder(const gdwg::Snapshot<N, E>& snapshot) {
+  gdwg::NodeOrder order;
+  order.node.resize(snapshot.NumNodes());
+  std::iota(order.node.begin(), order.node.end(), std::uint32_t{0});
+  std::shuffle(order.node.begin(), order.node.end(), std::mt19937{42});
+  order.rank.resize(order.node.size());
+  for (std::uint32_t r = 0; r < order.node.size(); ++r) {
+    order.rank[order.node[r]] = r;
+  }
+  return order;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  using N = std::uint32_t;
+  const auto scale = static_cast<unsigned>(bm::Arg(argc, argv, "scale", 18));
+  const auto degree = bm::Arg(argc, argv, "degree", 16);
+  const auto side = bm::Arg(argc, argv, "side", 700);
+  const auto cache_bytes = bm::Arg(argc, argv, "cache_kib", 256) * 1024;
+  const auto iterations = static_cast<int>(bm::Arg(argc, argv, "iterations", 10));
+
+  bm::Reporter reporter;
+  auto run = [&](const std::string& graph, const gdwg::Snapshot<N, E>& input) {
+    const auto shuffled = gdwg::Reorder(input, RandomOrder(input));
+    // the same source node whatever the names: the one with the most out-edges
+    std::uint32_t hub = 0;
+    for (std::uint32_t v = 0; v < shuffled.NumNodes(); ++v) {
+      hub = shuffled.Degree(v) > shuffled.Degree(hub) ? v : hub;
+    }
+    const std::pair<std::string, gdwg::Reordering> reorderings[] = {
+        {"degree", gdwg::Reordering::kDegree},
+        {"bfs", gdwg::Reordering::kBfs},
+        {"rcm", gdwg::Reordering::kReverseCuthillMcKee},
+        {"gorder", gdwg::Reordering::kGorder}};
+    auto report = [&](const std::string& ordering, const Reordered& g, std::uint32_t source,
+                      double order_seconds) {
+      double gap = 0;
+      for (std::uint32_t v = 0; v < g.NumNodes(); ++v) {
+        for (auto e = g.EdgeBegin(v); e != g.EdgeEnd(v); ++e) {
+          gap += v > g.Dst(e) ? v - g.Dst(e) : g.Dst(e) - v;
+        }
+      }
+      const double bfs_seconds =
+          bm::Measure([&] { bm::DoNotOptimize(Bfs(g, source, [](std::uint32_t) {})); });
+      const double pagerank_seconds =
+          bm::Measure([&] { bm::DoNotOptimize(PageRank(g, iterations, [](std::uint32_t) {})); });
+      // BFS looks up depth[dst], and PageRank adds to next[dst], for every edge
+      CacheModel bfs_cache{cache_bytes};
+      Bfs(g, source, [&](std::uint32_t dst) { bfs_cache.Access(dst * sizeof(std::uint32_t)); });
+      CacheModel pagerank_cache{cache_bytes};
+      PageRank(g, 1, [&](std::uint32_t dst) { pagerank_cache.Access(dst * sizeof(float)); });
+      bm::Fields params;
+      params.emplace_back("nodes", g.NumNodes());
+      params.emplace_back("edges", g.NumEdges());
+      params.emplace_back("cache_bytes", cache_bytes);
+      const double m = g.NumEdges();
+      reporter.Add(graph + "_" + ordering, params,
+                   {{"order_seconds", order_seconds},
+                    {"mean_edge_gap", gap / m},
+                    {"bfs_seconds", bfs_seconds},
+                    {"bfs_misses_per_edge", bfs_cache.Misses() / m},
+                    {"pagerank_seconds", pagerank_seconds},
+                    {"pagerank_misses_per_edge", pagerank_cache.Misses() / m}});
+    };
+    report("random", shuffled, hub, 0);
+    for (const auto& [name, reordering] : reorderings) {
+      bm::Timer timer;
+      const auto order = gdwg::OrderNodes(shuffled, reordering);
+      const auto reordered = gdwg::Reorder(shuffled, order);
+      report(name, reordered, order.rank[hub], timer.Seconds());
+    }
+  };
+  run("rmat", gdwg::Rmat<N, E>(scale, (std::size_t{1} << scale) * degree,
+                               gdwg::ConstantWeights<E>(1))
+                  .BuildSnapshot());
+  run("grid", gdwg::Grid2D<N, E>(side, side, gdwg::ConstantWeights<E>(1)).BuildSnapshot());
+  reporter.Print(std::cout);
+}
@@ -0,0 +1,175 @@
+/*
+  Tests for OrderNodes and Reorder. Every ordering must be a permutation, and a reordered
+  snapshot the same graph under new names. Each ordering is then checked for the shape it
+  promises: degrees falling, components together, a narrow band for a mesh, and tightly knit
+  groups of nodes kept together.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/builder.h"
+#include "assignments/dg/components.h"
+#include "assignments/dg/reorder.h"
+#include "catch.h"
+
+namespace {
+
+constexpr gdwg::Reordering kReorderings[] = {
+    gdwg::Reordering::kDegree, gdwg::Reordering::kBfs,
+    gdwg::Reordering::kReverseCuthillMcKee, gdwg::Reordering::kGorder};
+
+// a rows x cols grid with both directions of each edge, its nodes named in a random order
+gdwg::Snapshot<int, int> ShuffledGrid(int rows, int cols) {
+  std::vector<int> name(static_cast<std::size_t>(rows * cols));
+  std::iota(name.begin(), name.end(), 0);
+  std::shuffle(name.begin(), name.end(), std::mt19937{5});
+  gdwg::GraphBuilder<int, int> builder;
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      const int v = name[static_cast<std::size_t>(r * cols + c)];
+      if (c + 1 < cols) {
+        builder.AddEdge(v, name[static_cast<std::size_t>(r * cols + c + 1)], 1);
+      }
+      if (r + 1 < rows) {
+        builder.AddEdge(v, name[static_cast<std::size_t>((r + 1) * cols + c)], 1);
+      }
+    }
+  }
+  return builder.BuildSnapshot();
+}
+
+// the largest difference between the new ids of the ends of an edge
+std::uint32_t Bandwidth(const gdwg::Snapshot<std::uint32_t, int>& snapshot) {
+  std::uint32_t band = 0;
+  for (std::uint32_t v = 0; v < snapshot.NumNodes(); ++v) {
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      band = std::max(band, v > snapshot.Dst(e) ? v - snapshot.Dst(e) : snapshot.Dst(e) - v);
+    }
+  }
+  return band;
+}
+
+}  // namespace
+
+SCENARIO("Every ordering renames a graph without changing it") {
+  GIVEN("a random multigraph with isolated nodes, self loops and several components") {
+    std::mt19937 rng{8};
+    std::uniform_int_distribution<int> node(0, 299);
+    gdwg::GraphBuilder<int, int> builder;
+    for (int v = 0; v < 320; ++v) {
+      builder.AddNode(v);
+    }
+    for (int i = 0; i < 400; ++i) {
+      builder.AddEdge(node(rng), node(rng), i % 4);
+    }
+    const auto snapshot = builder.BuildSnapshot();
+    std::set<std::tuple<std::uint32_t, std::uint32_t, int>> edges;
+    for (std::uint32_t v = 0; v < snapshot.NumNodes(); ++v) {
+      for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+        edges.emplace(v, snapshot.Dst(e), snapshot.Weight(e));
+      }
+    }
+    for (auto reordering : kReorderings) {
+      WHEN("it is reordered with ordering " + std::to_string(static_cast<int>(reordering))) {
+        const auto order = gdwg::OrderNodes(snapshot, reordering);
+        const auto reordered = gdwg::Reorder(snapshot, order);
+        THEN("rank and node are inverse permutations") {
+          REQUIRE(order.node.size() == 320);
+          bool inverse = true;
+          for (std::uint32_t v = 0; v < 320; ++v) {
+            inverse = inverse && order.rank[v] < 320 && order.node[order.rank[v]] == v;
+          }
+          REQUIRE(inverse);
+        }
+        THEN("every edge is there under its new names, in order") {
+          std::set<std::tuple<std::uint32_t, std::uint32_t, int>> renamed;
+          bool sorted = true;
+          for (std::uint32_t v = 0; v < reordered.NumNodes(); ++v) {
+            for (auto e = reordered.EdgeBegin(v); e != reordered.EdgeEnd(v); ++e) {
+              renamed.emplace(order.node[v], order.node[reordered.Dst(e)], reordered.Weight(e));
+              sorted = sorted && (e == reordered.EdgeBegin(v) ||
+                                  std::pair{reordered.Dst(e - 1), reordered.Weight(e - 1)} <
+                                      std::pair{reordered.Dst(e), reordered.Weight(e)});
+            }
+          }
+          REQUIRE(renamed == edges);
+          REQUIRE(reordered.NumEdges() == snapshot.NumEdges());
+          REQUIRE(sorted);
+          REQUIRE(reordered.Value(17) == 17);
+        }
+      }
+    }
+    WHEN("the ordering is by degree") {
+      const auto order = gdwg::OrderNodes(snapshot, gdwg::Reordering::kDegree);
+      const gdwg::UndirectedGraph g{snapshot};
+      THEN("degrees never rise") {
+        bool falling = true;
+        for (std::size_t r = 1; r < order.node.size(); ++r) {
+          falling = falling && g.Degree(order.node[r - 1]) >= g.Degree(order.node[r]);
+        }
+        REQUIRE(falling);
+      }
+    }
+    WHEN("the ordering is breadth first, or reverse Cuthill-McKee") {
+      const auto components = gdwg::WeaklyConnectedComponents(snapshot);
+      THEN("each component's nodes are numbered together") {
+        for (auto reordering : {gdwg::Reordering::kBfs, gdwg::Reordering::kReverseCuthillMcKee}) {
+          const auto order = gdwg::OrderNodes(snapshot, reordering);
+          std::size_t runs = 1;
+          for (std::size_t r = 1; r < order.node.size(); ++r) {
+            runs += components.component[order.node[r - 1]] !=
+                    components.component[order.node[r]];
+          }
+          REQUIRE(runs == components.sizes.size());
+        }
+      }
+    }
+  }
+  GIVEN("an order of the wrong size") {
+    const auto snapshot = ShuffledGrid(2, 2);
+    THEN("Reorder throws") {
+      REQUIRE_THROWS_AS(gdwg::Reorder(snapshot, gdwg::NodeOrder{}), std::invalid_argument);
+    }
+  }
+}
+
+SCENARIO("Orderings find the structure behind shuffled names") {
+  GIVEN("a 12 x 40 grid whose nodes are named at random") {
+    const auto snapshot = ShuffledGrid(12, 40);
+    THEN("reverse Cuthill-McKee numbers it in a band about as wide as the grid is narrow") {
+      const auto order = gdwg::OrderNodes(snapshot, gdwg::Reordering::kReverseCuthillMcKee);
+      REQUIRE(Bandwidth(gdwg::Reorder(snapshot, gdwg::OrderNodes(
+                                                    snapshot, gdwg::Reordering::kDegree))) > 100);
+      REQUIRE(Bandwidth(gdwg::Reorder(snapshot, order)) <= 13);
+    }
+  }
+  GIVEN("three cliques of eight whose nodes are named alternately, joined in a ring") {
+    gdwg::GraphBuilder<int, int> builder;
+    for (int a = 0; a < 24; ++a) {
+      for (int b = 0; b < 24; ++b) {
+        if (a != b && a % 3 == b % 3) {
+          builder.AddEdge(a, b, 1);
+        }
+      }
+    }
+    builder.AddEdge(0, 1, 1);
+    builder.AddEdge(1, 2, 1);
+    builder.AddEdge(2, 0, 1);
+    const auto snapshot = builder.BuildSnapshot();
+    THEN("Gorder numbers each clique together") {
+      const auto order = gdwg::OrderNodes(snapshot, gdwg::Reordering::kGorder, 4);
+      std::size_t runs = 1;
+      for (std::size_t r = 1; r < order.node.size(); ++r) {
+        runs += order.node[r - 1] % 3 != order.node[r] % 3;
+      }
+      REQUIRE(runs == 3);
+    }
+  }
+}
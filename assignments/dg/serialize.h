@@ -0,0 +1,253 @@
+#ifndef ASSIGNMENTS_DG_SERIALIZE_H_
+#define ASSIGNMENTS_DG_SERIALIZE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/codec.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/mapped_file.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// Binary graph file, version 1. Integers are native endian and every section starts on a
+// 64 byte boundary so that MapBinary can point a Snapshot straight into the mapping:
+//
+//   BinaryHeader
+//   node table    NumNodes() values, raw if N is trivially copyable, else Codec<N> records
+//   offsets       NumNodes() + 1 uint64_t
+//   destinations  NumEdges() uint32_t
+//   weights       NumEdges() values, raw if E is trivially copyable, else Codec<E> records
+struct BinaryHeader {
+  static constexpr char kMagic[8] = {'G', 'D', 'W', 'G', 'C', 'S', 'R', '\0'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kEndian = 0x01020304;
+  static constexpr std::uint32_t kRawNodes = 1;
+  static constexpr std::uint32_t kRawWeights = 2;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endian;
+  std::uint32_t flags;
+  std::uint32_t node_size;
+  std::uint32_t weight_size;
+  std::uint32_t reserved;
+  std::uint64_t num_nodes;
+  std::uint64_t num_edges;
+  std::uint64_t nodes_offset;
+  std::uint64_t nodes_bytes;
+  std::uint64_t offsets_offset;
+  std::uint64_t dsts_offset;
+  std::uint64_t weights_offset;
+  std::uint64_t weights_bytes;
+};
+
+namespace detail {
+
+constexpr std::size_t kSectionAlign = 64;
+
+inline void PadTo(std::ofstream& os, std::uint64_t& pos) {
+  static const char zeros[kSectionAlign] = {};
+  const auto pad = (kSectionAlign - pos % kSectionAlign) % kSectionAlign;
+  os.write(zeros, static_cast<std::streamsize>(pad));
+  pos += pad;
+}
+
+inline void WriteBytes(std::ofstream& os, std::uint64_t& pos, const void* data, std::size_t size) {
+  os.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  pos += size;
+}
+
+// writes n values raw or as Codec records, returning the number of bytes written
+template <typename T>
+std::uint64_t WriteValues(std::ofstream& os, std::uint64_t& pos, const T* values, std::size_t n) {
+  const auto start = pos;
+  if constexpr (std::is_trivially_copyable<T>::value) {
+    WriteBytes(os, pos, values, n * sizeof(T));
+  } else {
+    constexpr std::size_t kFlushBytes = 1 << 20;
+    std::string buffer;
+    for (std::size_t i = 0; i < n; ++i) {
+      Codec<T>::Write(buffer, values[i]);
+      if (buffer.size() >= kFlushBytes) {
+        WriteBytes(os, pos, buffer.data(), buffer.size());
+        buffer.clear();
+      }
+    }
+    WriteBytes(os, pos, buffer.data(), buffer.size());
+  }
+  return pos - start;
+}
+
+template <typename T>
+bool FitsIn(const MappedFile& file, std::uint64_t offset, std::uint64_t bytes) {
+  return offset % alignof(T) == 0 && offset <= file.size() && bytes <= file.size() - offset;
+}
+
+}  // namespace detail
+
+template <typename N, typename E>
+void SaveBinary(const Snapshot<N, E>& s, const std::string& path) {
+  std::ofstream os{path, std::ios::binary | std::ios::trunc};
+  if (!os) {
+    throw std::runtime_error("Cannot call gdwg::SaveBinary on a file that can't be opened: " +
+                             path);
+  }
+  using EdgeId = typename Snapshot<N, E>::EdgeId;
+  using NodeId = typename Snapshot<N, E>::NodeId;
+
+  BinaryHeader header{};
+  std::memcpy(header.magic, BinaryHeader::kMagic, sizeof(header.magic));
+  header.version = BinaryHeader::kVersion;
+  header.endian = BinaryHeader::kEndian;
+  if (std::is_trivially_copyable<N>::value) {
+    header.flags |= BinaryHeader::kRawNodes;
+    header.node_size = sizeof(N);
+  }
+  if (std::is_trivially_copyable<E>::value) {
+    header.flags |= BinaryHeader::kRawWeights;
+    header.weight_size = sizeof(E);
+  }
+  header.num_nodes = s.NumNodes();
+  header.num_edges = s.NumEdges();
+
+  // the header is written again once the section offsets are known
+  std::uint64_t pos = 0;
+  detail::WriteBytes(os, pos, &header, sizeof(header));
+  detail::PadTo(os, pos);
+  header.nodes_offset = pos;
+  header.nodes_bytes = detail::WriteValues(os, pos, s.Nodes(), s.NumNodes());
+  detail::PadTo(os, pos);
+  header.offsets_offset = pos;
+  detail::WriteBytes(os, pos, s.Offsets(), (s.NumNodes() + 1) * sizeof(EdgeId));
+  detail::PadTo(os, pos);
+  header.dsts_offset = pos;
+  detail::WriteBytes(os, pos, s.Dsts(), s.NumEdges() * sizeof(NodeId));
+  detail::PadTo(os, pos);
+  header.weights_offset = pos;
+  header.weights_bytes = detail::WriteValues(os, pos, s.Weights(), s.NumEdges());
+
+  os.seekp(0);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.flush();
+  if (!os) {
+    throw std::runtime_error("Cannot call gdwg::SaveBinary, writing failed: " + path);
+  }
+}
+
+template <typename N, typename E>
+void SaveBinary(const Graph<N, E>& g, const std::string& path) {
+  SaveBinary(Snapshot<N, E>{g}, path);
+}
+
+// Maps a file written by SaveBinary and serves read-only queries straight from the mapping.
+// Offsets and destinations are never copied, nor are trivially copyable node and weight
+// tables; other node or weight types are decoded once with Codec. The file is trusted: only
+// the header and section bounds are checked.
+template <typename N, typename E>
+Snapshot<N, E> MapBinary(const std::string& path) {
+  using EdgeId = typename Snapshot<N, E>::EdgeId;
+  using NodeId = typename Snapshot<N, E>::NodeId;
+  struct Owner {
+    std::shared_ptr<const MappedFile> file;
+    std::vector<N> nodes;
+    std::vector<E> weights;
+  };
+  auto owner = std::make_shared<Owner>();
+  owner->file = std::make_shared<const MappedFile>(path);
+  const MappedFile& file = *owner->file;
+  auto fail = [&path](const std::string& why) {
+    return std::runtime_error("Cannot call gdwg::MapBinary on " + path + ": " + why);
+  };
+
+  BinaryHeader header;
+  if (file.size() < sizeof(header)) {
+    throw fail("file is too small");
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, BinaryHeader::kMagic, sizeof(header.magic)) != 0) {
+    throw fail("not a graph file");
+  }
+  if (header.version != BinaryHeader::kVersion) {
+    throw fail("unsupported version " + std::to_string(header.version));
+  }
+  if (header.endian != BinaryHeader::kEndian) {
+    throw fail("written on a machine with different endianness");
+  }
+  const bool raw_nodes = std::is_trivially_copyable<N>::value;
+  const bool raw_weights = std::is_trivially_copyable<E>::value;
+  if (((header.flags & BinaryHeader::kRawNodes) != 0) != raw_nodes ||
+      ((header.flags & BinaryHeader::kRawWeights) != 0) != raw_weights ||
+      (raw_nodes && header.node_size != sizeof(N)) ||
+      (raw_weights && header.weight_size != sizeof(E))) {
+    throw fail("node or weight type doesn't match the file");
+  }
+  if (!detail::FitsIn<N>(file, header.nodes_offset, header.nodes_bytes) ||
+      !detail::FitsIn<EdgeId>(file, header.offsets_offset,
+                              (header.num_nodes + 1) * sizeof(EdgeId)) ||
+      !detail::FitsIn<NodeId>(file, header.dsts_offset, header.num_edges * sizeof(NodeId)) ||
+      !detail::FitsIn<E>(file, header.weights_offset, header.weights_bytes)) {
+    throw fail("truncated or corrupt section table");
+  }
+
+  const char* base = file.data();
+  const auto* offsets = reinterpret_cast<const EdgeId*>(base + header.offsets_offset);
+  if (offsets[header.num_nodes] != header.num_edges) {
+    throw fail("edge offsets don't match the edge count");
+  }
+  const auto* dsts = reinterpret_cast<const NodeId*>(base + header.dsts_offset);
+
+  const N* nodes;
+  if constexpr (std::is_trivially_copyable<N>::value) {
+    if (header.nodes_bytes != header.num_nodes * sizeof(N)) {
+      throw fail("node table has the wrong size");
+    }
+    nodes = reinterpret_cast<const N*>(base + header.nodes_offset);
+  } else {
+    const char* in = base + header.nodes_offset;
+    const char* end = in + header.nodes_bytes;
+    owner->nodes.reserve(header.num_nodes);
+    for (std::uint64_t i = 0; i < header.num_nodes; ++i) {
+      owner->nodes.push_back(Codec<N>::Read(in, end));
+    }
+    nodes = owner->nodes.data();
+  }
+
+  const E* weights;
+  if constexpr (std::is_trivially_copyable<E>::value) {
+    if (header.weights_bytes != header.num_edges * sizeof(E)) {
+      throw fail("weight table has the wrong size");
+    }
+    weights = reinterpret_cast<const E*>(base + header.weights_offset);
+  } else {
+    const char* in = base + header.weights_offset;
+    const char* end = in + header.weights_bytes;
+    owner->weights.reserve(header.num_edges);
+    for (std::uint64_t i = 0; i < header.num_edges; ++i) {
+      owner->weights.push_back(Codec<E>::Read(in, end));
+    }
+    weights = owner->weights.data();
+  }
+
+  return Snapshot<N, E>{nodes,   offsets, dsts, weights, static_cast<std::size_t>(header.num_nodes),
+                        std::move(owner)};
+}
+
+// Rebuilds a mutable Graph from a file written by SaveBinary.
+template <typename N, typename E>
+Graph<N, E> LoadBinaryGraph(const std::string& path) {
+  return MapBinary<N, E>(path).ToGraph();
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_SERIALIZE_H_
@@ -0,0 +1,72 @@
+// Compares rebuilding a graph from a text edge list with saving it in the binary format and
+// mapping it back. Prints JSON to stdout.
+//
+//   serialize_benchmark [--nodes=10000] [--edges=200000]
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/serialize.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  const auto num_nodes = bm::Arg(argc, argv, "nodes", 10000);
+  const auto num_edges = bm::Arg(argc, argv, "edges", 200000);
+  const auto dir = std::filesystem::temp_directory_path();
+  const std::string text_path = dir / "serialize_benchmark.txt";
+  const std::string binary_path = dir / "serialize_benchmark.gdwg";
+
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<int> node(0, static_cast<int>(num_nodes) - 1);
+  std::uniform_real_distribution<double> weight(0, 100);
+  {
+    std::ofstream text{text_path};
+    for (std::size_t i = 0; i < num_edges; ++i)
+      text << node(rng) << ' ' << node(rng) << ' ' << weight(rng) << '\n';
+  }
+
+  bm::Reporter reporter;
+  const bm::Fields params{{"nodes", num_nodes}, {"edges", num_edges}};
+
+  bm::Timer timer;
+  gdwg::Graph<int, double> g;
+  {
+    std::ifstream text{text_path};
+    int src;
+    int dst;
+    double w;
+    while (text >> src >> dst >> w) {
+      g.InsertNode(src);
+      g.InsertNode(dst);
+      g.InsertEdge(src, dst, w);
+    }
+  }
+  reporter.Add("text_rebuild", params, {{"seconds", timer.Seconds()}});
+
+  timer.Reset();
+  gdwg::SaveBinary(g, binary_path);
+  reporter.Add("save_binary", params,
+               {{"seconds", timer.Seconds()},
+                {"file_mb", std::filesystem::file_size(binary_path) / 1e6}});
+
+  timer.Reset();
+  auto mapped = gdwg::MapBinary<int, double>(binary_path);
+  bm::DoNotOptimize(mapped.IsConnected(mapped.Value(0), mapped.Value(1)));
+  reporter.Add("map_binary_first_query", params, {{"seconds", timer.Seconds()}});
+
+  timer.Reset();
+  auto loaded = gdwg::LoadBinaryGraph<int, double>(binary_path);
+  reporter.Add("load_binary_graph", params, {{"seconds", timer.Seconds()}});
+  bm::DoNotOptimize(loaded);
+
+  reporter.Print(std::cout);
+  std::remove(text_path.c_str());
+  std::remove(binary_path.c_str());
+}
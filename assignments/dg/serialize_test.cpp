@@ -0,0 +1,102 @@
+/*
+  Round trips graphs through SaveBinary and MapBinary, for both the raw (trivially copyable)
+  and the Codec encoded node and weight tables, and checks that bad files are rejected.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "assignments/dg/serialize.h"
+#include "catch.h"
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+  return std::filesystem::temp_directory_path() / name;
+}
+
+}  // namespace
+
+SCENARIO("Graphs round trip through the binary format") {
+  GIVEN("a graph of strings weighted by doubles") {
+    gdwg::Graph<std::string, double> g{"hello", "how", "are", "you?", "lonely"};
+    g.InsertEdge("hello", "how", 5.5);
+    g.InsertEdge("hello", "are", 8);
+    g.InsertEdge("hello", "are", 2);
+    g.InsertEdge("how", "you?", 1);
+    g.InsertEdge("are", "you?", -3.25);
+    const auto path = TempPath("serialize_test_strings.gdwg");
+    gdwg::SaveBinary(g, path);
+
+    WHEN("the file is mapped") {
+      auto s = gdwg::MapBinary<std::string, double>(path);
+      THEN("queries see the saved graph") {
+        REQUIRE(s.GetNodes() == g.GetNodes());
+        REQUIRE(s.NumEdges() == g.NumEdges());
+        REQUIRE(s.GetWeights("hello", "are") == std::vector<double>{2, 8});
+        REQUIRE(s.IsConnected("are", "you?"));
+        REQUIRE_FALSE(s.IsConnected("you?", "are"));
+        REQUIRE(s.ToGraph() == g);
+      }
+    }
+    WHEN("the file is loaded as a graph") {
+      THEN("it equals the saved graph") {
+        REQUIRE((gdwg::LoadBinaryGraph<std::string, double>(path)) == g);
+      }
+    }
+    WHEN("the file is mapped with the wrong types") {
+      THEN("mapping throws") {
+        REQUIRE_THROWS_AS((gdwg::MapBinary<int, double>(path)), std::runtime_error);
+        REQUIRE_THROWS_AS((gdwg::MapBinary<std::string, int>(path)), std::runtime_error);
+      }
+    }
+    std::remove(path.c_str());
+  }
+
+  GIVEN("a graph of ints weighted by ints") {
+    gdwg::Graph<int, int> g{1, 2, 3, 4};
+    for (int i = 1; i <= 4; ++i)
+      for (int j = 1; j <= 4; ++j)
+        g.InsertEdge(i, j, i * j);
+    const auto path = TempPath("serialize_test_ints.gdwg");
+    gdwg::SaveBinary(g, path);
+    THEN("the raw tables are served straight from the mapping") {
+      auto s = gdwg::MapBinary<int, int>(path);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(s.Nodes()) % 64 == 0);
+      REQUIRE(s.ToGraph() == g);
+    }
+    std::remove(path.c_str());
+  }
+
+  GIVEN("an empty graph") {
+    gdwg::Graph<int, int> g;
+    const auto path = TempPath("serialize_test_empty.gdwg");
+    gdwg::SaveBinary(g, path);
+    THEN("it maps back empty") {
+      auto s = gdwg::MapBinary<int, int>(path);
+      REQUIRE(s.IsEmpty());
+      REQUIRE(s.NumEdges() == 0);
+    }
+    std::remove(path.c_str());
+  }
+}
+
+SCENARIO("MapBinary rejects files that aren't graph files") {
+  GIVEN("a text file") {
+    const auto path = TempPath("serialize_test_garbage.gdwg");
+    std::ofstream{path} << std::string(200, 'x');
+    THEN("mapping throws") {
+      REQUIRE_THROWS_AS((gdwg::MapBinary<int, int>(path)), std::runtime_error);
+    }
+    std::remove(path.c_str());
+  }
+  GIVEN("a file that doesn't exist") {
+    THEN("mapping throws") {
+      REQUIRE_THROWS_AS((gdwg::MapBinary<int, int>(TempPath("does_not_exist.gdwg"))),
+                        std::runtime_error);
+    }
+  }
+}
@@ -0,0 +1,106 @@
+#ifndef ASSIGNMENTS_DG_SHARED_GRAPH_H_
+#define ASSIGNMENTS_DG_SHARED_GRAPH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// A copy-on-write handle to a Graph. Copying a SharedGraph is O(1): the copies share one graph
+// until one of them is written to, at which point that handle takes a deep copy (Graph's copy
+// constructor, a single linear pass) and the others are left as they were. Mutations that
+// would change nothing (inserting a node or edge that exists, deleting or erasing one that
+// doesn't, replacing a node with one that exists) never copy, nor do those that throw: each is
+// first checked against the shared graph, which is only read.
+//
+// Like std::shared_ptr, different handles may be used from different threads even while they
+// share a graph, but one handle must not be read and written at the same time. A moved-from
+// handle may only be assigned to or destroyed.
+template <typename N, typename E>
+class SharedGraph {
+ public:
+  SharedGraph() : graph_{std::make_shared<Graph<N, E>>()} {}
+  explicit SharedGraph(Graph<N, E> graph)
+    : graph_{std::make_shared<Graph<N, E>>(std::move(graph))} {}
+
+  const Graph<N, E>& GetGraph() const noexcept { return *graph_; }
+  const Graph<N, E>& operator*() const noexcept { return *graph_; }
+  const Graph<N, E>* operator->() const noexcept { return graph_.get(); }
+
+  // true if another handle shares this graph, so the next write will copy it
+  bool IsShared() const noexcept { return graph_.use_count() > 1; }
+
+  // the graph for writing, copied first if it is shared
+  Graph<N, E>& Mutable() {
+    if (!OwnedAlone()) {
+      graph_ = std::make_shared<Graph<N, E>>(*graph_);
+    }
+    return *graph_;
+  }
+
+  bool InsertNode(const N& val) { return !graph_->IsNode(val) && Mutable().InsertNode(val); }
+  bool InsertEdge(const N& src, const N& dst, const E& w) {
+    if (!graph_->IsNode(src) || !graph_->IsNode(dst)) {
+      throw std::runtime_error(
+          "Cannot call Graph::InsertEdge when either src or dst node does not exist");
+    }
+    return !HasEdge(src, dst, w) && Mutable().InsertEdge(src, dst, w);
+  }
+  bool DeleteNode(const N& node) { return graph_->IsNode(node) && Mutable().DeleteNode(node); }
+  bool Replace(const N& old_data, const N& new_data) {
+    if (!graph_->IsNode(old_data)) {
+      throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
+    }
+    return !graph_->IsNode(new_data) && Mutable().Replace(old_data, new_data);
+  }
+  void MergeReplace(const N& old_data, const N& new_data) {
+    if (!graph_->IsNode(old_data) || !graph_->IsNode(new_data)) {
+      throw std::runtime_error(
+          "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
+    }
+    Mutable().MergeReplace(old_data, new_data);
+  }
+  bool erase(const N& src, const N& dst, const E& w) {
+    return HasEdge(src, dst, w) && Mutable().erase(src, dst, w);
+  }
+  void Clear() {
+    if (OwnedAlone()) {
+      graph_->Clear();
+    } else {
+      graph_ = std::make_shared<Graph<N, E>>();
+    }
+  }
+
+ private:
+  // True if no other handle shares the graph, so it may be written in place. use_count is a
+  // relaxed load, so the fence is what orders this thread's writes after the reads another
+  // thread made through a handle it has since dropped (whose release of the count was
+  // acq_rel); it is why shared_ptr::unique was deprecated rather than relied on.
+  bool OwnedAlone() const noexcept {
+    if (graph_.use_count() > 1) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+  }
+
+  bool HasEdge(const N& src, const N& dst, const E& w) const {
+    if (!graph_->IsNode(src) || !graph_->IsNode(dst) || !graph_->IsConnected(src, dst)) {
+      return false;
+    }
+    const auto weights = graph_->GetWeights(src, dst);
+    return std::find(weights.begin(), weights.end(), w) != weights.end();
+  }
+
+  std::shared_ptr<Graph<N, E>> graph_;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_SHARED_GRAPH_H_
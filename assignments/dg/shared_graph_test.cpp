@@ -0,0 +1,99 @@
+/*
+  Tests for SharedGraph. Sharing is observed through the address of the underlying
+  graph: copies share it until one of them is written to, and the handle that
+  writes is the only one that changes.
+*/
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/shared_graph.h"
+#include "catch.h"
+
+SCENARIO("Copies of a SharedGraph share one graph until written to") {
+  GIVEN("a handle to a small graph") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 2);
+    gdwg::SharedGraph<std::string, int> shared{std::move(g)};
+    REQUIRE_FALSE(shared.IsShared());
+
+    WHEN("it is copied") {
+      auto copy = shared;
+      THEN("both handles point at the same graph") {
+        REQUIRE(shared.IsShared());
+        REQUIRE(copy.IsShared());
+        REQUIRE(&copy.GetGraph() == &shared.GetGraph());
+        REQUIRE(copy->NumEdges() == 2);
+      }
+      AND_WHEN("the copy is written to") {
+        const auto* before = &shared.GetGraph();
+        copy.InsertEdge("c", "a", 3);
+        copy.DeleteNode("b");
+        THEN("only the copy changes") {
+          REQUIRE(&shared.GetGraph() == before);
+          REQUIRE(&copy.GetGraph() != before);
+          REQUIRE(shared->NumEdges() == 2);
+          REQUIRE(shared->IsConnected("a", "b"));
+          REQUIRE(copy->NumEdges() == 1);
+          REQUIRE(copy->IsConnected("c", "a"));
+          REQUIRE_FALSE(shared.IsShared());
+          REQUIRE_FALSE(copy.IsShared());
+        }
+      }
+      AND_WHEN("a write would change nothing") {
+        REQUIRE_FALSE(copy.InsertNode("a"));
+        REQUIRE_FALSE(copy.DeleteNode("z"));
+        REQUIRE_FALSE(copy.InsertEdge("a", "b", 1));
+        REQUIRE_FALSE(copy.erase("a", "b", 7));
+        REQUIRE_FALSE(copy.erase("z", "b", 1));
+        REQUIRE_FALSE(copy.Replace("a", "b"));
+        REQUIRE_THROWS_AS(copy.InsertEdge("a", "z", 1), std::runtime_error);
+        REQUIRE_THROWS_AS(copy.Replace("z", "y"), std::runtime_error);
+        REQUIRE_THROWS_AS(copy.MergeReplace("a", "z"), std::runtime_error);
+        THEN("the graph is still shared, and unchanged") {
+          REQUIRE(copy.IsShared());
+          REQUIRE(&copy.GetGraph() == &shared.GetGraph());
+          REQUIRE(copy->NumEdges() == 2);
+        }
+      }
+      AND_WHEN("the copy is cleared") {
+        copy.Clear();
+        THEN("the original is untouched") {
+          REQUIRE(copy->IsEmpty());
+          REQUIRE(shared->NumNodes() == 3);
+        }
+      }
+    }
+
+    WHEN("the only handle is written to") {
+      const auto* before = &shared.GetGraph();
+      shared.Replace("c", "d");
+      shared.MergeReplace("a", "d");
+      THEN("the graph is changed in place") {
+        REQUIRE(&shared.GetGraph() == before);
+        REQUIRE(shared->GetNodes() == std::vector<std::string>{"b", "d"});
+        REQUIRE(shared->IsConnected("d", "b"));
+      }
+    }
+  }
+}
+
+SCENARIO("SharedGraph::Mutable gives access to the rest of Graph") {
+  GIVEN("two handles sharing a graph") {
+    gdwg::SharedGraph<int, int> a{gdwg::Graph<int, int>{1, 2}};
+    auto b = a;
+    WHEN("an edge is erased through Mutable on one of them") {
+      b.InsertEdge(1, 2, 5);
+      auto c = b;
+      c.Mutable().erase(c->cbegin());
+      THEN("the others are unaffected") {
+        REQUIRE(a->NumEdges() == 0);
+        REQUIRE(b->NumEdges() == 1);
+        REQUIRE(c->NumEdges() == 0);
+      }
+    }
+  }
+}
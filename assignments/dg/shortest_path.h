@@ -0,0 +1,121 @@
+#ifndef ASSIGNMENTS_DG_SHORTEST_PATH_H_
+#define ASSIGNMENTS_DG_SHORTEST_PATH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/path.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// Single pair shortest path searches over a Snapshot and its reverse (the incoming edges of
+// each node, built once by the constructor). Every search stops as soon as the path is known:
+//  - Dijkstra settles nodes in order of distance from src until it reaches dst.
+//  - Bidirectional runs a Dijkstra forwards from src and one backwards from dst, always
+//    advancing the side with the smaller queue, and stops once the two queue fronts add up to
+//    no less than the shortest path seen where they meet. On graphs that grow like a ball
+//    around a node (roads, grids) each side settles about half the radius, so a quarter of
+//    the area in two dimensions.
+//  - AStar orders the search by distance from src plus heuristic(node), a lower bound of the
+//    distance from node to dst supplied by the caller (e.g. straight line distance). It is a
+//    template parameter so that the call is inlined. A heuristic that never overestimates
+//    gives shortest paths; nodes whose distance improves after they are settled are searched
+//    again, so it needn't also be consistent.
+//
+// A search keeps its labels in arrays over all nodes, which are reused and cleaned up after
+// each search, so it costs only what it touches; searches are therefore not const, and a
+// PathSearch is for one thread at a time.
+//
+// Weights must be non-negative and arithmetic.
+template <typename N, typename E>
+class PathSearch {
+  static_assert(std::is_arithmetic<E>::value, "PathSearch needs arithmetic weights");
+
+ public:
+  using NodeId = std::uint32_t;
+
+  explicit PathSearch(Snapshot<N, E> snapshot);
+  explicit PathSearch(const Graph<N, E>& g) : PathSearch(Snapshot<N, E>{g}) {}
+
+  const Snapshot<N, E>& GetSnapshot() const noexcept { return snapshot_; }
+
+  // a shortest path from src to dst, or nullopt if there is none
+  std::optional<Path<N, E>> Dijkstra(const N& src, const N& dst);
+  std::optional<Path<N, E>> Bidirectional(const N& src, const N& dst);
+  template <typename Heuristic>
+  std::optional<Path<N, E>> AStar(const N& src, const N& dst, Heuristic&& heuristic);
+
+  // nodes taken off the queues by the last search (more than once if A* searched one again)
+  std::size_t Settled() const noexcept { return settled_; }
+
+ private:
+  static constexpr NodeId kNone = ~NodeId{0};
+  static constexpr E kInfinity = std::numeric_limits<E>::max();
+
+  struct Label {
+    E dist = kInfinity;
+    // the node before this one on the path found so far, towards src for the forward side and
+    // towards dst for the backward side
+    NodeId parent = kNone;
+  };
+  struct Item {
+    // dist for Dijkstra, dist plus the heuristic for A*
+    E key;
+    E dist;
+    NodeId node;
+    bool operator>(const Item& other) const noexcept { return key > other.key; }
+  };
+  using Queue = std::priority_queue<Item, std::vector<Item>, std::greater<Item>>;
+
+  // src and dst ids, or throws naming the search
+  std::pair<NodeId, NodeId> Ends(const N& src, const N& dst, const char* search) const;
+  template <typename Heuristic>
+  std::optional<Path<N, E>> Search(NodeId src, NodeId dst, Heuristic&& heuristic);
+  void SetLabel(int side, NodeId node, E dist, NodeId parent);
+  // the path from src to meet along the forward parents, then on to dst along the backward ones
+  Path<N, E> Trace(NodeId src, NodeId meet, NodeId dst, E weight) const;
+  void Reset();
+
+  Snapshot<N, E> snapshot_;
+  // incoming edges: in_srcs_[in_offsets_[v], in_offsets_[v + 1]) are the sources of v's edges
+  std::vector<std::uint64_t> in_offsets_;
+  std::vector<NodeId> in_srcs_;
+  std::vector<E> in_weights_;
+
+  // labels of the forward and backward side, and the nodes whose labels are set
+  std::vector<Label> labels_[2];
+  std::vector<NodeId> touched_;
+  Queue queues_[2];
+  std::size_t settled_ = 0;
+};
+
+// A shortest path from src to dst by a bidirectional search, or nullopt if there is none.
+// Takes a Snapshot of g, so for many queries on the same graph build one PathSearch instead.
+template <typename N, typename E>
+std::optional<Path<N, E>> ShortestPath(const Graph<N, E>& g, const N& src, const N& dst) {
+  return PathSearch<N, E>{g}.Bidirectional(src, dst);
+}
+
+// As above by A*, with heuristic(node) a lower bound of the distance from node to dst
+template <typename N, typename E, typename Heuristic>
+std::optional<Path<N, E>> ShortestPath(const Graph<N, E>& g,
+                                       const N& src,
+                                       const N& dst,
+                                       Heuristic&& heuristic) {
+  return PathSearch<N, E>{g}.AStar(src, dst, std::forward<Heuristic>(heuristic));
+}
+
+}  // namespace gdwg
+
+#include "assignments/dg/shortest_path.tpp"
+
+#endif  // ASSIGNMENTS_DG_SHORTEST_PATH_H_
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace gdwg {
+
+template <typename N, typename E>
+PathSearch<N, E>::PathSearch(Snapshot<N, E> snapshot)
+  : snapshot_{std::move(snapshot)}, in_offsets_(snapshot_.NumNodes() + 1),
+    in_srcs_(snapshot_.NumEdges()), in_weights_(snapshot_.NumEdges()) {
+  const std::size_t n = snapshot_.NumNodes();
+  for (NodeId v = 0; v < n; ++v) {
+    for (auto e = snapshot_.EdgeBegin(v); e != snapshot_.EdgeEnd(v); ++e) {
+      if (snapshot_.Weight(e) < E{}) {
+        throw std::invalid_argument(
+            "Cannot create a PathSearch of a graph with negative weights");
+      }
+      ++in_offsets_[snapshot_.Dst(e) + 1];
+    }
+  }
+  std::partial_sum(in_offsets_.begin(), in_offsets_.end(), in_offsets_.begin());
+  std::vector<std::uint64_t> next(in_offsets_.begin(), in_offsets_.end() - 1);
+  for (NodeId v = 0; v < n; ++v) {
+    for (auto e = snapshot_.EdgeBegin(v); e != snapshot_.EdgeEnd(v); ++e) {
+      const auto i = next[snapshot_.Dst(e)]++;
+      in_srcs_[i] = v;
+      in_weights_[i] = snapshot_.Weight(e);
+    }
+  }
+  for (auto& labels : labels_) {
+    labels.resize(n);
+  }
+}
+
+template <typename N, typename E>
+std::optional<Path<N, E>> PathSearch<N, E>::Dijkstra(const N& src, const N& dst) {
+  const auto [s, t] = Ends(src, dst, "Dijkstra");
+  return Search(s, t, [](const N&) { return E{}; });
+}
+
+template <typename N, typename E>
+template <typename Heuristic>
+std::optional<Path<N, E>> PathSearch<N, E>::AStar(const N& src,
+                                                  const N& dst,
+                                                  Heuristic&& heuristic) {
+  const auto [s, t] = Ends(src, dst, "AStar");
+  return Search(s, t, heuristic);
+}
+
+template <typename N, typename E>
+std::pair<typename PathSearch<N, E>::NodeId, typename PathSearch<N, E>::NodeId>
+PathSearch<N, E>::Ends(const N& src, const N& dst, const char* search) const {
+  if (!snapshot_.IsNode(src) || !snapshot_.IsNode(dst)) {
+    throw std::out_of_range(std::string{"Cannot call PathSearch::"} + search +
+                            " if src or dst node don't exist in the graph");
+  }
+  return {snapshot_.Id(src), snapshot_.Id(dst)};
+}
+
+template <typename N, typename E>
+template <typename Heuristic>
+std::optional<Path<N, E>> PathSearch<N, E>::Search(NodeId src,
+                                                   NodeId dst,
+                                                   Heuristic&& heuristic) {
+  settled_ = 0;
+  auto& labels = labels_[0];
+  auto& queue = queues_[0];
+  SetLabel(0, src, E{}, kNone);
+  queue.push({heuristic(snapshot_.Value(src)), E{}, src});
+  std::optional<Path<N, E>> path;
+  while (!queue.empty()) {
+    const Item top = queue.top();
+    queue.pop();
+    if (top.dist > labels[top.node].dist) {
+      continue;
+    }
+    ++settled_;
+    if (top.node == dst) {
+      path = Trace(src, dst, dst, top.dist);
+      break;
+    }
+    for (auto e = snapshot_.EdgeBegin(top.node); e != snapshot_.EdgeEnd(top.node); ++e) {
+      const NodeId x = snapshot_.Dst(e);
+      const E next = top.dist + snapshot_.Weight(e);
+      if (next < labels[x].dist) {
+        SetLabel(0, x, next, top.node);
+        queue.push({next + heuristic(snapshot_.Value(x)), next, x});
+      }
+    }
+  }
+  Reset();
+  return path;
+}
+
+template <typename N, typename E>
+std::optional<Path<N, E>> PathSearch<N, E>::Bidirectional(const N& src, const N& dst) {
+  const auto [s, t] = Ends(src, dst, "Bidirectional");
+  settled_ = 0;
+  if (s == t) {
+    settled_ = 1;
+    return Path<N, E>{{src}, E{}};
+  }
+  SetLabel(0, s, E{}, kNone);
+  SetLabel(1, t, E{}, kNone);
+  queues_[0].push({E{}, E{}, s});
+  queues_[1].push({E{}, E{}, t});
+  // side 0 follows out edges from src, side 1 in edges from dst
+  const std::uint64_t* offsets[2] = {snapshot_.Offsets(), in_offsets_.data()};
+  const NodeId* ends[2] = {snapshot_.Dsts(), in_srcs_.data()};
+  const E* weights[2] = {snapshot_.Weights(), in_weights_.data()};
+  E best = kInfinity;
+  NodeId meet = kNone;
+  // once either side runs out, everything that side can reach has been met by the other
+  while (!queues_[0].empty() && !queues_[1].empty()) {
+    if (best != kInfinity && queues_[0].top().dist + queues_[1].top().dist >= best) {
+      break;
+    }
+    const int side = queues_[0].size() <= queues_[1].size() ? 0 : 1;
+    auto& labels = labels_[side];
+    const auto& other = labels_[side ^ 1];
+    const Item top = queues_[side].top();
+    queues_[side].pop();
+    if (top.dist > labels[top.node].dist) {
+      continue;
+    }
+    ++settled_;
+    for (auto i = offsets[side][top.node]; i != offsets[side][top.node + 1]; ++i) {
+      const NodeId x = ends[side][i];
+      const E next = top.dist + weights[side][i];
+      if (next < labels[x].dist) {
+        SetLabel(side, x, next, top.node);
+        queues_[side].push({next, next, x});
+        if (other[x].dist != kInfinity && next + other[x].dist < best) {
+          best = next + other[x].dist;
+          meet = x;
+        }
+      }
+    }
+  }
+  std::optional<Path<N, E>> path;
+  if (meet != kNone) {
+    path = Trace(s, meet, t, best);
+  }
+  Reset();
+  return path;
+}
+
+template <typename N, typename E>
+void PathSearch<N, E>::SetLabel(int side, NodeId node, E dist, NodeId parent) {
+  if (labels_[0][node].dist == kInfinity && labels_[1][node].dist == kInfinity) {
+    touched_.push_back(node);
+  }
+  labels_[side][node] = {dist, parent};
+}
+
+template <typename N, typename E>
+Path<N, E> PathSearch<N, E>::Trace(NodeId src, NodeId meet, NodeId dst, E weight) const {
+  Path<N, E> path{{}, weight};
+  for (NodeId v = meet; v != src; v = labels_[0][v].parent) {
+    path.nodes.push_back(snapshot_.Value(v));
+  }
+  path.nodes.push_back(snapshot_.Value(src));
+  std::reverse(path.nodes.begin(), path.nodes.end());
+  for (NodeId v = meet; v != dst;) {
+    v = labels_[1][v].parent;
+    path.nodes.push_back(snapshot_.Value(v));
+  }
+  return path;
+}
+
+template <typename N, typename E>
+void PathSearch<N, E>::Reset() {
+  for (NodeId v : touched_) {
+    labels_[0][v] = {};
+    labels_[1][v] = {};
+  }
+  touched_.clear();
+  for (auto& queue : queues_) {
+    queue = {};
+  }
+}
+
+}  // namespace gdwg
@@ -0,0 +1,101 @@
+// PathSearch on a grid with random weights, where A* has a manhattan distance lower bound, and
+// on an R-MAT graph, where it has none. Reports nodes settled and latency per query for
+// Dijkstra (stopping at dst), the bidirectional search and A*. Prints JSON to stdout.
+//
+//   shortest_path_benchmark [--side=300] [--scale=16] [--queries=500]
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/shortest_path.h"
+
+namespace {
+
+using N = std::uint32_t;
+using E = double;
+namespace bm = gdwg::benchmark;
+
+// times search over pairs, reporting the mean settled nodes and microseconds per query
+template <typename Search>
+void Report(bm::Reporter& reporter,
+            const std::string& name,
+            const bm::Fields& params,
+            gdwg::PathSearch<N, E>& paths,
+            const std::vector<std::pair<N, N>>& pairs,
+            Search search) {
+  std::size_t settled = 0;
+  double weight = 0;
+  const double seconds = bm::Measure([&] {
+    settled = 0;
+    for (const auto& [a, b] : pairs) {
+      const auto path = search(a, b);
+      weight += path ? path->weight : 0;
+      settled += paths.Settled();
+    }
+  });
+  bm::DoNotOptimize(weight);
+  reporter.Add(name, params,
+               {{"us_per_query", 1e6 * seconds / pairs.size()},
+                {"settled_per_query", static_cast<double>(settled) / pairs.size()}});
+}
+
+std::vector<std::pair<N, N>> RandomPairs(std::size_t nodes, std::size_t queries) {
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<N> node(0, static_cast<N>(nodes - 1));
+  std::vector<std::pair<N, N>> pairs(queries);
+  for (auto& pair : pairs) {
+    pair = {node(rng), node(rng)};
+  }
+  return pairs;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto side = static_cast<N>(bm::Arg(argc, argv, "side", 300));
+  const auto scale = static_cast<unsigned>(bm::Arg(argc, argv, "scale", 16));
+  const auto queries = bm::Arg(argc, argv, "queries", 500);
+  bm::Reporter reporter;
+
+  {
+    gdwg::PathSearch<N, E> paths{
+        gdwg::Grid2D<N, E>(side, side, gdwg::UniformWeights<E>(1, 10)).BuildSnapshot()};
+    const bm::Fields params{{"nodes", paths.GetSnapshot().NumNodes()},
+                            {"edges", paths.GetSnapshot().NumEdges()}};
+    const auto pairs = RandomPairs(paths.GetSnapshot().NumNodes(), queries);
+    Report(reporter, "grid/dijkstra", params, paths, pairs,
+           [&](N a, N b) { return paths.Dijkstra(a, b); });
+    Report(reporter, "grid/bidirectional", params, paths, pairs,
+           [&](N a, N b) { return paths.Bidirectional(a, b); });
+    // every step of the grid weighs at least 1
+    Report(reporter, "grid/astar", params, paths, pairs, [&](N a, N b) {
+      return paths.AStar(a, b, [b, side](N v) {
+        return static_cast<E>(std::abs(static_cast<long>(v / side) - static_cast<long>(b / side)) +
+                              std::abs(static_cast<long>(v % side) - static_cast<long>(b % side)));
+      });
+    });
+  }
+
+  {
+    const std::size_t nodes = std::size_t{1} << scale;
+    auto builder = gdwg::Rmat<N, E>(scale, nodes * 8, gdwg::UniformWeights<E>(1, 10));
+    for (N i = 0; i < nodes; ++i) {
+      builder.AddNode(i);
+    }
+    gdwg::PathSearch<N, E> paths{builder.BuildSnapshot()};
+    const bm::Fields params{{"nodes", nodes}, {"edges", paths.GetSnapshot().NumEdges()}};
+    const auto pairs = RandomPairs(nodes, queries);
+    Report(reporter, "rmat/dijkstra", params, paths, pairs,
+           [&](N a, N b) { return paths.Dijkstra(a, b); });
+    Report(reporter, "rmat/bidirectional", params, paths, pairs,
+           [&](N a, N b) { return paths.Bidirectional(a, b); });
+  }
+
+  reporter.Print(std::cout);
+}
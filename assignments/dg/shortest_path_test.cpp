@@ -0,0 +1,168 @@
+/*
+  Tests for PathSearch and ShortestPath. Each search is run for every pair of nodes of random
+  graphs and checked against a plain Dijkstra of the graph: the weight must match and the path
+  must be made of real edges adding up to it. A* is tried with an exact lower bound on a grid
+  and with one that is admissible but not consistent.
+*/
+
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/shortest_path.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+// true if search(src, dst) finds a shortest path for every pair, and nothing where there's none
+template <typename Search>
+bool MatchesDijkstra(const gdwg::Graph<int, int>& g, Search search) {
+  for (int src : g.GetNodes()) {
+    const auto dist = gdwg::testing::Dijkstra(g, src);
+    for (int dst : g.GetNodes()) {
+      const auto it = dist.find(dst);
+      const std::optional<gdwg::Path<int, int>> path = search(src, dst);
+      if (it == dist.end()) {
+        if (path.has_value()) {
+          return false;
+        }
+        continue;
+      }
+      if (!path || path->weight != it->second || path->nodes.front() != src ||
+          path->nodes.back() != dst || gdwg::testing::Walk(g, path->nodes) != it->second) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+SCENARIO("Every single pair search finds the same shortest paths as Dijkstra") {
+  for (int edges : {0, 40, 100, 250, 700}) {
+    GIVEN("a random graph with 60 nodes and " + std::to_string(edges) + " edges") {
+      const auto g =
+          gdwg::testing::RandomGraph(60, edges, static_cast<unsigned>(edges) + 3, 0, 20, 3);
+      gdwg::PathSearch<int, int> search{g};
+      THEN("Dijkstra, bidirectional and A* without a heuristic all match") {
+        REQUIRE(MatchesDijkstra(g, [&](int s, int t) { return search.Dijkstra(s, t); }));
+        REQUIRE(MatchesDijkstra(g, [&](int s, int t) { return search.Bidirectional(s, t); }));
+        REQUIRE(MatchesDijkstra(
+            g, [&](int s, int t) { return search.AStar(s, t, [](int) { return 0; }); }));
+      }
+      THEN("so do the one-off ShortestPath functions") {
+        REQUIRE(MatchesDijkstra(g, [&](int s, int t) { return gdwg::ShortestPath(g, s, t); }));
+        REQUIRE(MatchesDijkstra(g, [&](int s, int t) {
+          return gdwg::ShortestPath(g, s, t, [](int) { return 0; });
+        }));
+      }
+    }
+  }
+}
+
+SCENARIO("A* with a lower bound searches less of a grid") {
+  GIVEN("a 15 x 15 grid with edges both ways of weight 2 to 9") {
+    constexpr int kSide = 15;
+    gdwg::Graph<int, int> g;
+    std::mt19937 rng{11};
+    std::uniform_int_distribution<int> weight(2, 9);
+    for (int i = 0; i < kSide * kSide; ++i) {
+      g.InsertNode(i);
+    }
+    for (int r = 0; r < kSide; ++r) {
+      for (int c = 0; c < kSide; ++c) {
+        for (const auto& [dr, dc] : {std::pair{0, 1}, std::pair{1, 0}}) {
+          if (r + dr < kSide && c + dc < kSide) {
+            g.InsertEdge(r * kSide + c, (r + dr) * kSide + c + dc, weight(rng));
+            g.InsertEdge((r + dr) * kSide + c + dc, r * kSide + c, weight(rng));
+          }
+        }
+      }
+    }
+    gdwg::PathSearch<int, int> search{g};
+    // grid steps to dst, each of which weighs at least 2
+    auto manhattan = [](int dst) {
+      return [dst](int v) {
+        return 2 * (std::abs(v / kSide - dst / kSide) + std::abs(v % kSide - dst % kSide));
+      };
+    };
+    THEN("A* with the manhattan distance is exact") {
+      REQUIRE(MatchesDijkstra(g, [&](int s, int t) { return search.AStar(s, t, manhattan(t)); }));
+    }
+    THEN("so is A* with a lower bound that isn't consistent, which searches nodes again") {
+      // half the bound on odd nodes: still never too high, but it drops along some edges by
+      // more than their weight
+      auto uneven = [&](int t) {
+        return [bound = manhattan(t)](int v) { return v % 2 == 1 ? bound(v) / 2 : bound(v); };
+      };
+      REQUIRE(MatchesDijkstra(g, [&](int s, int t) { return search.AStar(s, t, uneven(t)); }));
+    }
+    THEN("corner to corner, A* and the bidirectional search settle fewer nodes than Dijkstra") {
+      const int corner = kSide * kSide - 1;
+      const auto dijkstra = search.Dijkstra(0, corner);
+      const auto dijkstra_settled = search.Settled();
+      const auto astar = search.AStar(0, corner, manhattan(corner));
+      const auto astar_settled = search.Settled();
+      const auto bidirectional = search.Bidirectional(0, corner);
+      const auto bidirectional_settled = search.Settled();
+      REQUIRE(dijkstra);
+      REQUIRE(astar->weight == dijkstra->weight);
+      REQUIRE(bidirectional->weight == dijkstra->weight);
+      REQUIRE(astar_settled < dijkstra_settled);
+      REQUIRE(bidirectional_settled <= dijkstra_settled);
+    }
+  }
+}
+
+SCENARIO("Paths are made of the graph's own nodes") {
+  GIVEN("a chain of strings with a heavy direct edge") {
+    gdwg::Graph<std::string, double> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("a", "d", 5);
+    g.InsertEdge("b", "b", 0);
+    gdwg::PathSearch<std::string, double> search{g};
+    const gdwg::Path<std::string, double> expected{{"a", "b", "c", "d"}, 3};
+    THEN("every search goes the long way round, which is shorter") {
+      REQUIRE(search.Dijkstra("a", "d") == expected);
+      REQUIRE(search.Bidirectional("a", "d") == expected);
+      REQUIRE(search.AStar("a", "d", [](const std::string&) { return 0.0; }) == expected);
+    }
+    THEN("a node's path to itself is just the node, and unreachable nodes have none") {
+      const gdwg::Path<std::string, double> itself{{"c"}, 0};
+      REQUIRE(search.Dijkstra("c", "c") == itself);
+      REQUIRE(search.Bidirectional("c", "c") == itself);
+      REQUIRE(search.Dijkstra("d", "a") == std::nullopt);
+      REQUIRE(search.Bidirectional("d", "a") == std::nullopt);
+      REQUIRE(search.Bidirectional("a", "e") == std::nullopt);
+    }
+  }
+}
+
+SCENARIO("Bad input to a path search is rejected") {
+  GIVEN("a graph with a negative weight") {
+    gdwg::Graph<int, int> g{1, 2};
+    g.InsertEdge(1, 2, -1);
+    THEN("it can't be searched") {
+      REQUIRE_THROWS_WITH((gdwg::PathSearch<int, int>{g}),
+                          "Cannot create a PathSearch of a graph with negative weights");
+      REQUIRE_THROWS_AS(gdwg::ShortestPath(g, 1, 2), std::invalid_argument);
+    }
+  }
+  GIVEN("a path search") {
+    gdwg::PathSearch<int, int> search{gdwg::Graph<int, int>{1, 2}};
+    THEN("searches from or to missing nodes throw") {
+      REQUIRE_THROWS_WITH(search.Dijkstra(1, 3),
+                          "Cannot call PathSearch::Dijkstra if src or dst node don't exist in "
+                          "the graph");
+      REQUIRE_THROWS_AS(search.Bidirectional(3, 1), std::out_of_range);
+      REQUIRE_THROWS_AS(search.AStar(3, 1, [](int) { return 0; }), std::out_of_range);
+    }
+  }
+}
@@ -0,0 +1,92 @@
+#ifndef ASSIGNMENTS_DG_SNAPSHOT_H_
+#define ASSIGNMENTS_DG_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// An immutable compressed sparse row (CSR) copy of a Graph. Nodes are numbered 0..NumNodes()-1
+// in the graph's (sorted) order, and the out edges of node i are the edge ids
+// [EdgeBegin(i), EdgeEnd(i)), sorted by destination and then weight just like Graph iterates.
+//
+// The arrays are either owned by the snapshot or borrowed from an owner it keeps alive (e.g. a
+// memory mapped file), so copying a Snapshot is cheap and every copy shares the same data.
+template <typename N, typename E>
+class Snapshot {
+ public:
+  using NodeId = std::uint32_t;
+  using EdgeId = std::uint64_t;
+
+  Snapshot();
+  explicit Snapshot(const Graph<N, E>& g);
+  // offsets must have nodes.size() + 1 entries, nodes must be sorted and each node's destinations
+  // sorted by (dst, weight)
+  Snapshot(std::vector<N> nodes,
+           std::vector<EdgeId> offsets,
+           std::vector<NodeId> dsts,
+           std::vector<E> weights);
+  // borrows the arrays; owner is kept alive for as long as any copy of the snapshot exists
+  Snapshot(const N* nodes,
+           const EdgeId* offsets,
+           const NodeId* dsts,
+           const E* weights,
+           std::size_t num_nodes,
+           std::shared_ptr<const void> owner) noexcept
+    : nodes_{nodes}, offsets_{offsets}, dsts_{dsts}, weights_{weights}, num_nodes_{num_nodes},
+      owner_{std::move(owner)} {}
+
+  std::size_t NumNodes() const noexcept { return num_nodes_; }
+  std::size_t NumEdges() const noexcept { return offsets_[num_nodes_]; }
+  bool IsEmpty() const noexcept { return num_nodes_ == 0; }
+
+  const N& Value(NodeId id) const noexcept { return nodes_[id]; }
+  EdgeId EdgeBegin(NodeId id) const noexcept { return offsets_[id]; }
+  EdgeId EdgeEnd(NodeId id) const noexcept { return offsets_[id + 1]; }
+  std::size_t Degree(NodeId id) const noexcept { return offsets_[id + 1] - offsets_[id]; }
+  NodeId Dst(EdgeId e) const noexcept { return dsts_[e]; }
+  const E& Weight(EdgeId e) const noexcept { return weights_[e]; }
+
+  // raw arrays, for algorithms and the binary format
+  const N* Nodes() const noexcept { return nodes_; }
+  const EdgeId* Offsets() const noexcept { return offsets_; }
+  const NodeId* Dsts() const noexcept { return dsts_; }
+  const E* Weights() const noexcept { return weights_; }
+
+  bool IsNode(const N& val) const;
+  NodeId Id(const N& val) const;
+  std::vector<N> GetNodes() const;
+  bool IsConnected(const N& src, const N& dst) const;
+  std::vector<N> GetConnected(const N& src) const;
+  std::vector<E> GetWeights(const N& src, const N& dst) const;
+
+  Graph<N, E> ToGraph() const;
+
+ private:
+  struct Storage {
+    std::vector<N> nodes;
+    std::vector<EdgeId> offsets;
+    std::vector<NodeId> dsts;
+    std::vector<E> weights;
+  };
+
+  void Adopt(std::shared_ptr<Storage> storage) noexcept;
+  const N* Find(const N& val) const;
+
+  const N* nodes_;
+  const EdgeId* offsets_;
+  const NodeId* dsts_;
+  const E* weights_;
+  std::size_t num_nodes_;
+  std::shared_ptr<const void> owner_;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/snapshot.tpp"
+
+#endif  // ASSIGNMENTS_DG_SNAPSHOT_H_
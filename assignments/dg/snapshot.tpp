@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+template <typename N, typename E>
+Snapshot<N, E>::Snapshot() {
+  auto storage = std::make_shared<Storage>();
+  storage->offsets.push_back(0);
+  Adopt(std::move(storage));
+}
+
+template <typename N, typename E>
+Snapshot<N, E>::Snapshot(const Graph<N, E>& g) {
+  if (g.NumNodes() > std::numeric_limits<NodeId>::max()) {
+    throw std::length_error("Cannot create a Snapshot of a graph with more than 2^32 - 1 nodes");
+  }
+  auto storage = std::make_shared<Storage>();
+  storage->nodes.reserve(g.NumNodes());
+  storage->offsets.reserve(g.NumNodes() + 1);
+  storage->offsets.push_back(0);
+  const std::size_t num_edges = g.NumEdges();
+  storage->dsts.reserve(num_edges);
+  storage->weights.reserve(num_edges);
+
+  // nodes are shared between the map keys and the edges, so ids can be found by address
+  std::unordered_map<const N*, NodeId> ids;
+  ids.reserve(g.NumNodes());
+  for (const auto& node_edges : g.edge_map_) {
+    ids.emplace(&*node_edges.first, static_cast<NodeId>(storage->nodes.size()));
+    storage->nodes.push_back(*node_edges.first);
+  }
+  for (const auto& node_edges : g.edge_map_) {
+    for (const auto& edge : node_edges.second) {
+      storage->dsts.push_back(ids.find(edge.dst_.lock().get())->second);
+      storage->weights.push_back(*edge.weight_);
+    }
+    storage->offsets.push_back(storage->dsts.size());
+  }
+  Adopt(std::move(storage));
+}
+
+template <typename N, typename E>
+Snapshot<N, E>::Snapshot(std::vector<N> nodes,
+                         std::vector<EdgeId> offsets,
+                         std::vector<NodeId> dsts,
+                         std::vector<E> weights) {
+  if (offsets.size() != nodes.size() + 1 || offsets.front() != 0 ||
+      offsets.back() != dsts.size() || dsts.size() != weights.size()) {
+    throw std::invalid_argument("Cannot create a Snapshot from arrays of mismatched sizes");
+  }
+  if (nodes.size() > std::numeric_limits<NodeId>::max()) {
+    throw std::length_error("Cannot create a Snapshot of a graph with more than 2^32 - 1 nodes");
+  }
+  auto storage = std::make_shared<Storage>();
+  storage->nodes = std::move(nodes);
+  storage->offsets = std::move(offsets);
+  storage->dsts = std::move(dsts);
+  storage->weights = std::move(weights);
+  Adopt(std::move(storage));
+}
+
+template <typename N, typename E>
+void Snapshot<N, E>::Adopt(std::shared_ptr<Storage> storage) noexcept {
+  nodes_ = storage->nodes.data();
+  offsets_ = storage->offsets.data();
+  dsts_ = storage->dsts.data();
+  weights_ = storage->weights.data();
+  num_nodes_ = storage->nodes.size();
+  owner_ = std::move(storage);
+}
+
+template <typename N, typename E>
+const N* Snapshot<N, E>::Find(const N& val) const {
+  const N* end = nodes_ + num_nodes_;
+  const N* it = std::lower_bound(nodes_, end, val);
+  return (it != end && !(val < *it)) ? it : end;
+}
+
+template <typename N, typename E>
+bool Snapshot<N, E>::IsNode(const N& val) const {
+  return Find(val) != nodes_ + num_nodes_;
+}
+
+template <typename N, typename E>
+typename Snapshot<N, E>::NodeId Snapshot<N, E>::Id(const N& val) const {
+  const N* it = Find(val);
+  if (it == nodes_ + num_nodes_) {
+    throw std::out_of_range("Cannot call Snapshot::Id on a node that doesn't exist");
+  }
+  return static_cast<NodeId>(it - nodes_);
+}
+
+template <typename N, typename E>
+std::vector<N> Snapshot<N, E>::GetNodes() const {
+  return std::vector<N>(nodes_, nodes_ + num_nodes_);
+}
+
+template <typename N, typename E>
+bool Snapshot<N, E>::IsConnected(const N& src, const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::runtime_error(
+        "Cannot call Snapshot::IsConnected if src or dst node don't exist in the graph");
+  }
+  const NodeId s = Id(src);
+  return std::binary_search(dsts_ + EdgeBegin(s), dsts_ + EdgeEnd(s), Id(dst));
+}
+
+template <typename N, typename E>
+std::vector<N> Snapshot<N, E>::GetConnected(const N& src) const {
+  if (!IsNode(src)) {
+    throw std::out_of_range("Cannot call Snapshot::GetConnected if src doesn't exist in the graph");
+  }
+  const NodeId s = Id(src);
+  std::vector<N> connected;
+  for (EdgeId e = EdgeBegin(s); e != EdgeEnd(s); ++e) {
+    if (e == EdgeBegin(s) || dsts_[e] != dsts_[e - 1]) {
+      connected.push_back(nodes_[dsts_[e]]);
+    }
+  }
+  return connected;
+}
+
+template <typename N, typename E>
+std::vector<E> Snapshot<N, E>::GetWeights(const N& src, const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::out_of_range(
+        "Cannot call Snapshot::GetWeights if src or dst node don't exist in the graph");
+  }
+  const NodeId s = Id(src);
+  const auto range = std::equal_range(dsts_ + EdgeBegin(s), dsts_ + EdgeEnd(s), Id(dst));
+  return std::vector<E>(weights_ + (range.first - dsts_), weights_ + (range.second - dsts_));
+}
+
+template <typename N, typename E>
+Graph<N, E> Snapshot<N, E>::ToGraph() const {
+  Graph<N, E> g;
+  std::vector<typename Graph<N, E>::node_iterator> node_its;
+  node_its.reserve(num_nodes_);
+  for (std::size_t i = 0; i < num_nodes_; ++i) {
+    node_its.push_back(g.AppendNode(nodes_[i]));
+  }
+  for (NodeId src = 0; src < num_nodes_; ++src) {
+    for (EdgeId e = EdgeBegin(src); e != EdgeEnd(src); ++e) {
+      g.AppendEdge(node_its[src], node_its[dsts_[e]], weights_[e]);
+    }
+  }
+  return g;
+}
+
+}  // namespace gdwg
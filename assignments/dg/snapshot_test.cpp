@@ -0,0 +1,78 @@
+/*
+  Snapshot is checked against the Graph it was built from: every query must give the same
+  answer, and ToGraph must rebuild an equal graph.
+*/
+
+#include <string>
+#include <vector>
+
+#include "assignments/dg/snapshot.h"
+#include "catch.h"
+
+SCENARIO("Snapshot answers queries like the graph it was built from") {
+  GIVEN("a graph with parallel edges and a node with no edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 3);
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "c", 2);
+    g.InsertEdge("c", "a", 5);
+    g.InsertEdge("c", "c", 0);
+    gdwg::Snapshot<std::string, int> s{g};
+
+    THEN("sizes and node ids follow the graph's order") {
+      REQUIRE(s.NumNodes() == 4);
+      REQUIRE(s.NumEdges() == 5);
+      REQUIRE(s.GetNodes() == g.GetNodes());
+      REQUIRE(s.Id("c") == 2);
+      REQUIRE(s.Value(3) == "d");
+      REQUIRE(s.Degree(s.Id("a")) == 3);
+      REQUIRE(s.Degree(s.Id("d")) == 0);
+      REQUIRE_THROWS_AS(s.Id("z"), std::out_of_range);
+    }
+    THEN("edge queries match the graph") {
+      for (const auto& src : g.GetNodes()) {
+        REQUIRE(s.GetConnected(src) == g.GetConnected(src));
+        for (const auto& dst : g.GetNodes()) {
+          REQUIRE(s.IsConnected(src, dst) == g.IsConnected(src, dst));
+          REQUIRE(s.GetWeights(src, dst) == g.GetWeights(src, dst));
+        }
+      }
+      REQUIRE_THROWS_AS(s.IsConnected("a", "z"), std::runtime_error);
+      REQUIRE_THROWS_AS(s.GetWeights("z", "a"), std::out_of_range);
+    }
+    THEN("edges are laid out in the graph's iteration order") {
+      auto it = g.begin();
+      for (gdwg::Snapshot<std::string, int>::NodeId src = 0; src < s.NumNodes(); ++src) {
+        for (auto e = s.EdgeBegin(src); e != s.EdgeEnd(src); ++e, ++it) {
+          REQUIRE(*it == std::tie(s.Value(src), s.Value(s.Dst(e)), s.Weight(e)));
+        }
+      }
+      REQUIRE(it == g.end());
+    }
+    THEN("ToGraph rebuilds an equal graph") {
+      auto rebuilt = s.ToGraph();
+      REQUIRE(rebuilt == g);
+      REQUIRE(rebuilt.InsertEdge("d", "a", 1));
+      REQUIRE(rebuilt.NumEdges() == 6);
+    }
+    THEN("copies share the same arrays") {
+      auto copy = s;
+      REQUIRE(copy.Dsts() == s.Dsts());
+    }
+  }
+  GIVEN("a default constructed snapshot") {
+    gdwg::Snapshot<int, int> s;
+    THEN("it is empty") {
+      REQUIRE(s.IsEmpty());
+      REQUIRE(s.NumEdges() == 0);
+      REQUIRE(s.ToGraph().IsEmpty());
+    }
+  }
+  GIVEN("arrays with mismatched sizes") {
+    THEN("constructing a snapshot throws") {
+      REQUIRE_THROWS_AS((gdwg::Snapshot<int, int>{{1, 2}, {0, 1}, {0}, {7}}),
+                        std::invalid_argument);
+      REQUIRE_THROWS_AS((gdwg::Snapshot<int, int>{{1}, {0, 1}, {0}, {}}), std::invalid_argument);
+    }
+  }
+}
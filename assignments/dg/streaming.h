@@ -0,0 +1,248 @@
+#ifndef ASSIGNMENTS_DG_STREAMING_H_
+#define ASSIGNMENTS_DG_STREAMING_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/serialize.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// Edge file, version 1, for StreamingGraph. Integers are native endian:
+//
+//   EdgeFileHeader
+//   node table    num_nodes values in order, as Codec<N> records
+//   edges         num_edges records of [uint32 src][uint32 dst][E weight], packed, by source,
+//                 starting on a 64 byte boundary
+struct EdgeFileHeader {
+  static constexpr char kMagic[8] = {'G', 'D', 'W', 'G', 'E', 'D', 'G', 'E'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kEndian = 0x01020304;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endian;
+  std::uint32_t weight_size;
+  std::uint32_t reserved;
+  std::uint64_t num_nodes;
+  std::uint64_t num_edges;
+  std::uint64_t nodes_offset;
+  std::uint64_t nodes_bytes;
+  std::uint64_t edges_offset;
+};
+
+// Writes the graph as an edge file, to be streamed by StreamingGraph.
+template <typename N, typename E>
+void SaveEdgeFile(const Snapshot<N, E>& s, const std::string& path);
+
+template <typename N, typename E>
+void SaveEdgeFile(const Graph<N, E>& g, const std::string& path) {
+  SaveEdgeFile(Snapshot<N, E>{g}, path);
+}
+
+struct StreamOptions {
+  // edges (and spilled updates) are read in blocks of about this many bytes, the prefetch
+  // thread reading one block ahead, so two are in memory at a time
+  std::size_t block_bytes = std::size_t{4} << 20;
+  // updates held in memory during a scatter before all of them are written out to disk, in one
+  // buffer shared by every partition
+  std::size_t update_bytes = std::size_t{64} << 20;
+  // nodes to a streaming partition: updates are shuffled by the partition of their
+  // destination and gathered a partition at a time, so that its state stays in cache
+  std::size_t partition_nodes = std::size_t{1} << 16;
+  // directory for the file updates spill to, the system's temporary directory if empty. Each
+  // pass has one file, every partition's updates in runs of it, with a name of its own. It is
+  // unlinked as soon as it is created, so passes never see each other's and nothing is left
+  // behind if the process dies.
+  std::string temp_dir;
+};
+
+struct StreamStats {
+  std::uint64_t edges = 0;
+  std::uint64_t updates = 0;
+  // bytes of edges and of spilled updates read from disk
+  std::uint64_t bytes_read = 0;
+  std::uint64_t bytes_spilled = 0;
+};
+
+namespace detail {
+
+// [offset, offset + bytes) of a file
+struct Extent {
+  std::uint64_t offset;
+  std::uint64_t bytes;
+};
+
+// Reads extents of a file front to back and one after the other, a block at a time, on a
+// thread of its own that reads the next block while the caller works on the one before. No
+// block spans two extents.
+class BlockReader {
+ public:
+  BlockReader(int fd, std::vector<Extent> extents, std::size_t block_bytes);
+  BlockReader(const BlockReader&) = delete;
+  BlockReader& operator=(const BlockReader&) = delete;
+  ~BlockReader();
+
+  // the next block, or an empty one after the last; valid until the next call
+  std::pair<const char*, std::size_t> Next();
+
+ private:
+  void Prefetch();
+
+  int fd_;
+  std::vector<Extent> extents_;
+  std::size_t block_bytes_;
+  std::vector<char> buffers_[2];
+  std::size_t sizes_[2] = {0, 0};
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  // blocks read so far, handed to the caller, and that the caller has finished with
+  std::uint64_t read_ = 0;
+  std::uint64_t taken_ = 0;
+  std::uint64_t released_ = 0;
+  bool done_ = false;
+  bool stopping_ = false;
+  std::exception_ptr error_;
+  std::thread thread_;
+};
+
+// a T copied out of bytes that needn't be aligned for it, without T having to be default
+// constructible
+template <typename T>
+class Unaligned {
+ public:
+  explicit Unaligned(const char* bytes) noexcept { std::memcpy(storage_, bytes, sizeof(T)); }
+  const T& operator*() const noexcept {
+    return *std::launder(reinterpret_cast<const T*>(storage_));
+  }
+
+ private:
+  alignas(T) unsigned char storage_[sizeof(T)];
+};
+
+// Reorders count records of RecordBytes bytes in place so that those of each partition are
+// together, in order of partition, where partition(record) gives a record's, below parts.
+// Records of a partition end up in no particular order. Returns where each partition's
+// records start, and count at the end.
+template <std::size_t RecordBytes, typename Partition>
+std::vector<std::size_t> GroupRecords(char* records,
+                                      std::size_t count,
+                                      std::size_t parts,
+                                      Partition partition);
+
+// an unnamed file that updates spill to, created in dir (the system's temporary directory if
+// empty) on the first write, and gone once it is closed on destruction
+class SpillFile {
+ public:
+  SpillFile() = default;
+  SpillFile(const SpillFile&) = delete;
+  SpillFile& operator=(const SpillFile&) = delete;
+  ~SpillFile();
+
+  void Append(const std::string& dir, const char* data, std::size_t size);
+  int Fd() const noexcept { return fd_; }
+  std::uint64_t Size() const noexcept { return size_; }
+
+ private:
+  std::string dir_;
+  int fd_ = -1;
+  std::uint64_t size_ = 0;
+};
+
+}  // namespace detail
+
+// An out-of-core graph engine after X-Stream (Roy, Mihailovic and Zwaenepoel). Node values are
+// in memory, but edges stay on disk in an edge file (see SaveEdgeFile) and are only ever
+// streamed through front to back in large blocks, never looked up, as sequential reads are
+// fast on any disk while random ones are not. The caller keeps whatever state it needs per
+// node, indexed by NodeId (node order, as for Snapshot), and computes in edge-centric passes:
+//  - scatter: scatter(src, dst, weight) is called for every edge, returning a std::optional
+//    update for dst, or nullopt if the edge has nothing to send.
+//  - shuffle: updates are appended to one buffer of StreamOptions::update_bytes. Whenever it
+//    fills, its updates are grouped in place by the partition of nodes holding dst and
+//    appended to an update file in StreamOptions::temp_dir, each partition's noted as a run
+//    of the file, so that memory stays bounded however many updates a pass makes.
+//  - gather: each partition in turn, gather(dst, update) is called for each of its updates,
+//    first those spilled to disk, its runs streamed back, then those still in memory, in no
+//    particular order.
+// A thread prefetches the next block of edges or updates as the caller works on the one
+// before, overlapping the reads with compute. Every pass streams every edge, so algorithms
+// that touch few edges each step (BFS on a long path, say) pay for all of them each time.
+//
+// Weights and updates must be trivially copyable, as edges and spilled updates are fixed size
+// records, though neither need be default constructible. Passes change the stream's
+// statistics, so aren't const, and a StreamingGraph is for one thread at a time.
+template <typename N, typename E>
+class StreamingGraph {
+  static_assert(std::is_trivially_copyable<E>::value,
+                "StreamingGraph streams fixed size edge records, so needs trivially copyable "
+                "weights");
+
+ public:
+  using NodeId = std::uint32_t;
+
+  explicit StreamingGraph(std::string path, StreamOptions options = {});
+  StreamingGraph(const StreamingGraph&) = delete;
+  StreamingGraph& operator=(const StreamingGraph&) = delete;
+  ~StreamingGraph();
+
+  std::size_t NumNodes() const noexcept { return nodes_.size(); }
+  std::uint64_t NumEdges() const noexcept { return num_edges_; }
+  const N& Value(NodeId id) const noexcept { return nodes_[id]; }
+  const std::vector<N>& Nodes() const noexcept { return nodes_; }
+  bool IsNode(const N& val) const;
+  NodeId Id(const N& val) const;
+
+  // totals over every pass so far
+  const StreamStats& Stats() const noexcept { return stats_; }
+  // the memory passes use at most, besides the node table, the caller's state and a few words
+  // for each partition and each run of updates spilled: two blocks and the updates buffered
+  std::size_t MemoryBytes() const noexcept {
+    return 2 * options_.block_bytes + options_.update_bytes;
+  }
+
+  // calls fn(src, dst, weight) for every edge, in order of source
+  template <typename Fn>
+  void ForEachEdge(Fn fn);
+
+  // One scatter, shuffle and gather pass, as described above. Returns the updates gathered.
+  template <typename Scatter, typename Gather>
+  std::uint64_t ScatterGather(Scatter scatter, Gather gather);
+
+  // reads the whole graph into memory
+  Graph<N, E> ToGraph();
+
+ private:
+  static constexpr std::size_t kEdgeBytes = 2 * sizeof(NodeId) + sizeof(E);
+
+  // calls fn(block, size) for each block of the extents of fd in turn, every block a whole
+  // number of records
+  template <typename Fn>
+  void ForEachBlock(int fd, std::vector<detail::Extent> extents, std::size_t record_bytes, Fn fn);
+
+  std::string path_;
+  StreamOptions options_;
+  int fd_ = -1;
+  std::vector<N> nodes_;
+  std::uint64_t num_edges_ = 0;
+  std::uint64_t edges_offset_ = 0;
+  StreamStats stats_;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/streaming.tpp"
+
+#endif  // ASSIGNMENTS_DG_STREAMING_H_
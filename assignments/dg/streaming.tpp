@@ -0,0 +1,435 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+
+namespace gdwg {
+
+namespace detail {
+
+// pread until size bytes are read. Returns 0 once they are, else the errno of the read that
+// failed, or kEndOfFile if the file ends first.
+constexpr int kEndOfFile = -1;
+inline int ReadFully(int fd, char* out, std::size_t size, std::uint64_t offset) {
+  while (size > 0) {
+    const auto got = ::pread(fd, out, size, static_cast<off_t>(offset));
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got < 0) {
+      return errno;
+    }
+    if (got == 0) {
+      return kEndOfFile;
+    }
+    out += got;
+    size -= static_cast<std::size_t>(got);
+    offset += static_cast<std::uint64_t>(got);
+  }
+  return 0;
+}
+
+inline BlockReader::BlockReader(int fd, std::vector<Extent> extents, std::size_t block_bytes)
+  : fd_(fd), extents_(std::move(extents)), block_bytes_(block_bytes) {
+  std::uint64_t longest = 0;
+  for (const auto& extent : extents_) {
+    longest = std::max(longest, extent.bytes);
+    ::posix_fadvise(fd_, static_cast<off_t>(extent.offset), static_cast<off_t>(extent.bytes),
+                    POSIX_FADV_SEQUENTIAL);
+  }
+  for (auto& buffer : buffers_) {
+    buffer.resize(static_cast<std::size_t>(std::min<std::uint64_t>(block_bytes, longest)));
+  }
+  thread_ = std::thread([this] { Prefetch(); });
+}
+
+inline BlockReader::~BlockReader() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  changed_.notify_all();
+  thread_.join();
+}
+
+inline std::pair<const char*, std::size_t> BlockReader::Next() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  // the block handed out last is finished with, so its buffer can be read into again
+  released_ = taken_;
+  changed_.notify_all();
+  changed_.wait(lock, [this] { return read_ > taken_ || done_ || error_; });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  if (read_ == taken_) {
+    return {nullptr, 0};
+  }
+  const auto slot = taken_++ % 2;
+  return {buffers_[slot].data(), sizes_[slot]};
+}
+
+inline void BlockReader::Prefetch() {
+  std::uint64_t block = 0;
+  for (const auto& extent : extents_) {
+    const auto end = extent.offset + extent.bytes;
+    for (std::uint64_t pos = extent.offset; pos < end; ++block) {
+      {
+        // a buffer is free once the caller has finished with the block two before
+        std::unique_lock<std::mutex> lock{mutex_};
+        changed_.wait(lock, [&] { return stopping_ || block < released_ + 2; });
+        if (stopping_) {
+          return;
+        }
+      }
+      const auto slot = block % 2;
+      const auto size = static_cast<std::size_t>(std::min<std::uint64_t>(block_bytes_, end - pos));
+      const int error = ReadFully(fd_, buffers_[slot].data(), size, pos);
+      const bool ok = error == 0;
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (!ok) {
+          error_ = std::make_exception_ptr(std::runtime_error(
+              std::string{"Cannot read a block of a streamed file: "} +
+              (error == kEndOfFile ? "it ends early, so was truncated while open"
+                                   : std::strerror(error))));
+        } else {
+          sizes_[slot] = size;
+          ++read_;
+        }
+      }
+      changed_.notify_all();
+      if (!ok) {
+        return;
+      }
+      pos += size;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    done_ = true;
+  }
+  changed_.notify_all();
+}
+
+template <std::size_t RecordBytes, typename Partition>
+std::vector<std::size_t> GroupRecords(char* records,
+                                      std::size_t count,
+                                      std::size_t parts,
+                                      Partition partition) {
+  std::vector<std::size_t> starts(parts + 1, 0);
+  for (std::size_t i = 0; i < count; ++i) {
+    ++starts[partition(records + i * RecordBytes) + 1];
+  }
+  for (std::size_t p = 0; p < parts; ++p) {
+    starts[p + 1] += starts[p];
+  }
+  // each record not yet in its partition's range is swapped with the next unplaced one there,
+  // so every swap places at least one record for good
+  std::vector<std::size_t> next(starts.begin(), starts.end() - 1);
+  for (std::size_t p = 0; p < parts; ++p) {
+    while (next[p] < starts[p + 1]) {
+      char* record = records + next[p] * RecordBytes;
+      const std::size_t q = partition(record);
+      if (q == p) {
+        ++next[p];
+      } else {
+        std::swap_ranges(record, record + RecordBytes, records + next[q]++ * RecordBytes);
+      }
+    }
+  }
+  return starts;
+}
+
+inline SpillFile::~SpillFile() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+inline void SpillFile::Append(const std::string& dir, const char* data, std::size_t size) {
+  if (fd_ < 0) {
+    dir_ = dir.empty() ? std::filesystem::temp_directory_path().string() : dir;
+    std::string path = (std::filesystem::path{dir_} / "gdwg_updates.XXXXXX").string();
+    fd_ = ::mkstemp(path.data());
+    if (fd_ < 0) {
+      throw std::runtime_error("Cannot create an update file in " + dir_ + ": " +
+                               std::strerror(errno));
+    }
+    // the open descriptor keeps it for as long as it's needed
+    ::unlink(path.c_str());
+  }
+  while (size > 0) {
+    const auto written = ::write(fd_, data, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      throw std::runtime_error("Cannot write an update file in " + dir_ + ": " +
+                               std::strerror(errno));
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+    size_ += static_cast<std::uint64_t>(written);
+  }
+}
+
+}  // namespace detail
+
+template <typename N, typename E>
+void SaveEdgeFile(const Snapshot<N, E>& s, const std::string& path) {
+  static_assert(std::is_trivially_copyable<E>::value,
+                "edge files hold fixed size edge records, so need trivially copyable weights");
+  using NodeId = typename Snapshot<N, E>::NodeId;
+  std::ofstream os{path, std::ios::binary | std::ios::trunc};
+  if (!os) {
+    throw std::runtime_error("Cannot call gdwg::SaveEdgeFile on a file that can't be opened: " +
+                             path);
+  }
+  EdgeFileHeader header{};
+  std::memcpy(header.magic, EdgeFileHeader::kMagic, sizeof(header.magic));
+  header.version = EdgeFileHeader::kVersion;
+  header.endian = EdgeFileHeader::kEndian;
+  header.weight_size = sizeof(E);
+  header.num_nodes = s.NumNodes();
+  header.num_edges = s.NumEdges();
+
+  // the header is written again once the section offsets are known
+  std::uint64_t pos = 0;
+  detail::WriteBytes(os, pos, &header, sizeof(header));
+  header.nodes_offset = pos;
+  std::string nodes;
+  for (std::size_t v = 0; v < s.NumNodes(); ++v) {
+    Codec<N>::Write(nodes, s.Value(static_cast<NodeId>(v)));
+  }
+  header.nodes_bytes = nodes.size();
+  detail::WriteBytes(os, pos, nodes.data(), nodes.size());
+  detail::PadTo(os, pos);
+  header.edges_offset = pos;
+
+  constexpr std::size_t kEdgeBytes = 2 * sizeof(NodeId) + sizeof(E);
+  constexpr std::size_t kFlushBytes = std::size_t{1} << 20;
+  std::string buffer;
+  for (NodeId src = 0; src < s.NumNodes(); ++src) {
+    for (auto e = s.EdgeBegin(src); e < s.EdgeEnd(src); ++e) {
+      const NodeId dst = s.Dst(e);
+      const auto at = buffer.size();
+      buffer.resize(at + kEdgeBytes);
+      std::memcpy(&buffer[at], &src, sizeof(NodeId));
+      std::memcpy(&buffer[at + sizeof(NodeId)], &dst, sizeof(NodeId));
+      std::memcpy(&buffer[at + 2 * sizeof(NodeId)], &s.Weight(e), sizeof(E));
+      if (buffer.size() >= kFlushBytes) {
+        detail::WriteBytes(os, pos, buffer.data(), buffer.size());
+        buffer.clear();
+      }
+    }
+  }
+  detail::WriteBytes(os, pos, buffer.data(), buffer.size());
+
+  os.seekp(0);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.flush();
+  if (!os) {
+    throw std::runtime_error("Cannot call gdwg::SaveEdgeFile, writing failed: " + path);
+  }
+}
+
+template <typename N, typename E>
+StreamingGraph<N, E>::StreamingGraph(std::string path, StreamOptions options)
+  : path_(std::move(path)), options_(options) {
+  auto fail = [this](const std::string& why) {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    return std::runtime_error("Cannot open gdwg::StreamingGraph on " + path_ + ": " + why);
+  };
+  options_.block_bytes = std::max<std::size_t>(options_.block_bytes, 1);
+  options_.partition_nodes = std::max<std::size_t>(options_.partition_nodes, 1);
+
+  fd_ = ::open(path_.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    throw fail(std::strerror(errno));
+  }
+  EdgeFileHeader header;
+  if (detail::ReadFully(fd_, reinterpret_cast<char*>(&header), sizeof(header), 0) != 0) {
+    throw fail("file is too small");
+  }
+  if (std::memcmp(header.magic, EdgeFileHeader::kMagic, sizeof(header.magic)) != 0) {
+    throw fail("not an edge file");
+  }
+  if (header.version != EdgeFileHeader::kVersion) {
+    throw fail("unsupported version " + std::to_string(header.version));
+  }
+  if (header.endian != EdgeFileHeader::kEndian) {
+    throw fail("written on a machine with different endianness");
+  }
+  if (header.weight_size != sizeof(E)) {
+    throw fail("weight type doesn't match the file");
+  }
+  std::string table(static_cast<std::size_t>(header.nodes_bytes), '\0');
+  if (detail::ReadFully(fd_, table.data(), table.size(), header.nodes_offset) != 0) {
+    throw fail("truncated node table");
+  }
+  try {
+    const char* in = table.data();
+    const char* end = in + table.size();
+    nodes_.reserve(static_cast<std::size_t>(header.num_nodes));
+    for (std::uint64_t i = 0; i < header.num_nodes; ++i) {
+      nodes_.push_back(Codec<N>::Read(in, end));
+    }
+  } catch (const std::runtime_error& e) {
+    throw fail(e.what());
+  }
+  struct stat st;
+  if (::fstat(fd_, &st) != 0 || static_cast<std::uint64_t>(st.st_size) < header.edges_offset ||
+      (static_cast<std::uint64_t>(st.st_size) - header.edges_offset) / kEdgeBytes <
+          header.num_edges) {
+    throw fail("truncated edges");
+  }
+  num_edges_ = header.num_edges;
+  edges_offset_ = header.edges_offset;
+}
+
+template <typename N, typename E>
+StreamingGraph<N, E>::~StreamingGraph() {
+  ::close(fd_);
+}
+
+template <typename N, typename E>
+bool StreamingGraph<N, E>::IsNode(const N& val) const {
+  return std::binary_search(nodes_.begin(), nodes_.end(), val);
+}
+
+template <typename N, typename E>
+typename StreamingGraph<N, E>::NodeId StreamingGraph<N, E>::Id(const N& val) const {
+  const auto it = std::lower_bound(nodes_.begin(), nodes_.end(), val);
+  if (it == nodes_.end() || *it != val) {
+    throw std::out_of_range("Cannot call StreamingGraph::Id on a node that doesn't exist");
+  }
+  return static_cast<NodeId>(it - nodes_.begin());
+}
+
+template <typename N, typename E>
+template <typename Fn>
+void StreamingGraph<N, E>::ForEachBlock(int fd,
+                                        std::vector<detail::Extent> extents,
+                                        std::size_t record_bytes,
+                                        Fn fn) {
+  if (std::all_of(extents.begin(), extents.end(),
+                  [](const detail::Extent& extent) { return extent.bytes == 0; })) {
+    return;
+  }
+  const auto block_bytes = std::max(options_.block_bytes / record_bytes, std::size_t{1}) *
+                           record_bytes;
+  detail::BlockReader reader{fd, std::move(extents), block_bytes};
+  for (auto [block, size] = reader.Next(); size > 0; std::tie(block, size) = reader.Next()) {
+    stats_.bytes_read += size;
+    fn(block, size);
+  }
+}
+
+template <typename N, typename E>
+template <typename Fn>
+void StreamingGraph<N, E>::ForEachEdge(Fn fn) {
+  ForEachBlock(fd_, {{edges_offset_, num_edges_ * kEdgeBytes}}, kEdgeBytes,
+               [&](const char* block, std::size_t size) {
+                 for (const char* p = block; p < block + size; p += kEdgeBytes) {
+                   NodeId src;
+                   NodeId dst;
+                   std::memcpy(&src, p, sizeof(NodeId));
+                   std::memcpy(&dst, p + sizeof(NodeId), sizeof(NodeId));
+                   const detail::Unaligned<E> weight{p + 2 * sizeof(NodeId)};
+                   fn(src, dst, *weight);
+                 }
+                 stats_.edges += size / kEdgeBytes;
+               });
+}
+
+template <typename N, typename E>
+template <typename Scatter, typename Gather>
+std::uint64_t StreamingGraph<N, E>::ScatterGather(Scatter scatter, Gather gather) {
+  using Update = typename std::invoke_result_t<Scatter&, NodeId, NodeId, const E&>::value_type;
+  static_assert(std::is_trivially_copyable<Update>::value,
+                "ScatterGather spills updates to disk, so needs trivially copyable updates");
+  constexpr std::size_t kUpdateBytes = sizeof(NodeId) + sizeof(Update);
+  const std::size_t parts = std::max<std::size_t>(
+      (nodes_.size() + options_.partition_nodes - 1) / options_.partition_nodes, 1);
+
+  // scatter and shuffle, into a buffer of whole updates, though never more than every edge
+  // could send
+  const auto capacity = static_cast<std::size_t>(
+      std::min<std::uint64_t>(std::max(options_.update_bytes / kUpdateBytes, std::size_t{1}),
+                              std::max<std::uint64_t>(num_edges_, 1)));
+  // left uninitialised, so memory is only used as updates fill it
+  const std::unique_ptr<char[]> buffer{new char[capacity * kUpdateBytes]};
+  std::size_t buffered = 0;
+  auto partition = [this](const char* record) {
+    NodeId dst;
+    std::memcpy(&dst, record, sizeof(NodeId));
+    return std::size_t{dst / options_.partition_nodes};
+  };
+  detail::SpillFile spilled;
+  std::vector<std::vector<detail::Extent>> runs(parts);
+  ForEachEdge([&](NodeId src, NodeId dst, const E& weight) {
+    const std::optional<Update> update = scatter(src, dst, weight);
+    if (!update) {
+      return;
+    }
+    char* record = buffer.get() + buffered * kUpdateBytes;
+    std::memcpy(record, &dst, sizeof(NodeId));
+    std::memcpy(record + sizeof(NodeId), &*update, sizeof(Update));
+    if (++buffered == capacity) {
+      const auto starts =
+          detail::GroupRecords<kUpdateBytes>(buffer.get(), buffered, parts, partition);
+      const auto offset = spilled.Size();
+      spilled.Append(options_.temp_dir, buffer.get(), buffered * kUpdateBytes);
+      stats_.bytes_spilled += buffered * kUpdateBytes;
+      for (std::size_t p = 0; p < parts; ++p) {
+        if (starts[p + 1] > starts[p]) {
+          runs[p].push_back({offset + starts[p] * kUpdateBytes,
+                             (starts[p + 1] - starts[p]) * std::uint64_t{kUpdateBytes}});
+        }
+      }
+      buffered = 0;
+    }
+  });
+
+  // gather
+  std::uint64_t updates = 0;
+  auto apply = [&](const char* block, std::size_t size) {
+    for (const char* p = block; p < block + size; p += kUpdateBytes) {
+      NodeId dst;
+      std::memcpy(&dst, p, sizeof(NodeId));
+      const detail::Unaligned<Update> update{p + sizeof(NodeId)};
+      gather(dst, *update);
+    }
+    updates += size / kUpdateBytes;
+  };
+  const auto starts = detail::GroupRecords<kUpdateBytes>(buffer.get(), buffered, parts, partition);
+  for (std::size_t p = 0; p < parts; ++p) {
+    ForEachBlock(spilled.Fd(), std::move(runs[p]), kUpdateBytes, apply);
+    apply(buffer.get() + starts[p] * kUpdateBytes, (starts[p + 1] - starts[p]) * kUpdateBytes);
+  }
+  stats_.updates += updates;
+  return updates;
+}
+
+template <typename N, typename E>
+Graph<N, E> StreamingGraph<N, E>::ToGraph() {
+  Graph<N, E> g{nodes_.cbegin(), nodes_.cend()};
+  ForEachEdge([&](NodeId src, NodeId dst, const E& weight) {
+    g.InsertEdge(nodes_[src], nodes_[dst], weight);
+  });
+  return g;
+}
+
+}  // namespace gdwg
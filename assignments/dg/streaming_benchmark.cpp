@@ -0,0 +1,214 @@
+// Breadth first search and PageRank streamed by StreamingGraph over an R-MAT edge file several
+// times larger than the memory budget it is given (--memory_mib), against the same over a
+// Snapshot in memory. Of the budget, two edge blocks take a quarter and the updates buffered
+// before spilling to disk half. The file is dropped from the page cache before each run where
+// the system allows, so that edges really come off the disk. Reports the seconds taken, the
+// passes made, the bytes read and spilled and the rate they were read at, and whether the
+// results agree with the in-memory ones. Prints JSON to stdout.
+//
+//   streaming_benchmark [--scale=20] [--degree=16] [--memory_mib=32] [--iterations=5]
+//                       [--path=<temp dir>/streaming_benchmark.edges]
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/streaming.h"
+
+namespace {
+
+namespace bm = gdwg::benchmark;
+using N = std::uint32_t;
+using E = float;
+constexpr auto kUnreached = std::numeric_limits<std::uint32_t>::max();
+constexpr double kDamping = 0.85;
+
+std::string StringArg(int argc, char** argv, const std::string& name, std::string fallback) {
+  const auto prefix = "--" + name + "=";
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.compare(0, prefix.size(), prefix) == 0) {
+      return arg.substr(prefix.size());
+    }
+  }
+  return fallback;
+}
+
+// writes back anything of the file still dirty, then asks the kernel to forget its pages
+void DropFromPageCache(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+  }
+}
+
+std::vector<std::uint32_t> SnapshotBfs(const gdwg::Snapshot<N, E>& s, std::uint32_t src) {
+  std::vector<std::uint32_t> level(s.NumNodes(), kUnreached);
+  std::vector<std::uint32_t> queue{src};
+  level[src] = 0;
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    const auto v = queue[i];
+    for (auto e = s.EdgeBegin(v); e < s.EdgeEnd(v); ++e) {
+      if (level[s.Dst(e)] == kUnreached) {
+        level[s.Dst(e)] = level[v] + 1;
+        queue.push_back(s.Dst(e));
+      }
+    }
+  }
+  return level;
+}
+
+std::vector<std::uint32_t> StreamingBfs(gdwg::StreamingGraph<N, E>& g,
+                                        std::uint32_t src,
+                                        std::size_t& passes) {
+  std::vector<std::uint32_t> level(g.NumNodes(), kUnreached);
+  level[src] = 0;
+  passes = 0;
+  for (std::uint64_t reached = 1; reached > 0; ++passes) {
+    reached = 0;
+    const auto depth = static_cast<std::uint32_t>(passes);
+    g.ScatterGather(
+        [&](std::uint32_t from, std::uint32_t, const E&) -> std::optional<std::uint8_t> {
+          if (level[from] == depth) {
+            return 1;
+          }
+          return std::nullopt;
+        },
+        [&](std::uint32_t to, std::uint8_t) {
+          if (level[to] == kUnreached) {
+            level[to] = depth + 1;
+            ++reached;
+          }
+        });
+  }
+  return level;
+}
+
+std::vector<double> SnapshotPageRank(const gdwg::Snapshot<N, E>& s, std::size_t iterations) {
+  const std::size_t n = s.NumNodes();
+  std::vector<double> rank(n, 1.0 / static_cast<double>(n));
+  std::vector<double> next(n);
+  for (std::size_t i = 0; i < iterations; ++i) {
+    std::fill(next.begin(), next.end(), 0);
+    for (std::uint32_t v = 0; v < n; ++v) {
+      for (auto e = s.EdgeBegin(v); e < s.EdgeEnd(v); ++e) {
+        next[s.Dst(e)] += rank[v] / static_cast<double>(s.Degree(v));
+      }
+    }
+    for (auto& r : next) {
+      r = (1 - kDamping) / static_cast<double>(n) + kDamping * r;
+    }
+    rank.swap(next);
+  }
+  return rank;
+}
+
+std::vector<double> StreamingPageRank(gdwg::StreamingGraph<N, E>& g, std::size_t iterations) {
+  const std::size_t n = g.NumNodes();
+  // one pass for the out-degrees, as the file holds no index
+  std::vector<std::uint32_t> degree(n);
+  g.ForEachEdge([&](std::uint32_t src, std::uint32_t, const E&) { ++degree[src]; });
+  std::vector<double> rank(n, 1.0 / static_cast<double>(n));
+  std::vector<double> next(n);
+  for (std::size_t i = 0; i < iterations; ++i) {
+    std::fill(next.begin(), next.end(), 0);
+    g.ScatterGather(
+        [&](std::uint32_t src, std::uint32_t, const E&) -> std::optional<double> {
+          return rank[src] / static_cast<double>(degree[src]);
+        },
+        [&](std::uint32_t dst, double share) { next[dst] += share; });
+    for (auto& r : next) {
+      r = (1 - kDamping) / static_cast<double>(n) + kDamping * r;
+    }
+    rank.swap(next);
+  }
+  return rank;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto scale = static_cast<unsigned>(bm::Arg(argc, argv, "scale", 20));
+  const auto degree = bm::Arg(argc, argv, "degree", 16);
+  const auto memory = bm::Arg(argc, argv, "memory_mib", 32) << 20;
+  const auto iterations = bm::Arg(argc, argv, "iterations", 5);
+  const auto path =
+      StringArg(argc, argv, "path",
+                std::filesystem::temp_directory_path() / "streaming_benchmark.edges");
+
+  // the references are computed, and the snapshot freed, before anything is streamed
+  std::vector<std::uint32_t> expected_levels;
+  std::vector<double> expected_ranks;
+  double bfs_seconds;
+  double pagerank_seconds;
+  {
+    const auto snapshot =
+        gdwg::Rmat<N, E>(scale, (std::size_t{1} << scale) * degree, gdwg::ConstantWeights<E>(1))
+            .BuildSnapshot();
+    gdwg::SaveEdgeFile(snapshot, path);
+    bm::Timer timer;
+    expected_levels = SnapshotBfs(snapshot, 0);
+    bfs_seconds = timer.Seconds();
+    timer.Reset();
+    expected_ranks = SnapshotPageRank(snapshot, iterations);
+    pagerank_seconds = timer.Seconds();
+  }
+
+  gdwg::StreamOptions options;
+  options.block_bytes = memory / 8;
+  options.update_bytes = memory / 2;
+  bm::Fields params;
+  params.emplace_back("file_mib", std::filesystem::file_size(path) / double{1 << 20});
+  params.emplace_back("memory_mib", memory / double{1 << 20});
+
+  bm::Reporter reporter;
+  auto report = [&](const std::string& name, const gdwg::StreamStats& before,
+                    const gdwg::StreamStats& after, double seconds, double in_memory,
+                    std::size_t passes, bool agrees) {
+    const double read = static_cast<double>(after.bytes_read - before.bytes_read);
+    reporter.Add(name, params,
+                 {{"seconds", seconds},
+                  {"in_memory_seconds", in_memory},
+                  {"passes", static_cast<double>(passes)},
+                  {"read_mib", read / (1 << 20)},
+                  {"spilled_mib",
+                   static_cast<double>(after.bytes_spilled - before.bytes_spilled) / (1 << 20)},
+                  {"read_mib_per_second", read / (1 << 20) / seconds},
+                  {"agrees", agrees ? 1 : 0}});
+  };
+
+  gdwg::StreamingGraph<N, E> g{path, options};
+  DropFromPageCache(path);
+  auto before = g.Stats();
+  bm::Timer timer;
+  std::size_t passes = 0;
+  const auto levels = StreamingBfs(g, 0, passes);
+  report("bfs", before, g.Stats(), timer.Seconds(), bfs_seconds, passes,
+         levels == expected_levels);
+
+  DropFromPageCache(path);
+  before = g.Stats();
+  timer.Reset();
+  const auto ranks = StreamingPageRank(g, iterations);
+  double max_difference = 0;
+  for (std::size_t v = 0; v < ranks.size(); ++v) {
+    max_difference = std::max(max_difference, std::abs(ranks[v] - expected_ranks[v]));
+  }
+  report("pagerank", before, g.Stats(), timer.Seconds(), pagerank_seconds, iterations + 1,
+         max_difference < 1e-12);
+
+  reporter.Print(std::cout);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,259 @@
+/*
+  Tests for SaveEdgeFile and StreamingGraph. Graphs must round trip through an edge file, and
+  bad files be rejected, as must one truncated while open. Breadth first search and PageRank
+  done by scatter and gather passes must give what they do in memory, whether every update
+  fits in memory or blocks are a few edges and updates spill to disk every few edges, spilled
+  updates must be cleaned up, and updates needn't be default constructible. Updates must spill
+  to one file, not one per partition, so that a partition for every node needs no more files.
+*/
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/streaming.h"
+#include "assignments/dg/test_util.h"
+#include "catch.h"
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+  return std::filesystem::temp_directory_path() / name;
+}
+
+// lowers the number of files the process may have open, for as long as it lives
+class OpenFileLimit {
+ public:
+  explicit OpenFileLimit(rlim_t files) {
+    ::getrlimit(RLIMIT_NOFILE, &old_);
+    rlimit limit = old_;
+    limit.rlim_cur = files;
+    ::setrlimit(RLIMIT_NOFILE, &limit);
+  }
+  OpenFileLimit(const OpenFileLimit&) = delete;
+  OpenFileLimit& operator=(const OpenFileLimit&) = delete;
+  ~OpenFileLimit() { ::setrlimit(RLIMIT_NOFILE, &old_); }
+
+ private:
+  rlimit old_;
+};
+
+constexpr auto kUnreached = std::numeric_limits<std::uint32_t>::max();
+
+// levels by scatter and gather: each pass sends from the nodes reached in the pass before
+std::vector<std::uint32_t> StreamingBfs(gdwg::StreamingGraph<int, float>& g, std::uint32_t src) {
+  std::vector<std::uint32_t> level(g.NumNodes(), kUnreached);
+  level[src] = 0;
+  std::uint32_t reached = 1;
+  for (std::uint32_t depth = 0; reached > 0; ++depth) {
+    reached = 0;
+    g.ScatterGather(
+        [&](std::uint32_t from, std::uint32_t, float) -> std::optional<std::uint8_t> {
+          if (level[from] == depth) {
+            return 1;
+          }
+          return std::nullopt;
+        },
+        [&](std::uint32_t to, std::uint8_t) {
+          if (level[to] == kUnreached) {
+            level[to] = depth + 1;
+            ++reached;
+          }
+        });
+  }
+  return level;
+}
+
+std::vector<std::uint32_t> Bfs(const gdwg::Snapshot<int, float>& s, std::uint32_t src) {
+  std::vector<std::uint32_t> level(s.NumNodes(), kUnreached);
+  std::vector<std::uint32_t> queue{src};
+  level[src] = 0;
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    const auto v = queue[i];
+    for (auto e = s.EdgeBegin(v); e < s.EdgeEnd(v); ++e) {
+      if (level[s.Dst(e)] == kUnreached) {
+        level[s.Dst(e)] = level[v] + 1;
+        queue.push_back(s.Dst(e));
+      }
+    }
+  }
+  return level;
+}
+
+}  // namespace
+
+SCENARIO("Graphs round trip through an edge file") {
+  GIVEN("a graph of strings with parallel edges, self loops and a node with no edges") {
+    gdwg::Graph<std::string, double> g{"hello", "how", "are", "you?", "lonely"};
+    g.InsertEdge("hello", "how", 5.5);
+    g.InsertEdge("hello", "are", 8);
+    g.InsertEdge("hello", "are", 2);
+    g.InsertEdge("how", "you?", 1);
+    g.InsertEdge("are", "are", -3.25);
+    const auto path = TempPath("streaming_test_strings.edges");
+    gdwg::SaveEdgeFile(g, path);
+    WHEN("it is opened for streaming") {
+      gdwg::StreamingGraph<std::string, double> streamed{path};
+      THEN("its nodes are in memory, and its edges stream back in order of source") {
+        REQUIRE(streamed.NumNodes() == 5);
+        REQUIRE(streamed.NumEdges() == 5);
+        REQUIRE(streamed.Nodes() == g.GetNodes());
+        REQUIRE(streamed.Value(streamed.Id("how")) == "how");
+        REQUIRE_FALSE(streamed.IsNode("bye"));
+        REQUIRE_THROWS_WITH(streamed.Id("bye"),
+                            "Cannot call StreamingGraph::Id on a node that doesn't exist");
+        std::vector<std::string> sources;
+        streamed.ForEachEdge([&](std::uint32_t src, std::uint32_t, double) {
+          sources.push_back(streamed.Value(src));
+        });
+        REQUIRE(sources == std::vector<std::string>{"are", "hello", "hello", "hello", "how"});
+        REQUIRE(streamed.Stats().edges == 5);
+      }
+      THEN("reading it back gives the graph saved") {
+        REQUIRE(streamed.ToGraph() == g);
+      }
+    }
+    std::filesystem::remove(path);
+  }
+  GIVEN("files that aren't edge files, or of the wrong weight type") {
+    const auto path = TempPath("streaming_test_bad.edges");
+    gdwg::SaveEdgeFile(gdwg::Graph<int, float>{1, 2}, path);
+    REQUIRE_THROWS_AS((gdwg::StreamingGraph<int, double>{path}), std::runtime_error);
+    {
+      std::ofstream os{path, std::ios::binary | std::ios::trunc};
+      os << "not a graph at all, but long enough to hold a header in the first place";
+    }
+    REQUIRE_THROWS_AS((gdwg::StreamingGraph<int, float>{path}), std::runtime_error);
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS((gdwg::StreamingGraph<int, float>{path}), std::runtime_error);
+  }
+  GIVEN("an edge file that is truncated after it is opened") {
+    const auto path = TempPath("streaming_test_truncated.edges");
+    gdwg::SaveEdgeFile(gdwg::testing::RandomSnapshot<float>(100, 1000, 3, 0.0f, 6.0f, 3), path);
+    gdwg::StreamingGraph<int, float> streamed{path};
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 120);
+    THEN("streaming its edges says so") {
+      REQUIRE_THROWS_WITH(streamed.ForEachEdge([](std::uint32_t, std::uint32_t, float) {}),
+                          Catch::Contains("truncated"));
+    }
+    std::filesystem::remove(path);
+  }
+}
+
+SCENARIO("Scatter and gather passes give what in-memory algorithms do") {
+  const auto snapshot = gdwg::testing::RandomSnapshot<float>(2000, 6000, 9, 0.0f, 6.0f, 3);
+  const auto path = TempPath("streaming_test_random.edges");
+  gdwg::SaveEdgeFile(snapshot, path);
+  gdwg::StreamOptions roomy;
+  const auto spill_dir = TempPath("streaming_test_spills");
+  std::filesystem::create_directories(spill_dir);
+  gdwg::StreamOptions tight;
+  tight.block_bytes = 100;
+  tight.update_bytes = 256;
+  tight.partition_nodes = 300;
+  tight.temp_dir = spill_dir;
+  for (const auto& options : {roomy, tight}) {
+    const bool spills = options.update_bytes == tight.update_bytes;
+    GIVEN(std::string{spills ? "tiny blocks, updates spilling to disk" : "room to spare"}) {
+      gdwg::StreamingGraph<int, float> streamed{path, options};
+      WHEN("it is searched breadth first") {
+        const auto level = StreamingBfs(streamed, 0);
+        THEN("every node is at the level an in-memory search puts it") {
+          REQUIRE(level == Bfs(snapshot, 0));
+          REQUIRE(streamed.Stats().bytes_read >= streamed.Stats().edges * 12);
+          REQUIRE((streamed.Stats().bytes_spilled > 0) == spills);
+        }
+        THEN("no update files are left behind") {
+          REQUIRE(std::filesystem::is_empty(spill_dir));
+        }
+      }
+      WHEN("it runs 10 iterations of PageRank") {
+        const std::size_t n = snapshot.NumNodes();
+        std::vector<std::uint32_t> degree(n);
+        streamed.ForEachEdge([&](std::uint32_t src, std::uint32_t, float) { ++degree[src]; });
+        std::vector<double> rank(n, 1.0 / static_cast<double>(n));
+        std::vector<double> next(n);
+        for (int i = 0; i < 10; ++i) {
+          std::fill(next.begin(), next.end(), 0);
+          const auto updates = streamed.ScatterGather(
+              [&](std::uint32_t src, std::uint32_t, float) -> std::optional<double> {
+                return rank[src] / degree[src];
+              },
+              [&](std::uint32_t dst, double share) { next[dst] += share; });
+          REQUIRE(updates == snapshot.NumEdges());
+          for (auto& r : next) {
+            r = 0.15 / static_cast<double>(n) + 0.85 * r;
+          }
+          rank.swap(next);
+        }
+        THEN("the ranks are those of the same iterations over the snapshot") {
+          std::vector<double> expected(n, 1.0 / static_cast<double>(n));
+          for (int i = 0; i < 10; ++i) {
+            std::fill(next.begin(), next.end(), 0);
+            for (std::uint32_t v = 0; v < n; ++v) {
+              for (auto e = snapshot.EdgeBegin(v); e < snapshot.EdgeEnd(v); ++e) {
+                next[snapshot.Dst(e)] += expected[v] / snapshot.Degree(v);
+              }
+            }
+            for (auto& r : next) {
+              r = 0.15 / static_cast<double>(n) + 0.85 * r;
+            }
+            expected.swap(next);
+          }
+          for (std::uint32_t v = 0; v < n; ++v) {
+            REQUIRE(rank[v] == Approx(expected[v]).epsilon(1e-12));
+          }
+          REQUIRE(streamed.Stats().updates == 10 * snapshot.NumEdges());
+        }
+      }
+      WHEN("in degrees are counted with updates that have no default constructor") {
+        struct Count {
+          explicit Count(std::uint32_t value) : n(value) {}
+          std::uint32_t n;
+        };
+        std::vector<std::uint32_t> in_degree(snapshot.NumNodes());
+        streamed.ScatterGather(
+            [](std::uint32_t, std::uint32_t, float) { return std::optional<Count>{Count{1}}; },
+            [&](std::uint32_t dst, const Count& count) { in_degree[dst] += count.n; });
+        THEN("they are those of the snapshot") {
+          std::vector<std::uint32_t> expected(snapshot.NumNodes());
+          for (std::uint32_t e = 0; e < snapshot.NumEdges(); ++e) {
+            ++expected[snapshot.Dst(e)];
+          }
+          REQUIRE(in_degree == expected);
+        }
+      }
+    }
+  }
+  std::filesystem::remove(path);
+  std::filesystem::remove_all(spill_dir);
+}
+
+SCENARIO("Updates spill to one file however many partitions there are") {
+  GIVEN("a graph with a partition for every node, in a process that may open 32 files") {
+    const auto snapshot = gdwg::testing::RandomSnapshot<float>(2000, 6000, 4, 0.0f, 6.0f, 3);
+    const auto path = TempPath("streaming_test_partitions.edges");
+    gdwg::SaveEdgeFile(snapshot, path);
+    gdwg::StreamOptions options;
+    options.update_bytes = 1000;
+    options.partition_nodes = 1;
+    const OpenFileLimit limit{32};
+    gdwg::StreamingGraph<int, float> streamed{path, options};
+    WHEN("it is searched breadth first, spilling many times") {
+      const auto level = StreamingBfs(streamed, 0);
+      THEN("every node is at the level an in-memory search puts it") {
+        REQUIRE(level == Bfs(snapshot, 0));
+        REQUIRE(streamed.Stats().bytes_spilled > 10 * options.update_bytes);
+      }
+    }
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef ASSIGNMENTS_DG_TEST_UTIL_H_
+#define ASSIGNMENTS_DG_TEST_UTIL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <queue>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/snapshot.h"
+
+// Fixtures and reference algorithms shared by the tests, which check the library against these
+// rather than against each other.
+
+namespace gdwg {
+namespace testing {
+
+// nodes nodes, 0, spacing, 2 spacing and so on, with edges random edges between them, self
+// loops and parallel edges included, weighted uniformly in [lo, hi]. A spacing above 1 keeps
+// the nodes' values apart from the ids a Snapshot gives them.
+template <typename E = int>
+Graph<int, E> RandomGraph(int nodes, int edges, unsigned seed, E lo, E hi, int spacing = 1) {
+  std::mt19937 rng{seed};
+  std::uniform_int_distribution<int> node(0, nodes - 1);
+  std::conditional_t<std::is_integral<E>::value, std::uniform_int_distribution<E>,
+                     std::uniform_real_distribution<E>>
+      weight(lo, hi);
+  Graph<int, E> g;
+  for (int i = 0; i < nodes; ++i) {
+    g.InsertNode(i * spacing);
+  }
+  for (int i = 0; i < edges; ++i) {
+    const int src = node(rng) * spacing;
+    const int dst = node(rng) * spacing;
+    g.InsertEdge(src, dst, weight(rng));
+  }
+  return g;
+}
+
+template <typename E = int>
+Snapshot<int, E> RandomSnapshot(int nodes, int edges, unsigned seed, E lo, E hi, int spacing = 1) {
+  return Snapshot<int, E>{RandomGraph<E>(nodes, edges, seed, lo, hi, spacing)};
+}
+
+// distances from src to every node it reaches, src included
+template <typename E>
+std::map<int, E> Dijkstra(const Graph<int, E>& g, int src) {
+  std::map<int, E> dist;
+  using Item = std::pair<E, int>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  queue.emplace(E{}, src);
+  while (!queue.empty()) {
+    const auto [d, u] = queue.top();
+    queue.pop();
+    if (!dist.emplace(u, d).second) {
+      continue;
+    }
+    for (int v : g.GetConnected(u)) {
+      const auto weights = g.GetWeights(u, v);
+      queue.emplace(d + *std::min_element(weights.begin(), weights.end()), v);
+    }
+  }
+  return dist;
+}
+
+// sum of the lightest edge between each pair of consecutive nodes, or nullopt if one is missing
+template <typename E>
+std::optional<E> Walk(const Graph<int, E>& g, const std::vector<int>& nodes) {
+  E total{};
+  for (std::size_t i = 1; i < nodes.size(); ++i) {
+    if (!g.IsConnected(nodes[i - 1], nodes[i])) {
+      return std::nullopt;
+    }
+    const auto weights = g.GetWeights(nodes[i - 1], nodes[i]);
+    total += *std::min_element(weights.begin(), weights.end());
+  }
+  return total;
+}
+
+}  // namespace testing
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_TEST_UTIL_H_
@@ -0,0 +1,167 @@
+#ifndef ASSIGNMENTS_DG_TRIANGLES_H_
+#define ASSIGNMENTS_DG_TRIANGLES_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/intersect.h"
+#include "assignments/dg/parallel.h"
+#include "assignments/dg/snapshot.h"
+#include "assignments/dg/undirected.h"
+
+namespace gdwg {
+
+// Triangles of the undirected graph underneath a graph (see UndirectedGraph): three nodes that
+// are each other's neighbours, whichever way their edges point.
+//
+// Each edge is oriented from the end of lower degree to the end of higher degree (ties broken
+// by NodeId), which leaves no node more than sqrt(2 * edges) out-neighbours however skewed the
+// graph. Nodes are renumbered in that order, so every out-neighbour list is sorted, and each
+// triangle is found exactly once: as an out-neighbour common to both ends of its first edge, by
+// ForEachCommonAdaptive (intersect.h). Work is split over the nodes on up to `threads` workers.
+std::uint64_t CountTriangles(const UndirectedGraph& g, std::size_t threads = DefaultThreads());
+
+template <typename N, typename E>
+std::uint64_t CountTriangles(const Graph<N, E>& g, std::size_t threads = DefaultThreads()) {
+  return CountTriangles(UndirectedGraph{Snapshot<N, E>{g}, threads}, threads);
+}
+
+struct LocalTriangles {
+  // triangles through each node, by its position in node order (the snapshot's NodeId)
+  std::vector<std::uint64_t> triangles;
+  // local clustering coefficient: the triangles through a node over the pairs of its
+  // neighbours, or 0 for a node with fewer than two
+  std::vector<double> clustering;
+};
+
+// CountTriangles, node by node
+LocalTriangles CountLocalTriangles(const UndirectedGraph& g,
+                                   std::size_t threads = DefaultThreads());
+
+template <typename N, typename E>
+LocalTriangles CountLocalTriangles(const Graph<N, E>& g, std::size_t threads = DefaultThreads()) {
+  return CountLocalTriangles(UndirectedGraph{Snapshot<N, E>{g}, threads}, threads);
+}
+
+namespace detail {
+
+// g's edges from lower to higher degree, with nodes renumbered in order of degree
+struct OrientedGraph {
+  using NodeId = UndirectedGraph::NodeId;
+
+  OrientedGraph(const UndirectedGraph& g, std::size_t threads) : node(g.NumNodes()) {
+    const std::size_t n = g.NumNodes();
+    std::iota(node.begin(), node.end(), NodeId{0});
+    std::sort(node.begin(), node.end(), [&g](NodeId a, NodeId b) {
+      return g.Degree(a) != g.Degree(b) ? g.Degree(a) < g.Degree(b) : a < b;
+    });
+    std::vector<NodeId> rank(n);
+    for (std::size_t r = 0; r < n; ++r) {
+      rank[node[r]] = static_cast<NodeId>(r);
+    }
+    offsets.assign(n + 1, 0);
+    ParallelFor(n,
+                [&](std::size_t r) {
+                  offsets[r + 1] = static_cast<std::uint64_t>(
+                      std::count_if(g.NeighboursBegin(node[r]), g.NeighboursEnd(node[r]),
+                                    [&](NodeId w) { return rank[w] > r; }));
+                },
+                threads);
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    targets.resize(offsets[n]);
+    ParallelFor(n,
+                [&](std::size_t r) {
+                  auto out = targets.begin() + static_cast<std::ptrdiff_t>(offsets[r]);
+                  const auto begin = out;
+                  std::for_each(g.NeighboursBegin(node[r]), g.NeighboursEnd(node[r]),
+                                [&](NodeId w) {
+                                  if (rank[w] > r) {
+                                    *out++ = rank[w];
+                                  }
+                                });
+                  std::sort(begin, out);
+                },
+                threads);
+  }
+
+  std::size_t NumNodes() const noexcept { return node.size(); }
+  const NodeId* Begin(NodeId r) const noexcept { return targets.data() + offsets[r]; }
+  std::size_t Size(NodeId r) const noexcept {
+    return static_cast<std::size_t>(offsets[r + 1] - offsets[r]);
+  }
+
+  // the node of each rank
+  std::vector<NodeId> node;
+  std::vector<std::uint64_t> offsets;
+  // out-neighbours of each rank, as ranks
+  std::vector<NodeId> targets;
+};
+
+// calls fn(u, v, w) for every triangle u -> v -> w (as ranks), over contiguous blocks of ranks
+// on up to `threads` workers, and returns how many there are
+template <typename Fn>
+std::uint64_t ForEachOrientedTriangle(const OrientedGraph& g, std::size_t threads, Fn fn) {
+  const std::size_t n = g.NumNodes();
+  // more blocks than workers evens out the busier ranks
+  const std::size_t blocks = std::max<std::size_t>(1, std::min(n, threads * 16));
+  std::vector<std::uint64_t> totals(blocks);
+  ParallelFor(blocks,
+              [&](std::size_t b) {
+                std::uint64_t total = 0;
+                for (auto u = static_cast<OrientedGraph::NodeId>(n * b / blocks);
+                     u != n * (b + 1) / blocks; ++u) {
+                  const auto* out = g.Begin(u);
+                  for (std::size_t i = 0; i < g.Size(u); ++i) {
+                    const auto v = out[i];
+                    ForEachCommonAdaptive(out, g.Size(u), g.Begin(v), g.Size(v),
+                                          [&](std::size_t k, std::size_t) {
+                                            ++total;
+                                            fn(u, v, out[k]);
+                                          });
+                  }
+                }
+                totals[b] = total;
+              },
+              threads);
+  return std::accumulate(totals.begin(), totals.end(), std::uint64_t{0});
+}
+
+}  // namespace detail
+
+inline std::uint64_t CountTriangles(const UndirectedGraph& g, std::size_t threads) {
+  threads = std::max<std::size_t>(threads, 1);
+  const detail::OrientedGraph oriented{g, threads};
+  return detail::ForEachOrientedTriangle(oriented, threads, [](auto, auto, auto) {});
+}
+
+inline LocalTriangles CountLocalTriangles(const UndirectedGraph& g, std::size_t threads) {
+  threads = std::max<std::size_t>(threads, 1);
+  const detail::OrientedGraph oriented{g, threads};
+  const std::size_t n = g.NumNodes();
+  std::vector<std::atomic<std::uint64_t>> counts(n);
+  // every triangle is credited to all three of its nodes
+  detail::ForEachOrientedTriangle(oriented, threads, [&](auto u, auto v, auto w) {
+    counts[oriented.node[u]].fetch_add(1, std::memory_order_relaxed);
+    counts[oriented.node[v]].fetch_add(1, std::memory_order_relaxed);
+    counts[oriented.node[w]].fetch_add(1, std::memory_order_relaxed);
+  });
+  LocalTriangles result{std::vector<std::uint64_t>(n), std::vector<double>(n, 0.0)};
+  for (std::size_t v = 0; v < n; ++v) {
+    result.triangles[v] = counts[v].load(std::memory_order_relaxed);
+    const auto degree = static_cast<double>(g.Degree(static_cast<UndirectedGraph::NodeId>(v)));
+    if (degree >= 2) {
+      result.clustering[v] = 2.0 * static_cast<double>(result.triangles[v]) /
+                             (degree * (degree - 1));
+    }
+  }
+  return result;
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_TRIANGLES_H_
@@ -0,0 +1,83 @@
+// Triangle counting and core numbers on an R-MAT graph. For each way of intersecting sorted
+// lists in intersect.h, reports the time to intersect the out-neighbours of both ends of every
+// edge of the degree-oriented graph (the inner loop of CountTriangles) as edges and list
+// entries per second. Then reports CountTriangles, CountLocalTriangles, CoreNumbers and
+// ParallelCoreNumbers end to end. Prints JSON to stdout.
+//
+//   triangles_benchmark [--scale=18] [--degree=16] [--threads=<cores>]
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/generators.h"
+#include "assignments/dg/k_core.h"
+#include "assignments/dg/triangles.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  using N = std::uint32_t;
+  using E = float;
+  const auto scale = static_cast<unsigned>(bm::Arg(argc, argv, "scale", 18));
+  const auto degree = bm::Arg(argc, argv, "degree", 16);
+  const auto threads = bm::Arg(argc, argv, "threads", gdwg::DefaultThreads());
+
+  const auto snapshot =
+      gdwg::Rmat<N, E>(scale, (std::size_t{1} << scale) * degree, gdwg::ConstantWeights<E>(1))
+          .BuildSnapshot();
+  bm::Reporter reporter;
+  bm::Timer timer;
+  const gdwg::UndirectedGraph g{snapshot, threads};
+  bm::Fields params;
+  params.emplace_back("nodes", g.NumNodes());
+  params.emplace_back("edges", g.NumEdges());
+  reporter.Add("undirected", params, {{"seconds", timer.Seconds()}});
+  timer.Reset();
+  const gdwg::detail::OrientedGraph oriented{g, threads};
+  reporter.Add("orient", params, {{"seconds", timer.Seconds()}});
+
+  // every oriented edge's intersection, one thread, with the given intersect
+  auto run = [&](const std::string& name, auto intersect) {
+    std::uint64_t found = 0;
+    std::uint64_t scanned = 0;
+    const double seconds = bm::Measure([&] {
+      found = 0;
+      scanned = 0;
+      for (std::uint32_t u = 0; u < oriented.NumNodes(); ++u) {
+        for (std::size_t i = 0; i < oriented.Size(u); ++i) {
+          const auto v = oriented.Begin(u)[i];
+          intersect(oriented.Begin(u), oriented.Size(u), oriented.Begin(v), oriented.Size(v),
+                    [&](std::size_t, std::size_t) { ++found; });
+          scanned += oriented.Size(u) + oriented.Size(v);
+        }
+      }
+      bm::DoNotOptimize(found);
+    });
+    reporter.Add("intersect_" + name, params,
+                 {{"seconds", seconds},
+                  {"edges_per_second", static_cast<double>(g.NumEdges()) / seconds},
+                  {"entries_per_second", static_cast<double>(scanned) / seconds},
+                  {"triangles", static_cast<double>(found)}});
+  };
+  run("merge", [](auto... args) { gdwg::detail::ForEachCommonMerge(args...); });
+  run("simd", [](auto... args) { gdwg::detail::ForEachCommon(args...); });
+  run("galloping", [](auto... args) { gdwg::detail::ForEachCommonGalloping(args...); });
+  run("adaptive", [](auto... args) { gdwg::detail::ForEachCommonAdaptive(args...); });
+
+  params.emplace_back("threads", threads);
+  std::uint64_t triangles = 0;
+  double seconds = bm::Measure([&] { triangles = gdwg::CountTriangles(g, threads); });
+  reporter.Add("count_triangles", params,
+               {{"seconds", seconds}, {"triangles", static_cast<double>(triangles)}});
+  seconds = bm::Measure([&] { bm::DoNotOptimize(gdwg::CountLocalTriangles(g, threads)); });
+  reporter.Add("count_local_triangles", params, {{"seconds", seconds}});
+
+  std::vector<std::uint32_t> cores;
+  seconds = bm::Measure([&] { cores = gdwg::CoreNumbers(g); });
+  const double max_core = *std::max_element(cores.begin(), cores.end());
+  reporter.Add("core_numbers", params, {{"seconds", seconds}, {"max_core", max_core}});
+  seconds = bm::Measure([&] { cores = gdwg::ParallelCoreNumbers(g, threads); });
+  reporter.Add("parallel_core_numbers", params, {{"seconds", seconds}, {"max_core", max_core}});
+  reporter.Print(std::cout);
+}
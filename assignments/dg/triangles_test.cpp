@@ -0,0 +1,147 @@
+/*
+  Tests for UndirectedGraph, the intersections in intersect.h and triangle counting. Every
+  intersection is checked against std::set_intersection on sorted arrays of very different
+  lengths, and triangle counts against a check of every triple of nodes.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/test_util.h"
+#include "assignments/dg/triangles.h"
+#include "catch.h"
+
+namespace {
+
+std::vector<std::uint32_t> SortedIds(std::size_t size, std::uint32_t range, std::mt19937& rng) {
+  std::uniform_int_distribution<std::uint32_t> id(0, range);
+  std::set<std::uint32_t> ids;
+  while (ids.size() < size) {
+    ids.insert(id(rng));
+  }
+  return {ids.begin(), ids.end()};
+}
+
+}  // namespace
+
+SCENARIO("Every intersection finds the same common ids") {
+  GIVEN("pairs of sorted arrays, some of them far longer than the other") {
+    std::mt19937 rng{11};
+    const std::vector<std::pair<std::size_t, std::size_t>> sizes{
+        {0, 0}, {0, 9}, {3, 5}, {17, 18}, {64, 70}, {5, 400}, {300, 9}, {1, 1000}};
+    THEN("merge, blocks, galloping and adaptive agree with std::set_intersection") {
+      for (const auto& [na, nb] : sizes) {
+        const auto a = SortedIds(na, 2000, rng);
+        const auto b = SortedIds(nb, 2000, rng);
+        std::vector<std::uint32_t> expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                              std::back_inserter(expected));
+        auto collect = [&](auto intersect) {
+          std::vector<std::uint32_t> common;
+          intersect(a.data(), a.size(), b.data(), b.size(), [&](std::size_t i, std::size_t j) {
+            common.push_back(a[i] == b[j] ? a[i] : ~std::uint32_t{0});
+          });
+          return common;
+        };
+        REQUIRE(collect([](auto... args) { gdwg::detail::ForEachCommonMerge(args...); }) ==
+                expected);
+        REQUIRE(collect([](auto... args) { gdwg::detail::ForEachCommon(args...); }) == expected);
+        REQUIRE(collect([](auto... args) { gdwg::detail::ForEachCommonGalloping(args...); }) ==
+                expected);
+        REQUIRE(collect([](auto... args) { gdwg::detail::ForEachCommonAdaptive(args...); }) ==
+                expected);
+      }
+    }
+  }
+}
+
+SCENARIO("The undirected graph underneath a snapshot") {
+  GIVEN("edges both ways, repeated with other weights, and a self loop") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "a", 2);
+    g.InsertEdge("a", "b", 3);
+    g.InsertEdge("c", "a", 1);
+    g.InsertEdge("c", "c", 1);
+    const gdwg::UndirectedGraph undirected{gdwg::Snapshot<std::string, int>{g}, 2};
+    THEN("each pair of neighbours is one edge, listed at both ends in order") {
+      REQUIRE(undirected.NumNodes() == 4);
+      REQUIRE(undirected.NumEdges() == 2);
+      REQUIRE(std::vector<std::uint32_t>(undirected.NeighboursBegin(0),
+                                         undirected.NeighboursEnd(0)) ==
+              std::vector<std::uint32_t>{1, 2});
+      REQUIRE(undirected.Degree(1) == 1);
+      REQUIRE(undirected.Degree(2) == 1);
+      REQUIRE(undirected.Degree(3) == 0);
+    }
+  }
+}
+
+SCENARIO("Triangle counts match a check of every triple") {
+  for (int edges : {0, 100, 400, 1200}) {
+    GIVEN("a random graph with 60 nodes and " + std::to_string(edges) + " edges") {
+      const auto snapshot =
+          gdwg::testing::RandomSnapshot(60, edges, static_cast<unsigned>(edges) + 3, 0, 2);
+      const gdwg::UndirectedGraph g{snapshot, 3};
+      std::set<std::pair<std::uint32_t, std::uint32_t>> linked;
+      for (std::uint32_t v = 0; v < 60; ++v) {
+        std::for_each(g.NeighboursBegin(v), g.NeighboursEnd(v), [&](std::uint32_t w) {
+          linked.emplace(v, w);
+        });
+      }
+      std::uint64_t expected = 0;
+      std::vector<std::uint64_t> through(60);
+      for (std::uint32_t a = 0; a < 60; ++a) {
+        for (std::uint32_t b = a + 1; b < 60; ++b) {
+          for (std::uint32_t c = b + 1; c < 60; ++c) {
+            if (linked.count({a, b}) && linked.count({b, c}) && linked.count({a, c})) {
+              ++expected;
+              ++through[a];
+              ++through[b];
+              ++through[c];
+            }
+          }
+        }
+      }
+      THEN("the total and the count through each node agree on 1 and 4 threads") {
+        for (std::size_t threads : {1, 4}) {
+          REQUIRE(gdwg::CountTriangles(g, threads) == expected);
+          const auto local = gdwg::CountLocalTriangles(g, threads);
+          REQUIRE(local.triangles == through);
+          for (std::uint32_t v = 0; v < 60; ++v) {
+            const double d = static_cast<double>(g.Degree(v));
+            const double coefficient =
+                d < 2 ? 0 : 2 * static_cast<double>(through[v]) / d / (d - 1);
+            REQUIRE(local.clustering[v] == Approx(coefficient));
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Triangles among accounts that pay each other") {
+  GIVEN("a ring of three accounts, one of which also pays a fourth") {
+    gdwg::Graph<std::string, double> g{"ann", "bob", "cat", "dan"};
+    g.InsertEdge("ann", "bob", 10);
+    g.InsertEdge("bob", "cat", 20);
+    g.InsertEdge("cat", "ann", 5);
+    g.InsertEdge("ann", "cat", 7);
+    g.InsertEdge("ann", "dan", 1);
+    THEN("there is one triangle, and ann's neighbours are a third as clustered") {
+      REQUIRE(gdwg::CountTriangles(g) == 1);
+      const auto local = gdwg::CountLocalTriangles(g);
+      REQUIRE(local.triangles == std::vector<std::uint64_t>{1, 1, 1, 0});
+      REQUIRE(local.clustering[0] == Approx(1.0 / 3));
+      REQUIRE(local.clustering[1] == Approx(1.0));
+      REQUIRE(local.clustering[3] == 0);
+    }
+  }
+}
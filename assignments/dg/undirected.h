@@ -0,0 +1,94 @@
+#ifndef ASSIGNMENTS_DG_UNDIRECTED_H_
+#define ASSIGNMENTS_DG_UNDIRECTED_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "assignments/dg/parallel.h"
+#include "assignments/dg/snapshot.h"
+
+namespace gdwg {
+
+// The simple undirected graph underneath a snapshot, for algorithms that ignore direction and
+// weights: u and v are neighbours if either has an edge to the other. Self loops and repeated
+// edges are dropped, and each node's neighbours are its snapshot's NodeIds in increasing order,
+// ready for the intersections in intersect.h.
+class UndirectedGraph {
+ public:
+  using NodeId = std::uint32_t;
+  using EdgeId = std::uint64_t;
+
+  UndirectedGraph() : offsets_{0} {}
+  // sorts each node's neighbours on up to `threads` workers
+  template <typename N, typename E>
+  explicit UndirectedGraph(const Snapshot<N, E>& snapshot, std::size_t threads = DefaultThreads());
+
+  std::size_t NumNodes() const noexcept { return offsets_.size() - 1; }
+  // every edge once, though each is in both of its ends' lists
+  std::size_t NumEdges() const noexcept { return neighbours_.size() / 2; }
+  std::size_t Degree(NodeId v) const noexcept { return offsets_[v + 1] - offsets_[v]; }
+  const NodeId* NeighboursBegin(NodeId v) const noexcept {
+    return neighbours_.data() + offsets_[v];
+  }
+  const NodeId* NeighboursEnd(NodeId v) const noexcept {
+    return neighbours_.data() + offsets_[v + 1];
+  }
+
+  const std::vector<EdgeId>& Offsets() const noexcept { return offsets_; }
+  const std::vector<NodeId>& Neighbours() const noexcept { return neighbours_; }
+
+ private:
+  std::vector<EdgeId> offsets_;
+  std::vector<NodeId> neighbours_;
+};
+
+template <typename N, typename E>
+UndirectedGraph::UndirectedGraph(const Snapshot<N, E>& snapshot, std::size_t threads) {
+  const std::size_t n = snapshot.NumNodes();
+  // both directions of every edge, with repeats, then each list sorted and cut down in place
+  std::vector<EdgeId> offsets(n + 1, 0);
+  for (NodeId v = 0; v < n; ++v) {
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      if (snapshot.Dst(e) != v) {
+        ++offsets[v + 1];
+        ++offsets[snapshot.Dst(e) + 1];
+      }
+    }
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<NodeId> all(offsets[n]);
+  std::vector<EdgeId> next(offsets.begin(), offsets.end() - 1);
+  for (NodeId v = 0; v < n; ++v) {
+    for (auto e = snapshot.EdgeBegin(v); e != snapshot.EdgeEnd(v); ++e) {
+      if (snapshot.Dst(e) != v) {
+        all[next[v]++] = snapshot.Dst(e);
+        all[next[snapshot.Dst(e)]++] = v;
+      }
+    }
+  }
+  std::vector<EdgeId> sizes(n + 1, 0);
+  ParallelFor(n,
+              [&](std::size_t v) {
+                const auto begin = all.begin() + static_cast<std::ptrdiff_t>(offsets[v]);
+                const auto end = all.begin() + static_cast<std::ptrdiff_t>(offsets[v + 1]);
+                std::sort(begin, end);
+                sizes[v + 1] = static_cast<EdgeId>(std::unique(begin, end) - begin);
+              },
+              threads);
+  offsets_.resize(n + 1);
+  std::partial_sum(sizes.begin(), sizes.end(), offsets_.begin());
+  neighbours_.resize(offsets_[n]);
+  ParallelFor(n,
+              [&](std::size_t v) {
+                std::copy_n(all.begin() + static_cast<std::ptrdiff_t>(offsets[v]), Degree(v),
+                            neighbours_.begin() + static_cast<std::ptrdiff_t>(offsets_[v]));
+              },
+              threads);
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_UNDIRECTED_H_
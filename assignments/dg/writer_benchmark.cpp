@@ -0,0 +1,52 @@
+// Measures how fast a graph can be dumped as text to a file: a per-edge `os <<` loop over the
+// public iterators against Graph::Write with stream and to_chars formatting. Prints JSON.
+//
+//   writer_benchmark [--nodes=100000] [--edges=1000000]
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "assignments/dg/benchmark.h"
+#include "assignments/dg/builder.h"
+#include "assignments/dg/graph.h"
+
+int main(int argc, char** argv) {
+  namespace bm = gdwg::benchmark;
+  const auto num_nodes = bm::Arg(argc, argv, "nodes", 100000);
+  const auto num_edges = bm::Arg(argc, argv, "edges", 1000000);
+  const std::string path = std::filesystem::temp_directory_path() / "writer_benchmark.txt";
+
+  gdwg::GraphBuilder<long, double> builder;
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<long> node(0, static_cast<long>(num_nodes) - 1);
+  std::uniform_real_distribution<double> weight(0, 1000);
+  for (std::size_t i = 0; i < num_edges; ++i)
+    builder.AddEdge(node(rng), node(rng), weight(rng));
+  const auto g = builder.Build();
+
+  bm::Reporter reporter;
+  const bm::Fields params{{"nodes", g.NumNodes()}, {"edges", g.NumEdges()}};
+  auto run = [&](const std::string& name, auto&& dump) {
+    bm::Timer timer;
+    {
+      std::ofstream os{path};
+      dump(os);
+    }
+    const double seconds = timer.Seconds();
+    const double mb = std::filesystem::file_size(path) / 1e6;
+    reporter.Add(name, params, {{"seconds", seconds}, {"mb", mb}, {"mb_per_second", mb / seconds}});
+  };
+
+  run("iterator_loop", [&](std::ostream& os) {
+    for (const auto& [from, to, w] : g)
+      os << from << " -> " << to << " | " << w << '\n';
+  });
+  run("write_stream_format", [&](std::ostream& os) { os << g; });
+  run("write_to_chars", [&](std::ostream& os) { g.Write(os, gdwg::NumberFormat::kToChars); });
+
+  reporter.Print(std::cout);
+  std::remove(path.c_str());
+}